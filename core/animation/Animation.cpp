@@ -1,9 +1,22 @@
+#include "../utils/LinearArena.h"
+#include "../utils/PoolAllocator.h"
 #include "Animation.h"
 
 Joint::~Joint() {
 	for (Joint * child : children)
 		delete child;
 }
+void * Joint::operator new(size_t size) {
+	if (size != sizeof(Joint))
+		return ::operator new(size);
+	return PoolAllocator<Joint>::getShared()->allocate();
+}
+void Joint::operator delete(void * memory, size_t size) {
+	if (size != sizeof(Joint))
+		::operator delete(memory);
+	else
+		PoolAllocator<Joint>::getShared()->free(memory);
+}
 
 
 vec3 TranslationKeyframe::interpolate(TranslationKeyframe * previous, TranslationKeyframe * next, float progress) {
@@ -16,6 +29,40 @@ vec3 ScaleKeyframe::interpolate(ScaleKeyframe * previous, ScaleKeyframe * next,
 	return previous->scale + progress * (next->scale - previous->scale);
 }
 
+void * TranslationKeyframe::operator new(size_t size) {
+	if (size != sizeof(TranslationKeyframe))
+		return ::operator new(size);
+	return PoolAllocator<TranslationKeyframe>::getShared()->allocate();
+}
+void TranslationKeyframe::operator delete(void * memory, size_t size) {
+	if (size != sizeof(TranslationKeyframe))
+		::operator delete(memory);
+	else
+		PoolAllocator<TranslationKeyframe>::getShared()->free(memory);
+}
+void * RotationKeyframe::operator new(size_t size) {
+	if (size != sizeof(RotationKeyframe))
+		return ::operator new(size);
+	return PoolAllocator<RotationKeyframe>::getShared()->allocate();
+}
+void RotationKeyframe::operator delete(void * memory, size_t size) {
+	if (size != sizeof(RotationKeyframe))
+		::operator delete(memory);
+	else
+		PoolAllocator<RotationKeyframe>::getShared()->free(memory);
+}
+void * ScaleKeyframe::operator new(size_t size) {
+	if (size != sizeof(ScaleKeyframe))
+		return ::operator new(size);
+	return PoolAllocator<ScaleKeyframe>::getShared()->allocate();
+}
+void ScaleKeyframe::operator delete(void * memory, size_t size) {
+	if (size != sizeof(ScaleKeyframe))
+		::operator delete(memory);
+	else
+		PoolAllocator<ScaleKeyframe>::getShared()->free(memory);
+}
+
 
 AnimationKeyframes::~AnimationKeyframes() {
 	for (TranslationKeyframe * t : translations)
@@ -26,38 +73,35 @@ AnimationKeyframes::~AnimationKeyframes() {
 		delete s;
 }
 
-vector<TranslationKeyframe*> AnimationKeyframes::getPreviousAndNextTranslations(float animTime) {
-	vector<TranslationKeyframe*> result;
-	for (int k = translations.size() - 1; k >= 0; k--) {
-		if (animTime >= translations[k]->time) {
-			result.push_back(translations[k]);
-			result.push_back(translations[(k + 1) % translations.size()]);
-			return result;
-		}
-	}
-	return result;
-}
-vector<RotationKeyframe*> AnimationKeyframes::getPreviousAndNextRotations(float animTime) {
-	vector<RotationKeyframe*> result;
-	for (int k = rotations.size() - 1; k >= 0; k--) {
-		if (animTime >= rotations[k]->time) {
-			result.push_back(rotations[k]);
-			result.push_back(rotations[(k + 1) % rotations.size()]);
-			return result;
-		}
-	}
-	return result;
-}
-vector<ScaleKeyframe*> AnimationKeyframes::getPreviousAndNextScales(float animTime) {
-	vector<ScaleKeyframe*> result;
-	for (int k = scales.size() - 1; k >= 0; k--) {
-		if (animTime >= scales[k]->time) {
-			result.push_back(scales[k]);
-			result.push_back(scales[(k + 1) % scales.size()]);
-			return result;
+// Finds the last keyframe at or before a time and the one after it, wrapping around, or the first one twice before it.
+template <typename K>
+static void findPreviousAndNext(const vector<K*> & keyframes, float time, K *& previous, K *& next) {
+	previous = next = nullptr;
+	if (keyframes.empty())
+		return;
+	for (int k = keyframes.size() - 1; k >= 0; k--) {
+		if (time >= keyframes[k]->time) {
+			previous = keyframes[k];
+			next = keyframes[(k + 1) % keyframes.size()];
+			return;
 		}
 	}
-	return result;
+	previous = next = keyframes[0];
+}
+
+// Position of a time between two keyframes, 0 when they coincide.
+static float progress(float time, float previous, float next) {
+	return next != previous ? (time - previous) / (next - previous) : 0.0f;
+}
+
+void AnimationKeyframes::getPreviousAndNextTranslations(float animTime, TranslationKeyframe *& previous, TranslationKeyframe *& next) {
+	findPreviousAndNext(translations, animTime, previous, next);
+}
+void AnimationKeyframes::getPreviousAndNextRotations(float animTime, RotationKeyframe *& previous, RotationKeyframe *& next) {
+	findPreviousAndNext(rotations, animTime, previous, next);
+}
+void AnimationKeyframes::getPreviousAndNextScales(float animTime, ScaleKeyframe *& previous, ScaleKeyframe *& next) {
+	findPreviousAndNext(scales, animTime, previous, next);
 }
 
 
@@ -93,8 +137,8 @@ void Animator::preorder(Joint * current, function<void(Joint*)> callback) {
 	for (int c = 0; c < current->children.size(); c++)
 		preorder(current->children[c], callback);
 }
-void Animator::applyPoseToJoints(map<string, mat4> & pose, Joint * joint, mat4 & parentTransform) {
-	mat4 currentTransform = parentTransform * pose[joint->name];
+void Animator::applyPoseToJoints(const mat4 * pose, Joint * joint, mat4 & parentTransform) {
+	mat4 currentTransform = parentTransform * pose[joint->index];
 	animTransforms[joint->index] = globalInverseTransform * currentTransform * joint->transform;
 
 	for (Joint* child : joint->children)
@@ -103,6 +147,14 @@ void Animator::applyPoseToJoints(map<string, mat4> & pose, Joint * joint, mat4 &
 
 Animator * Animator::use(Animation * anim) {
 	this->anim = anim;
+
+	// Resolve the joint of each channel once rather than on every pose.
+	channelJoints.clear();
+	if (anim != nullptr)
+		for (auto it = anim->keyframes.begin(); it != anim->keyframes.end(); it++) {
+			auto joint = joints.find(it->first);
+			channelJoints.push_back(joint != joints.end() ? static_cast<int>(joint->second->index) : -1);
+		}
 	return this;
 }
 Animator * Animator::seek(float time) {
@@ -120,22 +172,34 @@ Animator * Animator::stop() {
 }
 
 mat4 * Animator::computeTransforms()  {
-	
-	// Create the current pose based on the animation time
-	map<string, mat4> pose;
-	for (auto it = anim->keyframes.begin(); it != anim->keyframes.end(); it++) {
+
+	// Create the current pose based on the animation time, in scratch memory of the calling thread
+	LinearArena * arena = LinearArena::getThreadArena();
+	LinearArena::Marker marker = arena->getMarker();
+	mat4 * pose = arena->allocate<mat4>(numJoints);
+	for (unsigned int j = 0; j < numJoints; j++)
+		pose[j] = Mat4Identity;
+
+	unsigned int channel = 0;
+	for (auto it = anim->keyframes.begin(); it != anim->keyframes.end(); it++, channel++) {
+		int joint = channelJoints[channel];
+		if (joint < 0 || joint >= static_cast<int>(numJoints))
+			continue;
 
 		// Translation
-		vector<TranslationKeyframe*> tKeys = it->second->getPreviousAndNextTranslations(animTime);
-		vec3 translation = TranslationKeyframe::interpolate(tKeys[0], tKeys[1], (animTime - tKeys[0]->time) / (tKeys[1]->time - tKeys[0]->time));
+		TranslationKeyframe * tPrevious, * tNext;
+		it->second->getPreviousAndNextTranslations(animTime, tPrevious, tNext);
+		vec3 translation = tPrevious != nullptr ? TranslationKeyframe::interpolate(tPrevious, tNext, progress(animTime, tPrevious->time, tNext->time)) : vec3(0);
 
 		// Rotation
-		vector<RotationKeyframe*> rKeys = it->second->getPreviousAndNextRotations(animTime);
-		vec4 rotation = RotationKeyframe::interpolate(rKeys[0], rKeys[1], (animTime - rKeys[0]->time) / (rKeys[1]->time - rKeys[0]->time));
-		
+		RotationKeyframe * rPrevious, * rNext;
+		it->second->getPreviousAndNextRotations(animTime, rPrevious, rNext);
+		vec4 rotation = rPrevious != nullptr ? RotationKeyframe::interpolate(rPrevious, rNext, progress(animTime, rPrevious->time, rNext->time)) : vec4(0, 0, 0, 1);
+
 		// Scale
-		vector<ScaleKeyframe*> sKeys = it->second->getPreviousAndNextScales(animTime);
-		vec3 scale = ScaleKeyframe::interpolate(sKeys[0], sKeys[1], (animTime - sKeys[0]->time) / (sKeys[1]->time - sKeys[0]->time));
+		ScaleKeyframe * sPrevious, * sNext;
+		it->second->getPreviousAndNextScales(animTime, sPrevious, sNext);
+		vec3 scale = sPrevious != nullptr ? ScaleKeyframe::interpolate(sPrevious, sNext, progress(animTime, sPrevious->time, sNext->time)) : vec3(1);
 
 		// Convert the transformations to matrices
 		mat4 matTranslation, matRotation, matScale;
@@ -144,13 +208,14 @@ mat4 * Animator::computeTransforms()  {
 		matScale = mat4().scale(scale);
 
 		// Combine the transformations into a single matrix
-		pose[it->first] = matTranslation * matRotation * matScale;
+		pose[joint] = matTranslation * matRotation * matScale;
 	}
 	
 	// Apply the pose to the joints
 	mat4 identity;
 	applyPoseToJoints(pose, root, identity);
 
+	arena->rewind(marker);
 	return animTransforms;
 }
 
@@ -21,6 +21,10 @@ struct Joint {
 	vector<Joint*> children;
 
 	~Joint();
+
+	// Allocated from a shared pool, or from the heap for allocations of another size
+	static void * operator new(size_t size);
+	static void operator delete(void * memory, size_t size);
 };
 
 // Animation translation keyframe
@@ -29,6 +33,10 @@ struct TranslationKeyframe {
 	float time;
 
 	static vec3 interpolate(TranslationKeyframe * previous, TranslationKeyframe * next, float progress);
+
+	// Allocated from a shared pool, or from the heap for allocations of another size
+	static void * operator new(size_t size);
+	static void operator delete(void * memory, size_t size);
 };
 
 // Animation rotation keyframe
@@ -37,6 +45,10 @@ struct RotationKeyframe {
 	float time;
 
 	static vec4 interpolate(RotationKeyframe * previous, RotationKeyframe * next, float progress);
+
+	// Allocated from a shared pool, or from the heap for allocations of another size
+	static void * operator new(size_t size);
+	static void operator delete(void * memory, size_t size);
 };
 
 // Animation scale keyframe
@@ -45,6 +57,10 @@ struct ScaleKeyframe {
 	float time;
 
 	static vec3 interpolate(ScaleKeyframe * previous, ScaleKeyframe * next, float progress);
+
+	// Allocated from a shared pool, or from the heap for allocations of another size
+	static void * operator new(size_t size);
+	static void operator delete(void * memory, size_t size);
 };
 
 // Combination of all keyframes
@@ -55,9 +71,10 @@ struct AnimationKeyframes {
 
 	~AnimationKeyframes();
 
-	vector<TranslationKeyframe*> getPreviousAndNextTranslations(float time);
-	vector<RotationKeyframe*> getPreviousAndNextRotations(float time);
-	vector<ScaleKeyframe*> getPreviousAndNextScales(float time);
+	// Keyframes surrounding a time, both null if there are none
+	void getPreviousAndNextTranslations(float time, TranslationKeyframe *& previous, TranslationKeyframe *& next);
+	void getPreviousAndNextRotations(float time, RotationKeyframe *& previous, RotationKeyframe *& next);
+	void getPreviousAndNextScales(float time, ScaleKeyframe *& previous, ScaleKeyframe *& next);
 };
 
 // Represents an animation with a set of keyframes for each joint and a duration in seconds
@@ -77,6 +94,9 @@ class Animator {
 
 		// Animation to play
 		Animation * anim;
+
+		// Index of the joint each channel of the animation moves, -1 for channels moving no joint
+		vector<int> channelJoints;
 		float animTime;
 		bool playing;
 
@@ -95,8 +115,8 @@ class Animator {
 		// Performs preorder traversal of a joint tree
 		void preorder(Joint * current, function<void(Joint *)> callback);
 		
-		// Applies a transform to a joint and its children
-		void applyPoseToJoints(map<string, mat4> & rotation, Joint * joint, mat4 & parentTransform);
+		// Applies a transform to a joint and its children, the pose being indexed by joint index
+		void applyPoseToJoints(const mat4 * pose, Joint * joint, mat4 & parentTransform);
 		
 	public:
 		Animator(Joint * root, mat4 globalInverseTransform);
@@ -122,4 +142,13 @@ class Animator {
 
 		// Number of joints in the skeleton
 		inline unsigned int getJointCount() const { return numJoints; };
+
+		// Current animation, null if none is used
+		inline Animation * getAnimation() const { return anim; };
+
+		// Root of the skeleton
+		inline const Joint * getRoot() const { return root; };
+
+		// Joint transforms last computed, indexed by joint index
+		inline const mat4 * getTransforms() const { return animTransforms; };
 };
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include <chrono>
+#include <cfloat>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+#include "../utils/EngineDef.h"
+#include "../render/AABBTree.h"
+#include "../render/FrustumCuller.h"
+#include "Benchmarks.h"
+
+using std::cout;
+using std::endl;
+using namespace std::chrono;
+
+// Number of frustum queries, rays and overlap boxes per method, and of simulated frames of movement.
+static const unsigned int QUERIES = 100;
+static const unsigned int RAYS = 1000;
+static const unsigned int OVERLAPS = 1000;
+static const unsigned int FRAMES = 100;
+
+// Returns a random number between two bounds.
+static float randomRange(float min, float max) {
+	return min + static_cast<float>(rand()) / RAND_MAX * (max - min);
+}
+
+// Returns a random box scattered all around a camera at the origin.
+static AABB randomBox() {
+	vec3 center = vec3(randomRange(-1000.0f, 1000.0f), randomRange(-200.0f, 200.0f), randomRange(-1000.0f, 1000.0f));
+	vec3 extent = vec3(randomRange(0.5f, 5.0f), randomRange(0.5f, 5.0f), randomRange(0.5f, 5.0f));
+	return { center - extent, center + extent };
+}
+
+// Returns the time taken by a function in milliseconds.
+static double measure(const std::function<void()> & run) {
+	auto start = high_resolution_clock::now();
+	run();
+	return duration<double, std::milli>(high_resolution_clock::now() - start).count();
+}
+
+int benchmarkBVH(unsigned int count) {
+	srand(0);
+	vector<AABB> boxes(count);
+	CullingBounds bounds;
+	for (unsigned int i = 0; i < count; i++) {
+		boxes[i] = randomBox();
+		bounds.add(boxes[i].min, boxes[i].max);
+	}
+
+	// Build a static tree top-down, and a dynamic one by inserting each object.
+	AABBTree staticTree(0.0f), dynamicTree;
+	vector<int> proxies(count);
+	cout << "SAH build: " << measure([&]() { staticTree.build(boxes); }) << " ms, height " << staticTree.getHeight()
+		<< ", cost " << staticTree.computeCost() << endl;
+	cout << "Incremental build: " << measure([&]() {
+		for (unsigned int i = 0; i < count; i++)
+			proxies[i] = dynamicTree.insert(boxes[i], i);
+	}) << " ms, height " << dynamicTree.getHeight() << ", cost " << dynamicTree.computeCost() << endl;
+
+	// Frustum queries, linearly with the SIMD kernel and through each tree.
+	Frustum frustum(perspective(16, 9, 70.0f, true));
+	FrustumCuller culler;
+	vector<unsigned int> staticVisible, dynamicVisible;
+	double linearTime = measure([&]() {
+		for (unsigned int q = 0; q < QUERIES; q++)
+			culler.cull(frustum, bounds);
+	});
+	double staticTime = measure([&]() {
+		for (unsigned int q = 0; q < QUERIES; q++) {
+			staticVisible.clear();
+			staticTree.queryFrustum(frustum, staticVisible);
+		}
+	});
+	double dynamicTime = measure([&]() {
+		for (unsigned int q = 0; q < QUERIES; q++) {
+			dynamicVisible.clear();
+			dynamicTree.queryFrustum(frustum, dynamicVisible);
+		}
+	});
+	std::sort(staticVisible.begin(), staticVisible.end());
+	cout << "Frustum: linear " << linearTime / QUERIES << " ms, SAH tree " << staticTime / QUERIES << " ms, dynamic tree "
+		<< dynamicTime / QUERIES << " ms, " << culler.getVisible().size() << " visible"
+		<< (staticVisible == culler.getVisible() ? "" : ", MISMATCH") << endl;
+
+	// Ray casts from around the camera, against every box and through the static tree.
+	vector<vec3> origins(RAYS), directions(RAYS);
+	for (unsigned int r = 0; r < RAYS; r++) {
+		origins[r] = vec3(randomRange(-10.0f, 10.0f), randomRange(-10.0f, 10.0f), randomRange(-10.0f, 10.0f));
+		directions[r] = vec3(randomRange(-1.0f, 1.0f), randomRange(-0.4f, 0.4f), -1.0f);
+	}
+	vector<float> linearHits(RAYS, -1.0f), treeHits(RAYS, -1.0f);
+	linearTime = measure([&]() {
+		for (unsigned int r = 0; r < RAYS; r++) {
+			vec3 inverse = vec3(1.0f / directions[r].x, 1.0f / directions[r].y, 1.0f / directions[r].z);
+			for (const AABB & box : boxes) {
+				float t0 = std::max(std::max(std::min((box.min.x - origins[r].x) * inverse.x, (box.max.x - origins[r].x) * inverse.x),
+					std::min((box.min.y - origins[r].y) * inverse.y, (box.max.y - origins[r].y) * inverse.y)),
+					std::max(std::min((box.min.z - origins[r].z) * inverse.z, (box.max.z - origins[r].z) * inverse.z), 0.0f));
+				float t1 = std::min(std::min(std::max((box.min.x - origins[r].x) * inverse.x, (box.max.x - origins[r].x) * inverse.x),
+					std::max((box.min.y - origins[r].y) * inverse.y, (box.max.y - origins[r].y) * inverse.y)),
+					std::max((box.min.z - origins[r].z) * inverse.z, (box.max.z - origins[r].z) * inverse.z));
+				if (t0 <= t1 && (linearHits[r] < 0.0f || t0 < linearHits[r]))
+					linearHits[r] = t0;
+			}
+		}
+	});
+	staticTime = measure([&]() {
+		RaycastHit hit;
+		for (unsigned int r = 0; r < RAYS; r++)
+			if (staticTree.raycast(origins[r], directions[r], FLT_MAX, hit))
+				treeHits[r] = hit.distance;
+	});
+	unsigned int mismatches = 0, hits = 0;
+	for (unsigned int r = 0; r < RAYS; r++) {
+		hits += linearHits[r] >= 0.0f;
+		mismatches += linearHits[r] != treeHits[r];
+	}
+	cout << "Ray casts: linear " << linearTime / RAYS << " ms, SAH tree " << staticTime / RAYS << " ms, "
+		<< hits << " of " << RAYS << " hit, " << mismatches << " mismatches" << endl;
+
+	// Overlap queries with boxes of various sizes.
+	vector<AABB> queries(OVERLAPS);
+	for (AABB & query : queries) {
+		query = randomBox();
+		vec3 grow = vec3(randomRange(0.0f, 20.0f));
+		query = { query.min - grow, query.max + grow };
+	}
+	unsigned int linearFound = 0, treeFound = 0;
+	linearTime = measure([&]() {
+		for (const AABB & query : queries)
+			for (const AABB & box : boxes)
+				linearFound += query.overlaps(box);
+	});
+	staticTime = measure([&]() {
+		vector<unsigned int> found;
+		for (const AABB & query : queries) {
+			found.clear();
+			staticTree.queryOverlap(query, found);
+			treeFound += static_cast<unsigned int>(found.size());
+		}
+	});
+	cout << "Overlaps: linear " << linearTime / OVERLAPS << " ms, SAH tree " << staticTime / OVERLAPS << " ms, "
+		<< treeFound << " found" << (linearFound == treeFound ? "" : ", MISMATCH") << endl;
+
+	// A tenth of the objects drifting each frame, through updates and through in place refits.
+	unsigned int moving = count / 10, reinserted = 0;
+	vector<vec3> velocities(moving);
+	for (vec3 & velocity : velocities)
+		velocity = vec3(randomRange(-0.05f, 0.05f), randomRange(-0.05f, 0.05f), randomRange(-0.05f, 0.05f));
+	vector<AABB> moved(boxes.begin(), boxes.begin() + moving);
+	double updateTime = measure([&]() {
+		for (unsigned int f = 0; f < FRAMES; f++) {
+			for (unsigned int i = 0; i < moving; i++) {
+				moved[i] = { moved[i].min + velocities[i], moved[i].max + velocities[i] };
+				reinserted += dynamicTree.update(proxies[i], moved[i]);
+			}
+		}
+	});
+	cout << "Updates: " << updateTime / FRAMES << " ms per frame for " << moving << " objects, "
+		<< reinserted / FRAMES << " reinserted per frame, cost " << dynamicTree.computeCost() << endl;
+
+	vector<int> staticProxies;
+	staticTree.build(boxes, &staticProxies);
+	moved.assign(boxes.begin(), boxes.begin() + moving);
+	double refitTime = measure([&]() {
+		for (unsigned int f = 0; f < FRAMES; f++) {
+			for (unsigned int i = 0; i < moving; i++) {
+				moved[i] = { moved[i].min + velocities[i], moved[i].max + velocities[i] };
+				staticTree.refit(staticProxies[i], moved[i]);
+			}
+		}
+	});
+	cout << "Refits: " << refitTime / FRAMES << " ms per frame for " << moving << " objects, cost " << staticTree.computeCost() << endl;
+	return ENG_SUCCESS;
+}
@@ -0,0 +1,43 @@
+#include <iostream>
+
+#include "../utils/EngineDef.h"
+#include "Benchmarks.h"
+
+using std::cout;
+using std::endl;
+
+int runBenchmark(const string & name, const vector<string> & args) {
+	if (name == "decode" && args.size() == 1)
+		return benchmarkDecode(args[0]);
+	if (name == "instancing" && (args.size() == 1 || args.size() == 2))
+		return benchmarkInstancing(args[0], args.size() == 2 ? std::stoi(args[1]) : 1000);
+	if (name == "stream" && args.size() <= 1)
+		return benchmarkStream(args.size() == 1 ? std::stoi(args[0]) : 100000);
+	if (name == "multidraw" && (args.size() == 1 || args.size() == 2))
+		return benchmarkMultiDraw(args[0], args.size() == 2 ? std::stoi(args[1]) : 10000);
+	if (name == "culling" && args.size() <= 1)
+		return benchmarkCulling(args.size() == 1 ? std::stoi(args[0]) : 100000);
+	if (name == "bvh" && args.size() <= 1)
+		return benchmarkBVH(args.size() == 1 ? std::stoi(args[0]) : 100000);
+	if (name == "occlusion" && args.size() <= 1)
+		return benchmarkOcclusion(args.size() == 1 ? std::stoi(args[0]) : 100000);
+	if (name == "pipelining" && args.size() <= 2)
+		return benchmarkPipelining(args.size() >= 1 ? std::stof(args[0]) : 4.0f, args.size() == 2 ? std::stof(args[1]) : 6.0f);
+	if (name == "jobs" && args.size() <= 1)
+		return benchmarkJobs(args.size() == 1 ? std::stoi(args[0]) : 1000000);
+	if (name == "jobs-test" && args.size() <= 1)
+		return testJobs(args.size() == 1 ? std::stoi(args[0]) : 20);
+
+	cout << "Usage: --benchmark <name> [args...]" << endl;
+	cout << "  decode <folder>    Image decoding and upload throughput over a folder of PNG files." << endl;
+	cout << "  instancing <model> [count]    Separate versus instanced draws of many copies of a mesh." << endl;
+	cout << "  stream [count]    Orphaned versus streamed uploads of many debug lines per frame." << endl;
+	cout << "  multidraw <model> [count]    Separate draws versus a base vertex loop and multi-draw indirect over shared buffers." << endl;
+	cout << "  culling [count]    Scalar, SIMD and parallel frustum culling of random bounding boxes." << endl;
+	cout << "  bvh [count]    Bounding volume hierarchy builds, queries and updates versus linear tests." << endl;
+	cout << "  occlusion [count]    Software occlusion culling of random bounding boxes behind a wall." << endl;
+	cout << "  pipelining [simulation ms] [render ms]    Serial versus pipelined simulation and submission on the render thread." << endl;
+	cout << "  jobs [count]    Job system scaling, scheduling overhead and dependencies." << endl;
+	cout << "  jobs-test [rounds]    Job system correctness checks, failing with a non-zero exit code." << endl;
+	return ERR_UNKNOWN_BENCHMARK;
+}
@@ -0,0 +1,110 @@
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+#pragma once
+
+/**
+ * @brief Runs the named benchmark and prints its results. Benchmarks run once the OpenGL context is created.
+ * 
+ * @param name The name of the benchmark to run.
+ * @param args The benchmark's arguments.
+ * @return [int] ENG_SUCCESS if the benchmark ran, or an error code.
+ */
+int runBenchmark(const string & name, const vector<string> & args);
+
+/**
+ * @brief Measures image decoding and upload throughput over a folder of PNG files, 
+ * loading them one after the other like Loader::loadTexture2D and then through a TextureDecoder.
+ * 
+ * @param folder The folder containing the PNG files, mounted in the virtual file system for the decoder.
+ * @return [int] ENG_SUCCESS if the benchmark ran, ERR_NO_BENCHMARK_INPUT if the folder holds no PNG file,
+ * or ERR_CHECK_FAILED if the decoder failed to load any image.
+ */
+int benchmarkDecode(const string & folder);
+
+/**
+ * @brief Measures the cost of drawing many copies of a mesh, with one uniform upload and draw call per copy
+ * and then through the render queue, which merges them into instanced draws.
+ * 
+ * @param model The model file to draw, relative to the models directory.
+ * @param count The number of copies to draw.
+ * @return [int] ENG_SUCCESS if the benchmark ran, or an error code.
+ */
+int benchmarkInstancing(const string & model, unsigned int count);
+
+/**
+ * @brief Measures the cost of uploading and drawing many debug lines every frame, through orphaned buffers
+ * and then through a persistently mapped and an unsynchronized mapped stream buffer.
+ * 
+ * @param count The number of lines drawn each frame.
+ * @return [int] ENG_SUCCESS if the benchmark ran, or an error code.
+ */
+int benchmarkStream(unsigned int count);
+
+/**
+ * @brief Measures the CPU cost of submitting many static objects, with a draw call per object from its own vertex array,
+ * with a base vertex draw loop over shared buffers, and with a single multi-draw indirect.
+ * 
+ * @param model The model file to draw, relative to the models directory.
+ * @param count The number of objects, half of which are visible.
+ * @return [int] ENG_SUCCESS if the benchmark ran, or an error code.
+ */
+int benchmarkMultiDraw(const string & model, unsigned int count);
+
+/**
+ * @brief Measures frustum culling throughput over random bounding boxes, one box at a time,
+ * with the SIMD culling kernel, and with the kernel split across a thread pool.
+ * 
+ * @param count The number of boxes.
+ * @return [int] ENG_SUCCESS if the benchmark ran, or an error code.
+ */
+int benchmarkCulling(unsigned int count);
+
+/**
+ * @brief Measures building, frustum, ray and overlap queries, and updates of bounding volume hierarchies over random boxes,
+ * against linear tests of every box.
+ * 
+ * @param count The number of boxes.
+ * @return [int] ENG_SUCCESS if the benchmark ran, or an error code.
+ */
+int benchmarkBVH(unsigned int count);
+
+/**
+ * @brief Measures software occlusion culling of random bounding boxes behind a wall, rasterizing the wall,
+ * building the depth pyramid and testing the boxes left by frustum culling, and checks that no visible box is culled.
+ * 
+ * @param count The number of boxes.
+ * @return [int] ENG_SUCCESS if the benchmark ran, or an error code.
+ */
+int benchmarkOcclusion(unsigned int count);
+
+/**
+ * @brief Measures the frame time and latency of simulating a frame while the render thread submits the previous ones,
+ * with busy work standing in for both, at increasing maximum latencies.
+ * 
+ * @param simulationTime The time spent simulating each frame, in milliseconds.
+ * @param renderTime The time spent submitting each frame, in milliseconds.
+ * @return [int] ENG_SUCCESS if the benchmark ran, or an error code.
+ */
+int benchmarkPipelining(float simulationTime, float renderTime);
+
+/**
+ * @brief Measures how a parallel for scales with the number of workers of the job system, the cost of scheduling
+ * empty jobs compared to thread pool tasks, and chains of stages of jobs depending on each other.
+ * 
+ * @param count The number of elements processed and of empty jobs scheduled.
+ * @return [int] ENG_SUCCESS if the benchmark ran, or an error code.
+ */
+int benchmarkJobs(unsigned int count);
+
+/**
+ * @brief Checks the job system under contention: parallel for coverage, nested waits, dependency chains,
+ * jobs run from other threads, queue overflow and counter lifetime. Meant to be run under a thread sanitizer.
+ * 
+ * @param rounds The number of times the checks are repeated, each with a new job system.
+ * @return [int] ENG_SUCCESS if every check passed, or ERR_CHECK_FAILED.
+ */
+int testJobs(unsigned int rounds);
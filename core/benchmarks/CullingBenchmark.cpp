@@ -0,0 +1,69 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <functional>
+
+#include "../utils/EngineDef.h"
+#include "../utils/JobSystem.h"
+#include "../render/FrustumCuller.h"
+#include "Benchmarks.h"
+
+using std::cout;
+using std::endl;
+using namespace std::chrono;
+
+// Number of times each method culls the boxes.
+static const unsigned int RUNS = 100;
+
+// Returns a random number between two bounds.
+static float randomRange(float min, float max) {
+	return min + static_cast<float>(rand()) / RAND_MAX * (max - min);
+}
+
+int benchmarkCulling(unsigned int count) {
+
+	// Random boxes scattered around a camera looking down the negative Z axis, roughly half of them in view.
+	srand(0);
+	Frustum frustum(perspective(16, 9, 70.0f, true));
+	CullingBounds bounds;
+	vector<vec3> mins(count), maxs(count);
+	for (unsigned int i = 0; i < count; i++) {
+		vec3 center = vec3(randomRange(-500.0f, 500.0f), randomRange(-200.0f, 200.0f), randomRange(-1000.0f, 200.0f));
+		vec3 extent = vec3(randomRange(0.5f, 5.0f), randomRange(0.5f, 5.0f), randomRange(0.5f, 5.0f));
+		mins[i] = center - extent;
+		maxs[i] = center + extent;
+		bounds.add(mins[i], maxs[i]);
+	}
+
+	// One box at a time, through the frustum's own test.
+	vector<unsigned char> reference(count);
+	auto scalar = [&]() {
+		for (unsigned int i = 0; i < count; i++)
+			reference[i] = frustum.intersectsBox(mins[i], maxs[i]) ? 1 : 0;
+	};
+
+	// Several boxes at a time, on the calling thread and then across the job system's workers.
+	FrustumCuller serial;
+	JobSystem jobs;
+	FrustumCuller parallel(&jobs);
+
+	auto measure = [count](const string & name, const std::function<void()> & run) {
+		run();
+		auto start = high_resolution_clock::now();
+		for (unsigned int r = 0; r < RUNS; r++)
+			run();
+		double total = duration<double>(high_resolution_clock::now() - start).count();
+		cout << name << ": " << total * 1000.0 / RUNS << " ms per cull of " << count << " boxes" << endl;
+	};
+
+	measure("Scalar", scalar);
+	measure("SIMD", [&]() { serial.cull(frustum, bounds); });
+	measure("SIMD across " + std::to_string(jobs.getWorkerCount()) + " threads", [&]() { parallel.cull(frustum, bounds); });
+
+	unsigned int mismatches = 0;
+	for (unsigned int i = 0; i < count; i++)
+		if (reference[i] != serial.getFlags()[i] || reference[i] != parallel.getFlags()[i])
+			mismatches++;
+	cout << "Visible: " << serial.getVisible().size() << " of " << count << ", " << mismatches << " mismatches with the scalar test" << endl;
+	return ENG_SUCCESS;
+}
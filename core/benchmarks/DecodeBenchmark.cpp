@@ -0,0 +1,83 @@
+#include <chrono>
+#include <iostream>
+#include <functional>
+
+#include <glad/glad.h>
+
+#include "../utils/EngineDef.h"
+#include "../utils/stb_image.h"
+#include "../utils/BufferPool.h"
+#include "../utils/FileSystem.h"
+#include "../utils/TextureDecoder.h"
+#include "../utils/VirtualFileSystem.h"
+#include "../render/GLStateCache.h"
+#include "Benchmarks.h"
+
+using std::cout;
+using std::endl;
+using namespace std::chrono;
+
+// The virtual directory the benchmarked folder is mounted at for the decoder, which reads through the virtual file system.
+static const string MOUNT_POINT = "benchmark/decode/";
+
+int benchmarkDecode(const string & folder) {
+	vector<string> files = FileSystem::listFiles(folder, ".png");
+	if (files.empty()) {
+		cout << "No PNG files found in " << folder << "." << endl;
+		return ERR_NO_BENCHMARK_INPUT;
+	}
+
+	// Loads every image one after the other, decoding and uploading it synchronously.
+	auto serial = [&]() {
+		for (const string & file : files) {
+			int width, height, nbChannels;
+			unsigned char * data = stbi_load((folder + "/" + file).c_str(), &width, &height, &nbChannels, STBI_rgb_alpha);
+			if (data == NULL)
+				continue;
+			unsigned int texID;
+			glGenTextures(1, &texID);
+			GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, texID);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+			glGenerateMipmap(GL_TEXTURE_2D);
+			stbi_image_free(data);
+			GLStateCache::getShared()->deleteTexture(texID);
+		}
+		glFinish();
+	};
+
+	// Loads every image through the decode service, counting the images it failed to load.
+	if (!VirtualFileSystem::getShared()->mount(MOUNT_POINT, folder)) {
+		cout << "Could not mount " << folder << "." << endl;
+		return ERR_NO_BENCHMARK_INPUT;
+	}
+	TextureDecoder decoder(MOUNT_POINT);
+	unsigned int failures = 0;
+	auto parallel = [&]() {
+		for (const string & file : files)
+			decoder.load(file.c_str(), GL_LINEAR, [&failures](Texture * texture) {
+				if (texture == nullptr)
+					failures++;
+				delete texture;
+			});
+		decoder.finish();
+		glFinish();
+	};
+
+	// Run each method twice, only timing the second run so both read from a warm file cache.
+	auto measure = [&files](const string & name, const std::function<void()> & run) {
+		run();
+		auto start = high_resolution_clock::now();
+		run();
+		double seconds = duration<double>(high_resolution_clock::now() - start).count();
+		cout << name << ": " << files.size() / seconds << " images/s (" << seconds * 1000.0 << " ms for " << files.size() << " images)" << endl;
+	};
+
+	measure("Serial decode + glTexImage2D", serial);
+	measure("TextureDecoder (" + std::to_string(decoder.getThreadCount()) + " threads)", parallel);
+	cout << "Upload stalls: " << decoder.getStalls() << ", bytes uploaded: " << decoder.getBytesUploaded()
+		<< ", failed loads: " << failures << " over both runs" << endl;
+	cout << "Pooled buffers reused: " << BufferPool::getShared()->getReuses() << " / " << BufferPool::getShared()->getAllocations() << endl;
+
+	VirtualFileSystem::getShared()->unmount(folder);
+	return failures == 0 ? ENG_SUCCESS : ERR_CHECK_FAILED;
+}
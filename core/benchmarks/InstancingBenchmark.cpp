@@ -0,0 +1,106 @@
+#include <chrono>
+#include <iostream>
+#include <functional>
+
+#include <glad/glad.h>
+
+#include "../utils/EngineDef.h"
+#include "../utils/Loader.h"
+#include "../shaders/MeshShader.h"
+#include "../render/RenderQueue.h"
+#include "../render/FrameUniforms.h"
+#include "../objects/StreamBuffer.h"
+#include "Benchmarks.h"
+
+using std::cout;
+using std::endl;
+using namespace std::chrono;
+
+// Number of frames drawn by each method.
+static const unsigned int FRAMES = 100;
+
+int benchmarkInstancing(const string & model, unsigned int count) {
+	Loader loader;
+	Mesh * mesh = loader.loadMesh(model.c_str());
+	if (mesh == nullptr) {
+		cout << "Failed to load " << model << "." << endl;
+		return ERR_UNKNOWN_BENCHMARK;
+	}
+	FrameUniforms uniforms;
+	uniforms.update(mat4(), perspective(16, 9, 70.0f, true), vec3(0.0f), 0.0f, 0.0f);
+	MeshShader * shader = new MeshShader();
+	shader->use();
+	shader->loadAnimated(false);
+	shader->stop();
+
+	// Lay the copies out on a grid in front of the camera.
+	vector<MeshInstance> instances(count);
+	unsigned int side = 1;
+	while (side * side < count)
+		side++;
+	for (unsigned int i = 0; i < count; i++) {
+		instances[i].model = mat4();
+		instances[i].model.translate(vec3((i % side) * 3.0f - side * 1.5f, (i / side) * 3.0f - side * 1.5f, -side * 3.0f));
+		instances[i].tint = vec4(1.0f);
+		instances[i].paletteOffset = 0;
+	}
+	const MeshLOD & lod = mesh->getLOD(0);
+
+	// One uniform upload and one draw call per copy.
+	auto separate = [&]() {
+		shader->use();
+		shader->loadInstanced(false);
+		mesh->getVAO()->bind();
+		for (const MeshInstance & instance : instances) {
+			shader->loadModelMatrix(instance.model);
+			glDrawElements(GL_TRIANGLES, lod.indexCount, GL_UNSIGNED_INT, reinterpret_cast<void*>(static_cast<size_t>(lod.indexOffset) * sizeof(unsigned int)));
+		}
+		shader->stop();
+	};
+
+	// Every copy queued separately, the render queue merging them into instanced draws.
+	RenderQueue queue(count);
+	auto instanced = [&]() {
+		shader->use();
+		shader->loadInstanced(true);
+		for (const MeshInstance & instance : instances) {
+			DrawCommand command = {};
+			command.shader = shader;
+			command.vao = mesh->getVAO();
+			command.mode = GL_TRIANGLES;
+			command.indexOffset = lod.indexOffset;
+			command.indexCount = lod.indexCount;
+			command.mesh = mesh;
+			command.instance = instance;
+			queue.push(command, 0, false, 0.0f);
+		}
+		queue.submit()->clear();
+		StreamBuffer::getShared()->endFrame();
+	};
+
+	// Time the CPU side of each frame, then the whole run once the GPU is done.
+	auto measure = [count](const string & name, const std::function<void()> & run) {
+		run();
+		glFinish();
+		double cpu = 0.0;
+		auto start = high_resolution_clock::now();
+		for (unsigned int f = 0; f < FRAMES; f++) {
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			auto frameStart = high_resolution_clock::now();
+			run();
+			cpu += duration<double>(high_resolution_clock::now() - frameStart).count();
+		}
+		glFinish();
+		double total = duration<double>(high_resolution_clock::now() - start).count();
+		cout << name << ": " << cpu * 1000.0 / FRAMES << " ms CPU, " << total * 1000.0 / FRAMES << " ms total per frame of " << count << " copies" << endl;
+	};
+
+	measure("Separate draws", separate);
+	measure("Render queue instancing", instanced);
+	const RenderQueueStats & stats = queue.getStats();
+	cout << "Draw calls: " << stats.draws << " for " << stats.instances << " instances, " << stats.mergedDraws << " draws merged" << endl;
+
+	delete shader;
+	delete mesh;
+	return ENG_SUCCESS;
+}
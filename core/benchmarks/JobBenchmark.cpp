@@ -0,0 +1,90 @@
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <functional>
+
+#include "../utils/EngineDef.h"
+#include "../utils/JobSystem.h"
+#include "../utils/ThreadPool.h"
+#include "Benchmarks.h"
+
+using std::cout;
+using std::endl;
+using namespace std::chrono;
+
+// Number of times each measurement is repeated.
+static const unsigned int RUNS = 10;
+
+// Number of stages of the dependency chain, and of jobs in each stage.
+static const unsigned int STAGES = 100;
+static const unsigned int STAGE_JOBS = 64;
+
+// Runs a measurement once to warm up, then returns its average duration in milliseconds.
+static double measure(const std::function<void()> & run) {
+	run();
+	auto start = high_resolution_clock::now();
+	for (unsigned int r = 0; r < RUNS; r++)
+		run();
+	return duration<double, std::milli>(high_resolution_clock::now() - start).count() / RUNS;
+}
+
+int benchmarkJobs(unsigned int count) {
+
+	// Some arithmetic per element, enough for the work to outweigh the scheduling.
+	vector<float> values(count);
+	auto kernel = [&values](unsigned int begin, unsigned int end) {
+		for (unsigned int i = begin; i < end; i++) {
+			float x = static_cast<float>(i);
+			for (unsigned int k = 0; k < 32; k++)
+				x = std::sqrt(x * 1.0001f + 1.0f);
+			values[i] = x;
+		}
+	};
+
+	double serial = measure([&]() { kernel(0, count); });
+	cout << "Serial: " << serial << " ms for " << count << " elements" << endl;
+	unsigned int hardware = std::max(std::thread::hardware_concurrency(), 1u);
+	for (unsigned int workers = 1; workers <= hardware; workers *= 2) {
+		JobSystem jobs(workers);
+		double time = measure([&]() { jobs.parallelFor(0, count, kernel); });
+		cout << "Parallel for across " << workers << " workers: " << time << " ms, " << serial / time << "x" << endl;
+	}
+
+	// The cost of scheduling many empty jobs.
+	JobSystem jobs;
+	double jobTime = measure([&]() {
+		JobCounter counter;
+		for (unsigned int i = 0; i < count; i++)
+			jobs.run([] {}, &counter);
+		jobs.wait(&counter);
+	});
+	ThreadPool pool(jobs.getWorkerCount());
+	double taskTime = measure([&]() {
+		for (unsigned int i = 0; i < count; i++)
+			pool.submit([] {});
+		pool.wait();
+	});
+	cout << "Empty jobs: " << jobTime * 1e6 / count << " ns per job, versus " << taskTime * 1e6 / count
+		<< " ns per thread pool task" << endl;
+
+	// Stages of jobs each waiting on the previous stage's counter, checking it is done when they start.
+	std::atomic<unsigned int> errors(0);
+	double chainTime = measure([&]() {
+		vector<JobCounter> counters(STAGES);
+		for (unsigned int s = 0; s < STAGES; s++) {
+			JobCounter * previous = s > 0 ? &counters[s - 1] : nullptr;
+			for (unsigned int j = 0; j < STAGE_JOBS; j++)
+				jobs.run([previous, &errors] {
+					if (previous != nullptr && !previous->isDone())
+						errors++;
+				}, &counters[s], previous);
+		}
+		for (JobCounter & counter : counters)
+			jobs.wait(&counter);
+	});
+	cout << "Dependency chain of " << STAGES << " stages of " << STAGE_JOBS << " jobs: " << chainTime << " ms, "
+		<< errors.load() << " jobs started before their dependency" << endl;
+	return ENG_SUCCESS;
+}
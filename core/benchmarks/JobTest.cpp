@@ -0,0 +1,104 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <iostream>
+
+#include "../utils/EngineDef.h"
+#include "../utils/JobSystem.h"
+#include "Benchmarks.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+
+// Number of workers of the job system under test, more than one even on a single hardware thread.
+static const unsigned int WORKERS = 4;
+
+// Number of indices covered by the parallel for, not a multiple of its grain.
+static const unsigned int RANGE = 100003;
+static const unsigned int GRAIN = 97;
+
+// Number of stages of the dependency chain.
+static const unsigned int CHAIN_LENGTH = 30;
+
+// Counts a failed check and reports it.
+static void check(bool passed, const char * name, unsigned int round, unsigned int & failures) {
+	if (passed)
+		return;
+	cout << "Round " << round << ": " << name << " failed" << endl;
+	failures++;
+}
+
+int testJobs(unsigned int rounds) {
+	unsigned int failures = 0;
+	for (unsigned int round = 0; round < rounds; round++) {
+		JobSystem jobs(WORKERS);
+
+		// Every index of the range is processed exactly once.
+		vector<int> hits(RANGE, 0);
+		jobs.parallelFor(0, RANGE, [&hits](unsigned int begin, unsigned int end) {
+			for (unsigned int i = begin; i < end; i++)
+				hits[i]++;
+		}, GRAIN);
+		bool covered = true;
+		for (int h : hits)
+			covered = covered && h == 1;
+		check(covered, "parallel for coverage", round, failures);
+
+		// Jobs run from workers wait on jobs of their own.
+		std::atomic<unsigned int> nested(0);
+		JobCounter outer;
+		for (unsigned int i = 0; i < 50; i++)
+			jobs.run([&jobs, &nested] {
+				JobCounter inner;
+				for (unsigned int k = 0; k < 20; k++)
+					jobs.run([&nested] { nested++; }, &inner);
+				jobs.wait(&inner);
+			}, &outer);
+		jobs.wait(&outer);
+		check(nested == 1000, "nested waits", round, failures);
+
+		// Each stage of the chain reads what the previous one wrote, without synchronization of its own.
+		vector<JobCounter> stages(CHAIN_LENGTH);
+		vector<unsigned int> data(CHAIN_LENGTH, 0);
+		for (unsigned int s = 0; s < CHAIN_LENGTH; s++)
+			jobs.run([&data, s] { data[s] = s > 0 ? data[s - 1] + 1 : 1; }, &stages[s], s > 0 ? &stages[s - 1] : nullptr);
+		jobs.wait(&stages[CHAIN_LENGTH - 1]);
+		bool ordered = true;
+		for (unsigned int s = 0; s < CHAIN_LENGTH; s++)
+			ordered = ordered && data[s] == s + 1;
+		check(ordered, "dependency chain", round, failures);
+
+		// Threads that are not workers inject their jobs.
+		std::atomic<unsigned int> foreign(0);
+		JobCounter foreignCounter;
+		std::thread thread([&jobs, &foreign, &foreignCounter] {
+			for (unsigned int i = 0; i < 1000; i++)
+				jobs.run([&foreign] { foreign++; }, &foreignCounter);
+			jobs.wait(&foreignCounter);
+		});
+		thread.join();
+		check(foreign == 1000, "foreign thread jobs", round, failures);
+
+		// Jobs beyond a worker's queue capacity are injected instead.
+		std::atomic<unsigned int> overflow(0);
+		JobCounter overflowCounter;
+		for (unsigned int i = 0; i < JobSystem::QUEUE_CAPACITY * 2; i++)
+			jobs.run([&overflow] { overflow++; }, &overflowCounter);
+		jobs.wait(&overflowCounter);
+		check(overflow == JobSystem::QUEUE_CAPACITY * 2, "queue overflow", round, failures);
+
+		// Counters may be destroyed as soon as waiting on them returns.
+		for (unsigned int i = 0; i < 200; i++) {
+			JobCounter * counter = new JobCounter();
+			for (unsigned int j = 0; j < 3; j++)
+				jobs.run([] {}, counter);
+			jobs.wait(counter);
+			check(counter->isDone(), "counter lifetime", round, failures);
+			delete counter;
+		}
+	}
+
+	cout << failures << " checks failed over " << rounds << " rounds" << endl;
+	return failures == 0 ? ENG_SUCCESS : ERR_CHECK_FAILED;
+}
@@ -0,0 +1,112 @@
+#include <chrono>
+#include <iostream>
+#include <functional>
+
+#include <glad/glad.h>
+
+#include "../utils/EngineDef.h"
+#include "../utils/Loader.h"
+#include "../render/MeshBatch.h"
+#include "../render/FrameUniforms.h"
+#include "Benchmarks.h"
+
+using std::cout;
+using std::endl;
+using namespace std::chrono;
+
+// Number of frames drawn by each method.
+static const unsigned int FRAMES = 100;
+
+int benchmarkMultiDraw(const string & model, unsigned int count) {
+	FrameUniforms uniforms;
+	uniforms.update(mat4(), perspective(16, 9, 70.0f, true), vec3(0.0f), 0.0f, 0.0f);
+	Loader loader;
+	Mesh * mesh = loader.loadMesh(model.c_str());
+	if (mesh == nullptr) {
+		cout << "Failed to load " << model << "." << endl;
+		return ERR_UNKNOWN_BENCHMARK;
+	}
+	MeshShader * shader = new MeshShader();
+	shader->use();
+	shader->loadAnimated(false);
+
+	// Lay the objects out on a grid in front of the camera, every other one being visible.
+	vector<MeshBatchDraw> draws(count);
+	vector<unsigned int> visible;
+	unsigned int side = 1;
+	while (side * side < count)
+		side++;
+	for (unsigned int i = 0; i < count; i++) {
+		draws[i].mesh = 0;
+		draws[i].lod = 0;
+		draws[i].instance.model = mat4();
+		draws[i].instance.model.translate(vec3((i % side) * 3.0f - side * 1.5f, (i / side) * 3.0f - side * 1.5f, -side * 3.0f));
+		draws[i].instance.tint = vec4(1.0f);
+		draws[i].instance.paletteOffset = 0;
+		if (i % 2 == 0)
+			visible.push_back(i);
+	}
+	const MeshLOD & lod = mesh->getLOD(0);
+
+	// The mesh's own vertex array bound, the model matrix loaded and the mesh drawn for each object.
+	auto separate = [&]() {
+		shader->loadInstanced(false);
+		for (unsigned int i : visible) {
+			mesh->getVAO()->bind();
+			shader->loadModelMatrix(draws[i].instance.model);
+			glDrawElements(GL_TRIANGLES, lod.indexCount, GL_UNSIGNED_INT, reinterpret_cast<void*>(static_cast<size_t>(lod.indexOffset) * sizeof(unsigned int)));
+		}
+	};
+
+	// The objects drawn from shared buffers, in a loop and then with a single multi-draw.
+	MeshBatch * loopBatch = new MeshBatch(false);
+	MeshBatch * indirectBatch = new MeshBatch();
+	loopBatch->add(mesh);
+	indirectBatch->add(mesh);
+	if (!loopBatch->build() || !indirectBatch->build()) {
+		cout << "Failed to batch " << model << "." << endl;
+		delete loopBatch;
+		delete indirectBatch;
+		delete shader;
+		delete mesh;
+		return ERR_UNKNOWN_BENCHMARK;
+	}
+	auto loop = [&]() {
+		loopBatch->draw(shader, draws.data(), visible.data(), static_cast<unsigned int>(visible.size()));
+	};
+	auto indirect = [&]() {
+		indirectBatch->draw(shader, draws.data(), visible.data(), static_cast<unsigned int>(visible.size()));
+		StreamBuffer::getShared()->endFrame();
+	};
+
+	// Time the CPU submission of each frame, then the whole run once the GPU is done.
+	unsigned int drawn = static_cast<unsigned int>(visible.size());
+	auto measure = [drawn](const string & name, const std::function<void()> & run) {
+		run();
+		glFinish();
+		double cpu = 0.0;
+		auto start = high_resolution_clock::now();
+		for (unsigned int f = 0; f < FRAMES; f++) {
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			auto frameStart = high_resolution_clock::now();
+			run();
+			cpu += duration<double>(high_resolution_clock::now() - frameStart).count();
+		}
+		glFinish();
+		double total = duration<double>(high_resolution_clock::now() - start).count();
+		cout << name << ": " << cpu * 1000.0 / FRAMES << " ms CPU submission, " << total * 1000.0 / FRAMES << " ms total per frame of " << drawn << " visible objects" << endl;
+	};
+
+	measure("Separate draws", separate);
+	measure("Base vertex draw loop", loop);
+	if (indirectBatch->isIndirect())
+		measure("Multi-draw indirect", indirect);
+	else
+		cout << "Multi-draw indirect is not supported." << endl;
+
+	delete loopBatch;
+	delete indirectBatch;
+	delete shader;
+	delete mesh;
+	return ENG_SUCCESS;
+}
@@ -0,0 +1,98 @@
+#include <cmath>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <functional>
+
+#include "../utils/EngineDef.h"
+#include "../render/FrustumCuller.h"
+#include "../render/OcclusionCuller.h"
+#include "Benchmarks.h"
+
+using std::cout;
+using std::endl;
+using namespace std::chrono;
+
+// Number of frames culled.
+static const unsigned int FRAMES = 100;
+
+// The wall standing in front of the camera, as a box.
+static const vec3 WALL_MIN = vec3(-40.0f, -15.0f, -61.0f);
+static const vec3 WALL_MAX = vec3(40.0f, 15.0f, -60.0f);
+
+// Returns a random number between two bounds.
+static float randomRange(float min, float max) {
+	return min + static_cast<float>(rand()) / RAND_MAX * (max - min);
+}
+
+// Returns the 12 triangles of a box.
+static OccluderMesh createBox(const vec3 & min, const vec3 & max) {
+	OccluderMesh box;
+	for (unsigned int i = 0; i < 8; i++)
+		box.vertices.push_back(vec3(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z));
+	box.indices = {
+		0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6,
+		0, 1, 4, 1, 5, 4, 2, 6, 3, 3, 6, 7,
+		0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5
+	};
+	return box;
+}
+
+int benchmarkOcclusion(unsigned int count) {
+
+	// Objects scattered in front of the camera, many of them behind the wall.
+	srand(0);
+	CullingBounds bounds;
+	for (unsigned int i = 0; i < count; i++) {
+		vec3 center = vec3(randomRange(-200.0f, 200.0f), randomRange(-20.0f, 20.0f), randomRange(-600.0f, -10.0f));
+		vec3 extent = vec3(randomRange(0.5f, 3.0f), randomRange(0.5f, 3.0f), randomRange(0.5f, 3.0f));
+		bounds.add(center - extent, center + extent);
+	}
+	OccluderMesh wall = createBox(WALL_MIN, WALL_MAX);
+	mat4 projView = perspective(16, 9, 70.0f, true);
+	Frustum frustum(projView);
+
+	FrustumCuller frustumCuller;
+	OcclusionCuller occlusionCuller;
+	vector<unsigned int> visible;
+	double rasterTime = 0.0, pyramidTime = 0.0, testTime = 0.0;
+	for (unsigned int f = 0; f < FRAMES; f++) {
+		frustumCuller.cull(frustum, bounds);
+		auto start = high_resolution_clock::now();
+		occlusionCuller.beginFrame(projView)->addOccluder(wall, mat4());
+		auto rasterized = high_resolution_clock::now();
+		occlusionCuller.buildPyramid();
+		auto built = high_resolution_clock::now();
+		occlusionCuller.cull(bounds, frustumCuller.getVisible(), visible);
+		auto tested = high_resolution_clock::now();
+		rasterTime += duration<double, std::milli>(rasterized - start).count();
+		pyramidTime += duration<double, std::milli>(built - rasterized).count();
+		testTime += duration<double, std::milli>(tested - built).count();
+	}
+	cout << "Rasterization: " << rasterTime / FRAMES << " ms, pyramid: " << pyramidTime / FRAMES << " ms of "
+		<< occlusionCuller.getLevelCount() << " levels, tests: " << testTime / FRAMES << " ms" << endl;
+	cout << "Visible: " << frustumCuller.getVisible().size() << " of " << count << " after frustum culling, "
+		<< visible.size() << " after occlusion culling" << endl;
+
+	// Culled objects must lie behind the wall and, within a pixel of the depth buffer, inside its silhouette.
+	float wallX = WALL_MAX.x / -WALL_MAX.z, wallY = WALL_MAX.y / -WALL_MAX.z;
+	float pixelX = 2.0f / (projView.m00 * occlusionCuller.getWidth()), pixelY = 2.0f / (projView.m11 * occlusionCuller.getHeight());
+	unsigned int errors = 0;
+	size_t next = 0;
+	for (unsigned int i : frustumCuller.getVisible()) {
+		if (next < visible.size() && visible[next] == i) {
+			next++;
+			continue;
+		}
+		bool hidden = bounds.centerZ[i] + bounds.extentZ[i] < WALL_MAX.z;
+		for (unsigned int corner = 0; corner < 8 && hidden; corner++) {
+			float x = bounds.centerX[i] + (corner & 1 ? bounds.extentX[i] : -bounds.extentX[i]);
+			float y = bounds.centerY[i] + (corner & 2 ? bounds.extentY[i] : -bounds.extentY[i]);
+			float z = bounds.centerZ[i] + (corner & 4 ? bounds.extentZ[i] : -bounds.extentZ[i]);
+			hidden = std::fabs(x / -z) <= wallX + pixelX && std::fabs(y / -z) <= wallY + pixelY;
+		}
+		errors += !hidden;
+	}
+	cout << errors << " objects culled while visible" << endl;
+	return ENG_SUCCESS;
+}
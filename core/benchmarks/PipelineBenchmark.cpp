@@ -0,0 +1,51 @@
+#include <chrono>
+#include <iostream>
+
+#include "../utils/EngineDef.h"
+#include "../render/RenderThread.h"
+#include "Benchmarks.h"
+
+using std::cout;
+using std::endl;
+using namespace std::chrono;
+
+// Number of frames simulated and rendered at each latency.
+static const unsigned int FRAMES = 200;
+
+// The largest latency measured.
+static const unsigned int MAX_LATENCY = 2;
+
+// Keeps the calling thread busy for a duration, standing in for simulation or submission work.
+static void spin(double milliseconds) {
+	auto end = high_resolution_clock::now() + duration_cast<high_resolution_clock::duration>(duration<double, std::milli>(milliseconds));
+	while (high_resolution_clock::now() < end);
+}
+
+int benchmarkPipelining(float simulationTime, float renderTime) {
+	cout << "Simulation " << simulationTime << " ms and submission " << renderTime << " ms per frame." << endl;
+	for (unsigned int latency = 0; latency <= MAX_LATENCY; latency++) {
+
+		// Each slot holds the time its frame started simulating, the render thread summing the time until the frame is submitted.
+		vector<high_resolution_clock::time_point> started(latency + 1);
+		double totalLatency = 0.0;
+		RenderThread renderThread(nullptr, [&](unsigned int slot) {
+			spin(renderTime);
+			totalLatency += duration<double, std::milli>(high_resolution_clock::now() - started[slot]).count();
+		}, latency);
+		renderThread.start();
+
+		auto start = high_resolution_clock::now();
+		for (unsigned int f = 0; f < FRAMES; f++) {
+			unsigned int slot = renderThread.acquireFrame();
+			started[slot] = high_resolution_clock::now();
+			spin(simulationTime);
+			renderThread.publishFrame(slot);
+		}
+		renderThread.stop();
+		double total = duration<double, std::milli>(high_resolution_clock::now() - start).count();
+
+		cout << "Latency " << latency << ": " << total / FRAMES << " ms per frame, " << totalLatency / FRAMES
+			<< " ms from simulation to submission, simulation waited " << renderThread.getWaitTime() * 1000.0 / FRAMES << " ms per frame" << endl;
+	}
+	return ENG_SUCCESS;
+}
@@ -0,0 +1,128 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <functional>
+#include <map>
+
+#include <glad/glad.h>
+
+#include "../utils/EngineDef.h"
+#include "../render/PrimitiveRenderer.h"
+#include "../render/FrameUniforms.h"
+#include "../render/GLStateCache.h"
+#include "Benchmarks.h"
+
+using std::cout;
+using std::endl;
+using namespace std::chrono;
+
+// Number of frames drawn by each method.
+static const unsigned int FRAMES = 100;
+
+// Returns a random coordinate within the view volume set up by the benchmark.
+static float randomCoordinate() {
+	return static_cast<float>(rand()) / RAND_MAX * 20.0f - 10.0f;
+}
+
+int benchmarkStream(unsigned int count) {
+	FrameUniforms uniforms;
+	uniforms.update(mat4(), perspective(16, 9, 70.0f, true), vec3(0.0f), 0.0f, 0.0f);
+
+	// Random lines in front of the camera, each with its own color.
+	srand(0);
+	vector<Primitive *> lines;
+	lines.reserve(count);
+	for (unsigned int i = 0; i < count; i++) {
+		vector<vec3> points = {
+			vec3(randomCoordinate(), randomCoordinate(), randomCoordinate() - 20.0f),
+			vec3(randomCoordinate(), randomCoordinate(), randomCoordinate() - 20.0f)
+		};
+		lines.push_back(new Primitive(GL_LINES, points, vec3(randomCoordinate(), randomCoordinate(), randomCoordinate()) / 10.0f));
+	}
+	std::map<GLenum, vector<Primitive *>> primitives = { { GL_LINES, lines } };
+
+	// Two arrays filled and two orphaned buffers uploaded every frame, like the renderer did before streaming.
+	PrimitiveShader * shader = new PrimitiveShader();
+	unsigned int vao, vbos[2];
+	glGenVertexArrays(1, &vao);
+	glGenBuffers(2, vbos);
+	GLStateCache * state = GLStateCache::getShared();
+	state->bindVertexArray(vao);
+	for (unsigned int i = 0; i < 2; i++) {
+		state->bindBuffer(GL_ARRAY_BUFFER, vbos[i]);
+		glVertexAttribPointer(i, 3, GL_FLOAT, GL_FALSE, 0, 0);
+		glEnableVertexAttribArray(i);
+	}
+	auto orphaned = [&]() {
+		unsigned int size = count * 2;
+		vec3 * vertexArr = new vec3[size];
+		vec3 * colorArr = new vec3[size];
+		for (unsigned int i = 0; i < count; i++) {
+			vertexArr[i * 2] = lines[i]->getPoints()[0];
+			vertexArr[i * 2 + 1] = lines[i]->getPoints()[1];
+			colorArr[i * 2] = colorArr[i * 2 + 1] = lines[i]->getColor();
+		}
+		shader->use();
+		shader->loadUseUniformColor(false);
+		state->bindVertexArray(vao);
+		state->bindBuffer(GL_ARRAY_BUFFER, vbos[0]);
+		glBufferData(GL_ARRAY_BUFFER, size * sizeof(vec3), vertexArr, GL_DYNAMIC_DRAW);
+		state->bindBuffer(GL_ARRAY_BUFFER, vbos[1]);
+		glBufferData(GL_ARRAY_BUFFER, size * sizeof(vec3), colorArr, GL_DYNAMIC_DRAW);
+		glDrawArrays(GL_LINES, 0, size);
+		state->bindVertexArray(0);
+		delete[] vertexArr;
+		delete[] colorArr;
+	};
+
+	// The same lines streamed through a persistently mapped buffer, then one mapped for each allocation.
+	StreamBuffer * persistentStream = StreamBuffer::create(StreamBuffer::SHARED_REGION_SIZE);
+	StreamBuffer * mappedStream = StreamBuffer::create(StreamBuffer::SHARED_REGION_SIZE, false);
+	PrimitiveRenderer * persistentRenderer = new PrimitiveRenderer(persistentStream);
+	PrimitiveRenderer * mappedRenderer = new PrimitiveRenderer(mappedStream);
+	auto persistent = [&]() {
+		persistentRenderer->render(primitives);
+		persistentStream->endFrame();
+	};
+	auto mapped = [&]() {
+		mappedRenderer->render(primitives);
+		mappedStream->endFrame();
+	};
+
+	// Time the CPU side of each frame, then the whole run once the GPU is done.
+	auto measure = [count](const string & name, const std::function<void()> & run) {
+		run();
+		glFinish();
+		double cpu = 0.0;
+		auto start = high_resolution_clock::now();
+		for (unsigned int f = 0; f < FRAMES; f++) {
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			auto frameStart = high_resolution_clock::now();
+			run();
+			cpu += duration<double>(high_resolution_clock::now() - frameStart).count();
+		}
+		glFinish();
+		double total = duration<double>(high_resolution_clock::now() - start).count();
+		cout << name << ": " << cpu * 1000.0 / FRAMES << " ms CPU, " << total * 1000.0 / FRAMES << " ms total per frame of " << count << " lines" << endl;
+	};
+
+	measure("Orphaned buffers", orphaned);
+	if (persistentStream->isPersistent())
+		measure("Persistent stream buffer", persistent);
+	else
+		cout << "Persistent mapping is not supported." << endl;
+	measure("Unsynchronized mapped stream buffer", mapped);
+	cout << "Waits on the GPU: " << persistentStream->getStalls() << " persistent, " << mappedStream->getStalls() << " mapped" << endl;
+
+	delete persistentRenderer;
+	delete mappedRenderer;
+	delete persistentStream;
+	delete mappedStream;
+	state->deleteBuffer(vbos[0]);
+	state->deleteBuffer(vbos[1]);
+	state->deleteVertexArray(vao);
+	delete shader;
+	for (Primitive * line : lines)
+		delete line;
+	return ENG_SUCCESS;
+}
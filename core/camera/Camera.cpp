@@ -40,7 +40,7 @@ vec3 Camera::right() {
 	return glmath::cross(forward(), vec3(0, 1, 0));
 }
 
-mat4 Camera::createProjectionViewMatrix() {
+mat4 Camera::createViewMatrix() {
 	
 	mat4 view;
 
@@ -50,5 +50,22 @@ mat4 Camera::createProjectionViewMatrix() {
 
 	view.translate(-1 * pos);
 
-	return proj * view;
+	return view;
+}
+
+mat4 Camera::createProjectionViewMatrix() {
+	return proj * createViewMatrix();
+}
+
+Frustum Camera::createFrustum() {
+	return Frustum(createProjectionViewMatrix());
+}
+
+float Camera::computeScreenSize(const vec3 & center, float radius) {
+	float distance = (center - pos).length();
+	if (distance <= radius)
+		return 1.0f;
+
+	// proj.m11 maps view space heights at unit distance to normalized device coordinates, which span 2 units.
+	return std::fmin(1.0f, radius * proj.m11 / distance);
 }
\ No newline at end of file
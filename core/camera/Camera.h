@@ -2,6 +2,7 @@
 
 #include "../math/GLVector.h"
 #include "../math/GLMatrix.h"
+#include "Frustum.h"
 
 using namespace glmath;
 
@@ -168,6 +169,22 @@ class Camera {
 			return pos;
 		}
 
+		/**
+		 * @brief Returns the camera's projection matrix.
+		 * 
+		 * @return [const mat4 &] The perspective matrix built from the camera's aspect ratio and FOV.
+		 */
+		inline const mat4 & getProjectionMatrix() const {
+			return proj;
+		}
+
+		/**
+		 * @brief Creates a view matrix corresponding to the camera's current whereabouts and heading.
+		 * 
+		 * @return [mat4] The matrix transforming world space into the camera's view space.
+		 */
+		mat4 createViewMatrix();
+
 		/**
 		 * @brief Creates a projection view matrix corresponding to the camera's current whereabouts and heading.
 		 * 
@@ -175,6 +192,22 @@ class Camera {
 		 */
 		mat4 createProjectionViewMatrix();
 
+		/**
+		 * @brief Creates the camera's view frustum from its projection view matrix.
+		 * 
+		 * @return [Frustum] The frustum's clipping planes in world space.
+		 */
+		Frustum createFrustum();
+
+		/**
+		 * @brief Returns the projected size of a bounding sphere as seen from the camera.
+		 * 
+		 * @param center The sphere's center in world space.
+		 * @param radius The sphere's radius in world units.
+		 * @return [float] The fraction of the viewport height covered by the sphere, 1 if the camera is inside the sphere.
+		 */
+		float computeScreenSize(const vec3 & center, float radius);
+
 		/**
 		 * @brief This method is called every frame and is used by derived classes to implement the camera's logic.
 		 * 
@@ -0,0 +1,47 @@
+#include <cmath>
+
+#include "Frustum.h"
+
+Frustum::Frustum(const mat4 & m) {
+
+	// Rows of the matrix, which is stored in column-major order.
+	vec4 row0 = vec4(m.m00, m.m10, m.m20, m.m30);
+	vec4 row1 = vec4(m.m01, m.m11, m.m21, m.m31);
+	vec4 row2 = vec4(m.m02, m.m12, m.m22, m.m32);
+	vec4 row3 = vec4(m.m03, m.m13, m.m23, m.m33);
+
+	// Clip space is bounded by -w <= x, y, z <= w.
+	planes[PLANE_LEFT] = row3 + row0;
+	planes[PLANE_RIGHT] = row3 - row0;
+	planes[PLANE_BOTTOM] = row3 + row1;
+	planes[PLANE_TOP] = row3 - row1;
+	planes[PLANE_NEAR] = row3 + row2;
+	planes[PLANE_FAR] = row3 - row2;
+
+	// Normalize the planes so that they yield actual distances.
+	for (vec4 & plane : planes) {
+		float length = vec3(plane.x, plane.y, plane.z).length();
+		if (length > 0.0f)
+			plane = plane / length;
+	}
+}
+
+bool Frustum::intersectsSphere(const vec3 & center, float radius) const {
+	for (const vec4 & plane : planes)
+		if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+			return false;
+	return true;
+}
+
+bool Frustum::intersectsBox(const vec3 & min, const vec3 & max) const {
+	vec3 center = 0.5f * (min + max);
+	vec3 extent = 0.5f * (max - min);
+	for (const vec4 & plane : planes) {
+
+		// The box's extent projected on the plane's normal.
+		float radius = std::fabs(plane.x) * extent.x + std::fabs(plane.y) * extent.y + std::fabs(plane.z) * extent.z;
+		if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,61 @@
+#include "../math/GLVector.h"
+#include "../math/GLMatrix.h"
+
+using namespace glmath;
+
+#pragma once
+class Frustum {
+
+	public:
+		/**
+		 * @brief Indices of the individual clipping planes.
+		 * 
+		 */
+		enum Plane {
+			PLANE_LEFT,
+			PLANE_RIGHT,
+			PLANE_BOTTOM,
+			PLANE_TOP,
+			PLANE_NEAR,
+			PLANE_FAR,
+			PLANE_COUNT
+		};
+
+		/**
+		 * @brief The normalized clipping planes, stored as (normal.x, normal.y, normal.z, distance).
+		 * Points for which dot(normal, point) + distance >= 0 lie on the inner side of a plane.
+		 * 
+		 */
+		vec4 planes[PLANE_COUNT];
+
+		/**
+		 * @brief Extracts the clipping planes of a projection matrix.
+		 * The planes are expressed in the space the matrix transforms from, 
+		 * so a projection view model matrix yields model space planes.
+		 * 
+		 * @param matrix The matrix from which to extract the planes.
+		 */
+		Frustum(const mat4 & matrix);
+
+		/**
+		 * @brief Returns whether or not a sphere lies at least partially inside the frustum.
+		 * 
+		 * @param center The sphere's center.
+		 * @param radius The sphere's radius.
+		 * @return true The sphere intersects or lies inside the frustum.
+		 * @return false The sphere lies entirely outside the frustum.
+		 */
+		bool intersectsSphere(const vec3 & center, float radius) const;
+
+		/**
+		 * @brief Returns whether or not an axis-aligned box lies at least partially inside the frustum.
+		 * Boxes crossing the planes' extensions near the frustum's corners are conservatively kept.
+		 * 
+		 * @param min The box's minimum corner.
+		 * @param max The box's maximum corner.
+		 * @return true The box intersects or lies inside the frustum.
+		 * @return false The box lies entirely outside the frustum.
+		 */
+		bool intersectsBox(const vec3 & min, const vec3 & max) const;
+
+};
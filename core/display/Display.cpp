@@ -18,12 +18,18 @@ Display::~Display() {
 void Display::update(){
 
 	// Swap the front and back buffers.
-	glfwSwapBuffers(window);
+	swapBuffers();
 
 	// Poll any pending input events.
-	glfwPollEvents();
+	pollEvents();
 
 }
+void Display::swapBuffers() {
+	glfwSwapBuffers(window);
+}
+void Display::pollEvents() {
+	glfwPollEvents();
+}
 
 // STATIC FUNCTIONS
 vec2 Display::getMainScreenSize() {
@@ -34,9 +40,9 @@ void Display::resizeCallback(GLFWwindow * window, int width, int height) {
 
 	Display * self = instances.find(window)->second;
 
-	glViewport(0, 0, width, height);
-	self->width = height;
-	self->height = width;
+	// The viewport is set by whichever thread owns the context, from the new display size.
+	self->width = width;
+	self->height = height;
 }
 void Display::focusCallback(GLFWwindow * window, int focus) {
 
@@ -109,6 +109,18 @@ class Display {
 		 */
 		void update();
 
+		/**
+		 * @brief Swaps the display buffers, on the thread the OpenGL context is current on.
+		 * 
+		 */
+		void swapBuffers();
+
+		/**
+		 * @brief Polls any pending input events, on the main thread.
+		 * 
+		 */
+		void pollEvents();
+
 		/**
 		 * @brief Sets whether or not the display can be resized by the user. 
 		 * This method has no effect after the display has been created.
@@ -221,7 +233,7 @@ class Display {
 		static vec2 getMainScreenSize();
 
 		/**
-		 * @brief Called when the user resizes the diplay window.
+		 * @brief Called when the user resizes the diplay window, recording its new size.
 		 * 
 		 * @param window The window that was resized.
 		 * @param width The new width of the window in pixels.
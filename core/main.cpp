@@ -1,5 +1,5 @@
 #include <iostream>
-#include <chrono>
+#include <map>
 
 #include <glfw/glfw3.h>
 
@@ -10,12 +10,177 @@
 #include "shaders/MeshShader.h"
 #include "objects/VAO.h"
 #include "objects/FBO.h"
+#include "objects/StreamBuffer.h"
 #include "utils/Loader.h"
+#include "utils/TextureCompressor.h"
+#include "utils/TexturePacker.h"
+#include "utils/FileSystem.h"
+#include "utils/PackArchive.h"
+#include "utils/VirtualFileSystem.h"
+#include "utils/AssetReloader.h"
+#include "utils/GameLoop.h"
+#include "utils/LinearArena.h"
+#include "utils/AllocationStats.h"
 #include "camera/CameraFPS.h"
+#include "render/ClusterCuller.h"
+#include "render/TextureStreamer.h"
+#include "render/RenderQueue.h"
+#include "render/GLStateCache.h"
+#include "render/FrameUniforms.h"
+#include "render/DebugDraw.h"
+#include "render/FrustumCuller.h"
+#include "render/RenderThread.h"
+#include "render/ResourceManager.h"
+#include "utils/Logger.h"
+#include "benchmarks/Benchmarks.h"
 
 using namespace std;
 
-int main() {
+// Parses a compressed texture format name.
+static bool parseTextureFormat(const string & name, TextureFormat & format) {
+	static const map<string, TextureFormat> FORMATS = {
+		{ "bc1", TEXTURE_FORMAT_BC1 },
+		{ "bc3", TEXTURE_FORMAT_BC3 },
+		{ "bc5", TEXTURE_FORMAT_BC5 },
+		{ "bc7", TEXTURE_FORMAT_BC7 }
+	};
+	auto match = FORMATS.find(name);
+	if (match == FORMATS.end()) {
+		cout << "Unknown texture format " << name << ", expected bc1, bc3, bc5 or bc7." << endl;
+		return false;
+	}
+	format = match->second;
+	return true;
+}
+
+// Cooks a texture to a compressed KTX2 file, e.g. game-engine --cook-texture character.png character.ktx2 bc7
+static int cookTexture(const string & src, const string & dst, const string & formatName) {
+	TextureFormat format;
+	if (!parseTextureFormat(formatName, format))
+		return ERR_TEXTURE_COOK;
+	if (!TextureCompressor::cook(src.c_str(), dst.c_str(), format)) {
+		cout << "Failed to cook " << src << " to " << dst << "." << endl;
+		return ERR_TEXTURE_COOK;
+	}
+	return ENG_SUCCESS;
+}
+
+// Packs textures into a compressed KTX2 atlas, e.g. game-engine --pack-textures props.ktx2 bc7 crate.png barrel.png
+static int packTextures(const string & dst, const string & formatName, const vector<string> & sources) {
+	TextureFormat format;
+	if (!parseTextureFormat(formatName, format))
+		return ERR_TEXTURE_COOK;
+	PackingStats stats;
+	if (!TexturePacker::cook(sources, dst.c_str(), format, TexturePacker::DEFAULT_PAGE_SIZE, TexturePacker::DEFAULT_PADDING, &stats)) {
+		cout << "Failed to pack textures into " << dst << "." << endl;
+		return ERR_TEXTURE_COOK;
+	}
+	cout << "Packed " << stats.entries << " textures into " << stats.pages << " pages, " << stats.rejected << " rejected, "
+		<< stats.efficiency * 100.0f << "% of the page area used." << endl;
+	return ENG_SUCCESS;
+}
+
+// Packs a directory into an archive, e.g. game-engine --pack-archive Assets/shaders.pak shader_source shaders/
+static int packArchive(const string & dst, const string & directory, const string & prefix) {
+	unsigned int count;
+	if (!PackArchive::build(directory, dst.c_str(), prefix, &count)) {
+		cout << "Failed to pack " << directory << " into " << dst << "." << endl;
+		return ERR_PACK_ARCHIVE;
+	}
+	cout << "Packed " << count << " files into " << dst << "." << endl;
+	return ENG_SUCCESS;
+}
+
+// The state of a frame handed from the simulation to the render thread, left untouched by the simulation until rendered.
+struct FrameState {
+	mat4 view;
+	mat4 projection;
+	vec3 cameraPosition;
+	vec2 displaySize;
+	float time;
+	float delta;
+	bool visible;
+	bool clustered;
+	unsigned int level;
+	float distance;
+	float texturePixels;
+	vector<mat4> joints;
+	ClusterCuller culler;
+	vector<PrimitiveVertex> debugPoints;
+	vector<PrimitiveVertex> debugLines;
+};
+
+// Number of frames the allocations are averaged over before being logged.
+static const unsigned int ALLOCATION_REPORT_FRAMES = 300;
+
+// Logs the average allocations per frame from each source, and the peak usage of the frame arena.
+static void reportAllocations(const FrameAllocations & totals, unsigned int frames, const LinearArena * arena) {
+	if (!Logger::isEnabled(LOG_DEBUG))
+		return;
+	static const char * SOURCES[ALLOCATION_SOURCE_COUNT] = { "heap", "arena", "pool" };
+	ostream & stream = Logger::stream(LOG_DEBUG) << "Allocations per frame:";
+	for (unsigned int s = 0; s < ALLOCATION_SOURCE_COUNT; s++)
+		stream << " " << totals.counts[s] / frames << " " << SOURCES[s] << " (" << totals.bytes[s] / frames << " bytes)";
+	stream << ", frame arena peak " << arena->getPeak() << " of " << arena->getCapacity() << " bytes." << std::endl;
+}
+
+// Logs the number of GPU resources of each type and the memory they use, including those waiting for the GPU to be deleted.
+static void reportResources() {
+	if (!Logger::isEnabled(LOG_DEBUG))
+		return;
+	static const char * TYPES[RESOURCE_TYPE_COUNT] = { "vertex arrays", "buffers", "textures", "framebuffers", "shaders", "uniform buffers", "stream buffers" };
+	ostream & stream = Logger::stream(LOG_DEBUG) << "GPU resources:";
+	for (unsigned int t = 0; t < RESOURCE_TYPE_COUNT; t++) {
+		ResourceUsage usage = ResourceManager::getShared()->getUsage(static_cast<ResourceType>(t));
+		stream << " " << usage.count << " " << TYPES[t] << " (" << usage.bytes << " bytes)";
+		if (usage.pendingCount > 0)
+			stream << " + " << usage.pendingCount << " pending (" << usage.pendingBytes << " bytes)";
+	}
+	stream << "." << std::endl;
+}
+
+// The objects a queued mesh draw reads its uniforms and clusters from.
+struct MeshDraw {
+	MeshShader * shader;
+	SkeletalMesh * mesh;
+	FrameState * frame;
+};
+
+// Loads the skinning and texture uniforms of a queued mesh draw.
+static void setupMeshDraw(const DrawCommand & command, void * data) {
+	MeshDraw * draw = static_cast<MeshDraw *>(data);
+	draw->shader->loadJointTransforms(draw->frame->joints.data(), static_cast<unsigned int>(draw->frame->joints.size()));
+	draw->shader->loadInfluences(draw->mesh->getInfluences());
+	draw->shader->loadTextureTransform(command.texture);
+	draw->shader->loadInstanced(command.mesh != nullptr);
+}
+
+// Draws the clusters of a queued mesh that survived culling.
+static void drawMeshClusters(const DrawCommand &, void * data) {
+	static_cast<MeshDraw *>(data)->frame->culler.draw();
+}
+
+int main(int argc, char ** argv) {
+
+	// Cook assets instead of running when asked to.
+	if (argc == 5 && string(argv[1]) == "--cook-texture")
+		return cookTexture(argv[2], argv[3], argv[4]);
+	if (argc >= 5 && string(argv[1]) == "--pack-textures")
+		return packTextures(argv[2], argv[3], vector<string>(argv + 4, argv + argc));
+	if ((argc == 4 || argc == 5) && string(argv[1]) == "--pack-archive")
+		return packArchive(argv[2], argv[3], argc == 5 ? argv[4] : "");
+
+	// Mount the loose assets and shaders, then the archives shipped next to them which hide the loose files they contain.
+	VirtualFileSystem * vfs = VirtualFileSystem::getShared();
+	vfs->mount("", "./Assets");
+	vfs->mount(Shader::SHADER_SOURCE, "./shader_source");
+	for (const string & archive : FileSystem::listFiles("./Assets", ".pak"))
+		vfs->mount("", "./Assets/" + archive);
+
+	// Edited loose files win over stale archives during development.
+#ifdef _DEBUG
+	vfs->setLooseOverrides(true);
+#endif
 
 	// Init GLFW.
 	if (glfwInit() == GLFW_FALSE)
@@ -42,38 +207,79 @@ int main() {
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
 		return ERR_GLAD_INIT;
 
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_BACK);
-	glEnable(GL_DEPTH_TEST);
+	// Run a benchmark instead of the demo when asked to.
+	if (argc >= 3 && string(argv[1]) == "--benchmark")
+		return runBenchmark(argv[2], vector<string>(argv + 3, argv + argc));
+
+	GLStateCache * state = GLStateCache::getShared();
+	state->setEnabled(GL_CULL_FACE, true);
+	state->setCullFace(GL_BACK);
+	state->setEnabled(GL_DEPTH_TEST, true);
+
+	// Count the redundant state changes filtered out and the allocations made each frame while debugging.
+#ifdef _DEBUG
+	state->setCounting(true);
+	AllocationStats::setCounting(true);
+#endif
 
 	// Mesh shader
 	MeshShader * shader = new MeshShader();
 	
-	// Load model matrix into shader
-	shader->use();
-
-	shader->loadTextureUnit(0);
-	shader->loadAnimated(true);
-
+	// Load model matrix into shader, again whenever the shader is reloaded
 	mat4 mat;
 	mat.translate(vec3(0, 0, -10));
-	shader->loadModelMatrix(mat);
+	auto loadShaderConstants = [shader, mat] {
+		shader->use();
 
-	shader->stop();
+		shader->loadTextureUnit(0);
+		shader->loadTextureArrayUnit(1);
+		shader->loadAnimated(true);
+		shader->loadModelMatrix(mat);
+
+		shader->stop();
+	};
+	loadShaderConstants();
 	
 	// Camera
 	Camera * cam = new CameraFPS(16, 9, 70.0f, display->mouse, display->keyboard);
 
 	// Loader
-	Loader * loader = new Loader();
+	Loader * loader = (new Loader())
+		->setLODLevels({ 0.5f, 0.25f, 0.125f })
+		->setBuildMeshlets(true);
 
 	// Load mesh and texture
 	SkeletalMesh * mesh = (SkeletalMesh *) loader->loadMesh("character.dae");
-	Texture * texture = loader->loadTexture2D("character.png", GL_LINEAR);
+	// Stream the cooked texture if there is one, within a 256MB budget.
+	TextureStreamer * streamer = new TextureStreamer(256ull << 20);
+	Texture * texture = streamer->load("character.ktx2", GL_LINEAR);
+	bool streamed = texture != nullptr;
+	if (!streamed)
+		texture = loader->loadTexture2D("character.png", GL_LINEAR);
+
+	// Reload the assets edited while running, swapping them in between two frames.
+	AssetReloader * reloader = new AssetReloader(loader);
+	reloader->watch(mesh, "character.dae");
+	reloader->watch(shader, loadShaderConstants);
+	if (streamed)
+		reloader->watchFile(string(Loader::TEXTURE_DIRECTORY) + "character.ktx2", [streamer, texture] { streamer->reload(texture); });
+	else
+		reloader->watch(texture, "character.png");
 
 	display->keyboard->registerKeyUp(GLFW_KEY_Q, [mesh] { mesh->animator()->play(); });
 	display->keyboard->registerKeyUp(GLFW_KEY_E, [mesh] { mesh->animator()->stop(); });
 
+	// Toggle the skeleton and bounding sphere overlay.
+	bool showDebug = false;
+	display->keyboard->registerKeyUp(GLFW_KEY_B, [&showDebug] { showDebug = !showDebug; });
+
+	// Culls the scene's objects outside the camera's view.
+	CullingBounds * sceneBounds = new CullingBounds();
+	FrustumCuller * frustumCuller = new FrustumCuller();
+
+	// Sorts the frame's draws to minimize state changes.
+	RenderQueue * queue = new RenderQueue();
+
 	// Create fbo used to implement multisampling.
 	FBO * fbo = FBO::create(display->getDisplaySize().x, display->getDisplaySize().y, 8)
 		->addAttachment(GL_RGB, GL_RGB, GL_UNSIGNED_BYTE, GL_COLOR_ATTACHMENT0, false)
@@ -81,58 +287,200 @@ int main() {
 		->bindAttachments()
 		->unbind();
 
-	// Last frame timestamp.
-	auto last = chrono::high_resolution_clock::now();
-
-	while( !display->shouldClose() ) {
+	// Camera and render target data shared by all shaders through uniform buffers.
+	FrameUniforms * uniforms = new FrameUniforms();
 
-		auto now = chrono::high_resolution_clock::now();
-		float delta = chrono::duration_cast<chrono::nanoseconds>(now - last).count() / 1e9f;
+	// Submits each frame from its own state on the render thread, which owns the OpenGL context from now on.
+	vector<FrameState> frames;
+	vec2 viewportSize = display->getDisplaySize();
+	RenderThread * renderThread = new RenderThread(display->window, [&](unsigned int slot) {
+		FrameState & frame = frames[slot];
 
-		// ========================== BEGIN RENDER ==========================
+		// The window is resized on the main thread, the viewport follows on the thread owning the context.
+		if (frame.displaySize.x != viewportSize.x || frame.displaySize.y != viewportSize.y) {
+			viewportSize = frame.displaySize;
+			glViewport(0, 0, static_cast<GLsizei>(viewportSize.x), static_cast<GLsizei>(viewportSize.y));
+		}
 		fbo->bind();
 
 		glClearColor(0.3f, 0.0f, 0.5f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		cam->update(delta);
-
-		shader->use();
-		mat4 pView = cam->createProjectionViewMatrix();
-		shader->loadProjViewMatrix(pView);
-		mesh->animator()->update(delta);
-		shader->loadJointTransforms(mesh->animator()->computeTransforms(), mesh->animator()->getJointCount());
-		
-		// Bind texture
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(texture->getType(), texture->getID());
-
-		// Render mesh
-		mesh->getVAO()->bind({ 0, 1, 2, 3, 4 });
-		glDrawElements(GL_TRIANGLES, mesh->getVertexCount(), GL_UNSIGNED_INT, 0);
-		mesh->getVAO()->unbind({ 0, 1, 2, 3, 4 });
+		// Upload the camera once for every shader drawing this frame.
+		uniforms->update(frame.view, frame.projection, frame.cameraPosition, frame.time, frame.delta)
+			->updatePass(frame.displaySize.x, frame.displaySize.y);
+		streamer->request(texture, frame.texturePixels);
+
+		// Queue the mesh, atlas entries sampling their region of a texture array on their own unit.
+		// At full detail its individual clusters were culled and are drawn with a multi-draw.
+		const MeshLOD & lod = mesh->getLOD(frame.level);
+		MeshDraw meshDraw = { shader, mesh, &frame };
+		DrawCommand command = {};
+		command.shader = shader;
+		command.vao = mesh->getVAO();
+		command.texture = texture;
+		command.textureUnit = texture->getType() == GL_TEXTURE_2D_ARRAY ? 1 : 0;
+		command.mode = GL_TRIANGLES;
+		command.indexOffset = lod.indexOffset;
+		command.indexCount = lod.indexCount;
+		command.setup = setupMeshDraw;
+		command.draw = frame.clustered ? drawMeshClusters : nullptr;
+		command.data = &meshDraw;
+		command.mesh = frame.clustered ? nullptr : mesh;
+		command.instance = { mat, vec4(1.0f), 0, {} };
+		if (frame.visible)
+			queue->push(command, 0, false, frame.distance);
+
+		// Draw the queued packets in key order, then the debug shapes appended during the frame's simulation.
+		queue->submit()->clear();
+		DebugDraw::getShared()->render(frame.debugPoints, frame.debugLines);
 
-		shader->stop();
 		fbo->unbind();
-		// =========================== END RENDER ===========================
+
+		// Fence this frame's transient uploads so the next frame writes to another region,
+		// and delete the resources destroyed in earlier frames the GPU is done with.
+		StreamBuffer::getShared()->endFrame();
+		ResourceManager::getShared()->endFrame();
+
+		// Stream texture levels in and out according to this frame's demand.
+		streamer->update();
 
 		// Copy the framebuffer contents to the main framebuffer.
 		fbo->resolveToDisplay(display, GL_COLOR_ATTACHMENT0);
+	});
+	frames.resize(renderThread->getSlotCount());
+	renderThread->start();
+
+	// The camera position and skeleton pose after the two last simulation steps, which frames blend between.
+	vec3 previousPosition = cam->getPosition(), currentPosition = previousPosition;
+	const mat4 * restPose = mesh->animator()->computeTransforms();
+	vector<mat4> currentJoints(restPose, restPose + mesh->animator()->getJointCount()), previousJoints = currentJoints;
+
+	// Simulate at a fixed rate whatever the frame rate, frames capped when asked to, e.g. game-engine --frame-cap 30
+	GameLoop * loop = (new GameLoop([&](double step) {
+		cam->setPosition(currentPosition);
+		previousPosition = currentPosition;
+		cam->update(step);
+		currentPosition = cam->getPosition();
+
+		previousJoints.swap(currentJoints);
+		mesh->animator()->update(static_cast<float>(step));
+		const mat4 * joints = mesh->animator()->computeTransforms();
+		currentJoints.assign(joints, joints + mesh->animator()->getJointCount());
+	}))->setFrameCap(argc == 3 && string(argv[1]) == "--frame-cap" ? std::stof(argv[2]) : 0.0f);
+
+	// Transient data of the frame being simulated, freed at the start of the next one.
+	LinearArena * frameArena = LinearArena::getThreadArena();
+	FrameAllocations allocationTotals = {};
+	unsigned int allocationFrames = 0;
 
-		// Update the display.
-		display->update();
+	while( !display->shouldClose() ) {
 
-		// Set last frame time.
-		last = now;
+		frameArena->reset();
+		display->pollEvents();
+
+		// Swap in the assets reloaded since the last frame, once the frames in flight are rendered.
+		if (reloader->hasPending())
+			renderThread->invoke([reloader] { reloader->update(); });
+
+		// ======================== BEGIN SIMULATION ========================
+		// Run the simulation steps due since the last frame.
+		float alpha = loop->advance();
+
+		// Fill the next free frame state while the render thread submits the previous ones.
+		unsigned int slot = renderThread->acquireFrame();
+		FrameState & frame = frames[slot];
+
+		// Show the camera between its two last positions, its rotation following the mouse as soon as it moves.
+		cam->setPosition(lerp(previousPosition, currentPosition, alpha));
+		frame.view = cam->createViewMatrix();
+		frame.projection = cam->getProjectionMatrix();
+		frame.cameraPosition = cam->getPosition();
+		frame.displaySize = display->getDisplaySize();
+		frame.time = static_cast<float>(loop->getRenderTime());
+		frame.delta = static_cast<float>(loop->getFrameTime());
+
+		// Blend the skeleton's two last poses, unless a reload changed its joints in between.
+		if (previousJoints.size() == currentJoints.size()) {
+			frame.joints.resize(currentJoints.size());
+			for (size_t j = 0; j < currentJoints.size(); j++)
+				frame.joints[j] = lerp(previousJoints[j], currentJoints[j], alpha);
+		}
+		else
+			frame.joints = currentJoints;
+
+		// Cull the mesh with its bounds over all animation poses, which follow reloads.
+		sceneBounds->clear();
+		sceneBounds->add(mesh->getBoundsMin(), mesh->getBoundsMax(), mat);
+		frame.visible = !frustumCuller->cull(cam->createFrustum(), *sceneBounds)->getVisible().empty();
+
+		// Select the level of detail from the mesh's size on screen.
+		vec4 center;
+		transform(mat, vec4(mesh->getBoundingCenter().x, mesh->getBoundingCenter().y, mesh->getBoundingCenter().z, 1.0f), &center);
+		vec3 position = vec3(center.x, center.y, center.z);
+		float screenSize = cam->computeScreenSize(position, mesh->getBoundingRadius());
+		frame.level = mesh->selectLOD(screenSize);
+		frame.texturePixels = screenSize * frame.displaySize.y;
+		frame.distance = (position - frame.cameraPosition).length() / FAR_PLANE;
+
+		// At full detail the mesh's individual clusters are culled.
+		frame.clustered = frame.visible && frame.level == 0 && !mesh->getMeshlets().empty();
+		if (frame.clustered)
+			frame.culler.cull(mesh, mat, cam);
+
+		// Hand the debug shapes appended this frame over with the rest of its state.
+		if (showDebug)
+			DebugDraw::getShared()
+				->skeleton(mesh->animator(), mat, vec3(1.0f, 1.0f, 0.0f))
+				->sphere(position, mesh->getBoundingRadius(), vec3(0.0f, 1.0f, 0.0f));
+		DebugDraw::getShared()->flush(frame.debugPoints, frame.debugLines);
+
+		renderThread->publishFrame(slot);
+		// ========================= END SIMULATION =========================
+
+		// Sum up the allocations made by every thread since the last frame.
+		FrameAllocations allocations = AllocationStats::endFrame();
+		for (unsigned int s = 0; s < ALLOCATION_SOURCE_COUNT; s++) {
+			allocationTotals.counts[s] += allocations.counts[s];
+			allocationTotals.bytes[s] += allocations.bytes[s];
+		}
+		if (++allocationFrames == ALLOCATION_REPORT_FRAMES) {
+			reportAllocations(allocationTotals, allocationFrames, frameArena);
+			renderThread->post(reportResources);
+			allocationTotals = {};
+			allocationFrames = 0;
+		}
 
 	}
 
-	VAO::cleanAll();
+	// Take the OpenGL context back once the frames in flight are rendered.
+	renderThread->stop();
+	delete renderThread;
+
+	if (Logger::isEnabled(LOG_DEBUG))
+		Logger::stream(LOG_DEBUG) << "GL state cache issued " << state->getIssued() << " calls and filtered " << state->getFiltered() << " redundant ones." << std::endl;
+
+	delete loop;
+
+	delete reloader;
+
+	DebugDraw::getShared()->release();
+
+	StreamBuffer::cleanShared();
 
 	delete fbo;
 
+	delete uniforms;
+
+	delete queue;
+
+	delete frustumCuller;
+	delete sceneBounds;
+
 	delete mesh;
+	streamer->release(texture);
 	delete texture;
+	delete streamer;
 
 	delete loader;
 
@@ -140,6 +488,9 @@ int main() {
 
 	delete shader;
 
+	// Delete the resources destroyed during the last frames, and any still alive, while the context exists.
+	ResourceManager::getShared()->destroyAll();
+
 	delete display;
 
 	glfwTerminate();
@@ -332,6 +332,14 @@ namespace glmath {
 		return *dest;
 	}
 
+	mat4 lerp(const mat4 &a, const mat4 &b, float blend) {
+		mat4 result;
+		float blendI = 1.0f - blend;
+		for (int i = 0; i < 16; i++)
+			result.m[i] = blendI * a.m[i] + blend * b.m[i];
+		return result;
+	}
+
 	mat4 toMatrix(vec4 quaternion) {
 		const float xy = quaternion.x * quaternion.y;
 		const float xz = quaternion.x * quaternion.z;
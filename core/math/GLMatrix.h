@@ -89,5 +89,7 @@ namespace glmath {
 
 	vec4 transform(const mat4 &left, const vec4 &right, vec4 * dest);
 
+	mat4 lerp(const mat4 &a, const mat4 &b, float blend);
+
 	mat4 toMatrix(vec4 quaternion);
 }
\ No newline at end of file
@@ -157,6 +157,11 @@ namespace glmath {
 		return (float) acos(dot(left, right) / (left.length() * right.length()));
 	}
 
+	vec3 lerp(const vec3& a, const vec3& b, float blend) {
+		float blendI = 1.0f - blend;
+		return vec3(blendI * a.x + blend * b.x, blendI * a.y + blend * b.y, blendI * a.z + blend * b.z);
+	}
+
 	vec4 nlerp(vec4 a, vec4 b, float blend) {
 		vec4 result = vec4(0, 0, 0, 1);
 		float dot = glmath::dot(a, b);
@@ -247,7 +252,7 @@ namespace glmath {
 		return vec4(left.x + right.x, left.y + right.y, left.z + right.z, left.w + right.w);
 	}
 	vec4 operator-(const vec4& left, const vec4& right) {
-		return vec4(left.x - right.x, left.y - right.y, left.z - right.z, left.w + right.w);
+		return vec4(left.x - right.x, left.y - right.y, left.z - right.z, left.w - right.w);
 	}
 	void vec4::operator+=(const vec4& right) {
 		this->x += right.x;
@@ -109,6 +109,7 @@ namespace glmath {
 	float angle(const vec2& left, const vec2& right);
 	float angle(const vec3& left, const vec3& right);
 
+	vec3 lerp(const vec3& a, const vec3& b, float blend);
 	vec4 nlerp(vec4 a, vec4 b, float blend);
 
 }
\ No newline at end of file
@@ -1,17 +1,50 @@
 #include "FBO.h"
+#include "../render/GLStateCache.h"
+#include "../utils/PoolAllocator.h"
+
+// Returns the size in bytes of a pixel of an internal format, assuming 4 for base formats whose size the driver picks.
+static size_t getPixelSize(GLenum internalFormat) {
+	switch (internalFormat) {
+		case GL_R8:
+			return 1;
+		case GL_RG8: case GL_R16F: case GL_DEPTH_COMPONENT16:
+			return 2;
+		case GL_RGBA16F: case GL_RG32F: case GL_DEPTH32F_STENCIL8:
+			return 8;
+		case GL_RGBA32F:
+			return 16;
+		default:
+			return 4;
+	}
+}
 
 FBO::FBO(unsigned int id, int width, int height, int samples) :
-	id(id), width(width), height(height), samples(samples) {}
+	id(id), width(width), height(height), samples(samples) {
+	handle = ResourceManager::getShared()->add(RESOURCE_FRAMEBUFFER, this);
+}
 
 FBO::~FBO(){
 
 	for (Attachment * a : attachments)
 		delete a;
 	
-	glDeleteFramebuffers(1, &id);
+	GLStateCache::getShared()->deleteFramebuffer(id);
+	ResourceManager::getShared()->remove(handle);
 
 }
 
+void * FBO::operator new(size_t size) {
+	if (size != sizeof(FBO))
+		return ::operator new(size);
+	return PoolAllocator<FBO>::getShared()->allocate();
+}
+void FBO::operator delete(void * memory, size_t size) {
+	if (size != sizeof(FBO))
+		::operator delete(memory);
+	else
+		PoolAllocator<FBO>::getShared()->free(memory);
+}
+
 FBO * FBO::addAttachment(GLenum internalFormat, GLenum pixelFormat, GLenum dataType, GLenum glAttachment, bool texture) {
 	
 	Attachment * attachment;
@@ -37,15 +70,14 @@ FBO * FBO::bindAttachments() {
 	return this;
 }
 
+// Draw buffers are framebuffer state, set once by bindAttachments.
 FBO * FBO::bind() {
-	glBindFramebuffer(GL_FRAMEBUFFER, id);
-	glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+	GLStateCache::getShared()->bindFramebuffer(GL_FRAMEBUFFER, id);
 	return this;
 }
 
 FBO * FBO::unbind() {
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	glDrawBuffer(GL_BACK);
+	GLStateCache::getShared()->bindFramebuffer(GL_FRAMEBUFFER, 0);
 	return this;
 }
 
@@ -53,11 +85,14 @@ FBO * FBO::resolve(FBO * dest, GLenum srcAttachment, GLenum destAttachment) {
 	if (dest == NULL)
 		return this;
 
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, id);
+	GLStateCache::getShared()->bindFramebuffer(GL_READ_FRAMEBUFFER, id);
 	glReadBuffer(srcAttachment);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dest != NULL ? dest->id : 0);
+	GLStateCache::getShared()->bindFramebuffer(GL_DRAW_FRAMEBUFFER, dest->id);
 	glDrawBuffer(destAttachment);
 	glBlitFramebuffer(0, 0, width, height, 0, 0, dest->width, dest->height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+	// Restore the destination's draw buffers, which bind no longer sets.
+	glDrawBuffers(static_cast<GLsizei>(dest->drawBuffers.size()), dest->drawBuffers.data());
 	return this;
 }
 
@@ -65,17 +100,16 @@ FBO * FBO::resolveToDisplay(Display * dest, GLenum srcAttachment) {
 	if (dest == NULL)
 		return this;
 
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, id);
+	GLStateCache::getShared()->bindFramebuffer(GL_READ_FRAMEBUFFER, id);
 	glReadBuffer(srcAttachment);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-	glDrawBuffer(GL_BACK);
+	GLStateCache::getShared()->bindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
 	vec2 size = dest->getDisplaySize();
 	glBlitFramebuffer(0, 0, width, height, 0, 0, size.x, size.y, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 	return this;
 }
 
 bool FBO::checkFunctional() {
-	glBindFramebuffer(GL_FRAMEBUFFER, id);
+	GLStateCache::getShared()->bindFramebuffer(GL_FRAMEBUFFER, id);
 	bool flag = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
 	unbind();
 	return flag;
@@ -85,22 +119,30 @@ vector<FBO::Attachment*> FBO::getAttachments() {
 	return attachments;
 }
 
+size_t FBO::getMemorySize() const {
+	size_t size = 0;
+	for (const Attachment * a : attachments)
+		size += a->memorySize;
+	return size;
+}
+
 FBO* FBO::create(int width, int height, int samples) {
 	unsigned int fbo;
 	glGenFramebuffers(1, &fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLStateCache::getShared()->bindFramebuffer(GL_FRAMEBUFFER, fbo);
 	return new FBO(fbo, width, height, samples);
 }
 
-FBO::Attachment::Attachment(int width, int height, GLenum internalFormat, GLenum pixelFormat, GLenum dataType, GLenum glAttachment, bool texture) :	glAttachment(glAttachment), texture(texture) {
+FBO::Attachment::Attachment(int width, int height, GLenum internalFormat, GLenum pixelFormat, GLenum dataType, GLenum glAttachment, bool texture) :	glAttachment(glAttachment), texture(texture),
+	memorySize(static_cast<size_t>(width) * height * getPixelSize(internalFormat)) {
 	if (texture) {
 		glGenTextures(1, &id);
-		glBindTexture(GL_TEXTURE_2D, id);
+		GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, id);
 		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, pixelFormat, dataType, NULL);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glFramebufferTexture2D(GL_FRAMEBUFFER, glAttachment, GL_TEXTURE_2D, id, 0);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, 0);
 	} else {
 		glGenRenderbuffers(1, &id);
 		glBindRenderbuffer(GL_RENDERBUFFER, id);
@@ -109,13 +151,14 @@ FBO::Attachment::Attachment(int width, int height, GLenum internalFormat, GLenum
 	}
 }
 
-FBO::Attachment::Attachment(int width, int height, GLenum internalFormat, GLenum pixelFormat, GLenum dataType, GLenum glAttachment, int samples, bool texture) : glAttachment(glAttachment), texture(texture) {
+FBO::Attachment::Attachment(int width, int height, GLenum internalFormat, GLenum pixelFormat, GLenum dataType, GLenum glAttachment, int samples, bool texture) : glAttachment(glAttachment), texture(texture),
+	memorySize(static_cast<size_t>(width) * height * samples * getPixelSize(internalFormat)) {
 	if (texture){
 		glGenTextures(1, &id);
-		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, id);
+		GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D_MULTISAMPLE, id);
 		glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, samples, internalFormat, width, height, false);
 		glFramebufferTexture2D(GL_FRAMEBUFFER, glAttachment, GL_TEXTURE_2D_MULTISAMPLE, id, 0);
-		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+		GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
 	} else {
 		glGenRenderbuffers(1, &id);
 		glBindRenderbuffer(GL_RENDERBUFFER, id);
@@ -126,7 +169,7 @@ FBO::Attachment::Attachment(int width, int height, GLenum internalFormat, GLenum
 
 FBO::Attachment::~Attachment() {
 	if (texture)
-		glDeleteTextures(1, &id);
+		GLStateCache::getShared()->deleteTexture(id);
 	else
 		glDeleteRenderbuffers(1, &id);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <GLAD/glad.h>
 
 #include "../display/Display.h"
+#include "../render/ResourceManager.h"
 
 using namespace std;
 
@@ -39,6 +40,12 @@ class FBO {
 				const bool texture;
 
 			private:
+				/**
+				 * @brief The GPU memory taken by this attachment's samples, in bytes.
+				 * 
+				 */
+				size_t memorySize;
+
 				/**
 				 * @brief Constructs a single-sampled framebuffer attachment.
 				 * 
@@ -115,6 +122,12 @@ class FBO {
 		 */
 		vector<GLenum> drawBuffers;
 
+		/**
+		 * @brief The handle to this framebuffer in the resource manager.
+		 * 
+		 */
+		ResourceHandle handle;
+
 		/**
 		 * @brief Constructs a new framebuffer object with the specified attributes.
 		 * 
@@ -133,6 +146,14 @@ class FBO {
 		 */
 		~FBO();
 
+		/**
+		 * @brief Allocates and frees framebuffer objects from a shared pool rather than the heap.
+		 * Allocations of another size, such as those of derived classes, go to the heap.
+		 * 
+		 */
+		static void * operator new(size_t size);
+		static void operator delete(void * memory, size_t size);
+
 		/**
 		 * @brief Adds an attachment to the framebuffer.
 		 * 
@@ -203,6 +224,20 @@ class FBO {
 		 */
 		vector<Attachment*> getAttachments();
 
+		/**
+		 * @brief Returns the GPU memory taken by this framebuffer's attachments.
+		 * 
+		 * @return [size_t] The size of the attachments in bytes.
+		 */
+		size_t getMemorySize() const;
+
+		/**
+		 * @brief Returns this framebuffer's handle in the resource manager.
+		 * 
+		 * @return [ResourceHandle] The framebuffer's handle.
+		 */
+		inline ResourceHandle getHandle() const { return handle; }
+
 		/**
 		 * @brief Creates a new framebuffer object.
 		 * 
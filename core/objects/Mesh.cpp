@@ -1,8 +1,67 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
 #include "Mesh.h"
+#include "StreamBuffer.h"
+#include "../render/GLStateCache.h"
+#include "../render/ResourceManager.h"
 
 Mesh::Mesh(VAO * vao, unsigned int vertexCount) {
 	this->vao = vao;
 	this->vertexCount = vertexCount;
+	this->lods.push_back({ 0, vertexCount, 0.0f });
 }
 Mesh::~Mesh() {
-}
\ No newline at end of file
+	ResourceManager::getShared()->destroy(vao->getHandle());
+}
+
+unsigned int Mesh::selectLOD(float screenSize, float maxScreenError) const {
+	if (boundingRadius <= 0.0f)
+		return 0;
+
+	// The error of each level projected on screen, relative to the size of the whole mesh.
+	for (unsigned int level = static_cast<unsigned int>(lods.size()) - 1; level > 0; level--)
+		if (lods[level].error / boundingRadius * screenSize <= maxScreenError)
+			return level;
+
+	return 0;
+}
+void Mesh::drawInstanced(const MeshInstance * instances, unsigned int count, const MeshLOD & lod) {
+	if (count == 0)
+		return;
+
+	StreamBuffer * stream = StreamBuffer::getShared();
+	vao->bind();
+	GLStateCache::getShared()->bindBuffer(GL_ARRAY_BUFFER, stream->getID());
+
+	// Enable the vertex array's instance attributes, again if the vertex array was replaced by a reload.
+	if (instanceVAO != vao->getHandle()) {
+		for (unsigned int attribute = INSTANCE_ATTRIBUTE; attribute <= INSTANCE_ATTRIBUTE + 5; attribute++) {
+			glVertexAttribDivisor(attribute, 1);
+			glEnableVertexAttribArray(attribute);
+		}
+		instanceVAO = vao->getHandle();
+	}
+
+	// Stream the instances in chunks fitting a stream buffer region, the attributes reading each chunk from where it was written.
+	GLsizei stride = sizeof(MeshInstance);
+	unsigned int maxInstances = static_cast<unsigned int>(stream->getRegionSize() / sizeof(MeshInstance));
+	for (unsigned int drawn = 0; drawn < count; ) {
+		unsigned int n = std::min(count - drawn, maxInstances);
+		size_t offset;
+		void * data = stream->allocate(static_cast<size_t>(n) * sizeof(MeshInstance), sizeof(MeshInstance), offset);
+		if (data == nullptr)
+			return;
+		memcpy(data, instances + drawn, static_cast<size_t>(n) * sizeof(MeshInstance));
+		stream->commit();
+
+		for (unsigned int column = 0; column < 4; column++)
+			glVertexAttribPointer(INSTANCE_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offset + offsetof(MeshInstance, model) + column * 4 * sizeof(float)));
+		glVertexAttribPointer(INSTANCE_ATTRIBUTE + 4, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offset + offsetof(MeshInstance, tint)));
+		glVertexAttribIPointer(INSTANCE_ATTRIBUTE + 5, 1, GL_UNSIGNED_INT, stride, reinterpret_cast<void*>(offset + offsetof(MeshInstance, paletteOffset)));
+
+		glDrawElementsInstanced(GL_TRIANGLES, lod.indexCount, GL_UNSIGNED_INT, reinterpret_cast<void*>(static_cast<size_t>(lod.indexOffset) * sizeof(unsigned int)), n);
+		drawn += n;
+	}
+}
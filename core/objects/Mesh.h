@@ -1,7 +1,107 @@
+#include <vector>
+
 #include "VAO.h"
+#include "../math/GLVector.h"
+#include "../math/GLMatrix.h"
+
+using glmath::vec3;
+using glmath::vec4;
+using glmath::mat4;
+using std::vector;
 
 class Loader;
 
+/**
+ * @brief A single level of detail of a mesh, stored as a range of the mesh's index buffer.
+ * 
+ */
+struct MeshLOD {
+	/**
+	 * @brief The offset of the level's first index in the index buffer.
+	 * 
+	 */
+	unsigned int indexOffset;
+
+	/**
+	 * @brief The number of indices in the level.
+	 * 
+	 */
+	unsigned int indexCount;
+
+	/**
+	 * @brief The largest geometric deviation from the full detail mesh, in model units.
+	 * 
+	 */
+	float error;
+};
+
+/**
+ * @brief A small cluster of a mesh's triangles, stored as a range of the mesh's index buffer, 
+ * along with the bounds used to cull it.
+ * 
+ */
+struct Meshlet {
+	/**
+	 * @brief The offset of the cluster's first index in the index buffer.
+	 * 
+	 */
+	unsigned int indexOffset;
+
+	/**
+	 * @brief The number of indices in the cluster.
+	 * 
+	 */
+	unsigned int indexCount;
+
+	/**
+	 * @brief The number of unique vertices referenced by the cluster.
+	 * 
+	 */
+	unsigned int vertexCount;
+
+	/**
+	 * @brief The cluster's bounding sphere in model space.
+	 * 
+	 */
+	vec3 center;
+	float radius;
+
+	/**
+	 * @brief The cone containing the normals of all the cluster's triangles.
+	 * The cluster faces away from any viewer for which dot(normalize(coneApex - viewer), coneAxis) >= coneCutoff.
+	 * A cutoff of 1 means the cluster can never be backface culled.
+	 * 
+	 */
+	vec3 coneApex;
+	vec3 coneAxis;
+	float coneCutoff;
+};
+
+/**
+ * @brief The data of a single instance of an instanced mesh draw, laid out as it is stored in the instance buffer.
+ * 
+ */
+struct MeshInstance {
+	/**
+	 * @brief The instance's model matrix.
+	 * 
+	 */
+	mat4 model;
+
+	/**
+	 * @brief The color multiplying the instance's texture.
+	 * 
+	 */
+	vec4 tint;
+
+	/**
+	 * @brief The index of the instance's first joint transform, added to the joint indices of its vertices.
+	 * 
+	 */
+	unsigned int paletteOffset;
+	unsigned int padding[3];
+};
+
 #pragma once
 class Mesh {
 
@@ -20,6 +120,47 @@ class Mesh {
 		 */
 		unsigned int vertexCount;
 
+		/**
+		 * @brief The levels of detail of the mesh, from the most detailed to the coarsest.
+		 * The first level is always the full detail mesh.
+		 * 
+		 */
+		vector<MeshLOD> lods;
+
+		/**
+		 * @brief The center of the mesh's bounding sphere in model space.
+		 * 
+		 */
+		vec3 boundingCenter = vec3(0.0f);
+
+		/**
+		 * @brief The radius of the mesh's bounding sphere.
+		 * 
+		 */
+		float boundingRadius = 0.0f;
+
+		/**
+		 * @brief The minimum and maximum corners of the mesh's axis-aligned bounding box in model space.
+		 * Skeletal meshes are bounded over every pose of their animation.
+		 * 
+		 */
+		vec3 boundsMin = vec3(0.0f);
+		vec3 boundsMax = vec3(0.0f);
+
+		/**
+		 * @brief The clusters partitioning the full detail level of the mesh. 
+		 * Empty if the mesh was loaded without clusters.
+		 * 
+		 */
+		vector<Meshlet> meshlets;
+
+		/**
+		 * @brief The handle to the vertex array the instance attributes were enabled in.
+		 * Vertex arrays are pooled, so a replaced one may be allocated at the same address as its predecessor.
+		 * 
+		 */
+		ResourceHandle instanceVAO = {};
+
 		/**
 		 * @brief Constructs a new mesh object.
 		 * 
@@ -30,10 +171,17 @@ class Mesh {
 
 	public:
 		/**
-		 * @brief Destroys the mesh object.
+		 * @brief The attribute list of the first column of the instance model matrix. 
+		 * The other columns, the tint and the palette offset use the following attribute lists.
 		 * 
 		 */
-		~Mesh();
+		static const unsigned int INSTANCE_ATTRIBUTE = 7;
+
+		/**
+		 * @brief Destroys the mesh object, along with its vertex array once the GPU is done with it.
+		 * 
+		 */
+		virtual ~Mesh();
 
 		/**
 		 * @brief Returns this mesh's vertex array object.
@@ -49,5 +197,75 @@ class Mesh {
 		 */
 		inline unsigned int getVertexCount() const { return vertexCount; }
 
+		/**
+		 * @brief Returns this mesh's number of levels of detail.
+		 * 
+		 * @return [unsigned int] The number of levels of detail, including the full detail level.
+		 */
+		inline unsigned int getLODCount() const { return static_cast<unsigned int>(lods.size()); }
+
+		/**
+		 * @brief Returns one of this mesh's levels of detail.
+		 * 
+		 * @param level The level of detail, where 0 is the full detail mesh.
+		 * @return [const MeshLOD &] The index range and error of the level.
+		 */
+		inline const MeshLOD & getLOD(unsigned int level) const { return lods[level]; }
+
+		/**
+		 * @brief Returns the center of this mesh's bounding sphere.
+		 * 
+		 * @return [vec3] The bounding sphere center in model space.
+		 */
+		inline vec3 getBoundingCenter() const { return boundingCenter; }
+
+		/**
+		 * @brief Returns the radius of this mesh's bounding sphere.
+		 * 
+		 * @return [float] The bounding sphere radius in model units.
+		 */
+		inline float getBoundingRadius() const { return boundingRadius; }
+
+		/**
+		 * @brief Returns the minimum corner of this mesh's axis-aligned bounding box.
+		 * 
+		 * @return [vec3] The bounding box's minimum corner in model space.
+		 */
+		inline vec3 getBoundsMin() const { return boundsMin; }
+
+		/**
+		 * @brief Returns the maximum corner of this mesh's axis-aligned bounding box.
+		 * 
+		 * @return [vec3] The bounding box's maximum corner in model space.
+		 */
+		inline vec3 getBoundsMax() const { return boundsMax; }
+
+		/**
+		 * @brief Selects the coarsest level of detail whose error stays invisible at the given screen size.
+		 * 
+		 * @param screenSize The projected size of the mesh's bounding sphere, as returned by `Camera::computeScreenSize`.
+		 * @param maxScreenError The largest tolerated error, as a fraction of the viewport height.
+		 * @return [unsigned int] The selected level of detail.
+		 */
+		unsigned int selectLOD(float screenSize, float maxScreenError = 0.001f) const;
+
+		/**
+		 * @brief Returns the clusters partitioning the full detail level of this mesh.
+		 * 
+		 * @return [const vector<Meshlet> &] The mesh's clusters, empty if the mesh was loaded without clusters.
+		 */
+		inline const vector<Meshlet> & getMeshlets() const { return meshlets; }
+
+		/**
+		 * @brief Draws several instances of a level of detail of this mesh with a single draw call,
+		 * or one per stream buffer region when they do not fit in one. The instances are written to the shared stream buffer.
+		 * The shader in use must read its model matrix, tint and palette offset from the instance attributes.
+		 * 
+		 * @param instances The instances to draw.
+		 * @param count The number of instances.
+		 * @param lod The index range to draw.
+		 */
+		void drawInstanced(const MeshInstance * instances, unsigned int count, const MeshLOD & lod);
+
 };
 
@@ -1,7 +1,8 @@
 #include "SkeletalMesh.h"
 
-SkeletalMesh::SkeletalMesh(VAO * vao, unsigned int vertexCount, Animator * animator) : Mesh(vao, vertexCount) {
+SkeletalMesh::SkeletalMesh(VAO * vao, unsigned int vertexCount, Animator * animator, unsigned int influences) : Mesh(vao, vertexCount) {
 	this->anim = animator;
+	this->influences = influences;
 }
 
 SkeletalMesh::~SkeletalMesh(){
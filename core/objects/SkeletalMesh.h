@@ -14,13 +14,21 @@ class SkeletalMesh : public Mesh {
 
 	private: 
 		Animator * anim;
+		unsigned int influences;
 	
-		SkeletalMesh(VAO * vao, unsigned int vertexCount, Animator * animator);
+		SkeletalMesh(VAO * vao, unsigned int vertexCount, Animator * animator, unsigned int influences);
 	
 	public:
 		~SkeletalMesh();
 
 		inline Animator * animator() { return anim; };
 
+		/**
+		 * @brief Returns the number of joint influences stored per vertex.
+		 *
+		 * @return [unsigned int] The number of joint influences per vertex, either 4 or 8.
+		 */
+		inline unsigned int getInfluences() const { return influences; };
+
 };
 
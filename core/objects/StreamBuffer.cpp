@@ -0,0 +1,122 @@
+#include "StreamBuffer.h"
+#include "../render/GLStateCache.h"
+
+StreamBuffer * StreamBuffer::shared = nullptr;
+
+// Flags of the persistent mapping, coherent so written data needs no explicit flush.
+static const GLbitfield PERSISTENT_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+// Time waited on a fence at once before checking it again, in nanoseconds.
+static const GLuint64 FENCE_TIMEOUT = 1000000000ull;
+
+StreamBuffer::StreamBuffer(unsigned int id, size_t regionSize, bool persistent, char * mapped) :
+	id(id), regionSize(regionSize), persistent(persistent), mapped(mapped) {
+	handle = ResourceManager::getShared()->add(RESOURCE_STREAM_BUFFER, this);
+}
+
+StreamBuffer::~StreamBuffer() {
+	commit();
+	for (unsigned int i = 0; i < REGIONS; i++)
+		if (fences[i] != nullptr)
+			glDeleteSync(fences[i]);
+	if (persistent) {
+		GLStateCache::getShared()->bindBuffer(GL_COPY_WRITE_BUFFER, id);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+	}
+	GLStateCache::getShared()->deleteBuffer(id);
+	ResourceManager::getShared()->remove(handle);
+}
+
+void StreamBuffer::advance() {
+	fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	region = (region + 1) % REGIONS;
+	offset = region * regionSize;
+
+	// Wait for the draws reading the region from its last use, which only happens when the GPU is two regions behind.
+	GLsync fence = fences[region];
+	if (fence == nullptr)
+		return;
+	GLenum status = glClientWaitSync(fence, 0, 0);
+	if (status == GL_TIMEOUT_EXPIRED) {
+		stalls++;
+		do {
+			status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+		} while (status == GL_TIMEOUT_EXPIRED);
+	}
+	glDeleteSync(fence);
+	fences[region] = nullptr;
+}
+
+void * StreamBuffer::allocate(size_t size, size_t alignment, size_t & bufferOffset) {
+	if (size > regionSize)
+		return nullptr;
+	commit();
+
+	// Move on to the next region when the allocation does not fit in what remains of this one.
+	size_t start = (offset + alignment - 1) / alignment * alignment;
+	if (start + size > (region + 1) * regionSize) {
+		advance();
+		start = (offset + alignment - 1) / alignment * alignment;
+		if (start + size > (region + 1) * regionSize)
+			return nullptr;
+	}
+	offset = start + size;
+	allocated += size;
+	bufferOffset = start;
+	if (persistent)
+		return mapped + start;
+
+	// The fences already keep the GPU off this range, so the mapping does not need to synchronize.
+	GLStateCache::getShared()->bindBuffer(GL_COPY_WRITE_BUFFER, id);
+	mapping = true;
+	return glMapBufferRange(GL_COPY_WRITE_BUFFER, start, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+StreamBuffer * StreamBuffer::commit() {
+	if (mapping) {
+		GLStateCache::getShared()->bindBuffer(GL_COPY_WRITE_BUFFER, id);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		mapping = false;
+	}
+	return this;
+}
+
+StreamBuffer * StreamBuffer::endFrame() {
+	commit();
+	if (offset != region * regionSize)
+		advance();
+	return this;
+}
+
+StreamBuffer * StreamBuffer::create(size_t regionSize, bool allowPersistent) {
+	unsigned int id;
+	glGenBuffers(1, &id);
+	GLStateCache::getShared()->bindBuffer(GL_COPY_WRITE_BUFFER, id);
+	GLsizeiptr size = static_cast<GLsizeiptr>(regionSize) * REGIONS;
+
+	// Immutable storage can stay mapped while the GPU reads it, older contexts map each allocation instead.
+	if (allowPersistent && glBufferStorage != nullptr) {
+		glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, PERSISTENT_FLAGS);
+		char * mapped = static_cast<char *>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, PERSISTENT_FLAGS));
+		if (mapped != nullptr)
+			return new StreamBuffer(id, regionSize, true, mapped);
+
+		// The storage is immutable, start over with a new buffer.
+		GLStateCache::getShared()->deleteBuffer(id);
+		glGenBuffers(1, &id);
+		GLStateCache::getShared()->bindBuffer(GL_COPY_WRITE_BUFFER, id);
+	}
+	glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	return new StreamBuffer(id, regionSize, false, nullptr);
+}
+
+StreamBuffer * StreamBuffer::getShared() {
+	if (shared == nullptr)
+		shared = create(SHARED_REGION_SIZE);
+	return shared;
+}
+
+void StreamBuffer::cleanShared() {
+	delete shared;
+	shared = nullptr;
+}
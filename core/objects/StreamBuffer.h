@@ -0,0 +1,179 @@
+#include <cstddef>
+
+#include <glad/glad.h>
+
+#include "../render/ResourceManager.h"
+
+#pragma once
+class StreamBuffer {
+
+	public:
+		/**
+		 * @brief The number of regions the buffer is split into, so the CPU writes one while the GPU still reads the two others.
+		 *
+		 */
+		static const unsigned int REGIONS = 3;
+
+		/**
+		 * @brief The size in bytes of each region of the shared stream buffer.
+		 *
+		 */
+		static const size_t SHARED_REGION_SIZE = 8 << 20;
+
+	private:
+		/**
+		 * @brief This stream buffer's OpenGL ID, and the size in bytes of each of its regions.
+		 *
+		 */
+		unsigned int id;
+		size_t regionSize;
+
+		/**
+		 * @brief The handle to this stream buffer in the resource manager.
+		 *
+		 */
+		ResourceHandle handle;
+
+		/**
+		 * @brief Whether the buffer is persistently mapped, and the address it is mapped at.
+		 * Without persistent mapping, each allocation is mapped until it is committed.
+		 *
+		 */
+		bool persistent;
+		char * mapped = nullptr;
+		bool mapping = false;
+
+		/**
+		 * @brief The region being written, and the offset of its first free byte from the start of the buffer.
+		 *
+		 */
+		unsigned int region = 0;
+		size_t offset = 0;
+
+		/**
+		 * @brief The fence following the last draw reading each region, null if the GPU is done with it.
+		 *
+		 */
+		GLsync fences[REGIONS] = {};
+
+		/**
+		 * @brief The number of bytes allocated and the number of times a region was still in use by the GPU, since the buffer was created.
+		 *
+		 */
+		unsigned long long allocated = 0;
+		unsigned long long stalls = 0;
+
+		/**
+		 * @brief The shared stream buffer, created on first use.
+		 *
+		 */
+		static StreamBuffer * shared;
+
+		/**
+		 * @brief Constructs a new stream buffer object.
+		 *
+		 * @param id The buffer's OpenGL ID.
+		 * @param regionSize The size of each region in bytes.
+		 * @param persistent Whether the buffer's storage is immutable and persistently mapped.
+		 * @param mapped The persistent mapping of the whole buffer, or null.
+		 */
+		StreamBuffer(unsigned int id, size_t regionSize, bool persistent, char * mapped);
+
+		/**
+		 * @brief Fences the region being written and moves on to the next one, waiting for the GPU to be done reading it.
+		 *
+		 */
+		void advance();
+
+	public:
+		/**
+		 * @brief Unmaps and deletes the buffer, and destroys its instance.
+		 *
+		 */
+		~StreamBuffer();
+
+		/**
+		 * @brief Allocates transient storage for data read by the next draws. The data must be written before the allocation is committed,
+		 * and is only valid until the buffer wraps around to its region again, at least two regions later.
+		 *
+		 * @param size The number of bytes to allocate, at most the size of a region.
+		 * @param alignment The alignment of the allocation's offset in bytes, such as the vertex stride or GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+		 * @param bufferOffset Receives the offset of the allocation from the start of the buffer, for attribute pointers or glBindBufferRange.
+		 * @return [void *] The address to write the data to, or null if the size exceeds a region.
+		 */
+		void * allocate(size_t size, size_t alignment, size_t & bufferOffset);
+
+		/**
+		 * @brief Makes the data written to the last allocation visible to OpenGL. Must be called before drawing from it.
+		 *
+		 * @return [StreamBuffer *] This same stream buffer instance in order to allow for method chaining.
+		 */
+		StreamBuffer * commit();
+
+		/**
+		 * @brief Fences the draws issued this frame and moves on to the next region, so frames never share one.
+		 * Called once per frame, after the frame's draws were issued.
+		 *
+		 * @return [StreamBuffer *] This same stream buffer instance in order to allow for method chaining.
+		 */
+		StreamBuffer * endFrame();
+
+		/**
+		 * @brief Returns this stream buffer's OpenGL ID.
+		 *
+		 * @return [unsigned int] The OpenGL buffer ID.
+		 */
+		inline unsigned int getID() const { return id; };
+
+		/**
+		 * @brief Returns this stream buffer's handle in the resource manager.
+		 *
+		 * @return [ResourceHandle] The stream buffer's handle.
+		 */
+		inline ResourceHandle getHandle() const { return handle; };
+
+		/**
+		 * @brief Returns the size of each region, the largest possible allocation.
+		 *
+		 * @return [size_t] The region size in bytes.
+		 */
+		inline size_t getRegionSize() const { return regionSize; };
+
+		/**
+		 * @brief Returns whether the buffer is persistently mapped or mapped for each allocation.
+		 *
+		 * @return [bool] True if the buffer is persistently mapped.
+		 */
+		inline bool isPersistent() const { return persistent; };
+
+		/**
+		 * @brief Returns the number of bytes allocated and the number of waits on the GPU since the buffer was created.
+		 *
+		 */
+		inline unsigned long long getAllocated() const { return allocated; };
+		inline unsigned long long getStalls() const { return stalls; };
+
+		/**
+		 * @brief Creates a stream buffer, persistently mapped through glBufferStorage when available and if allowed.
+		 *
+		 * @param regionSize The size of each region in bytes.
+		 * @param allowPersistent [Optional] Whether persistent mapping may be used, false to always map each allocation.
+		 * @return [StreamBuffer *] The resulting stream buffer instance.
+		 */
+		static StreamBuffer * create(size_t regionSize, bool allowPersistent = true);
+
+		/**
+		 * @brief Returns the stream buffer shared by all transient uploads, creating it on the first call.
+		 * Must be called on the OpenGL thread.
+		 *
+		 * @return [StreamBuffer *] The shared stream buffer instance.
+		 */
+		static StreamBuffer * getShared();
+
+		/**
+		 * @brief Deletes the shared stream buffer, before the OpenGL context is destroyed.
+		 *
+		 */
+		static void cleanShared();
+
+};
@@ -1,8 +1,33 @@
 #include "Texture.h"
+#include "../render/GLStateCache.h"
+#include "../utils/PoolAllocator.h"
 
 Texture::Texture(GLenum type, unsigned int id, unsigned int samples) :
-	type(type), id(id), samples(samples) {}
+	type(type), id(id), samples(samples) {
+	handle = ResourceManager::getShared()->add(RESOURCE_TEXTURE, this);
+}
 
 Texture::~Texture() {
-	glDeleteTextures(1, &id);
-}
\ No newline at end of file
+	if (owner)
+		GLStateCache::getShared()->deleteTexture(id);
+	ResourceManager::getShared()->remove(handle);
+}
+
+void * Texture::operator new(size_t size) {
+	if (size != sizeof(Texture))
+		return ::operator new(size);
+	return PoolAllocator<Texture>::getShared()->allocate();
+}
+void Texture::operator delete(void * memory, size_t size) {
+	if (size != sizeof(Texture))
+		::operator delete(memory);
+	else
+		PoolAllocator<Texture>::getShared()->free(memory);
+}
+
+void Texture::setLevelRange(unsigned int baseLevel, unsigned int maxLevel) {
+	this->baseLevel = baseLevel;
+	this->maxLevel = maxLevel;
+	glTexParameteri(type, GL_TEXTURE_BASE_LEVEL, baseLevel);
+	glTexParameteri(type, GL_TEXTURE_MAX_LEVEL, maxLevel);
+}
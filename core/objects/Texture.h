@@ -1,11 +1,22 @@
 #include <glad/glad.h>
 
+#include "../math/GLVector.h"
+#include "../render/ResourceManager.h"
+
+using glmath::vec4;
+
 class Loader;
+class TextureStreamer;
+class TextureDecoder;
+class AssetReloader;
 
 #pragma once
 class Texture {
 
 	friend class Loader;
+	friend class TextureStreamer;
+	friend class TextureDecoder;
+	friend class AssetReloader;
 
 	private:
 		/**
@@ -26,6 +37,55 @@ class Texture {
 		 */
 		GLenum type;
 
+		/**
+		 * @brief This texture's dimensions at full resolution (level 0), and its total number of mip levels.
+		 * 
+		 */
+		unsigned int width = 0;
+		unsigned int height = 0;
+		unsigned int levelCount = 1;
+
+		/**
+		 * @brief The finest and coarsest mip levels currently resident in memory and available for sampling.
+		 * 
+		 */
+		unsigned int baseLevel = 0;
+		unsigned int maxLevel = 0;
+
+		/**
+		 * @brief The region of the OpenGL texture this texture occupies, as a UV offset (x, y) and scale (z, w), and its array layer.
+		 * Textures packed into an atlas share the atlas' OpenGL texture.
+		 * 
+		 */
+		vec4 uvTransform = vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		unsigned int layer = 0;
+
+		/**
+		 * @brief Whether or not this texture owns its OpenGL texture and deletes it when destroyed.
+		 * 
+		 */
+		bool owner = true;
+
+		/**
+		 * @brief The GPU memory taken by the levels uploaded to this texture's OpenGL texture, in bytes, 0 for atlas entries.
+		 * 
+		 */
+		size_t memorySize = 0;
+
+		/**
+		 * @brief The handle to this texture in the resource manager.
+		 * 
+		 */
+		ResourceHandle handle;
+
+		/**
+		 * @brief Restricts sampling to the given range of mip levels. The texture must be bound.
+		 * 
+		 * @param baseLevel The finest mip level to sample from.
+		 * @param maxLevel The coarsest mip level to sample from.
+		 */
+		void setLevelRange(unsigned int baseLevel, unsigned int maxLevel);
+
 		/**
 		 * @brief Constructs a new texture object with the specified properties.
 		 * 
@@ -42,6 +102,14 @@ class Texture {
 		 */
 		~Texture();
 
+		/**
+		 * @brief Allocates and frees texture objects from a shared pool rather than the heap.
+		 * Allocations of another size, such as those of derived classes, go to the heap.
+		 * 
+		 */
+		static void * operator new(size_t size);
+		static void operator delete(void * memory, size_t size);
+
 		/**
 		 * @brief Returns this texture's type.
 		 * 
@@ -70,6 +138,85 @@ class Texture {
 		 * @return false The texture is single-sampled.
 		 */
 		inline bool isMultisampled() const { return samples > 1; };
+
+		/**
+		 * @brief Returns this texture's width at full resolution.
+		 * 
+		 * @return [unsigned int] The width of mip level 0 in texels.
+		 */
+		inline unsigned int getWidth() const { return width; };
+
+		/**
+		 * @brief Returns this texture's height at full resolution.
+		 * 
+		 * @return [unsigned int] The height of mip level 0 in texels.
+		 */
+		inline unsigned int getHeight() const { return height; };
+
+		/**
+		 * @brief Returns this texture's total number of mip levels, resident or not.
+		 * 
+		 * @return [unsigned int] The number of mip levels in the full mip chain.
+		 */
+		inline unsigned int getLevelCount() const { return levelCount; };
+
+		/**
+		 * @brief Returns the finest mip level currently resident. Levels below it are not loaded.
+		 * 
+		 * @return [unsigned int] The finest resident mip level.
+		 */
+		inline unsigned int getBaseLevel() const { return baseLevel; };
+
+		/**
+		 * @brief Returns the coarsest mip level currently resident.
+		 * 
+		 * @return [unsigned int] The coarsest resident mip level.
+		 */
+		inline unsigned int getMaxLevel() const { return maxLevel; };
+
+		/**
+		 * @brief Returns whether or not every mip level of this texture is resident.
+		 * 
+		 * @return [bool] True if the full resolution level is resident, false otherwise.
+		 */
+		inline bool isFullyResident() const { return baseLevel == 0 && maxLevel == levelCount - 1; };
+
+		/**
+		 * @brief Returns the transform mapping this texture's UV coordinates into its OpenGL texture.
+		 * Textures packed into an atlas cannot use wrapping texture coordinates.
+		 * 
+		 * @return [const vec4 &] The UV offset in x and y, and the UV scale in z and w.
+		 */
+		inline const vec4 & getUVTransform() const { return uvTransform; };
+
+		/**
+		 * @brief Returns the layer of this texture in its OpenGL texture array.
+		 * 
+		 * @return [unsigned int] The array layer, 0 for textures that are not part of an array.
+		 */
+		inline unsigned int getLayer() const { return layer; };
+
+		/**
+		 * @brief Returns whether or not this texture is a region of a texture atlas.
+		 * 
+		 * @return true The texture shares its OpenGL texture with other textures of its atlas.
+		 * @return false The texture has its own OpenGL texture.
+		 */
+		inline bool isAtlasEntry() const { return !owner; };
+
+		/**
+		 * @brief Returns the GPU memory taken by this texture's uploaded levels.
+		 * 
+		 * @return [size_t] The size of the resident levels in bytes, 0 for atlas entries, whose memory belongs to the atlas.
+		 */
+		inline size_t getMemorySize() const { return memorySize; };
+
+		/**
+		 * @brief Returns this texture's handle in the resource manager.
+		 * 
+		 * @return [ResourceHandle] The texture's handle.
+		 */
+		inline ResourceHandle getHandle() const { return handle; };
 		
 };
 
@@ -0,0 +1,15 @@
+#include "TextureAtlas.h"
+
+TextureAtlas::TextureAtlas(Texture * array) :
+	array(array) {}
+
+TextureAtlas::~TextureAtlas() {
+	for (auto & pair : entries)
+		delete pair.second;
+	delete array;
+}
+
+Texture * TextureAtlas::get(const string & name) const {
+	auto match = entries.find(name);
+	return match == entries.end() ? nullptr : match->second;
+}
@@ -0,0 +1,66 @@
+#include <string>
+#include <unordered_map>
+
+#include "Texture.h"
+
+using std::string;
+using std::unordered_map;
+
+class Loader;
+
+#pragma once
+class TextureAtlas {
+
+	friend class Loader;
+
+	private:
+		/**
+		 * @brief The texture array holding every page of the atlas, one page per layer.
+		 * 
+		 */
+		Texture * array;
+
+		/**
+		 * @brief The textures packed into the atlas by name, each sampling its own region of the texture array.
+		 * 
+		 */
+		unordered_map<string, Texture *> entries;
+
+		/**
+		 * @brief Constructs a new texture atlas around its texture array.
+		 * 
+		 * @param array The texture array holding the atlas pages.
+		 */
+		TextureAtlas(Texture * array);
+
+	public:
+		/**
+		 * @brief Deletes the atlas entries and its texture array, and destroys the atlas object.
+		 * 
+		 */
+		~TextureAtlas();
+
+		/**
+		 * @brief Returns the texture array holding every page of the atlas.
+		 * 
+		 * @return [Texture *] The atlas' texture array.
+		 */
+		inline Texture * getTexture() const { return array; };
+
+		/**
+		 * @brief Returns the texture packed into the atlas under the given name.
+		 * This method returns a null pointer if no such texture was packed.
+		 * 
+		 * @param name The file name of the packed texture.
+		 * @return [Texture *] The atlas entry, owned by the atlas.
+		 */
+		Texture * get(const string & name) const;
+
+		/**
+		 * @brief Returns every texture packed into the atlas by name.
+		 * 
+		 * @return [const unordered_map<string, Texture *> &] The atlas entries, owned by the atlas.
+		 */
+		inline const unordered_map<string, Texture *> & getEntries() const { return entries; };
+
+};
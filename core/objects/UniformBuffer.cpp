@@ -0,0 +1,35 @@
+#include "UniformBuffer.h"
+#include "../render/GLStateCache.h"
+
+UniformBuffer::UniformBuffer(unsigned int id, unsigned int binding, size_t size) :
+	id(id), binding(binding), size(size) {
+	handle = ResourceManager::getShared()->add(RESOURCE_UNIFORM_BUFFER, this);
+}
+
+UniformBuffer::~UniformBuffer() {
+	GLStateCache::getShared()->deleteBuffer(id);
+	ResourceManager::getShared()->remove(handle);
+}
+
+UniformBuffer * UniformBuffer::update(const void * data, size_t size) {
+	GLStateCache::getShared()->bindBuffer(GL_UNIFORM_BUFFER, id);
+	glBufferData(GL_UNIFORM_BUFFER, this->size, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, size < this->size ? size : this->size, data);
+	return this;
+}
+
+UniformBuffer * UniformBuffer::bind() {
+
+	// Binding to an indexed point also binds the generic target, keep the cache in sync.
+	GLStateCache::getShared()->bindBuffer(GL_UNIFORM_BUFFER, id);
+	glBindBufferBase(GL_UNIFORM_BUFFER, binding, id);
+	return this;
+}
+
+UniformBuffer * UniformBuffer::create(unsigned int binding, size_t size) {
+	unsigned int id;
+	glGenBuffers(1, &id);
+	GLStateCache::getShared()->bindBuffer(GL_UNIFORM_BUFFER, id);
+	glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	return (new UniformBuffer(id, binding, size))->bind();
+}
@@ -0,0 +1,100 @@
+#include <cstddef>
+
+#include <glad/glad.h>
+
+#include "../render/ResourceManager.h"
+
+#pragma once
+class UniformBuffer {
+
+	private:
+		/**
+		 * @brief This uniform buffer's OpenGL ID.
+		 *
+		 */
+		unsigned int id;
+
+		/**
+		 * @brief The binding point this uniform buffer is bound to, and its size in bytes.
+		 *
+		 */
+		unsigned int binding;
+		size_t size;
+
+		/**
+		 * @brief The handle to this uniform buffer in the resource manager.
+		 *
+		 */
+		ResourceHandle handle;
+
+		/**
+		 * @brief Constructs a new uniform buffer object.
+		 *
+		 * @param id The uniform buffer's OpenGL ID.
+		 * @param binding The binding point the buffer is bound to.
+		 * @param size The size of the buffer in bytes.
+		 */
+		UniformBuffer(unsigned int id, unsigned int binding, size_t size);
+
+	public:
+		/**
+		 * @brief Deletes the uniform buffer from memory and destroys its instance.
+		 *
+		 */
+		~UniformBuffer();
+
+		/**
+		 * @brief Replaces the contents of the uniform buffer. The previous contents are orphaned,
+		 * so the upload does not wait for draws still reading them.
+		 *
+		 * @param data A pointer to the data, laid out following the std140 rules.
+		 * @param size The size of the data in bytes, at most the buffer's size.
+		 * @return [UniformBuffer *] This same uniform buffer instance in order to allow for method chaining.
+		 */
+		UniformBuffer * update(const void * data, size_t size);
+
+		/**
+		 * @brief Binds the uniform buffer to its binding point again, for when another buffer took its place.
+		 *
+		 * @return [UniformBuffer *] This same uniform buffer instance in order to allow for method chaining.
+		 */
+		UniformBuffer * bind();
+
+		/**
+		 * @brief Returns this uniform buffer's OpenGL ID.
+		 *
+		 * @return [unsigned int] The OpenGL buffer ID.
+		 */
+		inline unsigned int getID() const { return id; };
+
+		/**
+		 * @brief Returns this uniform buffer's handle in the resource manager.
+		 *
+		 * @return [ResourceHandle] The uniform buffer's handle.
+		 */
+		inline ResourceHandle getHandle() const { return handle; };
+
+		/**
+		 * @brief Returns the binding point this uniform buffer is bound to.
+		 *
+		 * @return [unsigned int] The uniform buffer binding point.
+		 */
+		inline unsigned int getBinding() const { return binding; };
+
+		/**
+		 * @brief Returns the size of this uniform buffer.
+		 *
+		 * @return [size_t] The size of the buffer in bytes.
+		 */
+		inline size_t getSize() const { return size; };
+
+		/**
+		 * @brief Creates a uniform buffer and binds it to a binding point, where it stays bound.
+		 *
+		 * @param binding The binding point, matching the binding of a uniform block in the shaders.
+		 * @param size The size of the buffer in bytes.
+		 * @return [UniformBuffer *] The resulting uniform buffer instance.
+		 */
+		static UniformBuffer * create(unsigned int binding, size_t size);
+
+};
@@ -1,43 +1,30 @@
+#include "../utils/PoolAllocator.h"
 #include "VAO.h"
 
 // VAO
-vector<VAO*> VAO::vaos;
-
 VAO::VAO(unsigned int id){
 	this->id = id;
-	vaos.push_back(this);
+	handle = ResourceManager::getShared()->add(RESOURCE_VERTEX_ARRAY, this);
 }
 VAO::~VAO(){
 	for (auto it = attributes.begin(); it != attributes.end(); it++)
 		delete it->second;
 
-	glDeleteVertexArrays(1, &id);
-}
-
-inline VAO * VAO::bind() {
-	glBindVertexArray(id);
-	return this;
+	GLStateCache::getShared()->deleteVertexArray(id);
+	ResourceManager::getShared()->remove(handle);
 }
-VAO* VAO::bind(const list<unsigned int> & attributes) {
-	bind();
-
-	for(unsigned int attribute: attributes)
-		glEnableVertexAttribArray(attribute);
-
-	return this;
+void * VAO::operator new(size_t size) {
+	if (size != sizeof(VAO))
+		return ::operator new(size);
+	return PoolAllocator<VAO>::getShared()->allocate();
 }
-inline VAO * VAO::unbind() {
-	glBindVertexArray(0);
-	return this;
+void VAO::operator delete(void * memory, size_t size) {
+	if (size != sizeof(VAO))
+		::operator delete(memory);
+	else
+		PoolAllocator<VAO>::getShared()->free(memory);
 }
-VAO * VAO::unbind(const list<unsigned int> & attributes) {
-	for(unsigned int attribute: attributes)
-		glDisableVertexAttribArray(attribute);
-
-	unbind();
 
-	return this;
-}
 
 VAO * VAO::storeData(unsigned int attribIndex, const void * data, unsigned int dataSize, unsigned int vectorSize, GLenum type, GLenum usage) {
 
@@ -51,11 +38,14 @@ VAO * VAO::storeData(unsigned int attribIndex, const void * data, unsigned int d
 	buffer->store(data, dataSize, usage);
 
 	// Create a proper pointer for the data
-	if (type == GL_INT || type == GL_UNSIGNED_INT)
+	if (type == GL_BYTE || type == GL_UNSIGNED_BYTE || type == GL_SHORT || type == GL_UNSIGNED_SHORT || type == GL_INT || type == GL_UNSIGNED_INT)
 		glVertexAttribIPointer(attribIndex, vectorSize, type, 0, NULL);
 	else
 		glVertexAttribPointer(attribIndex, vectorSize, type, GL_FALSE, 0, NULL);
 
+	// Enabling the attribute list is recorded in the VAO, it stays enabled whenever the VAO is bound.
+	glEnableVertexAttribArray(attribIndex);
+
 	// Unbind the buffer.
 	buffer->unbind();
 
@@ -75,10 +65,6 @@ VAO * VAO::storeIndices(const void* data, unsigned int dataSize, GLenum usage) {
 
 }
 
-inline unsigned int VAO::getID() {
-	return id;
-}
-
 inline VAO * VAO::addVBO(unsigned int attribIndex, VBO * vbo) {
 	attributes[attribIndex] = vbo;
 	return this;
@@ -90,36 +76,26 @@ VAO * VAO::create() {
 	return new VAO(id);
 }
 
-void VAO::cleanAll() {
-	for(VAO * vao: vaos)
-		delete vao;
-}
-
 // VBO
 VBO::VBO(unsigned int id, GLenum type) {
 	this->id = id;
 	this->type = type;
+	handle = ResourceManager::getShared()->add(RESOURCE_BUFFER, this);
 }
 VBO::~VBO() {
-	glDeleteBuffers(1, &id);
+	GLStateCache::getShared()->deleteBuffer(id);
+	ResourceManager::getShared()->remove(handle);
 }
-
-inline VBO * VBO::bind() {
-	glBindBuffer(type, id);
-	return this;
+void * VBO::operator new(size_t size) {
+	if (size != sizeof(VBO))
+		return ::operator new(size);
+	return PoolAllocator<VBO>::getShared()->allocate();
 }
-inline VBO * VBO::unbind() {
-	glBindBuffer(type, 0);
-	return this;
-}
-
-inline VBO * VBO::store(const void * data, unsigned int dataSize, GLenum usage) {
-	glBufferData(type, dataSize, data, usage);
-	return this;
-}
-
-inline unsigned int VBO::getID() {
-	return id;
+void VBO::operator delete(void * memory, size_t size) {
+	if (size != sizeof(VBO))
+		::operator delete(memory);
+	else
+		PoolAllocator<VBO>::getShared()->free(memory);
 }
 
 VBO * VBO::create(GLenum type) {
@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <list>
 #include <string>
 #include <map>
@@ -5,6 +6,9 @@
 
 #include <glad/glad.h>
 
+#include "../render/GLStateCache.h"
+#include "../render/ResourceManager.h"
+
 using namespace std;
 
 #pragma once
@@ -23,6 +27,18 @@ class VBO {
 		 */
 		GLenum type;
 
+		/**
+		 * @brief The size of the data stored in this vertex buffer object, in bytes.
+		 * 
+		 */
+		size_t size = 0;
+
+		/**
+		 * @brief The handle to this vertex buffer object in the resource manager.
+		 * 
+		 */
+		ResourceHandle handle;
+
 		/**
 		 * @brief Constructs a new vertex buffer object.
 		 * 
@@ -38,19 +54,33 @@ class VBO {
 		 */
 		~VBO();
 
+		/**
+		 * @brief Allocates and frees vertex buffer objects from a shared pool rather than the heap.
+		 * Allocations of another size, such as those of derived classes, go to the heap.
+		 * 
+		 */
+		static void * operator new(size_t size);
+		static void operator delete(void * memory, size_t size);
+
 		/**
 		 * @brief Binds this vertex buffer object to the currently bound vertex array object for manipulation.
 		 * 
 		 * @return [VBO *] This same vertex buffer instance in order to allow for method chaining.
 		 */
-		inline VBO * bind();
+		inline VBO * bind() {
+			GLStateCache::getShared()->bindBuffer(type, id);
+			return this;
+		}
 
 		/**
 		 * @brief Unbinds this vertex buffer object from the currently bound vertex array object.
 		 * 
 		 * @return [VBO *] This same vertex buffer instance in order to allow for method chaining.
 		 */
-		inline VBO * unbind();
+		inline VBO * unbind() {
+			GLStateCache::getShared()->bindBuffer(type, 0);
+			return this;
+		}
 
 		/**
 		 * @brief Buffers data into the vertex buffer object.
@@ -60,14 +90,32 @@ class VBO {
 		 * @param usage The OpenGL usage flag for this data. (GL_STATIC_DRAW, GL_DYNAMIC_DRAW, etc...)
 		 * @return [VBO *] This same vertex buffer instance in order to allow for method chaining.
 		 */
-		inline VBO * store(const void * data, unsigned int dataSize, GLenum usage);
+		inline VBO * store(const void * data, unsigned int dataSize, GLenum usage) {
+			glBufferData(type, dataSize, data, usage);
+			size = dataSize;
+			return this;
+		}
 
 		/**
 		 * @brief Returns this vertex buffer's OpenGL ID.
 		 * 
 		 * @return unsigned int 
 		 */
-		inline unsigned int getID();
+		inline unsigned int getID() const { return id; }
+
+		/**
+		 * @brief Returns the size of the data stored in this vertex buffer.
+		 * 
+		 * @return [size_t] The size of the data in bytes.
+		 */
+		inline size_t getSize() const { return size; }
+
+		/**
+		 * @brief Returns this vertex buffer's handle in the resource manager.
+		 * 
+		 * @return [ResourceHandle] The vertex buffer's handle.
+		 */
+		inline ResourceHandle getHandle() const { return handle; }
 
 		/**
 		 * @brief Creates a new vertex buffer object of the given type.
@@ -95,10 +143,10 @@ class VAO {
 		map<unsigned int, VBO*> attributes;
 
 		/**
-		 * @brief A collection of all existing vertex array objects.
+		 * @brief The handle to this vertex array object in the resource manager.
 		 * 
 		 */
-		static vector<VAO*> vaos;
+		ResourceHandle handle;
 
 		/**
 		 * @brief Constructs a new vertex array object.
@@ -113,36 +161,34 @@ class VAO {
 		 * 
 		 */
 		~VAO();
-		
-		/**
-		 * @brief Binds the vertex array object for manipulation.
-		 * 
-		 * @return [VAO *] This same vertex array instance in order to allow for method chaining.
-		 */
-		inline VAO * bind();
 
 		/**
-		 * @brief Binds the vertex array object for manipulation and enables the specified attribute lists.
+		 * @brief Allocates and frees vertex array objects from a shared pool rather than the heap.
+		 * Allocations of another size, such as those of derived classes, go to the heap.
 		 * 
-		 * @param attributes The attribute list indices to enable.
-		 * @return [VAO *] This same vertex array instance in order to allow for method chaining.
 		 */
-		VAO * bind(const list<unsigned int> & attributes);
-
+		static void * operator new(size_t size);
+		static void operator delete(void * memory, size_t size);
+		
 		/**
-		 * @brief Unbinds the vertex array object.
+		 * @brief Binds the vertex array object for manipulation.
 		 * 
 		 * @return [VAO *] This same vertex array instance in order to allow for method chaining.
 		 */
-		inline VAO * unbind();
+		inline VAO * bind() {
+			GLStateCache::getShared()->bindVertexArray(id);
+			return this;
+		}
 
 		/**
-		 * @brief Unbinds the vertex array object and disables the specified attribute lists.
+		 * @brief Unbinds the vertex array object.
 		 * 
-		 * @param attributes The attribute list indices to disable.
 		 * @return [VAO *] This same vertex array instance in order to allow for method chaining.
 		 */
-		VAO * unbind(const list<unsigned int> & attributes);
+		inline VAO * unbind() {
+			GLStateCache::getShared()->bindVertexArray(0);
+			return this;
+		}
 
 		/**
 		 * @brief Loads data into a single attribute list as a new vertex buffer object.
@@ -185,25 +231,50 @@ class VAO {
 		 */
 		inline VAO * addVBO(unsigned int attribIndex, VBO* vbo);
 
+		/**
+		 * @brief Returns the vertex buffer object holding one of this vertex array's attribute lists.
+		 * 
+		 * @param attribIndex The attribute list index.
+		 * @return [VBO *] The attribute list's vertex buffer, or nullptr if the attribute list is not stored.
+		 */
+		inline VBO * getVBO(unsigned int attribIndex) const {
+			auto it = attributes.find(attribIndex);
+			return it != attributes.end() ? it->second : nullptr;
+		}
+
+		/**
+		 * @brief Returns the vertex buffer object holding this vertex array's indices.
+		 * 
+		 * @return [VBO *] The index buffer, or nullptr if no indices are stored.
+		 */
+		inline VBO * getIndexVBO() const { return getVBO(UINT32_MAX); }
+
+		/**
+		 * @brief Returns the vertex buffer objects of this vertex array, which are deleted along with it.
+		 * 
+		 * @return [const map<unsigned int, VBO*> &] The vertex buffers by attribute list index, the index buffer at UINT32_MAX.
+		 */
+		inline const map<unsigned int, VBO*> & getAttributes() const { return attributes; }
+
 		/**
 		 * @brief Returns this vertex array's OpenGL ID.
 		 * 
 		 * @return [unsigned int] This vertex array object's OpenGL ID.
 		 */
-		inline unsigned int getID();
+		inline unsigned int getID() const { return id; }
 
 		/**
-		 * @brief Creates and returns a new vertex array.
+		 * @brief Returns this vertex array's handle in the resource manager.
 		 * 
-		 * @return [VAO *] The resulting vertex array instance.
+		 * @return [ResourceHandle] The vertex array's handle.
 		 */
-		static VAO * create();
+		inline ResourceHandle getHandle() const { return handle; }
 
 		/**
-		 * @brief Deletes all existing vertex array objects from memory. 
-		 * Accessing vertex array instances after calling this method will cause errors.
+		 * @brief Creates and returns a new vertex array.
 		 * 
+		 * @return [VAO *] The resulting vertex array instance.
 		 */
-		static void cleanAll();
+		static VAO * create();
 
 };
\ No newline at end of file
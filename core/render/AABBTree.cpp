@@ -0,0 +1,447 @@
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <utility>
+
+#include "AABBTree.h"
+
+using std::pair;
+
+// Returns a coordinate of a vector by axis index.
+static inline float component(const vec3 & v, int axis) {
+	return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+}
+
+// Returns the distance at which a ray enters a box, clamped to the ray's origin, or a negative value if it misses the box before the maximum distance.
+static float intersectRay(const AABB & box, const vec3 & origin, const vec3 & inverse, float maxDistance) {
+	float tx0 = (box.min.x - origin.x) * inverse.x, tx1 = (box.max.x - origin.x) * inverse.x;
+	float ty0 = (box.min.y - origin.y) * inverse.y, ty1 = (box.max.y - origin.y) * inverse.y;
+	float tz0 = (box.min.z - origin.z) * inverse.z, tz1 = (box.max.z - origin.z) * inverse.z;
+	float enter = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), 0.0f));
+	float exit = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), maxDistance));
+	return enter <= exit ? enter : -1.0f;
+}
+
+AABBTree::AABBTree(float margin) : margin(margin) {}
+
+int AABBTree::allocateNode() {
+	if (freeList == NULL_NODE) {
+		nodes.push_back(Node());
+		freeList = static_cast<int>(nodes.size()) - 1;
+		nodes[freeList].parent = NULL_NODE;
+	}
+	int node = freeList;
+	freeList = nodes[node].parent;
+	nodes[node].parent = NULL_NODE;
+	nodes[node].left = NULL_NODE;
+	nodes[node].right = NULL_NODE;
+	nodes[node].height = 0;
+	nodes[node].object = 0;
+	return node;
+}
+
+void AABBTree::freeNode(int node) {
+	nodes[node].parent = freeList;
+	nodes[node].height = -1;
+	freeList = node;
+}
+
+void AABBTree::insertLeaf(int leaf) {
+	if (root == NULL_NODE) {
+		root = leaf;
+		nodes[leaf].parent = NULL_NODE;
+		return;
+	}
+
+	// Descend towards the sibling whose union with the leaf adds the least area, including the growth of every ancestor on the way.
+	AABB box = nodes[leaf].box;
+	int index = root;
+	while (!nodes[index].isLeaf()) {
+		int left = nodes[index].left, right = nodes[index].right;
+		float area = nodes[index].box.surfaceArea();
+		float combinedArea = AABB::merge(nodes[index].box, box).surfaceArea();
+
+		// Pairing with this node creates a parent over both, all ancestors growing by the same amount.
+		float cost = 2.0f * combinedArea;
+		float inheritance = 2.0f * (combinedArea - area);
+
+		float leftArea = AABB::merge(box, nodes[left].box).surfaceArea();
+		float leftCost = (nodes[left].isLeaf() ? leftArea : leftArea - nodes[left].box.surfaceArea()) + inheritance;
+		float rightArea = AABB::merge(box, nodes[right].box).surfaceArea();
+		float rightCost = (nodes[right].isLeaf() ? rightArea : rightArea - nodes[right].box.surfaceArea()) + inheritance;
+
+		if (cost < leftCost && cost < rightCost)
+			break;
+		index = leftCost < rightCost ? left : right;
+	}
+
+	// Replace the sibling with a new parent over the sibling and the leaf.
+	int sibling = index;
+	int oldParent = nodes[sibling].parent;
+	int parent = allocateNode();
+	nodes[parent].parent = oldParent;
+	nodes[parent].box = AABB::merge(box, nodes[sibling].box);
+	nodes[parent].height = nodes[sibling].height + 1;
+	nodes[parent].left = sibling;
+	nodes[parent].right = leaf;
+	nodes[sibling].parent = parent;
+	nodes[leaf].parent = parent;
+	if (oldParent == NULL_NODE)
+		root = parent;
+	else if (nodes[oldParent].left == sibling)
+		nodes[oldParent].left = parent;
+	else
+		nodes[oldParent].right = parent;
+
+	refitAncestors(nodes[leaf].parent);
+}
+
+void AABBTree::removeLeaf(int leaf) {
+	if (leaf == root) {
+		root = NULL_NODE;
+		return;
+	}
+
+	// The sibling takes the place of the parent.
+	int parent = nodes[leaf].parent;
+	int grandParent = nodes[parent].parent;
+	int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+	freeNode(parent);
+	if (grandParent == NULL_NODE) {
+		root = sibling;
+		nodes[sibling].parent = NULL_NODE;
+		return;
+	}
+	if (nodes[grandParent].left == parent)
+		nodes[grandParent].left = sibling;
+	else
+		nodes[grandParent].right = sibling;
+	nodes[sibling].parent = grandParent;
+	refitAncestors(grandParent);
+}
+
+void AABBTree::refitAncestors(int node) {
+	while (node != NULL_NODE) {
+		node = balance(node);
+		const Node & left = nodes[nodes[node].left];
+		const Node & right = nodes[nodes[node].right];
+		nodes[node].height = 1 + std::max(left.height, right.height);
+		nodes[node].box = AABB::merge(left.box, right.box);
+		node = nodes[node].parent;
+	}
+}
+
+int AABBTree::balance(int a) {
+	if (nodes[a].isLeaf() || nodes[a].height < 2)
+		return a;
+
+	// Rotate the taller child up into the node's place, the node keeping the child's shorter subtree.
+	int b = nodes[a].left, c = nodes[a].right;
+	int difference = nodes[c].height - nodes[b].height;
+	if (difference >= -1 && difference <= 1)
+		return a;
+	int child = difference > 1 ? c : b;
+	int other = difference > 1 ? b : c;
+	int f = nodes[child].left, g = nodes[child].right;
+
+	nodes[child].left = a;
+	nodes[child].parent = nodes[a].parent;
+	nodes[a].parent = child;
+	int parent = nodes[child].parent;
+	if (parent == NULL_NODE)
+		root = child;
+	else if (nodes[parent].left == a)
+		nodes[parent].left = child;
+	else
+		nodes[parent].right = child;
+
+	// The taller grandchild stays under the rotated child, the shorter one moves under the node.
+	int taller = nodes[f].height > nodes[g].height ? f : g;
+	int shorter = taller == f ? g : f;
+	nodes[child].right = taller;
+	if (difference > 1)
+		nodes[a].right = shorter;
+	else
+		nodes[a].left = shorter;
+	nodes[shorter].parent = a;
+
+	nodes[a].box = AABB::merge(nodes[other].box, nodes[shorter].box);
+	nodes[a].height = 1 + std::max(nodes[other].height, nodes[shorter].height);
+	nodes[child].box = AABB::merge(nodes[a].box, nodes[taller].box);
+	nodes[child].height = 1 + std::max(nodes[a].height, nodes[taller].height);
+	return child;
+}
+
+int AABBTree::buildRange(const vector<AABB> & boxes, vector<unsigned int> & objects, unsigned int begin, unsigned int end, vector<int> * proxies) {
+
+	// Nodes are allocated in depth-first order, so each subtree sits contiguously in memory for queries.
+	int node = allocateNode();
+	if (end - begin == 1) {
+		nodes[node].box = boxes[objects[begin]];
+		nodes[node].object = objects[begin];
+		if (proxies != nullptr)
+			(*proxies)[objects[begin]] = node;
+		return node;
+	}
+
+	// Split along the longest axis of the objects' centers.
+	float low[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, high[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (unsigned int i = begin; i < end; i++) {
+		const AABB & box = boxes[objects[i]];
+		for (int axis = 0; axis < 3; axis++) {
+			float center = 0.5f * (component(box.min, axis) + component(box.max, axis));
+			low[axis] = std::min(low[axis], center);
+			high[axis] = std::max(high[axis], center);
+		}
+	}
+	int axis = 0;
+	for (int a = 1; a < 3; a++)
+		if (high[a] - low[a] > high[axis] - low[axis])
+			axis = a;
+	float extent = high[axis] - low[axis];
+	auto centerOf = [&](unsigned int object) {
+		return 0.5f * (component(boxes[object].min, axis) + component(boxes[object].max, axis));
+	};
+
+	unsigned int mid = begin;
+	if (extent > 0.0f) {
+
+		// Bin the objects by center, then pick the boundary between bins minimizing the area weighted counts on both sides.
+		auto binOf = [&](unsigned int object) {
+			unsigned int bin = static_cast<unsigned int>(SAH_BINS * (centerOf(object) - low[axis]) / extent);
+			return std::min(bin, SAH_BINS - 1);
+		};
+		unsigned int counts[SAH_BINS] = {};
+		AABB bins[SAH_BINS];
+		for (AABB & bin : bins)
+			bin = { vec3(FLT_MAX), vec3(-FLT_MAX) };
+		for (unsigned int i = begin; i < end; i++) {
+			unsigned int bin = binOf(objects[i]);
+			counts[bin]++;
+			bins[bin] = AABB::merge(bins[bin], boxes[objects[i]]);
+		}
+
+		// Costs of the objects left of each boundary, swept forward, then of those right of it, swept backward.
+		float leftCosts[SAH_BINS] = {};
+		AABB accumulated = { vec3(FLT_MAX), vec3(-FLT_MAX) };
+		unsigned int count = 0;
+		for (unsigned int b = 0; b + 1 < SAH_BINS; b++) {
+			accumulated = AABB::merge(accumulated, bins[b]);
+			count += counts[b];
+			leftCosts[b + 1] = count > 0 ? count * accumulated.surfaceArea() : 0.0f;
+		}
+		float bestCost = FLT_MAX;
+		unsigned int bestBin = 0;
+		accumulated = { vec3(FLT_MAX), vec3(-FLT_MAX) };
+		count = 0;
+		for (unsigned int b = SAH_BINS - 1; b > 0; b--) {
+			accumulated = AABB::merge(accumulated, bins[b]);
+			count += counts[b];
+			float cost = leftCosts[b] + (count > 0 ? count * accumulated.surfaceArea() : 0.0f);
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestBin = b;
+			}
+		}
+		mid = static_cast<unsigned int>(std::partition(objects.begin() + begin, objects.begin() + end,
+			[&](unsigned int object) { return binOf(object) < bestBin; }) - objects.begin());
+	}
+
+	// Objects sharing a center, or clustered in a single bin, are split evenly instead.
+	if (mid == begin || mid == end) {
+		mid = (begin + end) / 2;
+		std::nth_element(objects.begin() + begin, objects.begin() + mid, objects.begin() + end,
+			[&](unsigned int a, unsigned int b) { return centerOf(a) < centerOf(b); });
+	}
+
+	int left = buildRange(boxes, objects, begin, mid, proxies);
+	int right = buildRange(boxes, objects, mid, end, proxies);
+	nodes[node].left = left;
+	nodes[node].right = right;
+	nodes[node].box = AABB::merge(nodes[left].box, nodes[right].box);
+	nodes[node].height = 1 + std::max(nodes[left].height, nodes[right].height);
+	nodes[left].parent = node;
+	nodes[right].parent = node;
+	return node;
+}
+
+AABBTree * AABBTree::build(const vector<AABB> & boxes, vector<int> * proxies) {
+	clear();
+	if (boxes.empty())
+		return this;
+	nodes.reserve(boxes.size() * 2 - 1);
+	vector<unsigned int> objects(boxes.size());
+	for (unsigned int i = 0; i < boxes.size(); i++)
+		objects[i] = i;
+	if (proxies != nullptr)
+		proxies->resize(boxes.size());
+	leafCount = static_cast<unsigned int>(boxes.size());
+	root = buildRange(boxes, objects, 0, leafCount, proxies);
+	return this;
+}
+
+int AABBTree::insert(const AABB & box, unsigned int object) {
+	int leaf = allocateNode();
+	nodes[leaf].box = { box.min - vec3(margin), box.max + vec3(margin) };
+	nodes[leaf].object = object;
+	insertLeaf(leaf);
+	leafCount++;
+	return leaf;
+}
+
+void AABBTree::remove(int proxy) {
+	removeLeaf(proxy);
+	freeNode(proxy);
+	leafCount--;
+}
+
+bool AABBTree::update(int proxy, const AABB & box) {
+	if (nodes[proxy].box.contains(box))
+		return false;
+	removeLeaf(proxy);
+	nodes[proxy].box = { box.min - vec3(margin), box.max + vec3(margin) };
+	insertLeaf(proxy);
+	return true;
+}
+
+void AABBTree::refit(int proxy, const AABB & box) {
+	nodes[proxy].box = box;
+	for (int node = nodes[proxy].parent; node != NULL_NODE; node = nodes[node].parent)
+		nodes[node].box = AABB::merge(nodes[nodes[node].left].box, nodes[nodes[node].right].box);
+}
+
+void AABBTree::clear() {
+	nodes.clear();
+	root = NULL_NODE;
+	freeList = NULL_NODE;
+	leafCount = 0;
+}
+
+void AABBTree::queryFrustum(const Frustum & frustum, vector<unsigned int> & objects) const {
+	if (root == NULL_NODE)
+		return;
+
+	// Each node carries the planes its box still crosses, planes its parent lay fully inside of being skipped.
+	const unsigned int allPlanes = (1 << Frustum::PLANE_COUNT) - 1;
+	vector<pair<int, unsigned int>> stack;
+	stack.reserve(64);
+	stack.push_back({ root, allPlanes });
+	while (!stack.empty()) {
+		int index = stack.back().first;
+		unsigned int planes = stack.back().second;
+		stack.pop_back();
+		const Node & node = nodes[index];
+
+		bool culled = false;
+		if (planes != 0) {
+			const vec3 & min = node.box.min, & max = node.box.max;
+			float cx = 0.5f * (min.x + max.x), cy = 0.5f * (min.y + max.y), cz = 0.5f * (min.z + max.z);
+			float ex = 0.5f * (max.x - min.x), ey = 0.5f * (max.y - min.y), ez = 0.5f * (max.z - min.z);
+			for (unsigned int p = 0; p < Frustum::PLANE_COUNT; p++) {
+				if ((planes & (1 << p)) == 0)
+					continue;
+				const vec4 & plane = frustum.planes[p];
+				float distance = plane.x * cx + plane.y * cy + plane.z * cz + plane.w;
+				float radius = std::fabs(plane.x) * ex + std::fabs(plane.y) * ey + std::fabs(plane.z) * ez;
+				if (distance < -radius) {
+					culled = true;
+					break;
+				}
+				if (distance >= radius)
+					planes &= ~(1 << p);
+			}
+		}
+		if (culled)
+			continue;
+
+		if (node.isLeaf())
+			objects.push_back(node.object);
+		else {
+			stack.push_back({ node.left, planes });
+			stack.push_back({ node.right, planes });
+		}
+	}
+}
+
+void AABBTree::queryOverlap(const AABB & box, vector<unsigned int> & objects) const {
+	if (root == NULL_NODE)
+		return;
+	vector<int> stack;
+	stack.reserve(64);
+	stack.push_back(root);
+	while (!stack.empty()) {
+		const Node & node = nodes[stack.back()];
+		stack.pop_back();
+		if (!node.box.overlaps(box))
+			continue;
+		if (node.isLeaf())
+			objects.push_back(node.object);
+		else {
+			stack.push_back(node.left);
+			stack.push_back(node.right);
+		}
+	}
+}
+
+bool AABBTree::raycast(const vec3 & origin, const vec3 & direction, float maxDistance, RaycastHit & hit,
+	const function<float(unsigned int object, float boxDistance)> & intersect) const {
+	if (root == NULL_NODE)
+		return false;
+	vec3 inverse = vec3(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+	float closest = maxDistance;
+	bool found = false;
+
+	// Nodes are stacked with the distance at which the ray enters them, those farther than the closest hit being dropped.
+	vector<pair<int, float>> stack;
+	stack.reserve(64);
+	float distance = intersectRay(nodes[root].box, origin, inverse, closest);
+	if (distance >= 0.0f)
+		stack.push_back({ root, distance });
+	while (!stack.empty()) {
+		int index = stack.back().first;
+		float entry = stack.back().second;
+		stack.pop_back();
+		if (entry > closest)
+			continue;
+		const Node & node = nodes[index];
+
+		if (node.isLeaf()) {
+			float objectDistance = intersect ? intersect(node.object, entry) : entry;
+			if (objectDistance >= 0.0f && objectDistance <= closest) {
+				closest = objectDistance;
+				hit = { node.object, objectDistance };
+				found = true;
+			}
+			continue;
+		}
+
+		// Push the farther child first so the nearer one is visited first.
+		float leftDistance = intersectRay(nodes[node.left].box, origin, inverse, closest);
+		float rightDistance = intersectRay(nodes[node.right].box, origin, inverse, closest);
+		bool leftFirst = rightDistance < 0.0f || (leftDistance >= 0.0f && leftDistance <= rightDistance);
+		int nearChild = leftFirst ? node.left : node.right, farChild = leftFirst ? node.right : node.left;
+		float nearDistance = leftFirst ? leftDistance : rightDistance, farDistance = leftFirst ? rightDistance : leftDistance;
+		if (farDistance >= 0.0f)
+			stack.push_back({ farChild, farDistance });
+		if (nearDistance >= 0.0f)
+			stack.push_back({ nearChild, nearDistance });
+	}
+	return found;
+}
+
+float AABBTree::computeCost() const {
+	if (root == NULL_NODE || nodes[root].isLeaf())
+		return 0.0f;
+	float area = 0.0f;
+	vector<int> stack(1, root);
+	while (!stack.empty()) {
+		const Node & node = nodes[stack.back()];
+		stack.pop_back();
+		if (node.isLeaf())
+			continue;
+		area += node.box.surfaceArea();
+		stack.push_back(node.left);
+		stack.push_back(node.right);
+	}
+	return area / nodes[root].box.surfaceArea();
+}
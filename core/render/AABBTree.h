@@ -0,0 +1,321 @@
+#include <vector>
+#include <functional>
+
+#include "../math/GLVector.h"
+#include "../camera/Frustum.h"
+
+using namespace glmath;
+using std::vector;
+using std::function;
+
+#pragma once
+
+/**
+ * @brief An axis-aligned bounding box in world space.
+ *
+ */
+struct AABB {
+	vec3 min;
+	vec3 max;
+
+	/**
+	 * @brief Returns the area of the box's surface, the cost of visiting it in the surface area heuristic.
+	 *
+	 * @return [float] The box's surface area.
+	 */
+	inline float surfaceArea() const {
+		vec3 size = max - min;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	};
+
+	/**
+	 * @brief Returns whether another box lies entirely inside this one.
+	 *
+	 * @param other The other box.
+	 * @return [bool] True if the other box is contained in this one.
+	 */
+	inline bool contains(const AABB & other) const {
+		return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+			other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z;
+	};
+
+	/**
+	 * @brief Returns whether another box intersects this one.
+	 *
+	 * @param other The other box.
+	 * @return [bool] True if the boxes overlap or touch.
+	 */
+	inline bool overlaps(const AABB & other) const {
+		return min.x <= other.max.x && other.min.x <= max.x &&
+			min.y <= other.max.y && other.min.y <= max.y &&
+			min.z <= other.max.z && other.min.z <= max.z;
+	};
+
+	/**
+	 * @brief Returns the smallest box enclosing two boxes.
+	 *
+	 * @param a The first box.
+	 * @param b The second box.
+	 * @return [AABB] The union of both boxes.
+	 */
+	static inline AABB merge(const AABB & a, const AABB & b) {
+		return {
+			vec3(a.min.x < b.min.x ? a.min.x : b.min.x, a.min.y < b.min.y ? a.min.y : b.min.y, a.min.z < b.min.z ? a.min.z : b.min.z),
+			vec3(a.max.x > b.max.x ? a.max.x : b.max.x, a.max.y > b.max.y ? a.max.y : b.max.y, a.max.z > b.max.z ? a.max.z : b.max.z)
+		};
+	};
+};
+
+/**
+ * @brief The closest object found by a ray cast.
+ *
+ */
+struct RaycastHit {
+	unsigned int object;
+	float distance;
+};
+
+class AABBTree {
+
+	private:
+		/**
+		 * @brief A node of the tree. Leaves hold a single object, internal nodes always have two children.
+		 * Free nodes chain through their parent index.
+		 *
+		 */
+		struct Node {
+			AABB box;
+			unsigned int object;
+			int parent;
+			int left;
+			int right;
+			int height;
+
+			inline bool isLeaf() const { return left == NULL_NODE; };
+		};
+
+		/**
+		 * @brief Every node, live or free, indexed by proxy for leaves.
+		 *
+		 */
+		vector<Node> nodes;
+
+		/**
+		 * @brief The index of the root node, or NULL_NODE if the tree is empty.
+		 *
+		 */
+		int root = NULL_NODE;
+
+		/**
+		 * @brief The first free node, or NULL_NODE if every node is in use.
+		 *
+		 */
+		int freeList = NULL_NODE;
+
+		/**
+		 * @brief The number of objects in the tree.
+		 *
+		 */
+		unsigned int leafCount = 0;
+
+		/**
+		 * @brief The distance by which boxes of inserted objects are enlarged on each side, so small movements need no reinsertion.
+		 *
+		 */
+		float margin;
+
+		/**
+		 * @brief Takes a node from the free list, growing the node storage if needed.
+		 *
+		 * @return [int] The index of the node.
+		 */
+		int allocateNode();
+
+		/**
+		 * @brief Returns a node to the free list.
+		 *
+		 * @param node The index of the node.
+		 */
+		void freeNode(int node);
+
+		/**
+		 * @brief Links a leaf into the tree next to the sibling minimizing the growth in surface area, then refits and balances its ancestors.
+		 *
+		 * @param leaf The index of the leaf.
+		 */
+		void insertLeaf(int leaf);
+
+		/**
+		 * @brief Unlinks a leaf from the tree, replacing its parent with its sibling, then refits and balances its ancestors.
+		 *
+		 * @param leaf The index of the leaf.
+		 */
+		void removeLeaf(int leaf);
+
+		/**
+		 * @brief Recomputes the boxes and heights of a node and its ancestors, rotating unbalanced nodes on the way up.
+		 *
+		 * @param node The index of the first node to recompute.
+		 */
+		void refitAncestors(int node);
+
+		/**
+		 * @brief Promotes the deeper grandchild subtree when a node's children differ in height by more than one.
+		 *
+		 * @param node The index of the node to balance.
+		 * @return [int] The index of the node now at the position of the given node.
+		 */
+		int balance(int node);
+
+		/**
+		 * @brief Builds the subtree over a range of objects, splitting each range with the binned surface area heuristic.
+		 *
+		 * @param boxes The boxes of every object being built.
+		 * @param objects The objects, reordered in place.
+		 * @param begin The index of the first object of the range.
+		 * @param end The index following the last object of the range.
+		 * @param proxies Receives the proxy of each object, indexed by object, or null.
+		 * @return [int] The index of the subtree's root.
+		 */
+		int buildRange(const vector<AABB> & boxes, vector<unsigned int> & objects, unsigned int begin, unsigned int end, vector<int> * proxies);
+
+	public:
+		/**
+		 * @brief The index representing the absence of a node.
+		 *
+		 */
+		static const int NULL_NODE = -1;
+
+		/**
+		 * @brief The number of bins over which surface area heuristic splits are evaluated during a build.
+		 *
+		 */
+		static const unsigned int SAH_BINS = 16;
+
+		/**
+		 * @brief Creates an empty tree.
+		 *
+		 * @param margin [Optional] The distance by which boxes of inserted objects are enlarged on each side.
+		 */
+		AABBTree(float margin = 0.1f);
+
+		/**
+		 * @brief Replaces the contents of the tree with static objects, building it top-down with the surface area heuristic.
+		 * Boxes are stored as given, without any margin.
+		 *
+		 * @param boxes The boxes of the objects, the object of each box being its index.
+		 * @param proxies [Optional] Receives the proxy of each object, indexed like the boxes.
+		 * @return [AABBTree *] This same tree instance in order to allow for method chaining.
+		 */
+		AABBTree * build(const vector<AABB> & boxes, vector<int> * proxies = nullptr);
+
+		/**
+		 * @brief Inserts a moving object, its box enlarged by the margin.
+		 *
+		 * @param box The object's box.
+		 * @param object The object reported by queries.
+		 * @return [int] The proxy identifying the object in the tree.
+		 */
+		int insert(const AABB & box, unsigned int object);
+
+		/**
+		 * @brief Removes an object.
+		 *
+		 * @param proxy The proxy returned when the object was inserted.
+		 */
+		void remove(int proxy);
+
+		/**
+		 * @brief Moves an object, reinserting it only if its new box leaves its enlarged box.
+		 *
+		 * @param proxy The proxy of the object.
+		 * @param box The object's new box.
+		 * @return [bool] True if the object was reinserted, false if its enlarged box still encloses it.
+		 */
+		bool update(int proxy, const AABB & box);
+
+		/**
+		 * @brief Resizes an object's box in place and grows or shrinks its ancestors' boxes to match, without restructuring the tree.
+		 * Cheaper than an update for objects that move little, but the tree's quality degrades as they drift.
+		 *
+		 * @param proxy The proxy of the object.
+		 * @param box The object's new box, stored as given.
+		 */
+		void refit(int proxy, const AABB & box);
+
+		/**
+		 * @brief Removes every object.
+		 *
+		 */
+		void clear();
+
+		/**
+		 * @brief Finds the objects whose boxes intersect a frustum.
+		 * Subtrees entirely inside the frustum are collected without testing their boxes.
+		 *
+		 * @param frustum The frustum in world space, such as the one created by the camera.
+		 * @param objects Receives the objects found, appended in no particular order.
+		 */
+		void queryFrustum(const Frustum & frustum, vector<unsigned int> & objects) const;
+
+		/**
+		 * @brief Finds the objects whose boxes overlap a box.
+		 *
+		 * @param box The box to test.
+		 * @param objects Receives the objects found, appended in no particular order.
+		 */
+		void queryOverlap(const AABB & box, vector<unsigned int> & objects) const;
+
+		/**
+		 * @brief Finds the closest object along a ray, visiting nearer subtrees first and skipping those beyond the closest hit.
+		 *
+		 * @param origin The ray's origin.
+		 * @param direction The ray's direction, whose length scales the distances.
+		 * @param maxDistance The distance past which objects are ignored.
+		 * @param hit Receives the closest object and its distance.
+		 * @param intersect [Optional] Tests the ray against an object whose box it enters, given the distance to the box,
+		 * returning the distance to the object itself or a negative value if the ray misses it. The boxes are the objects if omitted.
+		 * @return [bool] True if an object was hit.
+		 */
+		bool raycast(const vec3 & origin, const vec3 & direction, float maxDistance, RaycastHit & hit,
+			const function<float(unsigned int object, float boxDistance)> & intersect = nullptr) const;
+
+		/**
+		 * @brief Returns the box stored for an object, enlarged by the margin unless built or refit.
+		 *
+		 * @param proxy The proxy of the object.
+		 * @return [const AABB &] The object's box in the tree.
+		 */
+		inline const AABB & getBox(int proxy) const { return nodes[proxy].box; };
+
+		/**
+		 * @brief Returns the object of a proxy.
+		 *
+		 * @param proxy The proxy of the object.
+		 * @return [unsigned int] The object given when it was inserted.
+		 */
+		inline unsigned int getObject(int proxy) const { return nodes[proxy].object; };
+
+		/**
+		 * @brief Returns the number of objects in the tree.
+		 *
+		 * @return [unsigned int] The number of objects.
+		 */
+		inline unsigned int getCount() const { return leafCount; };
+
+		/**
+		 * @brief Returns the height of the tree.
+		 *
+		 * @return [int] The number of levels below the root, 0 for a single object and -1 when empty.
+		 */
+		inline int getHeight() const { return root == NULL_NODE ? -1 : nodes[root].height; };
+
+		/**
+		 * @brief Returns the surface area heuristic cost of the tree, the summed areas of its internal nodes relative to the root's.
+		 * Lower costs mean fewer nodes visited by queries.
+		 *
+		 * @return [float] The tree's cost, 0 when it holds less than two objects.
+		 */
+		float computeCost() const;
+
+};
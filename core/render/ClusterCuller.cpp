@@ -0,0 +1,64 @@
+#include "ClusterCuller.h"
+
+ClusterCuller::ClusterCuller() {}
+
+ClusterCuller::~ClusterCuller() {}
+
+ClusterCuller * ClusterCuller::cull(const Mesh * mesh, const mat4 & model, Camera * cam) {
+	counts.clear();
+	offsets.clear();
+	tested = frustumCulled = backfaceCulled = 0;
+
+	// Work in model space: extract the planes from the full transform and bring the camera into the mesh's space.
+	Frustum frustum(cam->createProjectionViewMatrix() * model);
+	mat4 inverseModel = model;
+	inverseModel.inverse();
+	vec3 camPos = cam->getPosition();
+	vec4 viewer;
+	transform(inverseModel, vec4(camPos.x, camPos.y, camPos.z, 1.0f), &viewer);
+	vec3 eye = vec3(viewer.x, viewer.y, viewer.z);
+
+	unsigned int rangeStart = 0, rangeEnd = 0;
+	for (const Meshlet & meshlet : mesh->getMeshlets()) {
+		tested++;
+
+		if (!frustum.intersectsSphere(meshlet.center, meshlet.radius)) {
+			frustumCulled++;
+			continue;
+		}
+
+		if (meshlet.coneCutoff < 1.0f) {
+			vec3 direction = meshlet.coneApex - eye;
+			float length = direction.length();
+			if (length > 0.0f && glmath::dot(direction, meshlet.coneAxis) >= meshlet.coneCutoff * length) {
+				backfaceCulled++;
+				continue;
+			}
+		}
+
+		// Extend the current range when clusters are adjacent in the index buffer.
+		if (rangeEnd != rangeStart && meshlet.indexOffset == rangeEnd) {
+			rangeEnd += meshlet.indexCount;
+			continue;
+		}
+
+		if (rangeEnd != rangeStart) {
+			counts.push_back(static_cast<GLsizei>(rangeEnd - rangeStart));
+			offsets.push_back(reinterpret_cast<const void *>(static_cast<size_t>(rangeStart) * sizeof(unsigned int)));
+		}
+		rangeStart = meshlet.indexOffset;
+		rangeEnd = meshlet.indexOffset + meshlet.indexCount;
+	}
+	if (rangeEnd != rangeStart) {
+		counts.push_back(static_cast<GLsizei>(rangeEnd - rangeStart));
+		offsets.push_back(reinterpret_cast<const void *>(static_cast<size_t>(rangeStart) * sizeof(unsigned int)));
+	}
+
+	return this;
+}
+
+ClusterCuller * ClusterCuller::draw() {
+	if (!counts.empty())
+		glMultiDrawElements(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(), static_cast<GLsizei>(counts.size()));
+	return this;
+}
@@ -0,0 +1,106 @@
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "../math/GLMatrix.h"
+#include "../objects/Mesh.h"
+#include "../camera/Camera.h"
+#include "../camera/Frustum.h"
+
+using namespace glmath;
+using std::vector;
+
+#pragma once
+class ClusterCuller {
+
+	private:
+		/**
+		 * @brief The index counts and byte offsets of the index ranges that survived the last culling pass.
+		 * 
+		 */
+		vector<GLsizei> counts;
+		vector<const void *> offsets;
+
+		/**
+		 * @brief Statistics of the last culling pass.
+		 * 
+		 */
+		unsigned int tested = 0;
+		unsigned int frustumCulled = 0;
+		unsigned int backfaceCulled = 0;
+
+	public:
+		/**
+		 * @brief Constructs a new cluster culler.
+		 * 
+		 */
+		ClusterCuller();
+
+		/**
+		 * @brief Destroys the cluster culler.
+		 * 
+		 */
+		~ClusterCuller();
+
+		/**
+		 * @brief Culls a mesh's clusters against the camera's frustum and rejects the clusters facing away from it. 
+		 * The surviving clusters are merged into as few contiguous index ranges as possible.
+		 * 
+		 * @param mesh The mesh whose clusters to cull.
+		 * @param model The mesh's model matrix.
+		 * @param cam The camera from which the mesh is viewed.
+		 * @return [ClusterCuller *] This same culler instance in order to allow for method chaining.
+		 */
+		ClusterCuller * cull(const Mesh * mesh, const mat4 & model, Camera * cam);
+
+		/**
+		 * @brief Draws the index ranges that survived the last culling pass with a single multi-draw call. 
+		 * The mesh's vertex array must be bound.
+		 * 
+		 * @return [ClusterCuller *] This same culler instance in order to allow for method chaining.
+		 */
+		ClusterCuller * draw();
+
+		/**
+		 * @brief Returns the number of index ranges that survived the last culling pass.
+		 * 
+		 * @return [unsigned int] The number of draws issued by `draw`.
+		 */
+		inline unsigned int getDrawCount() const { return static_cast<unsigned int>(counts.size()); }
+
+		/**
+		 * @brief Returns the index counts of the ranges that survived the last culling pass.
+		 * 
+		 * @return [const vector<GLsizei> &] The number of indices of each range.
+		 */
+		inline const vector<GLsizei> & getCounts() const { return counts; }
+
+		/**
+		 * @brief Returns the byte offsets of the ranges that survived the last culling pass.
+		 * 
+		 * @return [const vector<const void *> &] The byte offset of each range in the index buffer.
+		 */
+		inline const vector<const void *> & getOffsets() const { return offsets; }
+
+		/**
+		 * @brief Returns the number of clusters tested during the last culling pass.
+		 * 
+		 * @return [unsigned int] The number of clusters tested.
+		 */
+		inline unsigned int getTestedCount() const { return tested; }
+
+		/**
+		 * @brief Returns the number of clusters rejected by the frustum test during the last culling pass.
+		 * 
+		 * @return [unsigned int] The number of clusters outside the camera's frustum.
+		 */
+		inline unsigned int getFrustumCulledCount() const { return frustumCulled; }
+
+		/**
+		 * @brief Returns the number of clusters rejected by the backface cone test during the last culling pass.
+		 * 
+		 * @return [unsigned int] The number of clusters facing away from the camera.
+		 */
+		inline unsigned int getBackfaceCulledCount() const { return backfaceCulled; }
+
+};
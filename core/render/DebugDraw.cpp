@@ -0,0 +1,158 @@
+#include <cmath>
+
+#include "DebugDraw.h"
+
+thread_local DebugDraw::ThreadBuffer * DebugDraw::localBuffer = nullptr;
+
+// Transforms a point, dividing by the resulting w.
+static vec3 transformPoint(const mat4 & transform, const vec3 & point) {
+	vec4 result;
+	glmath::transform(transform, vec4(point.x, point.y, point.z, 1.0f), &result);
+	return vec3(result.x, result.y, result.z) / result.w;
+}
+
+// Appends a line from a joint to each of its children, then does the same for the children.
+static void appendBones(vector<PrimitiveVertex> & lines, const Joint * joint, const vec3 & position, const mat4 * transforms, const mat4 & model, const vec3 & color) {
+	for (const Joint * child : joint->children) {
+
+		// The joint transforms skin vertices from bind pose, the joint itself sits at the origin of its inverse bind matrix.
+		mat4 bind = child->transform;
+		vec3 childPosition = transformPoint(model * transforms[child->index] * bind.inverse(), vec3(0.0f));
+		lines.push_back({ position, color });
+		lines.push_back({ childPosition, color });
+		appendBones(lines, child, childPosition, transforms, model, color);
+	}
+}
+
+DebugDraw::DebugDraw() {}
+
+DebugDraw::~DebugDraw() {
+	for (ThreadBuffer * buffer : buffers)
+		delete buffer;
+}
+
+DebugDraw::ThreadBuffer * DebugDraw::getBuffer() {
+	if (localBuffer == nullptr) {
+		ThreadBuffer * buffer = new ThreadBuffer();
+		std::lock_guard<std::mutex> lock(mutex);
+		buffers.push_back(buffer);
+		localBuffer = buffer;
+	}
+	return localBuffer;
+}
+
+DebugDraw * DebugDraw::point(const vec3 & position, const vec3 & color) {
+	getBuffer()->points.push_back({ position, color });
+	return this;
+}
+
+DebugDraw * DebugDraw::line(const vec3 & from, const vec3 & to, const vec3 & color) {
+	vector<PrimitiveVertex> & lines = getBuffer()->lines;
+	lines.push_back({ from, color });
+	lines.push_back({ to, color });
+	return this;
+}
+
+DebugDraw * DebugDraw::box(const vec3 & min, const vec3 & max, const vec3 & color, const mat4 & transform) {
+
+	// Corner i takes the maximum coordinate on each axis whose bit is set in i.
+	vec3 corners[8];
+	for (unsigned int i = 0; i < 8; i++)
+		corners[i] = transformPoint(transform, vec3(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z));
+
+	// Each edge joins two corners differing by a single bit.
+	vector<PrimitiveVertex> & lines = getBuffer()->lines;
+	for (unsigned int i = 0; i < 8; i++) {
+		for (unsigned int bit = 1; bit < 8; bit <<= 1) {
+			if ((i & bit) == 0) {
+				lines.push_back({ corners[i], color });
+				lines.push_back({ corners[i | bit], color });
+			}
+		}
+	}
+	return this;
+}
+
+DebugDraw * DebugDraw::sphere(const vec3 & center, float radius, const vec3 & color, unsigned int segments) {
+	vector<PrimitiveVertex> & lines = getBuffer()->lines;
+	for (unsigned int s = 0; s < segments; s++) {
+		float a0 = 2.0f * PI * s / segments;
+		float a1 = 2.0f * PI * (s + 1) / segments;
+		float c0 = std::cos(a0) * radius, s0 = std::sin(a0) * radius;
+		float c1 = std::cos(a1) * radius, s1 = std::sin(a1) * radius;
+
+		// One segment of the circle around each axis.
+		lines.push_back({ center + vec3(c0, s0, 0.0f), color });
+		lines.push_back({ center + vec3(c1, s1, 0.0f), color });
+		lines.push_back({ center + vec3(c0, 0.0f, s0), color });
+		lines.push_back({ center + vec3(c1, 0.0f, s1), color });
+		lines.push_back({ center + vec3(0.0f, c0, s0), color });
+		lines.push_back({ center + vec3(0.0f, c1, s1), color });
+	}
+	return this;
+}
+
+DebugDraw * DebugDraw::frustum(const mat4 & projView, const vec3 & color) {
+
+	// The frustum is the normalized device coordinates cube brought back to world space.
+	mat4 inverse = projView;
+	return box(vec3(-1.0f), vec3(1.0f), color, inverse.inverse());
+}
+
+DebugDraw * DebugDraw::skeleton(const Animator * animator, const mat4 & model, const vec3 & color) {
+	const Joint * root = animator->getRoot();
+	const mat4 * transforms = animator->getTransforms();
+	mat4 bind = root->transform;
+	vec3 position = transformPoint(model * transforms[root->index] * bind.inverse(), vec3(0.0f));
+	appendBones(getBuffer()->lines, root, position, transforms, model, color);
+	return this;
+}
+
+DebugDraw * DebugDraw::render() {
+
+	// Gather every thread's shapes so each topology goes out in a single draw.
+	flush(points, lines);
+	return render(points, lines);
+}
+
+DebugDraw * DebugDraw::flush(vector<PrimitiveVertex> & points, vector<PrimitiveVertex> & lines) {
+	points.clear();
+	lines.clear();
+	std::lock_guard<std::mutex> lock(mutex);
+	for (ThreadBuffer * buffer : buffers) {
+		points.insert(points.end(), buffer->points.begin(), buffer->points.end());
+		lines.insert(lines.end(), buffer->lines.begin(), buffer->lines.end());
+		buffer->points.clear();
+		buffer->lines.clear();
+	}
+	return this;
+}
+
+DebugDraw * DebugDraw::render(const vector<PrimitiveVertex> & points, const vector<PrimitiveVertex> & lines) {
+	if (points.empty() && lines.empty())
+		return this;
+	if (renderer == nullptr)
+		renderer = new PrimitiveRenderer();
+	renderer->render(GL_POINTS, points.data(), points.size());
+	renderer->render(GL_LINES, lines.data(), lines.size());
+	return this;
+}
+
+DebugDraw * DebugDraw::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	for (ThreadBuffer * buffer : buffers) {
+		buffer->points.clear();
+		buffer->lines.clear();
+	}
+	return this;
+}
+
+void DebugDraw::release() {
+	delete renderer;
+	renderer = nullptr;
+}
+
+DebugDraw * DebugDraw::getShared() {
+	static DebugDraw shared;
+	return &shared;
+}
@@ -0,0 +1,184 @@
+#include <mutex>
+#include <vector>
+
+#include "../math/GLVector.h"
+#include "../math/GLMatrix.h"
+#include "../animation/Animation.h"
+#include "PrimitiveRenderer.h"
+
+using namespace glmath;
+using std::vector;
+
+#pragma once
+class DebugDraw {
+
+	private:
+		/**
+		 * @brief The points and lines appended by one thread since the last render, each line being two consecutive vertices.
+		 *
+		 */
+		struct ThreadBuffer {
+			vector<PrimitiveVertex> points;
+			vector<PrimitiveVertex> lines;
+		};
+
+		/**
+		 * @brief The buffer of every thread that appended shapes so far, guarded by the mutex when a thread registers its own.
+		 *
+		 */
+		vector<ThreadBuffer *> buffers;
+		std::mutex mutex;
+
+		/**
+		 * @brief The calling thread's buffer, null until the thread appends its first shape.
+		 *
+		 */
+		static thread_local ThreadBuffer * localBuffer;
+
+		/**
+		 * @brief The points and lines of all threads gathered for a single draw per topology, kept to reuse their memory.
+		 *
+		 */
+		vector<PrimitiveVertex> points;
+		vector<PrimitiveVertex> lines;
+
+		/**
+		 * @brief The renderer streaming and drawing the vertices, created on the first render.
+		 *
+		 */
+		PrimitiveRenderer * renderer = nullptr;
+
+		/**
+		 * @brief Constructs the debug drawer, with no buffers.
+		 *
+		 */
+		DebugDraw();
+
+		/**
+		 * @brief Returns the calling thread's buffer, registering a new one on the thread's first call.
+		 *
+		 * @return [ThreadBuffer *] The calling thread's buffer.
+		 */
+		ThreadBuffer * getBuffer();
+
+	public:
+		/**
+		 * @brief The number of segments of each circle of a sphere, by default.
+		 *
+		 */
+		static const unsigned int SPHERE_SEGMENTS = 24;
+
+		/**
+		 * @brief Deletes the thread buffers.
+		 *
+		 */
+		~DebugDraw();
+
+		/**
+		 * @brief Appends a point. Shapes can be appended from any thread, but not while the frame's shapes are being rendered.
+		 *
+		 * @param position The point's position in world space.
+		 * @param color The point's color.
+		 * @return [DebugDraw *] This same instance in order to allow for method chaining.
+		 */
+		DebugDraw * point(const vec3 & position, const vec3 & color);
+
+		/**
+		 * @brief Appends a line.
+		 *
+		 * @param from The line's first end in world space.
+		 * @param to The line's second end in world space.
+		 * @param color The line's color.
+		 * @return [DebugDraw *] This same instance in order to allow for method chaining.
+		 */
+		DebugDraw * line(const vec3 & from, const vec3 & to, const vec3 & color);
+
+		/**
+		 * @brief Appends the edges of a box.
+		 *
+		 * @param min The box's minimum corner.
+		 * @param max The box's maximum corner.
+		 * @param color The box's color.
+		 * @param transform [Optional] The transform from the box's space to world space, for oriented boxes.
+		 * @return [DebugDraw *] This same instance in order to allow for method chaining.
+		 */
+		DebugDraw * box(const vec3 & min, const vec3 & max, const vec3 & color, const mat4 & transform = mat4());
+
+		/**
+		 * @brief Appends a sphere, drawn as three circles around its axes.
+		 *
+		 * @param center The sphere's center in world space.
+		 * @param radius The sphere's radius.
+		 * @param color The sphere's color.
+		 * @param segments [Optional] The number of segments of each circle.
+		 * @return [DebugDraw *] This same instance in order to allow for method chaining.
+		 */
+		DebugDraw * sphere(const vec3 & center, float radius, const vec3 & color, unsigned int segments = SPHERE_SEGMENTS);
+
+		/**
+		 * @brief Appends the edges of a view frustum.
+		 *
+		 * @param projView The projection view matrix of the frustum, such as the one of a camera.
+		 * @param color The frustum's color.
+		 * @return [DebugDraw *] This same instance in order to allow for method chaining.
+		 */
+		DebugDraw * frustum(const mat4 & projView, const vec3 & color);
+
+		/**
+		 * @brief Appends the bones of a posed skeleton, a line from each joint to each of its children.
+		 *
+		 * @param animator The animator holding the skeleton and the joint transforms of its current pose.
+		 * @param model The skeletal mesh's model matrix.
+		 * @param color The bones' color.
+		 * @return [DebugDraw *] This same instance in order to allow for method chaining.
+		 */
+		DebugDraw * skeleton(const Animator * animator, const mat4 & model, const vec3 & color);
+
+		/**
+		 * @brief Draws the shapes appended by all threads since the last render, with one draw per topology, and clears them.
+		 * Must be called on the OpenGL thread, once the other threads are done appending the frame's shapes.
+		 *
+		 * @return [DebugDraw *] This same instance in order to allow for method chaining.
+		 */
+		DebugDraw * render();
+
+		/**
+		 * @brief Moves the shapes appended by all threads since the last render into a frame's own lists, without drawing them,
+		 * so another thread can draw them later. Must be called once the other threads are done appending the frame's shapes.
+		 *
+		 * @param points Receives the points, replacing its contents.
+		 * @param lines Receives the lines, replacing its contents.
+		 * @return [DebugDraw *] This same instance in order to allow for method chaining.
+		 */
+		DebugDraw * flush(vector<PrimitiveVertex> & points, vector<PrimitiveVertex> & lines);
+
+		/**
+		 * @brief Draws shapes flushed from an earlier frame, with one draw per topology. Must be called on the OpenGL thread.
+		 *
+		 * @param points The points to draw.
+		 * @param lines The lines to draw, each line being two consecutive vertices.
+		 * @return [DebugDraw *] This same instance in order to allow for method chaining.
+		 */
+		DebugDraw * render(const vector<PrimitiveVertex> & points, const vector<PrimitiveVertex> & lines);
+
+		/**
+		 * @brief Clears the shapes appended by all threads since the last render without drawing them.
+		 *
+		 * @return [DebugDraw *] This same instance in order to allow for method chaining.
+		 */
+		DebugDraw * clear();
+
+		/**
+		 * @brief Deletes the renderer's OpenGL objects, before the OpenGL context is destroyed.
+		 *
+		 */
+		void release();
+
+		/**
+		 * @brief Returns the debug drawer shared by all threads.
+		 *
+		 * @return [DebugDraw *] The shared debug drawer instance.
+		 */
+		static DebugDraw * getShared();
+
+};
@@ -0,0 +1,32 @@
+#include "FrameUniforms.h"
+#include "../shaders/Shader.h"
+
+FrameUniforms::FrameUniforms() :
+	frameBuffer(UniformBuffer::create(Shader::FRAME_BLOCK_BINDING, sizeof(FrameData))),
+	passBuffer(UniformBuffer::create(Shader::PASS_BLOCK_BINDING, sizeof(PassData))) {}
+
+FrameUniforms::~FrameUniforms() {
+	delete frameBuffer;
+	delete passBuffer;
+}
+
+FrameUniforms * FrameUniforms::update(Camera * cam, float time, float delta) {
+	return update(cam->createViewMatrix(), cam->getProjectionMatrix(), cam->getPosition(), time, delta);
+}
+
+FrameUniforms * FrameUniforms::update(const mat4 & view, const mat4 & projection, const vec3 & position, float time, float delta) {
+	frame.view = view;
+	frame.projection = projection;
+	frame.projView = frame.projection * frame.view;
+	frame.cameraPosition = vec4(position.x, position.y, position.z, 1.0f);
+	frame.time = vec4(time, delta, 0.0f, 0.0f);
+	frameBuffer->update(&frame, sizeof(frame));
+	return this;
+}
+
+FrameUniforms * FrameUniforms::updatePass(float width, float height) {
+	pass.viewport = vec4(width, height, 1.0f / width, 1.0f / height);
+	pass.clipPlanes = vec4(NEAR_PLANE, FAR_PLANE, 0.0f, 0.0f);
+	passBuffer->update(&pass, sizeof(pass));
+	return this;
+}
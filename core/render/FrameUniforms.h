@@ -0,0 +1,125 @@
+#include "../math/GLMatrix.h"
+#include "../camera/Camera.h"
+#include "../objects/UniformBuffer.h"
+
+using namespace glmath;
+
+#pragma once
+
+/**
+ * @brief The data shared by every draw of a frame, laid out like the FrameData uniform block following the std140 rules.
+ *
+ */
+struct FrameData {
+	mat4 view;
+	mat4 projection;
+	mat4 projView;
+
+	/**
+	 * @brief The camera's position in world space in xyz, w being unused.
+	 *
+	 */
+	vec4 cameraPosition;
+
+	/**
+	 * @brief The time elapsed since the first frame in x and the duration of the last frame in y, in seconds, zw being unused.
+	 *
+	 */
+	vec4 time;
+};
+
+/**
+ * @brief The data shared by every draw of a render pass, laid out like the PassData uniform block following the std140 rules.
+ *
+ */
+struct PassData {
+	/**
+	 * @brief The size of the pass' render target in pixels in xy, and its reciprocal in zw.
+	 *
+	 */
+	vec4 viewport;
+
+	/**
+	 * @brief The distances of the near and far clipping planes in xy, zw being unused.
+	 *
+	 */
+	vec4 clipPlanes;
+};
+
+class FrameUniforms {
+
+	private:
+		/**
+		 * @brief The uniform buffers holding the frame and pass data.
+		 *
+		 */
+		UniformBuffer * frameBuffer;
+		UniformBuffer * passBuffer;
+
+		/**
+		 * @brief The data last written to the uniform buffers.
+		 *
+		 */
+		FrameData frame;
+		PassData pass;
+
+	public:
+		/**
+		 * @brief Creates the frame and pass uniform buffers and binds them to the binding points shared by all shaders.
+		 * Must be called on the OpenGL thread.
+		 *
+		 */
+		FrameUniforms();
+
+		/**
+		 * @brief Deletes the uniform buffers.
+		 *
+		 */
+		~FrameUniforms();
+
+		/**
+		 * @brief Writes the frame data for the given camera, once per frame before drawing.
+		 *
+		 * @param cam The camera the frame is viewed from.
+		 * @param time The time elapsed since the first frame, in seconds.
+		 * @param delta The duration of the last frame, in seconds.
+		 * @return [FrameUniforms *] This same instance in order to allow for method chaining.
+		 */
+		FrameUniforms * update(Camera * cam, float time, float delta);
+
+		/**
+		 * @brief Writes the frame data for explicit camera matrices, for views that are not driven by a camera.
+		 *
+		 * @param view The view matrix.
+		 * @param projection The projection matrix.
+		 * @param position The camera's position in world space.
+		 * @param time The time elapsed since the first frame, in seconds.
+		 * @param delta The duration of the last frame, in seconds.
+		 * @return [FrameUniforms *] This same instance in order to allow for method chaining.
+		 */
+		FrameUniforms * update(const mat4 & view, const mat4 & projection, const vec3 & position, float time, float delta);
+
+		/**
+		 * @brief Writes the pass data, once per render pass before drawing it.
+		 *
+		 * @param width The width of the pass' render target in pixels.
+		 * @param height The height of the pass' render target in pixels.
+		 * @return [FrameUniforms *] This same instance in order to allow for method chaining.
+		 */
+		FrameUniforms * updatePass(float width, float height);
+
+		/**
+		 * @brief Returns the frame data last written, so the CPU side can reuse the camera matrices.
+		 *
+		 * @return [const FrameData &] The current frame data.
+		 */
+		inline const FrameData & getFrameData() const { return frame; };
+
+		/**
+		 * @brief Returns the pass data last written.
+		 *
+		 * @return [const PassData &] The current pass data.
+		 */
+		inline const PassData & getPassData() const { return pass; };
+
+};
@@ -0,0 +1,136 @@
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FRUSTUM_CULLER_SSE
+#endif
+
+#include "FrustumCuller.h"
+
+unsigned int CullingBounds::add(const vec3 & min, const vec3 & max) {
+	centerX.push_back(0.5f * (min.x + max.x));
+	centerY.push_back(0.5f * (min.y + max.y));
+	centerZ.push_back(0.5f * (min.z + max.z));
+	extentX.push_back(0.5f * (max.x - min.x));
+	extentY.push_back(0.5f * (max.y - min.y));
+	extentZ.push_back(0.5f * (max.z - min.z));
+	return size() - 1;
+}
+
+unsigned int CullingBounds::add(const vec3 & min, const vec3 & max, const mat4 & model) {
+
+	// The center moves with the matrix, each world extent sums the model extents scaled by the matrix' absolute entries.
+	vec3 center = 0.5f * (min + max);
+	vec3 extent = 0.5f * (max - min);
+	const float * m = model.m;
+	vec3 worldCenter = vec3(
+		m[0] * center.x + m[4] * center.y + m[8] * center.z + m[12],
+		m[1] * center.x + m[5] * center.y + m[9] * center.z + m[13],
+		m[2] * center.x + m[6] * center.y + m[10] * center.z + m[14]);
+	vec3 worldExtent = vec3(
+		std::fabs(m[0]) * extent.x + std::fabs(m[4]) * extent.y + std::fabs(m[8]) * extent.z,
+		std::fabs(m[1]) * extent.x + std::fabs(m[5]) * extent.y + std::fabs(m[9]) * extent.z,
+		std::fabs(m[2]) * extent.x + std::fabs(m[6]) * extent.y + std::fabs(m[10]) * extent.z);
+	return add(worldCenter - worldExtent, worldCenter + worldExtent);
+}
+
+void CullingBounds::clear() {
+	centerX.clear();
+	centerY.clear();
+	centerZ.clear();
+	extentX.clear();
+	extentY.clear();
+	extentZ.clear();
+}
+
+FrustumCuller::FrustumCuller(JobSystem * jobs) : jobs(jobs) {}
+
+FrustumCuller * FrustumCuller::cull(const Frustum & frustum, const CullingBounds & bounds) {
+	unsigned int count = bounds.size();
+	flags.resize(count);
+
+	// Split large sets into jobs writing disjoint ranges of the flags.
+	if (jobs != nullptr && count >= PARALLEL_THRESHOLD) {
+		unsigned char * output = flags.data();
+		jobs->parallelFor(0, count, [&frustum, &bounds, output](unsigned int begin, unsigned int end) {
+			cullRange(frustum, bounds, begin, end, output);
+		}, PARALLEL_CHUNK);
+	}
+	else
+		cullRange(frustum, bounds, 0, count, flags.data());
+
+	visible.clear();
+	for (unsigned int i = 0; i < count; i++)
+		if (flags[i])
+			visible.push_back(i);
+	return this;
+}
+
+void FrustumCuller::cullRange(const Frustum & frustum, const CullingBounds & bounds, unsigned int begin, unsigned int end, unsigned char * flags) {
+	const float * cx = bounds.centerX.data();
+	const float * cy = bounds.centerY.data();
+	const float * cz = bounds.centerZ.data();
+	const float * ex = bounds.extentX.data();
+	const float * ey = bounds.extentY.data();
+	const float * ez = bounds.extentZ.data();
+	unsigned int i = begin;
+
+	// A box is outside when its center lies farther behind any plane than its extent projected on the plane's normal.
+#if defined(__AVX__)
+	const __m256 signMask = _mm256_set1_ps(-0.0f);
+	for (; i + 8 <= end; i += 8) {
+		__m256 outside = _mm256_setzero_ps();
+		for (const vec4 & plane : frustum.planes) {
+			__m256 nx = _mm256_set1_ps(plane.x), ny = _mm256_set1_ps(plane.y), nz = _mm256_set1_ps(plane.z);
+			__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(nx, _mm256_loadu_ps(cx + i)),
+				_mm256_mul_ps(ny, _mm256_loadu_ps(cy + i))),
+				_mm256_mul_ps(nz, _mm256_loadu_ps(cz + i))),
+				_mm256_set1_ps(plane.w));
+			__m256 radius = _mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(_mm256_andnot_ps(signMask, nx), _mm256_loadu_ps(ex + i)),
+				_mm256_mul_ps(_mm256_andnot_ps(signMask, ny), _mm256_loadu_ps(ey + i))),
+				_mm256_mul_ps(_mm256_andnot_ps(signMask, nz), _mm256_loadu_ps(ez + i)));
+			outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_xor_ps(radius, signMask), _CMP_LT_OQ));
+		}
+		int mask = _mm256_movemask_ps(outside);
+		for (unsigned int lane = 0; lane < 8; lane++)
+			flags[i + lane] = (mask >> lane & 1) ^ 1;
+	}
+#elif defined(FRUSTUM_CULLER_SSE)
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	for (; i + 4 <= end; i += 4) {
+		__m128 outside = _mm_setzero_ps();
+		for (const vec4 & plane : frustum.planes) {
+			__m128 nx = _mm_set1_ps(plane.x), ny = _mm_set1_ps(plane.y), nz = _mm_set1_ps(plane.z);
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(nx, _mm_loadu_ps(cx + i)),
+				_mm_mul_ps(ny, _mm_loadu_ps(cy + i))),
+				_mm_mul_ps(nz, _mm_loadu_ps(cz + i))),
+				_mm_set1_ps(plane.w));
+			__m128 radius = _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_andnot_ps(signMask, nx), _mm_loadu_ps(ex + i)),
+				_mm_mul_ps(_mm_andnot_ps(signMask, ny), _mm_loadu_ps(ey + i))),
+				_mm_mul_ps(_mm_andnot_ps(signMask, nz), _mm_loadu_ps(ez + i)));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_xor_ps(radius, signMask)));
+		}
+		int mask = _mm_movemask_ps(outside);
+		for (unsigned int lane = 0; lane < 4; lane++)
+			flags[i + lane] = (mask >> lane & 1) ^ 1;
+	}
+#endif
+
+	// Remaining boxes, or all of them without SIMD support.
+	for (; i < end; i++) {
+		unsigned char inside = 1;
+		for (const vec4 & plane : frustum.planes) {
+			float distance = plane.x * cx[i] + plane.y * cy[i] + plane.z * cz[i] + plane.w;
+			float radius = std::fabs(plane.x) * ex[i] + std::fabs(plane.y) * ey[i] + std::fabs(plane.z) * ez[i];
+			if (distance < -radius)
+				inside = 0;
+		}
+		flags[i] = inside;
+	}
+}
@@ -0,0 +1,126 @@
+#include <vector>
+
+#include "../math/GLVector.h"
+#include "../math/GLMatrix.h"
+#include "../camera/Frustum.h"
+#include "../utils/JobSystem.h"
+
+using namespace glmath;
+using std::vector;
+
+#pragma once
+
+/**
+ * @brief World space axis-aligned bounding boxes stored as structures of arrays, centers and half extents per axis,
+ * so the culling kernel loads the same coordinate of consecutive boxes at once.
+ *
+ */
+struct CullingBounds {
+	vector<float> centerX, centerY, centerZ;
+	vector<float> extentX, extentY, extentZ;
+
+	/**
+	 * @brief Appends a box.
+	 *
+	 * @param min The box's minimum corner in world space.
+	 * @param max The box's maximum corner in world space.
+	 * @return [unsigned int] The index of the box.
+	 */
+	unsigned int add(const vec3 & min, const vec3 & max);
+
+	/**
+	 * @brief Appends the world space box enclosing a model space box moved by a model matrix.
+	 *
+	 * @param min The box's minimum corner in model space.
+	 * @param max The box's maximum corner in model space.
+	 * @param model The model matrix.
+	 * @return [unsigned int] The index of the box.
+	 */
+	unsigned int add(const vec3 & min, const vec3 & max, const mat4 & model);
+
+	/**
+	 * @brief Removes every box.
+	 *
+	 */
+	void clear();
+
+	/**
+	 * @brief Returns the number of boxes.
+	 *
+	 * @return [unsigned int] The number of boxes.
+	 */
+	inline unsigned int size() const { return static_cast<unsigned int>(centerX.size()); };
+};
+
+class FrustumCuller {
+
+	private:
+		/**
+		 * @brief The visibility of each box tested last, 1 if visible and 0 if culled.
+		 *
+		 */
+		vector<unsigned char> flags;
+
+		/**
+		 * @brief The indices of the boxes found visible last, in increasing order.
+		 *
+		 */
+		vector<unsigned int> visible;
+
+		/**
+		 * @brief The job system culling large sets of boxes in parallel, null to always cull on the calling thread.
+		 *
+		 */
+		JobSystem * jobs;
+
+	public:
+		/**
+		 * @brief The number of boxes from which culling is split across the job system, and the number of boxes of each job.
+		 *
+		 */
+		static const unsigned int PARALLEL_THRESHOLD = 16384;
+		static const unsigned int PARALLEL_CHUNK = 4096;
+
+		/**
+		 * @brief Creates a frustum culler.
+		 *
+		 * @param jobs [Optional] The job system used to cull large sets of boxes in parallel.
+		 */
+		FrustumCuller(JobSystem * jobs = nullptr);
+
+		/**
+		 * @brief Tests every box against a frustum, keeping the indices of the visible ones.
+		 *
+		 * @param frustum The frustum in world space, such as the one created by the camera.
+		 * @param bounds The boxes to test.
+		 * @return [FrustumCuller *] This same culler instance in order to allow for method chaining.
+		 */
+		FrustumCuller * cull(const Frustum & frustum, const CullingBounds & bounds);
+
+		/**
+		 * @brief Returns the indices of the boxes found visible by the last cull.
+		 *
+		 * @return [const vector<unsigned int> &] The visible box indices, in increasing order.
+		 */
+		inline const vector<unsigned int> & getVisible() const { return visible; };
+
+		/**
+		 * @brief Returns the visibility of each box tested by the last cull.
+		 *
+		 * @return [const vector<unsigned char> &] 1 for each visible box and 0 for each culled one.
+		 */
+		inline const vector<unsigned char> & getFlags() const { return flags; };
+
+		/**
+		 * @brief Tests a range of boxes against a frustum, 8 or 4 boxes at a time depending on the instruction set the engine is built for.
+		 * Results match Frustum::intersectsBox.
+		 *
+		 * @param frustum The frustum in world space.
+		 * @param bounds The boxes to test.
+		 * @param begin The index of the first box to test.
+		 * @param end The index following the last box to test.
+		 * @param flags Receives 1 for each visible box and 0 for each culled one, indexed like the boxes.
+		 */
+		static void cullRange(const Frustum & frustum, const CullingBounds & bounds, unsigned int begin, unsigned int end, unsigned char * flags);
+
+};
@@ -0,0 +1,206 @@
+#include "GLStateCache.h"
+
+GLStateCache::GLStateCache() {
+	invalidate();
+}
+
+int GLStateCache::getBufferTargetIndex(GLenum target) {
+	switch (target) {
+		case GL_ARRAY_BUFFER:
+			return 0;
+		case GL_UNIFORM_BUFFER:
+			return 1;
+		case GL_PIXEL_UNPACK_BUFFER:
+			return 2;
+		case GL_PIXEL_PACK_BUFFER:
+			return 3;
+		case GL_DRAW_INDIRECT_BUFFER:
+			return 4;
+		case GL_COPY_WRITE_BUFFER:
+			return 5;
+		default:
+			return -1;
+	}
+}
+
+int GLStateCache::getTextureTargetIndex(GLenum target) {
+	switch (target) {
+		case GL_TEXTURE_2D:
+			return 0;
+		case GL_TEXTURE_2D_ARRAY:
+			return 1;
+		case GL_TEXTURE_2D_MULTISAMPLE:
+			return 2;
+		case GL_TEXTURE_CUBE_MAP:
+			return 3;
+		case GL_TEXTURE_3D:
+			return 4;
+		default:
+			return -1;
+	}
+}
+
+int GLStateCache::getCapabilityIndex(GLenum capability) {
+	switch (capability) {
+		case GL_BLEND:
+			return 0;
+		case GL_DEPTH_TEST:
+			return 1;
+		case GL_CULL_FACE:
+			return 2;
+		case GL_SCISSOR_TEST:
+			return 3;
+		case GL_STENCIL_TEST:
+			return 4;
+		case GL_PRIMITIVE_RESTART:
+			return 5;
+		default:
+			return -1;
+	}
+}
+
+void GLStateCache::useProgram(unsigned int id) {
+	if (update(program, id))
+		glUseProgram(id);
+}
+
+void GLStateCache::bindVertexArray(unsigned int id) {
+	if (update(vertexArray, id))
+		glBindVertexArray(id);
+}
+
+void GLStateCache::bindBuffer(GLenum target, unsigned int id) {
+	int index = getBufferTargetIndex(target);
+	unsigned int unknown = UNKNOWN;
+	if (update(index >= 0 ? buffers[index] : unknown, id))
+		glBindBuffer(target, id);
+}
+
+void GLStateCache::activeTexture(unsigned int unit) {
+	if (update(activeUnit, unit))
+		glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLStateCache::bindTexture(GLenum target, unsigned int id) {
+	int index = getTextureTargetIndex(target);
+	unsigned int unknown = UNKNOWN;
+	if (update(index >= 0 && activeUnit < MAX_TEXTURE_UNITS ? textures[activeUnit][index] : unknown, id))
+		glBindTexture(target, id);
+}
+
+void GLStateCache::bindTextureUnit(unsigned int unit, GLenum target, unsigned int id) {
+
+	// Only switch units when a bind is needed, the active unit does not matter for sampling.
+	int index = getTextureTargetIndex(target);
+	if (index >= 0 && unit < MAX_TEXTURE_UNITS && textures[unit][index] == id && id != UNKNOWN) {
+		if (counting)
+			filtered++;
+		return;
+	}
+	activeTexture(unit);
+	bindTexture(target, id);
+}
+
+void GLStateCache::bindFramebuffer(GLenum target, unsigned int id) {
+	bool changed;
+	if (target == GL_READ_FRAMEBUFFER)
+		changed = readFramebuffer != id;
+	else if (target == GL_DRAW_FRAMEBUFFER)
+		changed = drawFramebuffer != id;
+	else
+		changed = readFramebuffer != id || drawFramebuffer != id;
+	if (target != GL_DRAW_FRAMEBUFFER)
+		readFramebuffer = id;
+	if (target != GL_READ_FRAMEBUFFER)
+		drawFramebuffer = id;
+	if (counting)
+		(changed ? issued : filtered)++;
+	if (changed)
+		glBindFramebuffer(target, id);
+}
+
+void GLStateCache::setEnabled(GLenum capability, bool enabled) {
+	int index = getCapabilityIndex(capability);
+	unsigned int unknown = UNKNOWN;
+	if (update(index >= 0 ? capabilities[index] : unknown, enabled ? 1 : 0)) {
+		if (enabled)
+			glEnable(capability);
+		else
+			glDisable(capability);
+	}
+}
+
+void GLStateCache::blendFunc(GLenum src, GLenum dst) {
+	if (update(blendFactors, (src << 16) | (dst & 0xFFFF)))
+		glBlendFunc(src, dst);
+}
+
+void GLStateCache::setDepthFunc(GLenum func) {
+	if (update(depthFunc, func))
+		glDepthFunc(func);
+}
+
+void GLStateCache::setDepthMask(bool enabled) {
+	if (update(depthMask, enabled ? 1 : 0))
+		glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void GLStateCache::setCullFace(GLenum mode) {
+	if (update(cullFace, mode))
+		glCullFace(mode);
+}
+
+void GLStateCache::deleteProgram(unsigned int id) {
+
+	// A program in use stays in use after being deleted, until another one replaces it.
+	if (program == id)
+		program = UNKNOWN;
+	glDeleteProgram(id);
+}
+
+void GLStateCache::deleteVertexArray(unsigned int id) {
+	if (vertexArray == id)
+		vertexArray = 0;
+	glDeleteVertexArrays(1, &id);
+}
+
+void GLStateCache::deleteBuffer(unsigned int id) {
+	for (unsigned int & buffer : buffers)
+		if (buffer == id)
+			buffer = 0;
+	glDeleteBuffers(1, &id);
+}
+
+void GLStateCache::deleteTexture(unsigned int id) {
+	for (auto & unit : textures)
+		for (unsigned int & texture : unit)
+			if (texture == id)
+				texture = 0;
+	glDeleteTextures(1, &id);
+}
+
+void GLStateCache::deleteFramebuffer(unsigned int id) {
+	if (readFramebuffer == id)
+		readFramebuffer = 0;
+	if (drawFramebuffer == id)
+		drawFramebuffer = 0;
+	glDeleteFramebuffers(1, &id);
+}
+
+void GLStateCache::invalidate() {
+	program = vertexArray = activeUnit = UNKNOWN;
+	readFramebuffer = drawFramebuffer = UNKNOWN;
+	blendFactors = depthFunc = depthMask = cullFace = UNKNOWN;
+	for (unsigned int & buffer : buffers)
+		buffer = UNKNOWN;
+	for (auto & unit : textures)
+		for (unsigned int & texture : unit)
+			texture = UNKNOWN;
+	for (unsigned int & capability : capabilities)
+		capability = UNKNOWN;
+}
+
+GLStateCache * GLStateCache::getShared() {
+	static GLStateCache shared;
+	return &shared;
+}
@@ -0,0 +1,246 @@
+#include <glad/glad.h>
+
+#pragma once
+class GLStateCache {
+
+	private:
+		/**
+		 * @brief The value of a binding or setting not known to the cache, which is always forwarded to OpenGL.
+		 *
+		 */
+		static const unsigned int UNKNOWN = 0xFFFFFFFF;
+
+		/**
+		 * @brief The number of texture units, buffer targets, texture targets and capabilities shadowed.
+		 * Calls for units, targets and capabilities not shadowed are always forwarded to OpenGL.
+		 *
+		 */
+		static const unsigned int MAX_TEXTURE_UNITS = 32;
+		static const unsigned int BUFFER_TARGETS = 6;
+		static const unsigned int TEXTURE_TARGETS = 5;
+		static const unsigned int CAPABILITIES = 6;
+
+		/**
+		 * @brief The current program and vertex array.
+		 *
+		 */
+		unsigned int program;
+		unsigned int vertexArray;
+
+		/**
+		 * @brief The buffer bound to each shadowed target. The element array buffer is vertex array state and is not shadowed.
+		 *
+		 */
+		unsigned int buffers[BUFFER_TARGETS];
+
+		/**
+		 * @brief The active texture unit, and the texture bound to each target of each unit.
+		 *
+		 */
+		unsigned int activeUnit;
+		unsigned int textures[MAX_TEXTURE_UNITS][TEXTURE_TARGETS];
+
+		/**
+		 * @brief The framebuffers bound for reading and drawing.
+		 *
+		 */
+		unsigned int readFramebuffer;
+		unsigned int drawFramebuffer;
+
+		/**
+		 * @brief Whether each shadowed capability is enabled, 0 or 1, or UNKNOWN.
+		 *
+		 */
+		unsigned int capabilities[CAPABILITIES];
+
+		/**
+		 * @brief Blending, depth and face culling settings. Both blending factors are packed together, the source one in the high bits.
+		 *
+		 */
+		unsigned int blendFactors;
+		unsigned int depthFunc;
+		unsigned int depthMask;
+		unsigned int cullFace;
+
+		/**
+		 * @brief Whether or not calls are counted, and the number of calls forwarded to OpenGL and filtered out since the counters were reset.
+		 *
+		 */
+		bool counting = false;
+		unsigned long long issued = 0;
+		unsigned long long filtered = 0;
+
+		/**
+		 * @brief Constructs a new state cache, with no state known.
+		 *
+		 */
+		GLStateCache();
+
+		/**
+		 * @brief Compares a shadowed value with a new one, storing the new one if they differ.
+		 *
+		 * @return [bool] True if the call must reach OpenGL, false if it is redundant.
+		 */
+		inline bool update(unsigned int & shadow, unsigned int value) {
+			bool changed = shadow != value || value == UNKNOWN;
+			shadow = value;
+			if (counting)
+				(changed ? issued : filtered)++;
+			return changed;
+		}
+
+		/**
+		 * @brief Returns the index of a shadowed buffer target, texture target or capability, or -1 if it is not shadowed.
+		 *
+		 */
+		static int getBufferTargetIndex(GLenum target);
+		static int getTextureTargetIndex(GLenum target);
+		static int getCapabilityIndex(GLenum capability);
+
+	public:
+		/**
+		 * @brief Binds a program, unless it is already in use.
+		 *
+		 * @param id The OpenGL program ID.
+		 */
+		void useProgram(unsigned int id);
+
+		/**
+		 * @brief Binds a vertex array, unless it is already bound.
+		 *
+		 * @param id The OpenGL vertex array ID.
+		 */
+		void bindVertexArray(unsigned int id);
+
+		/**
+		 * @brief Binds a buffer to a target, unless it is already bound to it.
+		 *
+		 * @param target The buffer target. (GL_ARRAY_BUFFER, GL_UNIFORM_BUFFER, etc...)
+		 * @param id The OpenGL buffer ID.
+		 */
+		void bindBuffer(GLenum target, unsigned int id);
+
+		/**
+		 * @brief Selects the active texture unit, unless it is already active.
+		 *
+		 * @param unit The texture unit, starting at 0 for GL_TEXTURE0.
+		 */
+		void activeTexture(unsigned int unit);
+
+		/**
+		 * @brief Binds a texture to a target of the active texture unit, unless it is already bound to it.
+		 * Used to bind textures for modification.
+		 *
+		 * @param target The texture target. (GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, etc...)
+		 * @param id The OpenGL texture ID.
+		 */
+		void bindTexture(GLenum target, unsigned int id);
+
+		/**
+		 * @brief Binds a texture to a target of the given texture unit, unless it is already bound to it.
+		 * Used to bind textures for sampling, the unit is only activated if the texture must be bound.
+		 *
+		 * @param unit The texture unit, starting at 0 for GL_TEXTURE0.
+		 * @param target The texture target. (GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, etc...)
+		 * @param id The OpenGL texture ID.
+		 */
+		void bindTextureUnit(unsigned int unit, GLenum target, unsigned int id);
+
+		/**
+		 * @brief Binds a framebuffer, unless it is already bound.
+		 *
+		 * @param target The framebuffer target. (GL_FRAMEBUFFER, GL_READ_FRAMEBUFFER or GL_DRAW_FRAMEBUFFER)
+		 * @param id The OpenGL framebuffer ID, 0 for the display.
+		 */
+		void bindFramebuffer(GLenum target, unsigned int id);
+
+		/**
+		 * @brief Enables or disables a capability, unless it is already in that state.
+		 *
+		 * @param capability The capability. (GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, etc...)
+		 * @param enabled Whether to enable or disable the capability.
+		 */
+		void setEnabled(GLenum capability, bool enabled);
+
+		/**
+		 * @brief Sets the blending factors, unless they are already set.
+		 *
+		 * @param src The source factor.
+		 * @param dst The destination factor.
+		 */
+		void blendFunc(GLenum src, GLenum dst);
+
+		/**
+		 * @brief Sets the depth comparison function, unless it is already set.
+		 *
+		 * @param func The comparison function. (GL_LESS, GL_LEQUAL, etc...)
+		 */
+		void setDepthFunc(GLenum func);
+
+		/**
+		 * @brief Enables or disables writing to the depth buffer, unless it is already in that state.
+		 *
+		 * @param enabled Whether or not depth values are written.
+		 */
+		void setDepthMask(bool enabled);
+
+		/**
+		 * @brief Sets the faces culled when face culling is enabled, unless they are already set.
+		 *
+		 * @param mode The culled faces. (GL_BACK, GL_FRONT or GL_FRONT_AND_BACK)
+		 */
+		void setCullFace(GLenum mode);
+
+		/**
+		 * @brief Deletes OpenGL objects, forgetting their bindings since their IDs can be reused by new objects.
+		 * Objects bound through the cache must be deleted through it.
+		 *
+		 * @param id The OpenGL ID of the object to delete.
+		 */
+		void deleteProgram(unsigned int id);
+		void deleteVertexArray(unsigned int id);
+		void deleteBuffer(unsigned int id);
+		void deleteTexture(unsigned int id);
+		void deleteFramebuffer(unsigned int id);
+
+		/**
+		 * @brief Forgets the whole shadowed state, for when OpenGL state was changed without going through the cache.
+		 *
+		 */
+		void invalidate();
+
+		/**
+		 * @brief Starts or stops counting the calls forwarded to OpenGL and filtered out. Meant for debugging.
+		 *
+		 * @param counting Whether or not to count calls.
+		 */
+		inline void setCounting(bool counting) { this->counting = counting; };
+
+		/**
+		 * @brief Resets the call counters.
+		 *
+		 */
+		inline void resetCounters() { issued = filtered = 0; };
+
+		/**
+		 * @brief Returns the number of calls forwarded to OpenGL since the counters were reset, while counting.
+		 *
+		 * @return [unsigned long long] The number of calls issued.
+		 */
+		inline unsigned long long getIssued() const { return issued; };
+
+		/**
+		 * @brief Returns the number of redundant calls filtered out since the counters were reset, while counting.
+		 *
+		 * @return [unsigned long long] The number of calls that never reached OpenGL.
+		 */
+		inline unsigned long long getFiltered() const { return filtered; };
+
+		/**
+		 * @brief Returns the state cache of the OpenGL context. Must only be used on the OpenGL thread.
+		 *
+		 * @return [GLStateCache *] The shared state cache.
+		 */
+		static GLStateCache * getShared();
+
+};
@@ -0,0 +1,130 @@
+#include <cstddef>
+
+#include "MeshBatch.h"
+#include "GLStateCache.h"
+#include "ResourceManager.h"
+
+// The attribute lists copied into the shared buffers, and the size of their vertices.
+static const unsigned int ATTRIBUTES = 3;
+static const unsigned int ATTRIBUTE_SIZES[ATTRIBUTES] = { 3, 3, 2 };
+
+// Returns the size in bytes of a buffer's data.
+static GLint getBufferSize(GLenum target, unsigned int id) {
+	GLint size = 0;
+	GLStateCache::getShared()->bindBuffer(target, id);
+	glGetBufferParameteriv(target, GL_BUFFER_SIZE, &size);
+	return size;
+}
+
+MeshBatch::MeshBatch(bool allowIndirect) :
+	indirect(allowIndirect && glMultiDrawElementsIndirect != nullptr && GLAD_GL_ARB_base_instance) {}
+
+MeshBatch::~MeshBatch() {
+	if (vao != nullptr)
+		ResourceManager::getShared()->destroy(vao->getHandle());
+}
+
+unsigned int MeshBatch::add(Mesh * mesh) {
+	entries.push_back({ mesh, 0, 0 });
+	return static_cast<unsigned int>(entries.size()) - 1;
+}
+
+bool MeshBatch::build() {
+	GLStateCache * state = GLStateCache::getShared();
+
+	// Place each mesh's vertices and indices after the previous mesh's.
+	GLint vertices = 0, indices = 0;
+	for (Entry & entry : entries) {
+		VAO * source = entry.mesh->getVAO();
+		if (source->getIndexVBO() == nullptr)
+			return false;
+		for (unsigned int a = 0; a < ATTRIBUTES; a++)
+			if (source->getVBO(a) == nullptr)
+				return false;
+		entry.baseVertex = vertices;
+		entry.firstIndex = indices;
+		vertices += getBufferSize(GL_COPY_READ_BUFFER, source->getVBO(0)->getID()) / static_cast<GLint>(3 * sizeof(float));
+		indices += getBufferSize(GL_COPY_READ_BUFFER, source->getIndexVBO()->getID()) / static_cast<GLint>(sizeof(unsigned int));
+	}
+
+	// Allocate the shared buffers, then copy each mesh in on the GPU. Frames still in flight may draw from the previous ones.
+	if (vao != nullptr)
+		ResourceManager::getShared()->destroy(vao->getHandle());
+	vao = VAO::create()->bind();
+	vao->storeIndices(nullptr, indices * sizeof(unsigned int), GL_STATIC_DRAW);
+	for (unsigned int a = 0; a < ATTRIBUTES; a++)
+		vao->storeData(a, nullptr, vertices * ATTRIBUTE_SIZES[a] * sizeof(float), ATTRIBUTE_SIZES[a], GL_FLOAT, GL_STATIC_DRAW);
+	vao->unbind();
+
+	for (const Entry & entry : entries) {
+		VAO * source = entry.mesh->getVAO();
+		for (unsigned int a = 0; a < ATTRIBUTES; a++) {
+			GLint size = getBufferSize(GL_COPY_READ_BUFFER, source->getVBO(a)->getID());
+			state->bindBuffer(GL_COPY_WRITE_BUFFER, vao->getVBO(a)->getID());
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, entry.baseVertex * ATTRIBUTE_SIZES[a] * sizeof(float), size);
+		}
+		GLint size = getBufferSize(GL_COPY_READ_BUFFER, source->getIndexVBO()->getID());
+		state->bindBuffer(GL_COPY_WRITE_BUFFER, vao->getIndexVBO()->getID());
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, entry.firstIndex * sizeof(unsigned int), size);
+	}
+	return true;
+}
+
+MeshBatch * MeshBatch::draw(MeshShader * shader, const MeshBatchDraw * draws, const unsigned int * visible, unsigned int count) {
+	if (vao == nullptr || count == 0)
+		return this;
+	vao->bind();
+
+	// Draw in a loop, the model matrix of each draw going through the uniform.
+	if (!indirect) {
+		shader->loadInstanced(false);
+		for (unsigned int i = 0; i < count; i++) {
+			const MeshBatchDraw & object = draws[visible != nullptr ? visible[i] : i];
+			const Entry & entry = entries[object.mesh];
+			const MeshLOD & lod = entry.mesh->getLOD(object.lod);
+			shader->loadModelMatrix(object.instance.model);
+			glDrawElementsBaseVertex(GL_TRIANGLES, lod.indexCount, GL_UNSIGNED_INT,
+				reinterpret_cast<void*>(static_cast<size_t>(entry.firstIndex + lod.indexOffset) * sizeof(unsigned int)), entry.baseVertex);
+		}
+		return this;
+	}
+
+	// Compact the visible objects into instances followed by commands, in a single allocation so both stay valid until the draw is fenced.
+	// The base instance of each command selects its instance.
+	StreamBuffer * stream = StreamBuffer::getShared();
+	size_t instanceOffset;
+	MeshInstance * instances = static_cast<MeshInstance *>(
+		stream->allocate(count * (sizeof(MeshInstance) + sizeof(DrawElementsIndirectCommand)), sizeof(MeshInstance), instanceOffset));
+	if (instances == nullptr)
+		return this;
+	DrawElementsIndirectCommand * commands = reinterpret_cast<DrawElementsIndirectCommand *>(instances + count);
+	size_t commandOffset = instanceOffset + count * sizeof(MeshInstance);
+	for (unsigned int i = 0; i < count; i++) {
+		const MeshBatchDraw & object = draws[visible != nullptr ? visible[i] : i];
+		const Entry & entry = entries[object.mesh];
+		const MeshLOD & lod = entry.mesh->getLOD(object.lod);
+		commands[i] = { lod.indexCount, 1, entry.firstIndex + lod.indexOffset, static_cast<int>(entry.baseVertex), i };
+		instances[i] = object.instance;
+	}
+	stream->commit();
+
+	// Point the instance attributes at the instances written.
+	GLStateCache::getShared()->bindBuffer(GL_ARRAY_BUFFER, stream->getID());
+	GLsizei stride = sizeof(MeshInstance);
+	for (unsigned int column = 0; column < 4; column++) {
+		glVertexAttribPointer(Mesh::INSTANCE_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(instanceOffset + offsetof(MeshInstance, model) + column * 4 * sizeof(float)));
+		glVertexAttribDivisor(Mesh::INSTANCE_ATTRIBUTE + column, 1);
+		glEnableVertexAttribArray(Mesh::INSTANCE_ATTRIBUTE + column);
+	}
+	glVertexAttribPointer(Mesh::INSTANCE_ATTRIBUTE + 4, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(instanceOffset + offsetof(MeshInstance, tint)));
+	glVertexAttribDivisor(Mesh::INSTANCE_ATTRIBUTE + 4, 1);
+	glEnableVertexAttribArray(Mesh::INSTANCE_ATTRIBUTE + 4);
+	glVertexAttribIPointer(Mesh::INSTANCE_ATTRIBUTE + 5, 1, GL_UNSIGNED_INT, stride, reinterpret_cast<void*>(instanceOffset + offsetof(MeshInstance, paletteOffset)));
+	glVertexAttribDivisor(Mesh::INSTANCE_ATTRIBUTE + 5, 1);
+	glEnableVertexAttribArray(Mesh::INSTANCE_ATTRIBUTE + 5);
+
+	shader->loadInstanced(true);
+	GLStateCache::getShared()->bindBuffer(GL_DRAW_INDIRECT_BUFFER, stream->getID());
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<void*>(commandOffset), count, 0);
+	return this;
+}
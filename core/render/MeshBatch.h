@@ -0,0 +1,121 @@
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "../objects/Mesh.h"
+#include "../objects/StreamBuffer.h"
+#include "../shaders/MeshShader.h"
+
+using std::vector;
+
+#pragma once
+
+/**
+ * @brief A single indexed draw read by glMultiDrawElementsIndirect, laid out as OpenGL expects it.
+ *
+ */
+struct DrawElementsIndirectCommand {
+	unsigned int count;
+	unsigned int instanceCount;
+	unsigned int firstIndex;
+	int baseVertex;
+	unsigned int baseInstance;
+};
+
+/**
+ * @brief An object drawn from a mesh batch: one of its meshes, at a level of detail, with its own instance data.
+ *
+ */
+struct MeshBatchDraw {
+	unsigned int mesh;
+	unsigned int lod;
+	MeshInstance instance;
+};
+
+class MeshBatch {
+
+	private:
+		/**
+		 * @brief Where a mesh's vertices and indices start in the shared buffers.
+		 *
+		 */
+		struct Entry {
+			Mesh * mesh;
+			unsigned int baseVertex;
+			unsigned int firstIndex;
+		};
+
+		/**
+		 * @brief The meshes of the batch, in the order they were added.
+		 *
+		 */
+		vector<Entry> entries;
+
+		/**
+		 * @brief The vertex array reading the shared buffers, null until the batch is built.
+		 *
+		 */
+		VAO * vao = nullptr;
+
+		/**
+		 * @brief Whether draws are submitted with a single glMultiDrawElementsIndirect, or with a glDrawElementsBaseVertex per draw.
+		 *
+		 */
+		bool indirect;
+
+	public:
+		/**
+		 * @brief Creates an empty mesh batch, using multi-draw indirect when the context supports it and if allowed.
+		 *
+		 * @param allowIndirect [Optional] Whether multi-draw indirect may be used, false to always draw in a loop.
+		 */
+		MeshBatch(bool allowIndirect = true);
+
+		/**
+		 * @brief Deletes the shared buffers.
+		 *
+		 */
+		~MeshBatch();
+
+		/**
+		 * @brief Adds a static mesh to the batch, before it is built. Skeletal meshes are drawn in their bind pose.
+		 *
+		 * @param mesh The mesh to add, which must stay alive until the batch is built.
+		 * @return [unsigned int] The index of the mesh within the batch.
+		 */
+		unsigned int add(Mesh * mesh);
+
+		/**
+		 * @brief Copies the positions, normals, texture coordinates and indices of every mesh added into shared buffers on the GPU.
+		 *
+		 * @return [bool] True if the batch was built, false if a mesh lacks an attribute list or indices.
+		 */
+		bool build();
+
+		/**
+		 * @brief Draws visible objects of the batch, writing their commands and instances straight to the shared stream buffer.
+		 * The mesh shader must be in use.
+		 *
+		 * @param shader The mesh shader in use, which receives the model matrix of each draw when drawing in a loop.
+		 * @param draws The objects that may be drawn.
+		 * @param visible The indices of the visible objects in the draws, or null to draw them all.
+		 * @param count The number of visible objects, or of objects if all are drawn.
+		 * @return [MeshBatch *] This same mesh batch instance in order to allow for method chaining.
+		 */
+		MeshBatch * draw(MeshShader * shader, const MeshBatchDraw * draws, const unsigned int * visible, unsigned int count);
+
+		/**
+		 * @brief Returns whether draws go through multi-draw indirect.
+		 *
+		 * @return [bool] True if the batch submits its draws with a single glMultiDrawElementsIndirect.
+		 */
+		inline bool isIndirect() const { return indirect; };
+
+		/**
+		 * @brief Returns the number of meshes in the batch.
+		 *
+		 * @return [unsigned int] The number of meshes added.
+		 */
+		inline unsigned int getMeshCount() const { return static_cast<unsigned int>(entries.size()); };
+
+};
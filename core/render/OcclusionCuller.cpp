@@ -0,0 +1,250 @@
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OCCLUSION_CULLER_SSE
+#endif
+
+#include "OcclusionCuller.h"
+
+// Transforms a point to clip space.
+static inline vec4 toClip(const float * m, float x, float y, float z) {
+	return vec4(
+		m[0] * x + m[4] * y + m[8] * z + m[12],
+		m[1] * x + m[5] * y + m[9] * z + m[13],
+		m[2] * x + m[6] * y + m[10] * z + m[14],
+		m[3] * x + m[7] * y + m[11] * z + m[15]);
+}
+
+// Returns whether a clip space point lies in front of the near plane, where its projection is defined.
+static inline bool inFrontOfNear(const vec4 & clip) {
+	return clip.w > 0.0f && clip.z >= -clip.w;
+}
+
+OcclusionCuller::OcclusionCuller(unsigned int width, unsigned int height) : width((std::max(width, 4u) + 3) & ~3u), height(std::max(height, 1u)) {
+	unsigned int w = this->width, h = this->height;
+	while (true) {
+		levels.push_back(vector<float>(w * h, 1.0f));
+		levelWidths.push_back(w);
+		levelHeights.push_back(h);
+		if (w == 1 && h == 1)
+			break;
+		w = (w + 1) / 2;
+		h = (h + 1) / 2;
+	}
+}
+
+OcclusionCuller * OcclusionCuller::beginFrame(const mat4 & projView) {
+	this->projView = projView;
+	std::fill(levels[0].begin(), levels[0].end(), 1.0f);
+	return this;
+}
+
+OcclusionCuller * OcclusionCuller::addOccluder(const OccluderMesh & occluder, const mat4 & model) {
+	mat4 transform = projView * model;
+
+	// Project every vertex once, vertices behind the near plane disabling their triangles.
+	vector<vec3> screen(occluder.vertices.size());
+	vector<bool> valid(occluder.vertices.size());
+	for (size_t i = 0; i < occluder.vertices.size(); i++) {
+		const vec3 & vertex = occluder.vertices[i];
+		vec4 clip = toClip(transform.m, vertex.x, vertex.y, vertex.z);
+		valid[i] = inFrontOfNear(clip);
+		if (valid[i])
+			screen[i] = vec3(
+				(clip.x / clip.w * 0.5f + 0.5f) * width,
+				(clip.y / clip.w * 0.5f + 0.5f) * height,
+				clip.z / clip.w * 0.5f + 0.5f);
+	}
+
+	for (size_t i = 0; i + 2 < occluder.indices.size(); i += 3) {
+		unsigned int a = occluder.indices[i], b = occluder.indices[i + 1], c = occluder.indices[i + 2];
+		if (valid[a] && valid[b] && valid[c])
+			rasterizeTriangle(screen[a], screen[b], screen[c]);
+	}
+	return this;
+}
+
+void OcclusionCuller::rasterizeTriangle(const vec3 & v0, const vec3 & v1, const vec3 & v2) {
+
+	// Both windings are drawn, reordered counter-clockwise so covered pixels lie on the positive side of every edge.
+	float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+	if (area == 0.0f || std::isnan(area))
+		return;
+	const vec3 * p[3] = { &v0, area > 0.0f ? &v1 : &v2, area > 0.0f ? &v2 : &v1 };
+	area = std::fabs(area);
+
+	// Pixels the triangle may cover.
+	float lowX = std::min(std::min(v0.x, v1.x), v2.x), highX = std::max(std::max(v0.x, v1.x), v2.x);
+	float lowY = std::min(std::min(v0.y, v1.y), v2.y), highY = std::max(std::max(v0.y, v1.y), v2.y);
+	if (highX < 0.0f || highY < 0.0f || lowX >= width || lowY >= height)
+		return;
+	int minX = std::max(static_cast<int>(lowX), 0), maxX = std::min(static_cast<int>(highX), static_cast<int>(width) - 1);
+	int minY = std::max(static_cast<int>(lowY), 0), maxY = std::min(static_cast<int>(highY), static_cast<int>(height) - 1);
+
+	// The edge facing vertex i is a * x + b * y + c, its value over the area being the vertex's barycentric weight.
+	// Depth is interpolated with the same weights, so it is also a plane over the screen.
+	float a[3], b[3], c[3];
+	for (int i = 0; i < 3; i++) {
+		const vec3 & from = *p[(i + 1) % 3], & to = *p[(i + 2) % 3];
+		a[i] = from.y - to.y;
+		b[i] = to.x - from.x;
+		c[i] = from.x * to.y - from.y * to.x;
+	}
+	float depthA = (a[0] * p[0]->z + a[1] * p[1]->z + a[2] * p[2]->z) / area;
+	float depthB = (b[0] * p[0]->z + b[1] * p[1]->z + b[2] * p[2]->z) / area;
+	float depthC = (c[0] * p[0]->z + c[1] * p[1]->z + c[2] * p[2]->z) / area;
+
+	float * depth = levels[0].data();
+	for (int y = minY; y <= maxY; y++) {
+		float * row = depth + y * width;
+		float centerY = y + 0.5f;
+		int x = minX;
+
+		// Rows are padded to a multiple of 4 pixels, so aligning the start keeps every group of 4 inside the row.
+#if defined(OCCLUSION_CULLER_SSE)
+		const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		const __m128 zero = _mm_setzero_ps();
+		__m128 edgeA[3], edgeRow[3];
+		for (int i = 0; i < 3; i++) {
+			edgeA[i] = _mm_set1_ps(a[i]);
+			edgeRow[i] = _mm_set1_ps(b[i] * centerY + c[i]);
+		}
+		__m128 depthSlope = _mm_set1_ps(depthA), depthRow = _mm_set1_ps(depthB * centerY + depthC);
+		for (x = minX & ~3; x <= maxX; x += 4) {
+			__m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+			__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[0], centerX), edgeRow[0]), zero);
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[1], centerX), edgeRow[1]), zero));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[2], centerX), edgeRow[2]), zero));
+			if (_mm_movemask_ps(inside) == 0)
+				continue;
+			__m128 current = _mm_loadu_ps(row + x);
+			__m128 nearest = _mm_min_ps(current, _mm_add_ps(_mm_mul_ps(depthSlope, centerX), depthRow));
+			_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+		}
+#endif
+
+		// Remaining pixels, or all of them without SIMD support.
+		for (; x <= maxX; x++) {
+			float centerX = x + 0.5f;
+			if (a[0] * centerX + b[0] * centerY + c[0] >= 0.0f &&
+				a[1] * centerX + b[1] * centerY + c[1] >= 0.0f &&
+				a[2] * centerX + b[2] * centerY + c[2] >= 0.0f)
+				row[x] = std::min(row[x], depthA * centerX + depthB * centerY + depthC);
+		}
+	}
+}
+
+OcclusionCuller * OcclusionCuller::buildPyramid() {
+	for (size_t level = 1; level < levels.size(); level++) {
+		const float * source = levels[level - 1].data();
+		float * destination = levels[level].data();
+		unsigned int sourceWidth = levelWidths[level - 1], sourceHeight = levelHeights[level - 1];
+
+		// Each texel keeps the farthest of the texels it covers, the last row and column of odd sized levels covering a single one.
+		for (unsigned int y = 0; y < levelHeights[level]; y++) {
+			unsigned int y0 = 2 * y, y1 = std::min(2 * y + 1, sourceHeight - 1);
+			for (unsigned int x = 0; x < levelWidths[level]; x++) {
+				unsigned int x0 = 2 * x, x1 = std::min(2 * x + 1, sourceWidth - 1);
+				destination[y * levelWidths[level] + x] = std::max(
+					std::max(source[y0 * sourceWidth + x0], source[y0 * sourceWidth + x1]),
+					std::max(source[y1 * sourceWidth + x0], source[y1 * sourceWidth + x1]));
+			}
+		}
+	}
+	return this;
+}
+
+bool OcclusionCuller::isVisible(const vec3 & min, const vec3 & max) const {
+
+	// Clip space corners, from the minimum corner and the edges along each axis.
+	const float * m = projView.m;
+	float base[4], edges[3][4];
+	vec3 size = max - min;
+	for (int row = 0; row < 4; row++) {
+		base[row] = m[row] * min.x + m[4 + row] * min.y + m[8 + row] * min.z + m[12 + row];
+		edges[0][row] = m[row] * size.x;
+		edges[1][row] = m[4 + row] * size.y;
+		edges[2][row] = m[8 + row] * size.z;
+	}
+
+	// Screen space rectangle and nearest depth of the box's corners, corner i taking the edge along each axis whose bit is set in i.
+	float lowX, highX, lowY, highY, nearest;
+#if defined(OCCLUSION_CULLER_SSE)
+	const __m128 alongX = _mm_setr_ps(0.0f, 1.0f, 0.0f, 1.0f), alongY = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+	__m128 clip[2][4];
+	for (int row = 0; row < 4; row++) {
+		__m128 face = _mm_add_ps(_mm_set1_ps(base[row]),
+			_mm_add_ps(_mm_mul_ps(alongX, _mm_set1_ps(edges[0][row])), _mm_mul_ps(alongY, _mm_set1_ps(edges[1][row]))));
+		clip[0][row] = face;
+		clip[1][row] = _mm_add_ps(face, _mm_set1_ps(edges[2][row]));
+	}
+	__m128 low[3], high[3];
+	for (int half = 0; half < 2; half++) {
+		__m128 w = clip[half][3];
+		__m128 behind = _mm_or_ps(_mm_cmple_ps(w, _mm_setzero_ps()), _mm_cmplt_ps(clip[half][2], _mm_sub_ps(_mm_setzero_ps(), w)));
+		if (_mm_movemask_ps(behind) != 0)
+			return true;
+		__m128 scale = _mm_div_ps(_mm_set1_ps(0.5f), w);
+		__m128 ndc[3] = { _mm_mul_ps(clip[half][0], scale), _mm_mul_ps(clip[half][1], scale), _mm_mul_ps(clip[half][2], scale) };
+		for (int axis = 0; axis < 3; axis++) {
+			low[axis] = half == 0 ? ndc[axis] : _mm_min_ps(low[axis], ndc[axis]);
+			high[axis] = half == 0 ? ndc[axis] : _mm_max_ps(high[axis], ndc[axis]);
+		}
+	}
+	float lows[3][4], highs[3][4];
+	for (int axis = 0; axis < 3; axis++) {
+		_mm_storeu_ps(lows[axis], low[axis]);
+		_mm_storeu_ps(highs[axis], high[axis]);
+	}
+	lowX = (std::min(std::min(lows[0][0], lows[0][1]), std::min(lows[0][2], lows[0][3])) + 0.5f) * width;
+	highX = (std::max(std::max(highs[0][0], highs[0][1]), std::max(highs[0][2], highs[0][3])) + 0.5f) * width;
+	lowY = (std::min(std::min(lows[1][0], lows[1][1]), std::min(lows[1][2], lows[1][3])) + 0.5f) * height;
+	highY = (std::max(std::max(highs[1][0], highs[1][1]), std::max(highs[1][2], highs[1][3])) + 0.5f) * height;
+	nearest = std::min(std::min(lows[2][0], lows[2][1]), std::min(lows[2][2], lows[2][3])) + 0.5f;
+#else
+	lowX = static_cast<float>(width), highX = 0.0f, lowY = static_cast<float>(height), highY = 0.0f, nearest = 1.0f;
+	for (unsigned int i = 0; i < 8; i++) {
+		float clip[4];
+		for (int row = 0; row < 4; row++)
+			clip[row] = base[row] + (i & 1 ? edges[0][row] : 0.0f) + (i & 2 ? edges[1][row] : 0.0f) + (i & 4 ? edges[2][row] : 0.0f);
+		if (clip[3] <= 0.0f || clip[2] < -clip[3])
+			return true;
+		float scale = 0.5f / clip[3];
+		lowX = std::min(lowX, (clip[0] * scale + 0.5f) * width);
+		highX = std::max(highX, (clip[0] * scale + 0.5f) * width);
+		lowY = std::min(lowY, (clip[1] * scale + 0.5f) * height);
+		highY = std::max(highY, (clip[1] * scale + 0.5f) * height);
+		nearest = std::min(nearest, clip[2] * scale + 0.5f);
+	}
+#endif
+	if (highX < 0.0f || highY < 0.0f || lowX >= width || lowY >= height)
+		return false;
+
+	// Clamp before converting, boxes just past the near plane project far outside the range of an unsigned int.
+	unsigned int x0 = static_cast<unsigned int>(std::max(lowX, 0.0f)), x1 = static_cast<unsigned int>(std::min(highX, static_cast<float>(width - 1)));
+	unsigned int y0 = static_cast<unsigned int>(std::max(lowY, 0.0f)), y1 = static_cast<unsigned int>(std::min(highY, static_cast<float>(height - 1)));
+
+	// Climb to the level where the rectangle spans at most 2 by 2 texels.
+	unsigned int level = 0;
+	while (level + 1 < levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+		level++;
+
+	const vector<float> & texels = levels[level];
+	for (unsigned int y = y0 >> level; y <= y1 >> level; y++)
+		for (unsigned int x = x0 >> level; x <= x1 >> level; x++)
+			if (texels[y * levelWidths[level] + x] >= nearest)
+				return true;
+	return false;
+}
+
+void OcclusionCuller::cull(const CullingBounds & bounds, const vector<unsigned int> & candidates, vector<unsigned int> & visible) const {
+	visible.clear();
+	for (unsigned int i : candidates) {
+		vec3 min = vec3(bounds.centerX[i] - bounds.extentX[i], bounds.centerY[i] - bounds.extentY[i], bounds.centerZ[i] - bounds.extentZ[i]);
+		vec3 max = vec3(bounds.centerX[i] + bounds.extentX[i], bounds.centerY[i] + bounds.extentY[i], bounds.centerZ[i] + bounds.extentZ[i]);
+		if (isVisible(min, max))
+			visible.push_back(i);
+	}
+}
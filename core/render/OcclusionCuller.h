@@ -0,0 +1,141 @@
+#include <vector>
+
+#include "../math/GLVector.h"
+#include "../math/GLMatrix.h"
+#include "FrustumCuller.h"
+
+using namespace glmath;
+using std::vector;
+
+#pragma once
+
+/**
+ * @brief The triangles of an occluder kept in RAM for the CPU rasterizer, usually a simplified stand-in for a large opaque mesh
+ * that lies entirely within it, such as the walls and floors of a level.
+ *
+ */
+struct OccluderMesh {
+	vector<vec3> vertices;
+	vector<unsigned int> indices;
+};
+
+class OcclusionCuller {
+
+	private:
+		/**
+		 * @brief The size of the depth buffer in pixels.
+		 *
+		 */
+		unsigned int width, height;
+
+		/**
+		 * @brief The projection view matrix of the frame, taking occluders and boxes to clip space.
+		 *
+		 */
+		mat4 projView;
+
+		/**
+		 * @brief The depth pyramid, the first level being the depth buffer occluders are drawn to, one float per pixel in [0, 1].
+		 * Each following level halves the size of the previous one and keeps the farthest depth of each 2 by 2 pixel block.
+		 *
+		 */
+		vector<vector<float>> levels;
+
+		/**
+		 * @brief The size of each level of the pyramid.
+		 *
+		 */
+		vector<unsigned int> levelWidths, levelHeights;
+
+		/**
+		 * @brief Draws a screen space triangle into the depth buffer, keeping the nearest depth of each pixel whose center it covers.
+		 *
+		 * @param v0 The first vertex, in pixels with its depth in [0, 1] as z.
+		 * @param v1 The second vertex.
+		 * @param v2 The third vertex.
+		 */
+		void rasterizeTriangle(const vec3 & v0, const vec3 & v1, const vec3 & v2);
+
+	public:
+		/**
+		 * @brief The default size of the depth buffer, small enough to draw and test on the CPU each frame.
+		 *
+		 */
+		static const unsigned int DEFAULT_WIDTH = 256;
+		static const unsigned int DEFAULT_HEIGHT = 128;
+
+		/**
+		 * @brief Creates an occlusion culler.
+		 *
+		 * @param width [Optional] The width of the depth buffer, rounded up to a multiple of 4.
+		 * @param height [Optional] The height of the depth buffer.
+		 */
+		OcclusionCuller(unsigned int width = DEFAULT_WIDTH, unsigned int height = DEFAULT_HEIGHT);
+
+		/**
+		 * @brief Clears the depth buffer for a new frame seen through a projection view matrix.
+		 *
+		 * @param projView The camera's projection view matrix.
+		 * @return [OcclusionCuller *] This same culler instance in order to allow for method chaining.
+		 */
+		OcclusionCuller * beginFrame(const mat4 & projView);
+
+		/**
+		 * @brief Draws an occluder into the depth buffer. Triangles crossing the near plane are skipped.
+		 *
+		 * @param occluder The occluder's triangles.
+		 * @param model The occluder's model matrix.
+		 * @return [OcclusionCuller *] This same culler instance in order to allow for method chaining.
+		 */
+		OcclusionCuller * addOccluder(const OccluderMesh & occluder, const mat4 & model);
+
+		/**
+		 * @brief Builds the depth pyramid from the depth buffer, once every occluder of the frame has been drawn.
+		 *
+		 * @return [OcclusionCuller *] This same culler instance in order to allow for method chaining.
+		 */
+		OcclusionCuller * buildPyramid();
+
+		/**
+		 * @brief Returns whether a box may be visible past the occluders, comparing its nearest depth to the farthest depth
+		 * of the pyramid texels covering its projection, read from the level where they span at most 2 by 2 texels.
+		 * Boxes crossing the near plane are always visible.
+		 *
+		 * @param min The box's minimum corner in world space.
+		 * @param max The box's maximum corner in world space.
+		 * @return [bool] True if the box may be visible, false if it is hidden by the occluders or off screen.
+		 */
+		bool isVisible(const vec3 & min, const vec3 & max) const;
+
+		/**
+		 * @brief Tests the boxes that passed frustum culling against the pyramid.
+		 *
+		 * @param bounds The boxes.
+		 * @param candidates The indices of the boxes to test, such as those found visible by a frustum culler.
+		 * @param visible Receives the indices of the boxes that may be visible, in the order of the candidates.
+		 */
+		void cull(const CullingBounds & bounds, const vector<unsigned int> & candidates, vector<unsigned int> & visible) const;
+
+		/**
+		 * @brief Returns the depth buffer occluders were drawn to.
+		 *
+		 * @return [const vector<float> &] The depth of each pixel in [0, 1], row by row from the bottom of the screen.
+		 */
+		inline const vector<float> & getDepth() const { return levels[0]; };
+
+		/**
+		 * @brief Returns the size of the depth buffer.
+		 *
+		 * @return [unsigned int] The size of the depth buffer in pixels.
+		 */
+		inline unsigned int getWidth() const { return width; };
+		inline unsigned int getHeight() const { return height; };
+
+		/**
+		 * @brief Returns the number of levels of the depth pyramid.
+		 *
+		 * @return [unsigned int] The number of levels, including the depth buffer.
+		 */
+		inline unsigned int getLevelCount() const { return static_cast<unsigned int>(levels.size()); };
+
+};
@@ -1,111 +1,107 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
 #include "PrimitiveRenderer.h"
+#include "GLStateCache.h"
 
 
-PrimitiveRenderer::PrimitiveRenderer(){
+PrimitiveRenderer::PrimitiveRenderer(StreamBuffer * stream){
 
 	shader = new PrimitiveShader();
+	this->stream = stream != nullptr ? stream : StreamBuffer::getShared();
 
-	glGenVertexArrays(1, &vaoID);
-	glBindVertexArray(vaoID);
-
-	glGenBuffers(1, &vertexVboID);
-	glGenBuffers(1, &colorVboID);
-
-	glBindBuffer(GL_ARRAY_BUFFER, vertexVboID);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+	vao = VAO::create()->bind();
 
-	glBindBuffer(GL_ARRAY_BUFFER, colorVboID);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, 0);
+	// The attributes read the whole stream buffer, each draw starting at the first vertex it allocated.
+	GLStateCache::getShared()->bindBuffer(GL_ARRAY_BUFFER, this->stream->getID());
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PrimitiveVertex), reinterpret_cast<void*>(offsetof(PrimitiveVertex, position)));
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(PrimitiveVertex), reinterpret_cast<void*>(offsetof(PrimitiveVertex, color)));
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
 
 }
 
 PrimitiveRenderer::~PrimitiveRenderer(){
+	ResourceManager::getShared()->destroy(vao->getHandle());
+	delete shader;
 }
 
-void PrimitiveRenderer::beginRender(Camera * cam){
+void PrimitiveRenderer::beginRender(){
+
+	// The camera matrices come from the shared FrameData uniform block.
 	shader->use();
-	shader->loadProjViewMatrix(cam->createProjectionViewMatrix());
+	shader->loadUseUniformColor(false);
+	vao->bind();
 }
 
 void PrimitiveRenderer::endRender(){
+	GLStateCache::getShared()->bindVertexArray(0);
 	shader->stop();
-	
-}
-
-void PrimitiveRenderer::render(Camera * cam, std::map<GLenum, std::vector<Primitive*>>& primitives){
-	beginRender(cam);
-
-	for (auto i = primitives.begin(); i != primitives.end(); i++) {
-		std::vector<Primitive *> & ps = i->second;
-		int size, pointer;
-		vec3 * vertexArr, * colorArr;
-		switch (i->first) {
-			case GL_POINTS:
-			case GL_LINES:
-				size = 0;
-				for (Primitive * p : ps)
-					size += p->getSize();
-
-				vertexArr = new vec3[size];
-				colorArr = new vec3[size];
-
-				pointer = 0;
-				for (Primitive * p : ps) {
-					memcpy_s(vertexArr + pointer, p->getSize() * sizeof(vec3), p->getPoints(), p->getSize() * sizeof(vec3));
-					for (int i = 0; i < p->getSize(); i++)
-						colorArr[pointer + i] = p->getColor();
-
-					pointer += p->getSize();
-				}
-
-				shader->loadUseUniformColor(false);
-
-				glBindVertexArray(vaoID);
-
-				glBindBuffer(GL_ARRAY_BUFFER, vertexVboID);
-				glBufferData(GL_ARRAY_BUFFER, size * sizeof(vec3), vertexArr, GL_DYNAMIC_DRAW);
-
-				glBindBuffer(GL_ARRAY_BUFFER, colorVboID);
-				glBufferData(GL_ARRAY_BUFFER, size * sizeof(vec3), colorArr, GL_DYNAMIC_DRAW);
-
-				glEnableVertexAttribArray(0);
-				glEnableVertexAttribArray(1);
-
-				glDrawArrays(i->first, 0, size);
 
-				glDisableVertexAttribArray(0);
-				glDisableVertexAttribArray(1);
-
-				glBindVertexArray(0);
-
-				delete[] vertexArr;
-				delete[] colorArr;
-
-				break;
-
-			case GL_LINE_STRIP:
-
-				for (Primitive * p : ps) {
-					shader->loadUseUniformColor(true);
-					shader->loadUniformColor(p->getColor());
-
-					glBindVertexArray(vaoID);
-
-					glBindBuffer(GL_ARRAY_BUFFER, vertexVboID);
-					glBufferData(GL_ARRAY_BUFFER, p->getSize() * sizeof(vec3), p->getPoints(), GL_DYNAMIC_DRAW);
-					
-					glEnableVertexAttribArray(0);
-
-					glDrawArrays(p->getType(), 0, p->getSize());
+}
 
-					glDisableVertexAttribArray(0);
+void PrimitiveRenderer::drawVertices(GLenum mode, const PrimitiveVertex * vertices, size_t count){
+
+	// Keep whole lines within each draw.
+	size_t maxVertices = (stream->getRegionSize() / sizeof(PrimitiveVertex)) & ~static_cast<size_t>(1);
+	for (size_t drawn = 0; drawn < count; ) {
+		size_t n = std::min(count - drawn, maxVertices);
+		size_t offset;
+		void * data = stream->allocate(n * sizeof(PrimitiveVertex), sizeof(PrimitiveVertex), offset);
+		if (data == nullptr)
+			return;
+		memcpy(data, vertices + drawn, n * sizeof(PrimitiveVertex));
+		stream->commit();
+
+		glDrawArrays(mode, static_cast<GLint>(offset / sizeof(PrimitiveVertex)), static_cast<GLsizei>(n));
+		drawn += n;
+	}
+}
 
-					glBindVertexArray(0);
-				}
+void PrimitiveRenderer::render(std::map<GLenum, std::vector<Primitive*>>& primitives){
 
-				break;
+	// Gather every primitive into one array per topology, each segment of a line strip becoming a line.
+	points.clear();
+	lines.clear();
+	for (auto i = primitives.begin(); i != primitives.end(); i++) {
+		for (Primitive * p : i->second) {
+			vec3 * vertices = p->getPoints();
+			vec3 color = p->getColor();
+			unsigned int size = p->getSize();
+			switch (i->first) {
+				case GL_POINTS:
+					for (unsigned int v = 0; v < size; v++)
+						points.push_back({ vertices[v], color });
+					break;
+
+				case GL_LINES:
+					for (unsigned int v = 0; v + 1 < size; v += 2) {
+						lines.push_back({ vertices[v], color });
+						lines.push_back({ vertices[v + 1], color });
+					}
+					break;
+
+				case GL_LINE_STRIP:
+					for (unsigned int v = 0; v + 1 < size; v++) {
+						lines.push_back({ vertices[v], color });
+						lines.push_back({ vertices[v + 1], color });
+					}
+					break;
+			}
 		}
 	}
 
+	beginRender();
+	drawVertices(GL_POINTS, points.data(), points.size());
+	drawVertices(GL_LINES, lines.data(), lines.size());
 	endRender();
-}
\ No newline at end of file
+}
+
+void PrimitiveRenderer::render(GLenum mode, const PrimitiveVertex * vertices, size_t count){
+	if (count == 0)
+		return;
+	beginRender();
+	drawVertices(mode, vertices, count);
+	endRender();
+}
@@ -4,24 +4,75 @@
 
 #include "../shaders/PrimitiveShader.h"
 #include "../objects/Primitive.h"
-#include "../camera/Camera.h"
+#include "../objects/StreamBuffer.h"
+#include "../objects/VAO.h"
 
 #pragma once
+
+/**
+ * @brief A vertex of a primitive as it is streamed to the GPU, its color repeated on each vertex so primitives of any color share draws.
+ *
+ */
+struct PrimitiveVertex {
+	vec3 position;
+	vec3 color;
+};
+
 class PrimitiveRenderer
 {
 private:
-	unsigned int vaoID, vertexVboID, colorVboID;
+	VAO * vao;
+
+	/**
+	 * @brief The stream buffer the vertices are written to each frame.
+	 *
+	 */
+	StreamBuffer * stream;
 
+	/**
+	 * @brief The vertices of the points and lines of the primitives drawn, line strips being converted to lines.
+	 * Kept to reuse their memory from one frame to the next.
+	 *
+	 */
+	std::vector<PrimitiveVertex> points;
+	std::vector<PrimitiveVertex> lines;
 
 	PrimitiveShader * shader;
 
-	void beginRender(Camera * cam);
+	void beginRender();
 	void endRender();
 
+	/**
+	 * @brief Streams and draws vertices, in as few draws as the stream buffer's region size allows.
+	 *
+	 * @param mode GL_POINTS or GL_LINES.
+	 * @param vertices The vertices to draw.
+	 * @param count The number of vertices.
+	 */
+	void drawVertices(GLenum mode, const PrimitiveVertex * vertices, size_t count);
+
 public:
-	PrimitiveRenderer();
+	/**
+	 * @brief Creates a primitive renderer streaming its vertices through a stream buffer.
+	 *
+	 * @param stream [Optional] The stream buffer to use, the shared one if null.
+	 */
+	PrimitiveRenderer(StreamBuffer * stream = nullptr);
 	~PrimitiveRenderer();
 
-	void render(Camera * cam, std::map<GLenum, std::vector<Primitive *>> & primitives);
-};
+	/**
+	 * @brief Draws primitives with one draw per topology, line strips being drawn as lines.
+	 *
+	 * @param primitives The primitives to draw, by type.
+	 */
+	void render(std::map<GLenum, std::vector<Primitive *>> & primitives);
 
+	/**
+	 * @brief Draws vertices already laid out for streaming with a single draw, unless they exceed a region of the stream buffer.
+	 *
+	 * @param mode GL_POINTS or GL_LINES.
+	 * @param vertices The vertices to draw.
+	 * @param count The number of vertices.
+	 */
+	void render(GLenum mode, const PrimitiveVertex * vertices, size_t count);
+};
@@ -0,0 +1,177 @@
+#include <cstring>
+#include <algorithm>
+
+#include "RenderQueue.h"
+#include "GLStateCache.h"
+
+// Whether or not two draws only differ by their instance and can be drawn with a single instanced draw.
+static inline bool canMerge(const DrawCommand & a, const DrawCommand & b) {
+	return a.mesh != nullptr && a.mesh == b.mesh && a.shader == b.shader && a.vao == b.vao && a.texture == b.texture && a.textureUnit == b.textureUnit &&
+		a.mode == b.mode && a.indexOffset == b.indexOffset && a.indexCount == b.indexCount &&
+		a.setup == b.setup && a.draw == nullptr && b.draw == nullptr && a.data == b.data;
+}
+
+// Masks a value to the given number of bits.
+static inline unsigned long long field(unsigned int value, unsigned int bits) {
+	return static_cast<unsigned long long>(value) & ((1ull << bits) - 1);
+}
+
+unsigned long long RenderQueue::makeKey(unsigned int layer, bool translucent, unsigned int shader, unsigned int material, unsigned int vao, float depth) {
+	const unsigned int depthMax = (1u << DEPTH_BITS) - 1;
+	unsigned int quantized = static_cast<unsigned int>(std::min(std::max(depth, 0.0f), 1.0f) * depthMax);
+	unsigned long long key = field(layer, LAYER_BITS);
+	key = key << TRANSLUCENT_BITS | (translucent ? 1 : 0);
+
+	// Translucent draws blend over what is behind them, their depth order comes before their state.
+	if (translucent) {
+		key = key << DEPTH_BITS | field(depthMax - quantized, DEPTH_BITS);
+		key = key << SHADER_BITS | field(shader, SHADER_BITS);
+		key = key << MATERIAL_BITS | field(material, MATERIAL_BITS);
+		key = key << VAO_BITS | field(vao, VAO_BITS);
+	} else {
+		key = key << SHADER_BITS | field(shader, SHADER_BITS);
+		key = key << MATERIAL_BITS | field(material, MATERIAL_BITS);
+		key = key << VAO_BITS | field(vao, VAO_BITS);
+		key = key << DEPTH_BITS | field(quantized, DEPTH_BITS);
+	}
+	return key;
+}
+
+RenderQueue::RenderQueue(unsigned int capacity) {
+	packets.reserve(capacity);
+	order.reserve(capacity);
+	scratch.reserve(capacity);
+}
+
+RenderQueue::~RenderQueue() {}
+
+RenderQueue * RenderQueue::push(unsigned long long key, const DrawCommand & command) {
+	packets.push_back({ key, command });
+	sorted = false;
+	return this;
+}
+
+RenderQueue * RenderQueue::push(const DrawCommand & command, unsigned int layer, bool translucent, float depth) {
+	unsigned int material = command.texture != nullptr ? command.texture->getID() : 0;
+	return push(makeKey(layer, translucent, command.shader->getID(), material, command.vao->getID(), depth), command);
+}
+
+RenderQueue * RenderQueue::sort() {
+	unsigned int count = static_cast<unsigned int>(packets.size());
+	order.resize(count);
+	scratch.resize(count);
+	for (unsigned int i = 0; i < count; i++)
+		order[i] = { packets[i].key, i };
+
+	// Count every byte position in a single pass over the keys.
+	unsigned int histograms[8][256];
+	memset(histograms, 0, sizeof(histograms));
+	for (const SortEntry & entry : order)
+		for (unsigned int b = 0; b < 8; b++)
+			histograms[b][(entry.key >> (b * 8)) & 0xFF]++;
+
+	// Least significant byte first, each pass being stable. Bytes equal across all keys need no pass.
+	stats.sortPasses = 0;
+	for (unsigned int b = 0; b < 8; b++) {
+		unsigned int * histogram = histograms[b];
+		if (count == 0 || histogram[(order[0].key >> (b * 8)) & 0xFF] == count)
+			continue;
+		unsigned int offset = 0;
+		for (unsigned int d = 0; d < 256; d++) {
+			unsigned int size = histogram[d];
+			histogram[d] = offset;
+			offset += size;
+		}
+		for (const SortEntry & entry : order)
+			scratch[histogram[(entry.key >> (b * 8)) & 0xFF]++] = entry;
+		order.swap(scratch);
+		stats.sortPasses++;
+	}
+
+	sorted = true;
+	return this;
+}
+
+RenderQueue * RenderQueue::submit() {
+	if (!sorted)
+		sort();
+	unsigned int sortPasses = stats.sortPasses;
+	stats = {};
+	stats.sortPasses = sortPasses;
+	stats.packets = static_cast<unsigned int>(packets.size());
+
+	Shader * shader = nullptr;
+	unsigned int program = 0;
+	VAO * vao = nullptr;
+	const Texture * texture = nullptr;
+	unsigned int textureUnit = 0;
+	for (unsigned int i = 0; i < order.size(); i++) {
+		const DrawCommand & command = packets[order[i].index].command;
+
+		// A reloaded shader keeps its instance but changes program, compare both.
+		if (command.shader != shader || command.shader->getID() != program) {
+			shader = command.shader;
+			program = shader->getID();
+			shader->use();
+			stats.shaderChanges++;
+		} else
+			stats.shaderChangesAvoided++;
+
+		if (command.vao != vao) {
+			vao = command.vao;
+			vao->bind();
+			stats.vaoChanges++;
+		} else
+			stats.vaoChangesAvoided++;
+
+		// Atlas entries share their OpenGL texture, switching between them needs no bind.
+		if (command.texture != nullptr) {
+			if (texture == nullptr || command.texture->getID() != texture->getID() || command.texture->getType() != texture->getType() || command.textureUnit != textureUnit) {
+				texture = command.texture;
+				textureUnit = command.textureUnit;
+				GLStateCache::getShared()->bindTextureUnit(textureUnit, texture->getType(), texture->getID());
+				stats.textureChanges++;
+			} else
+				stats.textureChangesAvoided++;
+		}
+
+		if (command.setup != nullptr)
+			command.setup(command, command.data);
+
+		// Gather the following draws of the same mesh as instances of this one.
+		if (command.mesh != nullptr && command.draw == nullptr) {
+			instances.clear();
+			instances.push_back(command.instance);
+			while (i + 1 < order.size() && canMerge(command, packets[order[i + 1].index].command))
+				instances.push_back(packets[order[++i].index].command.instance);
+			command.mesh->drawInstanced(instances.data(), static_cast<unsigned int>(instances.size()), { command.indexOffset, command.indexCount, 0.0f });
+			stats.instances += static_cast<unsigned int>(instances.size());
+			stats.mergedDraws += static_cast<unsigned int>(instances.size()) - 1;
+		} else if (command.draw != nullptr)
+			command.draw(command, command.data);
+		else
+			glDrawElements(command.mode, command.indexCount, GL_UNSIGNED_INT, reinterpret_cast<void*>(static_cast<size_t>(command.indexOffset) * sizeof(unsigned int)));
+		stats.draws++;
+	}
+
+	// The last state stays bound, the next frame likely starting with it.
+	if (shader != nullptr)
+		shader->stop();
+
+	return this;
+}
+
+RenderQueue * RenderQueue::clear() {
+	packets.clear();
+	order.clear();
+	sorted = true;
+	return this;
+}
+
+vector<unsigned long long> RenderQueue::getSortedKeys() const {
+	vector<unsigned long long> keys;
+	keys.reserve(order.size());
+	for (const SortEntry & entry : order)
+		keys.push_back(entry.key);
+	return keys;
+}
@@ -0,0 +1,251 @@
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "../shaders/Shader.h"
+#include "../objects/VAO.h"
+#include "../objects/Mesh.h"
+#include "../objects/Texture.h"
+
+using std::vector;
+
+#pragma once
+
+/**
+ * @brief The state and parameters of a single draw call. Plain data, copied into the queue as is.
+ * The same state is only bound once for consecutive draws sharing it.
+ *
+ */
+struct DrawCommand {
+	/**
+	 * @brief The shader drawing the geometry.
+	 *
+	 */
+	Shader * shader;
+
+	/**
+	 * @brief The vertex array holding the geometry, with its attribute lists enabled.
+	 *
+	 */
+	VAO * vao;
+
+	/**
+	 * @brief The texture sampled by the draw, and the texture unit it is bound to. May be a null pointer.
+	 *
+	 */
+	const Texture * texture;
+	unsigned int textureUnit;
+
+	/**
+	 * @brief The primitive type, and the range of the index buffer to draw, in indices.
+	 *
+	 */
+	GLenum mode;
+	unsigned int indexOffset;
+	unsigned int indexCount;
+
+	/**
+	 * @brief Loads the draw's own uniforms once its state is bound. May be a null pointer.
+	 *
+	 */
+	void (*setup)(const DrawCommand & command, void * data);
+
+	/**
+	 * @brief Issues the draw itself instead of the queue drawing the index range, for multi-draws. May be a null pointer.
+	 *
+	 */
+	void (*draw)(const DrawCommand & command, void * data);
+
+	/**
+	 * @brief The user data passed to the callbacks.
+	 *
+	 */
+	void * data;
+
+	/**
+	 * @brief The mesh to draw instanced, whose vertex array must be the draw's, and the instance to draw. 
+	 * Consecutive draws of the same mesh with the same state, index range and callbacks are merged into a single instanced draw.
+	 * A null pointer draws the index range without instancing.
+	 *
+	 */
+	Mesh * mesh;
+	MeshInstance instance;
+};
+
+/**
+ * @brief The draws and state changes of the last submitted frame.
+ *
+ */
+struct RenderQueueStats {
+	unsigned int packets;
+	unsigned int draws;
+	unsigned int shaderChanges;
+	unsigned int vaoChanges;
+	unsigned int textureChanges;
+	unsigned int shaderChangesAvoided;
+	unsigned int vaoChangesAvoided;
+	unsigned int textureChangesAvoided;
+	unsigned int instances;
+	unsigned int mergedDraws;
+	unsigned int sortPasses;
+};
+
+class RenderQueue {
+
+	private:
+		/**
+		 * @brief A draw command and the key it is sorted by.
+		 *
+		 */
+		struct Packet {
+			unsigned long long key;
+			DrawCommand command;
+		};
+
+		/**
+		 * @brief A packet's key and index, the only thing moved around while sorting.
+		 *
+		 */
+		struct SortEntry {
+			unsigned long long key;
+			unsigned int index;
+		};
+
+		/**
+		 * @brief The packets queued this frame, in submission order.
+		 *
+		 */
+		vector<Packet> packets;
+
+		/**
+		 * @brief The sorted order of the packets, and the scratch buffer of the radix sort.
+		 *
+		 */
+		vector<SortEntry> order;
+		vector<SortEntry> scratch;
+
+		/**
+		 * @brief The instances of the instanced draw being merged.
+		 *
+		 */
+		vector<MeshInstance> instances;
+
+		/**
+		 * @brief Whether or not the packets were sorted since the last one was pushed.
+		 *
+		 */
+		bool sorted = true;
+
+		/**
+		 * @brief Statistics of the last submitted frame.
+		 *
+		 */
+		RenderQueueStats stats = {};
+
+	public:
+		/**
+		 * @brief The number of bits of each key field, from the most significant to the least significant.
+		 * Opaque packets sort by shader, material, vertex array, then front to back.
+		 * Translucent packets sort back to front, the depth moving ahead of the shader.
+		 * Identifiers wider than their field alias, which only costs redundant state changes.
+		 *
+		 */
+		static const unsigned int LAYER_BITS = 4;
+		static const unsigned int TRANSLUCENT_BITS = 1;
+		static const unsigned int SHADER_BITS = 10;
+		static const unsigned int MATERIAL_BITS = 14;
+		static const unsigned int VAO_BITS = 11;
+		static const unsigned int DEPTH_BITS = 24;
+
+		/**
+		 * @brief Builds a sort key.
+		 *
+		 * @param layer The layer of the draw, layers being drawn in increasing order. (0 to 15)
+		 * @param translucent Whether or not the draw is blended, translucent draws coming after the opaque draws of their layer.
+		 * @param shader The identifier of the draw's shader.
+		 * @param material The identifier of the draw's material, usually its texture.
+		 * @param vao The identifier of the draw's vertex array.
+		 * @param depth The distance of the draw from the camera, normalized to [0, 1], e.g. divided by the far plane distance.
+		 * @return [unsigned long long] The draw's key.
+		 */
+		static unsigned long long makeKey(unsigned int layer, bool translucent, unsigned int shader, unsigned int material, unsigned int vao, float depth);
+
+		/**
+		 * @brief Constructs a new render queue.
+		 *
+		 * @param capacity [Optional] The number of packets to reserve room for.
+		 */
+		RenderQueue(unsigned int capacity = 1024);
+
+		/**
+		 * @brief Destroys the render queue.
+		 *
+		 */
+		~RenderQueue();
+
+		/**
+		 * @brief Queues a draw with the given key.
+		 *
+		 * @param key The key the draw is sorted by, as built by `makeKey`.
+		 * @param command The draw.
+		 * @return [RenderQueue *] This same queue instance in order to allow for method chaining.
+		 */
+		RenderQueue * push(unsigned long long key, const DrawCommand & command);
+
+		/**
+		 * @brief Queues a draw, building its key from the command's shader, texture and vertex array.
+		 *
+		 * @param command The draw.
+		 * @param layer The layer of the draw. (0 to 15)
+		 * @param translucent Whether or not the draw is blended.
+		 * @param depth The distance of the draw from the camera, normalized to [0, 1].
+		 * @return [RenderQueue *] This same queue instance in order to allow for method chaining.
+		 */
+		RenderQueue * push(const DrawCommand & command, unsigned int layer, bool translucent, float depth);
+
+		/**
+		 * @brief Sorts the queued packets by key with a radix sort, skipping the byte positions shared by every key.
+		 * Packets with equal keys keep their submission order.
+		 *
+		 * @return [RenderQueue *] This same queue instance in order to allow for method chaining.
+		 */
+		RenderQueue * sort();
+
+		/**
+		 * @brief Sorts the packets if needed and issues them, binding only the state that differs from the previous draw
+		 * and merging consecutive draws of the same mesh into instanced draws.
+		 * State goes through the shared GLStateCache. Must be called on the OpenGL thread.
+		 *
+		 * @return [RenderQueue *] This same queue instance in order to allow for method chaining.
+		 */
+		RenderQueue * submit();
+
+		/**
+		 * @brief Removes every queued packet, keeping the memory for the next frame.
+		 *
+		 * @return [RenderQueue *] This same queue instance in order to allow for method chaining.
+		 */
+		RenderQueue * clear();
+
+		/**
+		 * @brief Returns the number of queued packets.
+		 *
+		 * @return [unsigned int] The number of packets.
+		 */
+		inline unsigned int getSize() const { return static_cast<unsigned int>(packets.size()); };
+
+		/**
+		 * @brief Returns the sorted keys of the queued packets. Only valid after sorting.
+		 *
+		 * @return [vector<unsigned long long>] The keys in ascending order, as sorted by the radix sort.
+		 */
+		vector<unsigned long long> getSortedKeys() const;
+
+		/**
+		 * @brief Returns the statistics of the last submitted frame.
+		 *
+		 * @return [const RenderQueueStats &] The draw and state change counts.
+		 */
+		inline const RenderQueueStats & getStats() const { return stats; };
+
+};
@@ -0,0 +1,139 @@
+#include <chrono>
+
+#include <glad/glad.h>
+#include <glfw/glfw3.h>
+
+#include "../utils/LinearArena.h"
+#include "RenderThread.h"
+
+RenderThread::RenderThread(GLFWwindow * window, function<void(unsigned int)> render, unsigned int maxLatency) :
+	window(window), render(render), slotCount(maxLatency + 1) {
+	for (unsigned int slot = 0; slot < slotCount; slot++)
+		freeSlots.push(slot);
+}
+
+RenderThread::~RenderThread() {
+	stop();
+}
+
+RenderThread * RenderThread::start() {
+	if (thread.joinable())
+		return this;
+	stopping = false;
+	if (window != nullptr)
+		glfwMakeContextCurrent(nullptr);
+	thread = std::thread(&RenderThread::run, this);
+	return this;
+}
+
+void RenderThread::stop() {
+	if (!thread.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	submitted.notify_one();
+	thread.join();
+	if (window != nullptr)
+		glfwMakeContextCurrent(window);
+}
+
+void RenderThread::run() {
+	if (window != nullptr)
+		glfwMakeContextCurrent(window);
+
+	while (true) {
+		Item item;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			submitted.wait(lock, [this] { return stopping || !items.empty(); });
+			if (items.empty())
+				break;
+			item = std::move(items.front());
+			items.pop();
+		}
+
+		// Frames are presented as soon as they are drawn, freeing the scratch memory they used.
+		if (item.frame >= 0) {
+			render(static_cast<unsigned int>(item.frame));
+			if (window != nullptr)
+				glfwSwapBuffers(window);
+			LinearArena::getThreadArena()->reset();
+		}
+		else
+			item.task();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (item.frame >= 0) {
+				freeSlots.push(static_cast<unsigned int>(item.frame));
+				renderedFrames++;
+			}
+			else
+				finishedTasks++;
+		}
+		finished.notify_all();
+	}
+
+	// The context returns to the thread stopping the render thread.
+	if (window != nullptr)
+		glfwMakeContextCurrent(nullptr);
+}
+
+unsigned int RenderThread::acquireFrame() {
+	std::unique_lock<std::mutex> lock(mutex);
+	if (freeSlots.empty()) {
+		auto start = std::chrono::high_resolution_clock::now();
+		finished.wait(lock, [this] { return !freeSlots.empty(); });
+		waitTime += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+	unsigned int slot = freeSlots.front();
+	freeSlots.pop();
+	return slot;
+}
+
+void RenderThread::publishFrame(unsigned int slot) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		items.push({ static_cast<int>(slot), nullptr });
+	}
+	submitted.notify_one();
+}
+
+void RenderThread::post(function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		items.push({ -1, task });
+		postedTasks++;
+	}
+	submitted.notify_one();
+}
+
+void RenderThread::invoke(function<void()> task) {
+
+	// Run the task directly when there is no render thread to run it.
+	if (!thread.joinable()) {
+		task();
+		return;
+	}
+	unsigned long long ticket;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		items.push({ -1, task });
+		ticket = ++postedTasks;
+	}
+	submitted.notify_one();
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this, ticket] { return finishedTasks >= ticket; });
+}
+
+unsigned long long RenderThread::getRenderedFrames() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return renderedFrames;
+}
+
+double RenderThread::getWaitTime() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return waitTime;
+}
@@ -0,0 +1,185 @@
+#include <queue>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+
+using std::queue;
+using std::vector;
+using std::function;
+
+struct GLFWwindow;
+
+#pragma once
+class RenderThread {
+
+	private:
+		/**
+		 * @brief An entry of the render thread's queue, either a frame to render or a task to run.
+		 *
+		 */
+		struct Item {
+			int frame;
+			function<void()> task;
+		};
+
+		/**
+		 * @brief The window whose OpenGL context the render thread owns, or null to render without a context.
+		 *
+		 */
+		GLFWwindow * window;
+
+		/**
+		 * @brief Renders the frame state of a slot, on the render thread.
+		 *
+		 */
+		function<void(unsigned int)> render;
+
+		/**
+		 * @brief The number of frame state slots, one more than the number of frames the simulation may run ahead.
+		 *
+		 */
+		unsigned int slotCount;
+
+		/**
+		 * @brief The render thread, running while started.
+		 *
+		 */
+		std::thread thread;
+
+		/**
+		 * @brief The frames published and tasks posted, in submission order.
+		 *
+		 */
+		queue<Item> items;
+
+		/**
+		 * @brief The slots neither being filled by the simulation nor waiting or being rendered.
+		 *
+		 */
+		queue<unsigned int> freeSlots;
+
+		/**
+		 * @brief The number of tasks posted and run, identifying each task by its position.
+		 *
+		 */
+		unsigned long long postedTasks = 0, finishedTasks = 0;
+
+		/**
+		 * @brief The number of frames rendered, and the time the simulation spent waiting for a free slot, in seconds.
+		 *
+		 */
+		unsigned long long renderedFrames = 0;
+		double waitTime = 0.0;
+
+		/**
+		 * @brief Whether or not the render thread should exit once its queue is empty.
+		 *
+		 */
+		bool stopping = false;
+
+		/**
+		 * @brief Guards the queue and slots, signaling the render thread when work is submitted and the simulation when work is done.
+		 *
+		 */
+		std::mutex mutex;
+		std::condition_variable submitted;
+		std::condition_variable finished;
+
+		/**
+		 * @brief Renders frames and runs tasks until stopped.
+		 *
+		 */
+		void run();
+
+	public:
+		/**
+		 * @brief The default number of frames the simulation may run ahead of the frame being rendered.
+		 *
+		 */
+		static const unsigned int DEFAULT_LATENCY = 1;
+
+		/**
+		 * @brief Creates a render thread, which must then be started.
+		 *
+		 * @param window The window whose OpenGL context is handed to the render thread and whose buffers it swaps after each frame,
+		 * or null to render without a context.
+		 * @param render Renders the frame state of a slot, on the render thread. The state is immutable until the function returns.
+		 * The render thread's arena is reset after each frame.
+		 * @param maxLatency [Optional] The number of frames the simulation may run ahead of the frame being rendered,
+		 * 0 to simulate and render one after the other.
+		 */
+		RenderThread(GLFWwindow * window, function<void(unsigned int)> render, unsigned int maxLatency = DEFAULT_LATENCY);
+
+		/**
+		 * @brief Stops the render thread if it is running and destroys the render thread object.
+		 *
+		 */
+		~RenderThread();
+
+		/**
+		 * @brief Releases the OpenGL context from the calling thread and starts the render thread, which makes it current.
+		 *
+		 * @return [RenderThread *] This same render thread instance in order to allow for method chaining.
+		 */
+		RenderThread * start();
+
+		/**
+		 * @brief Renders the frames and runs the tasks already submitted, then stops the render thread
+		 * and makes the OpenGL context current on the calling thread again.
+		 *
+		 */
+		void stop();
+
+		/**
+		 * @brief Takes a slot to fill with the state of the next frame, waiting while the simulation is too far ahead of the render thread.
+		 *
+		 * @return [unsigned int] The index of the slot, below the slot count.
+		 */
+		unsigned int acquireFrame();
+
+		/**
+		 * @brief Hands a filled slot to the render thread. The slot must not be modified until it is acquired again.
+		 *
+		 * @param slot The index of the slot.
+		 */
+		void publishFrame(unsigned int slot);
+
+		/**
+		 * @brief Runs a task on the render thread after the frames already published, without waiting for it.
+		 *
+		 * @param task The task, which may make OpenGL calls.
+		 */
+		void post(function<void()> task);
+
+		/**
+		 * @brief Runs a task on the render thread after the frames already published, and waits for it to finish.
+		 * Nothing else runs on the render thread meanwhile, so the task may modify state frames read.
+		 *
+		 * @param task The task, which may make OpenGL calls.
+		 */
+		void invoke(function<void()> task);
+
+		/**
+		 * @brief Returns the number of frame state slots.
+		 *
+		 * @return [unsigned int] The number of slots, one more than the maximum latency.
+		 */
+		inline unsigned int getSlotCount() const { return slotCount; };
+
+		/**
+		 * @brief Returns the number of frames rendered so far.
+		 *
+		 * @return [unsigned long long] The number of frames rendered.
+		 */
+		unsigned long long getRenderedFrames();
+
+		/**
+		 * @brief Returns the time the simulation spent waiting for the render thread to free a slot.
+		 *
+		 * @return [double] The total time waited, in seconds.
+		 */
+		double getWaitTime();
+
+};
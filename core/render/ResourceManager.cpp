@@ -0,0 +1,237 @@
+#include "../objects/VAO.h"
+#include "../objects/Texture.h"
+#include "../objects/FBO.h"
+#include "../objects/StreamBuffer.h"
+#include "../objects/UniformBuffer.h"
+#include "../shaders/Shader.h"
+#include "GLStateCache.h"
+#include "ResourceManager.h"
+
+ResourceHandle ResourceManager::add(ResourceType type, void * object) {
+	std::lock_guard<std::mutex> lock(mutex);
+	Pool & pool = pools[type];
+	unsigned int slot;
+	if (!pool.freeSlots.empty()) {
+		slot = pool.freeSlots.back();
+		pool.freeSlots.pop_back();
+	}
+	else {
+		slot = static_cast<unsigned int>(pool.generations.size());
+		pool.generations.push_back(1);
+		pool.denseIndices.push_back(0);
+	}
+	pool.denseIndices[slot] = static_cast<unsigned int>(pool.objects.size());
+	pool.objects.push_back(object);
+	pool.slots.push_back(slot);
+	return { type, slot, pool.generations[slot] };
+}
+
+void * ResourceManager::find(const ResourceHandle & handle) const {
+	if (handle.isNull() || handle.type >= RESOURCE_TYPE_COUNT)
+		return nullptr;
+	const Pool & pool = pools[handle.type];
+	if (handle.index >= pool.generations.size() || pool.generations[handle.index] != handle.generation)
+		return nullptr;
+	return pool.objects[pool.denseIndices[handle.index]];
+}
+
+void ResourceManager::remove(const ResourceHandle & handle) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (find(handle) == nullptr)
+		return;
+
+	// Move the last live resource into the hole to keep the dense arrays contiguous.
+	Pool & pool = pools[handle.type];
+	unsigned int dense = pool.denseIndices[handle.index];
+	unsigned int last = static_cast<unsigned int>(pool.objects.size()) - 1;
+	pool.objects[dense] = pool.objects[last];
+	pool.slots[dense] = pool.slots[last];
+	pool.denseIndices[pool.slots[dense]] = dense;
+	pool.objects.pop_back();
+	pool.slots.pop_back();
+
+	// Generation 0 is kept for null handles.
+	if (++pool.generations[handle.index] == 0)
+		pool.generations[handle.index] = 1;
+	pool.freeSlots.push_back(handle.index);
+}
+
+bool ResourceManager::isValid(const ResourceHandle & handle) {
+	std::lock_guard<std::mutex> lock(mutex);
+	return find(handle) != nullptr;
+}
+
+void ResourceManager::destroy(const ResourceHandle & handle) {
+	void * object;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		object = find(handle);
+	}
+	if (object == nullptr)
+		return;
+	vector<Pending> resources = { { handle.type, object, getSize(handle.type, object), 0 } };
+	remove(handle);
+
+	// A vertex array deletes its buffers along with it, so they are pending as soon as it is, without being deleted on their own.
+	if (handle.type == RESOURCE_VERTEX_ARRAY)
+		for (const auto & attribute : static_cast<VAO *>(object)->getAttributes()) {
+			resources.push_back({ RESOURCE_BUFFER, nullptr, attribute.second->getSize(), 0 });
+			remove(attribute.second->getHandle());
+		}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	destroyed.insert(destroyed.end(), resources.begin(), resources.end());
+}
+
+void ResourceManager::release(ResourceType type, unsigned int id, size_t bytes) {
+	if (id == 0)
+		return;
+	std::lock_guard<std::mutex> lock(mutex);
+	destroyed.push_back({ type, nullptr, bytes, id });
+}
+
+void ResourceManager::endFrame() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!destroyed.empty()) {
+			batches.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), {} });
+			batches.back().resources.swap(destroyed);
+		}
+	}
+
+	// Batches are fenced in order, so the first one still in use ends the search.
+	while (!batches.empty()) {
+		GLenum status = glClientWaitSync(batches.front().fence, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+			break;
+		Batch batch;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			batch = std::move(batches.front());
+			batches.pop_front();
+		}
+		glDeleteSync(batch.fence);
+		for (const Pending & pending : batch.resources)
+			deleteResource(pending);
+	}
+}
+
+void ResourceManager::destroyAll() {
+	glFinish();
+
+	// Deleting resources may destroy others, such as a VAO's buffers, so collect until nothing is left.
+	while (true) {
+		vector<Pending> resources;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (Batch & batch : batches) {
+				glDeleteSync(batch.fence);
+				resources.insert(resources.end(), batch.resources.begin(), batch.resources.end());
+			}
+			batches.clear();
+			resources.insert(resources.end(), destroyed.begin(), destroyed.end());
+			destroyed.clear();
+
+			// Vertex arrays come first, as they delete their own buffers.
+			for (unsigned int t = 0; t < RESOURCE_TYPE_COUNT && resources.empty(); t++)
+				if (!pools[t].objects.empty())
+					resources.push_back({ static_cast<ResourceType>(t), pools[t].objects.back(), 0, 0 });
+		}
+		if (resources.empty())
+			return;
+		for (const Pending & pending : resources)
+			deleteResource(pending);
+	}
+}
+
+ResourceUsage ResourceManager::getUsage(ResourceType type) {
+	std::lock_guard<std::mutex> lock(mutex);
+	ResourceUsage usage = { static_cast<unsigned int>(pools[type].objects.size()), 0, 0, 0 };
+	for (void * object : pools[type].objects)
+		usage.bytes += getSize(type, object);
+	for (const Batch & batch : batches)
+		for (const Pending & pending : batch.resources)
+			if (pending.type == type) {
+				usage.pendingCount++;
+				usage.pendingBytes += pending.bytes;
+			}
+	for (const Pending & pending : destroyed)
+		if (pending.type == type) {
+			usage.pendingCount++;
+			usage.pendingBytes += pending.bytes;
+		}
+	return usage;
+}
+
+void ResourceManager::deleteResource(const Pending & resource) {
+	if (resource.object == nullptr) {
+		if (resource.id == 0)
+			return;
+		GLStateCache * state = GLStateCache::getShared();
+		switch (resource.type) {
+			case RESOURCE_VERTEX_ARRAY:
+				state->deleteVertexArray(resource.id);
+				break;
+			case RESOURCE_TEXTURE:
+				state->deleteTexture(resource.id);
+				break;
+			case RESOURCE_FRAMEBUFFER:
+				state->deleteFramebuffer(resource.id);
+				break;
+			case RESOURCE_SHADER:
+				state->deleteProgram(resource.id);
+				break;
+			default:
+				state->deleteBuffer(resource.id);
+				break;
+		}
+		return;
+	}
+	switch (resource.type) {
+		case RESOURCE_VERTEX_ARRAY:
+			delete static_cast<VAO *>(resource.object);
+			break;
+		case RESOURCE_BUFFER:
+			delete static_cast<VBO *>(resource.object);
+			break;
+		case RESOURCE_TEXTURE:
+			delete static_cast<Texture *>(resource.object);
+			break;
+		case RESOURCE_FRAMEBUFFER:
+			delete static_cast<FBO *>(resource.object);
+			break;
+		case RESOURCE_SHADER:
+			delete static_cast<Shader *>(resource.object);
+			break;
+		case RESOURCE_UNIFORM_BUFFER:
+			delete static_cast<UniformBuffer *>(resource.object);
+			break;
+		case RESOURCE_STREAM_BUFFER:
+			delete static_cast<StreamBuffer *>(resource.object);
+			break;
+		default:
+			break;
+	}
+}
+
+size_t ResourceManager::getSize(ResourceType type, const void * object) {
+	switch (type) {
+		case RESOURCE_BUFFER:
+			return static_cast<const VBO *>(object)->getSize();
+		case RESOURCE_TEXTURE:
+			return static_cast<const Texture *>(object)->getMemorySize();
+		case RESOURCE_FRAMEBUFFER:
+			return static_cast<const FBO *>(object)->getMemorySize();
+		case RESOURCE_UNIFORM_BUFFER:
+			return static_cast<const UniformBuffer *>(object)->getSize();
+		case RESOURCE_STREAM_BUFFER:
+			return static_cast<const StreamBuffer *>(object)->getRegionSize() * StreamBuffer::REGIONS;
+		default:
+			return 0;
+	}
+}
+
+ResourceManager * ResourceManager::getShared() {
+	static ResourceManager * shared = new ResourceManager();
+	return shared;
+}
@@ -0,0 +1,221 @@
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <cstddef>
+
+#include <glad/glad.h>
+
+using std::deque;
+using std::vector;
+
+#pragma once
+
+/**
+ * @brief The kinds of GPU resources tracked by the resource manager.
+ *
+ */
+enum ResourceType {
+	RESOURCE_VERTEX_ARRAY,
+	RESOURCE_BUFFER,
+	RESOURCE_TEXTURE,
+	RESOURCE_FRAMEBUFFER,
+	RESOURCE_SHADER,
+	RESOURCE_UNIFORM_BUFFER,
+	RESOURCE_STREAM_BUFFER,
+	RESOURCE_TYPE_COUNT
+};
+
+/**
+ * @brief Refers to a resource without owning it. A handle becomes invalid as soon as its resource is destroyed,
+ * even if its slot is reused, as the slot's generation then differs from the handle's.
+ *
+ */
+struct ResourceHandle {
+	ResourceType type;
+	unsigned int index;
+	unsigned int generation;
+
+	inline bool isNull() const { return generation == 0; };
+	inline bool operator==(const ResourceHandle & other) const { return type == other.type && index == other.index && generation == other.generation; };
+	inline bool operator!=(const ResourceHandle & other) const { return !(*this == other); };
+};
+
+/**
+ * @brief The number of live resources of a type and the GPU memory they use, along with the memory of those
+ * waiting for the GPU to finish with them before being destroyed.
+ *
+ */
+struct ResourceUsage {
+	unsigned int count;
+	size_t bytes;
+	unsigned int pendingCount;
+	size_t pendingBytes;
+};
+
+class ResourceManager {
+
+	private:
+		/**
+		 * @brief The resources of a type. Slots hold the generation of the handles to them and their position in the dense arrays,
+		 * which keep the live resources contiguous.
+		 *
+		 */
+		struct Pool {
+			vector<unsigned int> generations;
+			vector<unsigned int> denseIndices;
+			vector<unsigned int> freeSlots;
+			vector<void *> objects;
+			vector<unsigned int> slots;
+		};
+
+		/**
+		 * @brief A resource destroyed while the GPU may still use it, with the memory it held.
+		 * Resources deleted by their owner, such as the buffers of a vertex array, have no object of their own,
+		 * and OpenGL objects replaced within a live resource only have their OpenGL ID.
+		 *
+		 */
+		struct Pending {
+			ResourceType type;
+			void * object;
+			size_t bytes;
+			unsigned int id;
+		};
+
+		/**
+		 * @brief The resources destroyed during a frame, deleted once the fence following the frame's commands is signaled.
+		 *
+		 */
+		struct Batch {
+			GLsync fence;
+			vector<Pending> resources;
+		};
+
+		/**
+		 * @brief The resources of each type.
+		 *
+		 */
+		Pool pools[RESOURCE_TYPE_COUNT];
+
+		/**
+		 * @brief The resources destroyed during the current frame, and the batches of previous frames the GPU may still be using.
+		 *
+		 */
+		vector<Pending> destroyed;
+		deque<Batch> batches;
+
+		/**
+		 * @brief Guards the pools and the destroyed resources.
+		 *
+		 */
+		std::mutex mutex;
+
+		/**
+		 * @brief Returns the resource a handle refers to. The mutex must be held.
+		 *
+		 * @param handle The handle.
+		 * @return [void *] The resource, null if the handle is null or its resource was destroyed.
+		 */
+		void * find(const ResourceHandle & handle) const;
+
+		/**
+		 * @brief Deletes a destroyed resource's object, which unregisters it if it is still registered,
+		 * or the OpenGL object it stands for if it has no object of its own.
+		 *
+		 * @param resource The destroyed resource.
+		 */
+		static void deleteResource(const Pending & resource);
+
+		/**
+		 * @brief Returns the GPU memory a resource uses.
+		 *
+		 * @param type The resource's type.
+		 * @param object The resource's object.
+		 * @return [size_t] The resource's size in bytes, 0 for resources without storage of their own.
+		 */
+		static size_t getSize(ResourceType type, const void * object);
+
+	public:
+		/**
+		 * @brief Registers a resource, done by the resource objects themselves when they are created.
+		 *
+		 * @param type The resource's type.
+		 * @param object The resource's object, a VAO, VBO, Texture, FBO, Shader, UniformBuffer or StreamBuffer according to the type.
+		 * @return [ResourceHandle] The handle to the resource.
+		 */
+		ResourceHandle add(ResourceType type, void * object);
+
+		/**
+		 * @brief Unregisters a resource, done by the resource objects themselves when they are deleted. Invalid handles are ignored.
+		 *
+		 * @param handle The handle to the resource.
+		 */
+		void remove(const ResourceHandle & handle);
+
+		/**
+		 * @brief Returns whether or not a handle still refers to a resource, in constant time.
+		 *
+		 * @param handle The handle.
+		 * @return [bool] True if the handle's resource exists, false if it is null or its resource was destroyed.
+		 */
+		bool isValid(const ResourceHandle & handle);
+
+		/**
+		 * @brief Returns the resource a handle refers to.
+		 *
+		 * @param handle The handle.
+		 * @return [T *] The resource, of the type the handle was created for, or null if the handle is no longer valid.
+		 */
+		template <typename T>
+		inline T * get(const ResourceHandle & handle) {
+			std::lock_guard<std::mutex> lock(mutex);
+			return static_cast<T *>(find(handle));
+		}
+
+		/**
+		 * @brief Destroys a resource once the GPU is done with the commands issued so far. Its handles become invalid immediately,
+		 * and its object is deleted by a later call to endFrame. The buffers of a vertex array are destroyed along with it.
+		 * Invalid handles are ignored.
+		 *
+		 * @param handle The handle to the resource.
+		 */
+		void destroy(const ResourceHandle & handle);
+
+		/**
+		 * @brief Deletes an OpenGL object a live resource replaced, such as the texture of a reloaded asset,
+		 * once the GPU is done with the commands issued so far.
+		 *
+		 * @param type The type of the resource that owned the OpenGL object. (RESOURCE_TEXTURE, RESOURCE_SHADER, etc...)
+		 * @param id The OpenGL ID of the object, a program for shaders.
+		 * @param bytes [Optional] The memory the object held, reported as pending until it is deleted.
+		 */
+		void release(ResourceType type, unsigned int id, size_t bytes = 0);
+
+		/**
+		 * @brief Fences the resources destroyed during the frame, and deletes those of earlier frames the GPU is done with.
+		 * This method must be called on the thread owning the OpenGL context, after the frame's commands.
+		 *
+		 */
+		void endFrame();
+
+		/**
+		 * @brief Waits for the GPU and deletes every resource, including the ones still registered, before the context is destroyed.
+		 *
+		 */
+		void destroyAll();
+
+		/**
+		 * @brief Returns the number of resources of a type and the GPU memory they use.
+		 *
+		 * @param type The type of resources.
+		 * @return [ResourceUsage] The resources' count and memory, live and waiting to be deleted.
+		 */
+		ResourceUsage getUsage(ResourceType type);
+
+		/**
+		 * @brief Returns the resource manager shared by all resources, created on first use.
+		 *
+		 * @return [ResourceManager *] The shared resource manager.
+		 */
+		static ResourceManager * getShared();
+
+};
@@ -0,0 +1,262 @@
+#include <cmath>
+#include <algorithm>
+
+#include "TextureStreamer.h"
+#include "GLStateCache.h"
+#include "../utils/Loader.h"
+
+TextureStreamer::TextureStreamer(unsigned long long budget, unsigned int numThreads, unsigned int coarseResolution) :
+	pool(new ThreadPool(numThreads)), coarseResolution(coarseResolution), budget(budget) {}
+
+TextureStreamer::~TextureStreamer() {
+	delete pool;
+}
+
+Texture * TextureStreamer::load(const char * file, GLenum textureFilter) {
+
+	// Read the header to find the coarse levels, then read them.
+	string path = string(Loader::TEXTURE_DIRECTORY) + file;
+	KTX2::Image image;
+	unsigned int coarseLevel;
+	if (!readCoarseLevels(path, image, coarseLevel))
+		return nullptr;
+
+	// Create the texture, sampling from the resident levels only.
+	unsigned int texID;
+	glGenTextures(1, &texID);
+	GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, texID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, textureFilter == GL_NEAREST ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, textureFilter);
+	Texture * texture = new Texture(GL_TEXTURE_2D, texID);
+	Entry & entry = entries[texture];
+	entry.path = path;
+	start(texture, entry, image, coarseLevel);
+
+	return texture;
+}
+
+bool TextureStreamer::reload(Texture * texture) {
+	auto match = entries.find(texture);
+	if (match == entries.end())
+		return false;
+	Entry & entry = match->second;
+	KTX2::Image image;
+	unsigned int coarseLevel;
+	if (!readCoarseLevels(entry.path, image, coarseLevel))
+		return false;
+
+	// Replace the texture's levels with the new coarse levels, pending requests for the old ones being discarded.
+	int minFilter, magFilter;
+	GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, texture->id);
+	glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &minFilter);
+	glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &magFilter);
+	ResourceManager::getShared()->release(RESOURCE_TEXTURE, texture->id, texture->memorySize);
+	glGenTextures(1, &texture->id);
+	GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, texture->id);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+	residentBytes -= entry.residentBytes;
+	start(texture, entry, image, coarseLevel);
+	return true;
+}
+
+bool TextureStreamer::readCoarseLevels(const string & path, KTX2::Image & image, unsigned int & coarseLevel) {
+	if (!KTX2::read(path.c_str(), image, UINT_MAX) || image.layers > 0)
+		return false;
+	unsigned int levelCount = static_cast<unsigned int>(image.levels.size());
+	coarseLevel = 0;
+	while (coarseLevel + 1 < levelCount && (std::max(image.width, image.height) >> coarseLevel) > coarseResolution)
+		coarseLevel++;
+	return KTX2::read(path.c_str(), image, coarseLevel);
+}
+
+void TextureStreamer::start(Texture * texture, Entry & entry, const KTX2::Image & image, unsigned int coarseLevel) {
+	unsigned int levelCount = static_cast<unsigned int>(image.levels.size());
+	texture->width = image.width;
+	texture->height = image.height;
+	texture->levelCount = levelCount;
+	texture->maxLevel = levelCount - 1;
+	texture->baseLevel = levelCount;
+
+	entry.format = image.format;
+	entry.serial = nextSerial++;
+	entry.coarseLevel = coarseLevel;
+	entry.wantedLevel = coarseLevel;
+	entry.demandLevel = coarseLevel;
+	entry.pending = false;
+	entry.residentBytes = 0;
+	entry.totalBytes = 0;
+	for (unsigned int l = 0; l < levelCount; l++)
+		entry.totalBytes += KTX2::getLevelSize(image.format, image.width, image.height, l);
+
+	upload(texture, entry, image, coarseLevel, levelCount);
+}
+
+void TextureStreamer::release(Texture * texture) {
+	auto match = entries.find(texture);
+	if (match == entries.end())
+		return;
+	residentBytes -= match->second.residentBytes;
+	entries.erase(match);
+}
+
+void TextureStreamer::request(Texture * texture, float pixels) {
+	auto match = entries.find(texture);
+	if (match == entries.end())
+		return;
+
+	// Each level halves the texel density, pick the finest level with at most one texel per pixel.
+	Entry & entry = match->second;
+	float texels = static_cast<float>(std::max(texture->width, texture->height));
+	unsigned int level = entry.coarseLevel;
+	if (pixels >= 1.0f)
+		level = texels > pixels ? std::min(entry.coarseLevel, static_cast<unsigned int>(std::log2(texels / pixels))) : 0;
+	entry.wantedLevel = std::min(entry.wantedLevel, level);
+}
+
+TextureStreamer * TextureStreamer::update() {
+
+	// Upload the levels read since the last update, skipping textures released in the meantime.
+	vector<Result> results;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		results.swap(completed);
+	}
+	for (Result & result : results) {
+		pendingRequests--;
+		pendingBytes -= result.bytes;
+		auto match = entries.find(result.texture);
+		if (match == entries.end() || match->second.serial != result.serial)
+			continue;
+		match->second.pending = false;
+		if (result.success) {
+			upload(result.texture, match->second, result.image, result.firstLevel, result.lastLevel);
+			levelsStreamed += result.lastLevel - result.firstLevel;
+		}
+	}
+
+	// Latch this frame's demand.
+	vector<Texture *> starved;
+	for (auto & pair : entries) {
+		Entry & entry = pair.second;
+		entry.demandLevel = entry.wantedLevel;
+		entry.wantedLevel = entry.coarseLevel;
+		if (entry.demandLevel < pair.first->baseLevel && !entry.pending)
+			starved.push_back(pair.first);
+	}
+
+	// Stay within the budget, evicting levels no longer needed first.
+	while (residentBytes + pendingBytes > budget && evictLevel(true));
+	while (residentBytes + pendingBytes > budget && evictLevel(false));
+
+	// Request the missing levels, most starved textures first.
+	std::sort(starved.begin(), starved.end(), [this](Texture * a, Texture * b) {
+		return a->baseLevel - entries[a].demandLevel > b->baseLevel - entries[b].demandLevel;
+	});
+	for (Texture * texture : starved) {
+		Entry & entry = entries[texture];
+		unsigned int lastLevel = texture->baseLevel;
+		unsigned int firstLevel = entry.demandLevel;
+
+		// Make room by evicting unneeded levels, or settle for fewer levels if there is not enough.
+		unsigned long long bytes = 0;
+		while (firstLevel < lastLevel) {
+			bytes = 0;
+			for (unsigned int l = firstLevel; l < lastLevel; l++)
+				bytes += KTX2::getLevelSize(entry.format, texture->width, texture->height, l);
+			if (residentBytes + pendingBytes + bytes <= budget)
+				break;
+			if (!evictLevel(true))
+				firstLevel++;
+		}
+		if (firstLevel == lastLevel)
+			continue;
+
+		// Read the levels in the background.
+		entry.pending = true;
+		pendingRequests++;
+		pendingBytes += bytes;
+		string path = entry.path;
+		unsigned int serial = entry.serial;
+		pool->submit([this, texture, serial, path, firstLevel, lastLevel, bytes]() {
+			Result result;
+			result.texture = texture;
+			result.serial = serial;
+			result.firstLevel = firstLevel;
+			result.lastLevel = lastLevel;
+			result.bytes = bytes;
+			result.success = KTX2::read(path.c_str(), result.image, firstLevel, lastLevel);
+			std::lock_guard<std::mutex> lock(mutex);
+			completed.push_back(std::move(result));
+		});
+	}
+
+	return this;
+}
+
+void TextureStreamer::upload(Texture * texture, Entry & entry, const KTX2::Image & image, unsigned int firstLevel, unsigned int lastLevel) {
+	GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, texture->id);
+	GLenum internalFormat = KTX2::getInternalFormat(image.format);
+	for (unsigned int l = firstLevel; l < lastLevel; l++) {
+		unsigned int width = image.width >> l > 0 ? image.width >> l : 1;
+		unsigned int height = image.height >> l > 0 ? image.height >> l : 1;
+		glCompressedTexImage2D(GL_TEXTURE_2D, l, internalFormat, width, height, 0, static_cast<GLsizei>(image.levels[l].size()), image.levels[l].data());
+		entry.residentBytes += image.levels[l].size();
+		residentBytes += image.levels[l].size();
+	}
+	texture->memorySize = entry.residentBytes;
+	texture->setLevelRange(firstLevel, texture->maxLevel);
+}
+
+bool TextureStreamer::evictLevel(bool overResidentOnly) {
+
+	// Pick the texture with the most levels beyond its demand, then the largest finest level.
+	Texture * victim = nullptr;
+	int victimSurplus = 0;
+	unsigned int victimBytes = 0;
+	for (auto & pair : entries) {
+		Texture * texture = pair.first;
+		Entry & entry = pair.second;
+		if (entry.pending || texture->baseLevel >= entry.coarseLevel)
+			continue;
+		int surplus = static_cast<int>(entry.demandLevel) - static_cast<int>(texture->baseLevel);
+		if (overResidentOnly && surplus <= 0)
+			continue;
+		unsigned int bytes = KTX2::getLevelSize(entry.format, texture->width, texture->height, texture->baseLevel);
+		if (victim == nullptr || surplus > victimSurplus || (surplus == victimSurplus && bytes > victimBytes)) {
+			victim = texture;
+			victimSurplus = surplus;
+			victimBytes = bytes;
+		}
+	}
+	if (victim == nullptr)
+		return false;
+
+	// Stop sampling from the level, then redefine it as empty to release its memory.
+	Entry & entry = entries[victim];
+	unsigned int level = victim->baseLevel;
+	GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, victim->id);
+	victim->setLevelRange(level + 1, victim->maxLevel);
+	glCompressedTexImage2D(GL_TEXTURE_2D, level, KTX2::getInternalFormat(entry.format), 0, 0, 0, 0, nullptr);
+	entry.residentBytes -= victimBytes;
+	residentBytes -= victimBytes;
+	victim->memorySize = entry.residentBytes;
+	levelsEvicted++;
+	return true;
+}
+
+TextureResidency TextureStreamer::getResidency() const {
+	TextureResidency residency = {};
+	residency.textures = static_cast<unsigned int>(entries.size());
+	residency.pendingRequests = pendingRequests;
+	residency.residentBytes = residentBytes;
+	residency.budget = budget;
+	residency.levelsStreamed = levelsStreamed;
+	residency.levelsEvicted = levelsEvicted;
+	for (auto & pair : entries) {
+		residency.totalBytes += pair.second.totalBytes;
+		if (pair.first->isFullyResident())
+			residency.fullyResident++;
+	}
+	return residency;
+}
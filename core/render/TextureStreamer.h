@@ -0,0 +1,223 @@
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <glad/glad.h>
+
+#include "../objects/Texture.h"
+#include "../utils/KTX2.h"
+#include "../utils/ThreadPool.h"
+
+using std::string;
+using std::vector;
+using std::unordered_map;
+
+#pragma once
+
+/**
+ * @brief A snapshot of the memory used by streamed textures.
+ *
+ */
+struct TextureResidency {
+	unsigned int textures;
+	unsigned int fullyResident;
+	unsigned int pendingRequests;
+	unsigned long long residentBytes;
+	unsigned long long totalBytes;
+	unsigned long long budget;
+	unsigned int levelsStreamed;
+	unsigned int levelsEvicted;
+};
+
+class TextureStreamer {
+
+	private:
+		/**
+		 * @brief The streaming state of a single texture.
+		 *
+		 */
+		struct Entry {
+			string path;
+			TextureFormat format;
+			unsigned int serial;
+			unsigned int coarseLevel;
+			unsigned int wantedLevel;
+			unsigned int demandLevel;
+			bool pending;
+			unsigned long long residentBytes;
+			unsigned long long totalBytes;
+		};
+
+		/**
+		 * @brief The mip levels read by a background request, waiting to be uploaded.
+		 *
+		 */
+		struct Result {
+			Texture * texture;
+			unsigned int serial;
+			unsigned int firstLevel;
+			unsigned int lastLevel;
+			unsigned long long bytes;
+			bool success;
+			KTX2::Image image;
+		};
+
+		/**
+		 * @brief The worker threads reading mip levels from disk.
+		 *
+		 */
+		ThreadPool * pool;
+
+		/**
+		 * @brief The streaming state of every texture loaded through this streamer.
+		 *
+		 */
+		unordered_map<Texture *, Entry> entries;
+		unsigned int nextSerial = 0;
+
+		/**
+		 * @brief The requests completed by the worker threads since the last update.
+		 *
+		 */
+		std::mutex mutex;
+		vector<Result> completed;
+
+		/**
+		 * @brief The largest mip dimension always kept resident.
+		 *
+		 */
+		unsigned int coarseResolution;
+
+		/**
+		 * @brief The memory budget, the memory used by resident levels, and the memory reserved by pending requests, in bytes.
+		 *
+		 */
+		unsigned long long budget;
+		unsigned long long residentBytes = 0;
+		unsigned long long pendingBytes = 0;
+
+		/**
+		 * @brief Streaming statistics.
+		 *
+		 */
+		unsigned int pendingRequests = 0;
+		unsigned int levelsStreamed = 0;
+		unsigned int levelsEvicted = 0;
+
+		/**
+		 * @brief Reads the header of a KTX2 texture and its coarse levels, the ones always kept resident.
+		 *
+		 */
+		bool readCoarseLevels(const string & path, KTX2::Image & image, unsigned int & coarseLevel);
+
+		/**
+		 * @brief Resets a texture's streaming state and uploads its coarse levels.
+		 *
+		 */
+		void start(Texture * texture, Entry & entry, const KTX2::Image & image, unsigned int coarseLevel);
+
+		/**
+		 * @brief Uploads the mip levels in the range [firstLevel, lastLevel) and makes them available for sampling.
+		 *
+		 */
+		void upload(Texture * texture, Entry & entry, const KTX2::Image & image, unsigned int firstLevel, unsigned int lastLevel);
+
+		/**
+		 * @brief Evicts the finest resident level of the texture that can best spare it.
+		 *
+		 * @return [bool] True if a level was evicted, false if no texture could spare one.
+		 */
+		bool evictLevel(bool overResidentOnly);
+
+	public:
+		/**
+		 * @brief The default largest mip dimension always kept resident.
+		 *
+		 */
+		static const unsigned int DEFAULT_COARSE_RESOLUTION = 64;
+
+		/**
+		 * @brief Constructs a new texture streamer.
+		 *
+		 * @param budget The amount of memory streamed texture levels may use, in bytes.
+		 * @param numThreads [Optional] The number of threads reading mip levels in the background.
+		 * @param coarseResolution [Optional] The largest mip dimension loaded up front and never evicted.
+		 */
+		TextureStreamer(unsigned long long budget, unsigned int numThreads = 2, unsigned int coarseResolution = DEFAULT_COARSE_RESOLUTION);
+
+		/**
+		 * @brief Waits for pending requests and destroys the streamer. Streamed textures stay valid with their current levels.
+		 *
+		 */
+		~TextureStreamer();
+
+		/**
+		 * @brief Loads the coarse mip levels of a KTX2 texture and starts streaming it.
+		 * This method returns a null pointer if the loading process fails.
+		 *
+		 * @param file The KTX2 texture file to load, relative to the virtual textures directory.
+		 * @param textureFilter The type for filtering to use for interpolation. (GL_NEAREST, GL_LINEAR, etc...)
+		 * @return [Texture *] The resulting texture instance.
+		 */
+		Texture * load(const char * file, GLenum textureFilter);
+
+		/**
+		 * @brief Stops streaming a texture, which must be released before it is deleted.
+		 *
+		 * @param texture The texture to release.
+		 */
+		void release(Texture * texture);
+
+		/**
+		 * @brief Reloads a streamed texture from its file, for when the file changed. The texture starts over from its coarse levels,
+		 * the finer ones being streamed in again as they are requested.
+		 *
+		 * @param texture The texture to reload.
+		 * @return [bool] True if the texture was reloaded, false if it is not streamed or its file cannot be read.
+		 */
+		bool reload(Texture * texture);
+
+		/**
+		 * @brief Signals that a texture is being drawn at the given size on screen this frame.
+		 * The finest mip level whose texels are no smaller than a pixel will be streamed in.
+		 *
+		 * @param texture The texture being drawn.
+		 * @param pixels The size covered by the texture on screen, in pixels.
+		 */
+		void request(Texture * texture, float pixels);
+
+		/**
+		 * @brief Uploads the levels streamed in since the last update, evicts levels to stay within the budget,
+		 * and requests the levels demanded this frame. Must be called once per frame on the OpenGL thread.
+		 *
+		 * @return [TextureStreamer *] This same streamer instance in order to allow for method chaining.
+		 */
+		TextureStreamer * update();
+
+		/**
+		 * @brief Sets the amount of memory streamed texture levels may use. Levels are evicted during the next update if needed.
+		 *
+		 * @param budget The new budget, in bytes.
+		 * @return [TextureStreamer *] This same streamer instance in order to allow for method chaining.
+		 */
+		inline TextureStreamer * setBudget(unsigned long long budget) {
+			this->budget = budget;
+			return this;
+		}
+
+		/**
+		 * @brief Returns the amount of memory streamed texture levels may use.
+		 *
+		 * @return [unsigned long long] The budget, in bytes.
+		 */
+		inline unsigned long long getBudget() const { return budget; };
+
+		/**
+		 * @brief Returns the current residency statistics of the streamed textures.
+		 *
+		 * @return [TextureResidency] The residency statistics.
+		 */
+		TextureResidency getResidency() const;
+
+};
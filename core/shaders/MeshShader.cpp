@@ -3,11 +3,14 @@
 const char * MeshShader::VERTEX_FILE = "MeshShaderVertex.glsl";
 const char * MeshShader::FRAGMENT_FILE = "MeshShaderFragment.glsl";
 
-MeshShader::MeshShader() : Shader(VERTEX_FILE, FRAGMENT_FILE) {
+MeshShader::MeshShader() : Shader(VERTEX_FILE, FRAGMENT_FILE),
+	jointBuffer(UniformBuffer::create(JOINT_BLOCK_BINDING, MAX_JOINTS * sizeof(mat4))) {
 	validate();
 }
 
-MeshShader::~MeshShader() {}
+MeshShader::~MeshShader() {
+	delete jointBuffer;
+}
 
 void MeshShader::bindAttributes() {
 	bindAttribute(0, "pos");
@@ -15,12 +18,21 @@ void MeshShader::bindAttributes() {
 	bindAttribute(2, "uv");
 	bindAttribute(3, "jointIDs");
 	bindAttribute(4, "weights");
+	bindAttribute(5, "jointIDs2");
+	bindAttribute(6, "weights2");
+	bindAttribute(Mesh::INSTANCE_ATTRIBUTE, "instanceModel");
+	bindAttribute(Mesh::INSTANCE_ATTRIBUTE + 4, "instanceTint");
+	bindAttribute(Mesh::INSTANCE_ATTRIBUTE + 5, "instancePalette");
 }
 
 void MeshShader::getUniformLocations() {
-	location_projViewMatrix = getUniformLocation("projViewMatrix");
 	location_modelMatrix = getUniformLocation("modelMatrix");
-	location_jointTransforms = getUniformLocation("jointTransforms[0]");
 	location_animated = getUniformLocation("animated");
+	location_influences = getUniformLocation("influences");
+	location_instanced = getUniformLocation("instanced");
 	location_tex = getUniformLocation("tex");
+	location_texArray = getUniformLocation("texArray");
+	location_arrayTexture = getUniformLocation("arrayTexture");
+	location_uvTransform = getUniformLocation("uvTransform");
+	location_layer = getUniformLocation("layer");
 }
\ No newline at end of file
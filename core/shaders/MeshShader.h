@@ -1,6 +1,9 @@
 #include <string>
 
 #include "Shader.h"
+#include "../objects/Texture.h"
+#include "../objects/Mesh.h"
+#include "../objects/UniformBuffer.h"
 
 using namespace glmath;
 using std::string;
@@ -22,10 +25,11 @@ class MeshShader: public Shader {
 		static const char * FRAGMENT_FILE;
 
 		/**
-		 * @brief The maximum number of joints a skeleton can have.
+		 * @brief The maximum number of joint transformations in the palette, shared by the skeletons of an instanced draw.
+		 * The palette fills the 16 KB every implementation allows a uniform block.
 		 *
 		 */
-		static const int MAX_JOINTS = 50;
+		static const int MAX_JOINTS = 256;
 
 		/**
 		 * @brief The location of the 2D texture sampler.
@@ -34,10 +38,18 @@ class MeshShader: public Shader {
 		unsigned int location_tex = 0;
 
 		/**
-		 * @brief The location of projection view matrix.
+		 * @brief The location of the 2D array texture sampler used by atlas textures.
 		 * 
 		 */
-		unsigned int location_projViewMatrix = 0;
+		unsigned int location_texArray = 0;
+
+		/**
+		 * @brief The locations of the boolean indicating whether or not the texture is an array, and of its UV transform and layer.
+		 * 
+		 */
+		unsigned int location_arrayTexture = 0;
+		unsigned int location_uvTransform = 0;
+		unsigned int location_layer = 0;
 
 		/**
 		 * @brief The location of model matrix.
@@ -46,10 +58,10 @@ class MeshShader: public Shader {
 		unsigned int location_modelMatrix = 0;
 
 		/**
-		 * @brief The location of the joint transformations.
+		 * @brief The uniform buffer holding the joint transformations, bound to the JointData uniform block.
 		 *
 		 */
-		unsigned int location_jointTransforms;
+		UniformBuffer * jointBuffer;
 
 		/**
 		 * @brief The location of the boolean indicating whether or not the model is animated.
@@ -57,6 +69,18 @@ class MeshShader: public Shader {
 		 */
 		unsigned int location_animated = 0;
 
+		/**
+		 * @brief The location of the number of joint influences per vertex.
+		 *
+		 */
+		unsigned int location_influences = 0;
+
+		/**
+		 * @brief The location of the boolean indicating whether or not the draw is instanced.
+		 *
+		 */
+		unsigned int location_instanced = 0;
+
 	public:
 		/**
 		 * @brief Constructs a new mesh shader program.
@@ -77,15 +101,6 @@ class MeshShader: public Shader {
 		 */
 		void getUniformLocations() override; 
 
-		/**
-		 * @brief Loads a projection view matrix into the shader program.
-		 * 
-		 * @param matrix The matrix to load as a projection view matrix.
-		 */
-		inline void loadProjViewMatrix(const mat4 & matrix) { 
-			loadMatrix(location_projViewMatrix, &matrix); 
-		};
-
 		/**
 		 * @brief Loads a model matrix into the shader program.
 		 * 
@@ -105,13 +120,33 @@ class MeshShader: public Shader {
 		}
 
 		/**
-		 * @brief Loads the joint transformations used for animation into the shader program.
+		 * @brief Loads the texture unit used by 2D array textures into the shader program.
+		 * 
+		 * @param unit The texture unit to use.
+		 */
+		inline void loadTextureArrayUnit(int unit) {
+			loadInt(location_texArray, unit);
+		}
+
+		/**
+		 * @brief Loads where the texture to sample lies within its OpenGL texture into the shader program.
+		 * 
+		 * @param texture The texture about to be sampled.
+		 */
+		inline void loadTextureTransform(const Texture * texture) {
+			loadBoolean(location_arrayTexture, texture->getType() == GL_TEXTURE_2D_ARRAY);
+			loadVector(location_uvTransform, &texture->getUVTransform());
+			loadInt(location_layer, texture->getLayer());
+		}
+
+		/**
+		 * @brief Loads the joint transformations used for animation into the shader program's joint buffer.
 		 *
 		 * @param jointTransforms A pointer to the matrix array of transformations.
-		 * @param size The number of transformations to load.
+		 * @param size The number of transformations to load, at most MAX_JOINTS.
 		 */
 		inline void loadJointTransforms(mat4 * jointTransforms, unsigned int size) {
-			glUniformMatrix4fv(location_jointTransforms, size, false, reinterpret_cast<float*>(jointTransforms));
+			jointBuffer->update(jointTransforms, static_cast<size_t>(size) * sizeof(mat4))->bind();
 		}
 
 		/**
@@ -122,5 +157,24 @@ class MeshShader: public Shader {
 		inline void loadAnimated(bool animated) {
 			loadBoolean(location_animated, animated);
 		}
+
+		/**
+		 * @brief Loads the number of joint influences per vertex into the shader program.
+		 *
+		 * @param influences The number of joint influences per vertex, either 4 or 8.
+		 */
+		inline void loadInfluences(int influences) {
+			loadInt(location_influences, influences);
+		}
+
+		/**
+		 * @brief Loads whether the model matrix, tint and joint palette offset come from the instance attributes 
+		 * or from the model matrix uniform.
+		 *
+		 * @param instanced Whether or not the mesh is drawn through `Mesh::drawInstanced`.
+		 */
+		inline void loadInstanced(bool instanced) {
+			loadBoolean(location_instanced, instanced);
+		}
 };
 
@@ -16,7 +16,6 @@ void PrimitiveShader::bindAttributes() {
 }
 
 void PrimitiveShader::getUniformLocations() {
-	location_projViewMatrix = getUniformLocation("projViewMatrix");
 	location_uniformColor = getUniformLocation("uniformColor");
 	location_useUniformColor = getUniformLocation("useUniformColor");
 }
\ No newline at end of file
@@ -4,7 +4,7 @@ class PrimitiveShader : public Shader {
 	
 	public:
 		static const char * VERTEX_FILE, * FRAGMENT_FILE;
-		unsigned int location_projViewMatrix, location_uniformColor, location_useUniformColor;
+		unsigned int location_uniformColor, location_useUniformColor;
 
 	public:
 		PrimitiveShader();
@@ -13,10 +13,6 @@ class PrimitiveShader : public Shader {
 		void bindAttributes();
 		void getUniformLocations();
 
-		inline void loadProjViewMatrix(const mat4 & matrix) {
-			loadMatrix(location_projViewMatrix, &matrix);
-		}
-
 		inline void loadUseUniformColor(const bool & value) {
 			loadBoolean(location_useUniformColor, value);
 		}
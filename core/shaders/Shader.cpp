@@ -1,41 +1,25 @@
 #include "Shader.h"
+#include "../utils/VirtualFileSystem.h"
+#include "../render/GLStateCache.h"
 
-const char * Shader::SHADER_SOURCE = "shader_source/";
+const char * Shader::SHADER_SOURCE = "shaders/";
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath){
+// Reads a shader source file from the virtual shader source folder.
+static bool readSource(const char * file, string & code) {
+	FileView view = VirtualFileSystem::getShared()->open(string(Shader::SHADER_SOURCE) + file);
+	code = view.toString();
+	return view.isValid();
+}
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath) :
+	vertexFile(vertexPath), fragmentFile(fragmentPath) {
+	handle = ResourceManager::getShared()->add(RESOURCE_SHADER, this);
 
-	// Code strings and file streams.
+	// Read the shader source files.
 	string vertexCode;
 	string fragmentCode;
-	ifstream vShaderFile;
-	ifstream fShaderFile;
-	
-	// Enable file stream exceptions.
-	vShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-	fShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-
-	try {
-
-		// Open the shader source files.
-		vShaderFile.open(SHADER_SOURCE + string(vertexPath));
-		fShaderFile.open(SHADER_SOURCE + string(fragmentPath));
-		stringstream vShaderStream, fShaderStream;
-		
-		// Read into code strings.
-		vShaderStream << vShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
-		
-		// Close the files.
-		vShaderFile.close();
-		fShaderFile.close();
-		
-		// Convert streams to strings.
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
-
-	} catch (ifstream::failure e) {
+	if (!readSource(vertexPath, vertexCode) || !readSource(fragmentPath, fragmentCode))
 		cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << endl;
-	}
 
 	// String pointers.
 	const char *vShaderCode = vertexCode.c_str();
@@ -62,47 +46,16 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath){
 	glAttachShader(id, vertex);
 	glAttachShader(id, fragment);
 }
-Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath) {
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath) :
+	vertexFile(vertexPath), fragmentFile(fragmentPath), geometryFile(geometryPath) {
+	handle = ResourceManager::getShared()->add(RESOURCE_SHADER, this);
 	
-	// Code strings and file streams.
+	// Read the shader source files.
 	string vertexCode;
 	string geometryCode;
 	string fragmentCode;
-	ifstream vShaderFile;
-	ifstream gShaderFile;
-	ifstream fShaderFile;
-	
-	// Enable file stream exceptions.
-	vShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-	gShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-	fShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-
-	try {
-
-		// Open the shader source files.
-		vShaderFile.open(SHADER_SOURCE + string(vertexPath));
-		gShaderFile.open(SHADER_SOURCE + string(geometryPath));
-		fShaderFile.open(SHADER_SOURCE + string(fragmentPath));
-		stringstream vShaderStream, gShaderStream, fShaderStream;
-		
-		// Read into code strings.
-		vShaderStream << vShaderFile.rdbuf();
-		gShaderStream << gShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
-		
-		// Close the files.
-		vShaderFile.close();
-		gShaderFile.close();
-		fShaderFile.close();
-
-		// Convert streams to strings.
-		vertexCode = vShaderStream.str();
-		geometryCode = gShaderStream.str();
-		fragmentCode = fShaderStream.str();
-
-	} catch (ifstream::failure e) {
+	if (!readSource(vertexPath, vertexCode) || !readSource(geometryPath, geometryCode) || !readSource(fragmentPath, fragmentCode))
 		cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << endl;
-	}
 
 	// String pointers.
 	const char *vShaderCode = vertexCode.c_str();
@@ -146,15 +99,62 @@ Shader::~Shader(){
 	glDeleteShader(vertex);
 	glDeleteShader(geometry);
 	glDeleteShader(fragment);
-	glDeleteProgram(id);
+	GLStateCache::getShared()->deleteProgram(id);
+	ResourceManager::getShared()->remove(handle);
 }
 
-void Shader::use() {
-	glUseProgram(id);
+bool Shader::reload(const string & vertexCode, const string & fragmentCode, const string & geometryCode) {
+
+	// Compile the new stages, keeping the current program if any of them fails.
+	bool hasGeometry = !geometryFile.empty();
+	unsigned int newVertex = compileStage(GL_VERTEX_SHADER, vertexCode, "VERTEX");
+	unsigned int newFragment = compileStage(GL_FRAGMENT_SHADER, fragmentCode, "FRAGMENT");
+	unsigned int newGeometry = hasGeometry ? compileStage(GL_GEOMETRY_SHADER, geometryCode, "GEOMETRY") : 0;
+	unsigned int newProgram = 0;
+	if (newVertex != 0 && newFragment != 0 && (!hasGeometry || newGeometry != 0)) {
+
+		// Link the new program, binding attributes through the current ID.
+		unsigned int previous = id;
+		id = newProgram = glCreateProgram();
+		glAttachShader(id, newVertex);
+		if (hasGeometry)
+			glAttachShader(id, newGeometry);
+		glAttachShader(id, newFragment);
+		bindAttributes();
+		glLinkProgram(id);
+		glValidateProgram(id);
+		id = previous;
+		if (!checkCompileErrors(newProgram, "PROGRAM")) {
+			glDeleteProgram(newProgram);
+			newProgram = 0;
+		}
+	}
+	if (newProgram == 0) {
+		glDeleteShader(newVertex);
+		glDeleteShader(newGeometry);
+		glDeleteShader(newFragment);
+		return false;
+	}
+
+	// Release the previous program once the draws using it are done, and use the new one.
+	// Its shaders stay alive while attached to it, so they can be flagged for deletion right away.
+	ResourceManager::getShared()->release(RESOURCE_SHADER, id);
+	glDeleteShader(vertex);
+	glDeleteShader(geometry);
+	glDeleteShader(fragment);
+	id = newProgram;
+	vertex = newVertex;
+	geometry = newGeometry;
+	fragment = newFragment;
+	bindUniformBlocks(id);
+	getUniformLocations();
+	return true;
 }
-void Shader::stop() {
-	glUseProgram(0);
+
+void Shader::use() {
+	GLStateCache::getShared()->useProgram(id);
 }
+void Shader::stop() {}
 void Shader::bindAttribute(int attribute, const char * varName) {
 	glBindAttribLocation(id, attribute, varName);
 }
@@ -215,6 +215,30 @@ bool Shader::checkCompileErrors(unsigned int shader, string type) {
 	}
 }
 
+unsigned int Shader::compileStage(GLenum type, const string & code, const string & name) {
+	const char * source = code.c_str();
+	unsigned int shader = glCreateShader(type);
+	glShaderSource(shader, 1, &source, NULL);
+	glCompileShader(shader);
+	if (!checkCompileErrors(shader, name)) {
+		glDeleteShader(shader);
+		return 0;
+	}
+	return shader;
+}
+
+void Shader::bindUniformBlocks(unsigned int program) {
+	unsigned int frame = glGetUniformBlockIndex(program, "FrameData");
+	if (frame != GL_INVALID_INDEX)
+		glUniformBlockBinding(program, frame, FRAME_BLOCK_BINDING);
+	unsigned int pass = glGetUniformBlockIndex(program, "PassData");
+	if (pass != GL_INVALID_INDEX)
+		glUniformBlockBinding(program, pass, PASS_BLOCK_BINDING);
+	unsigned int joints = glGetUniformBlockIndex(program, "JointData");
+	if (joints != GL_INVALID_INDEX)
+		glUniformBlockBinding(program, joints, JOINT_BLOCK_BINDING);
+}
+
 void Shader::validate() {
 
 	// Bind shader attributes.
@@ -227,6 +251,9 @@ void Shader::validate() {
 	// Check for any errors.
 	if (!checkCompileErrors(id, "PROGRAM")) exit(ERR_SHADER_COMPILATION);
 
+	// Attach the shared uniform blocks to their binding points.
+	bindUniformBlocks(id);
+
 	// Retrieve any uniform variables' locations.
 	getUniformLocations();
 
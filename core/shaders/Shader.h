@@ -10,6 +10,7 @@
 #include "../utils/EngineDef.h"
 #include "../math/GLVector.h"
 #include "../math/GLMatrix.h"
+#include "../render/ResourceManager.h"
 
 using namespace glmath;
 using std::ifstream;
@@ -45,9 +46,37 @@ class Shader {
 		 * @brief This shader program's geometry shader ID number.
 		 * 
 		 */ 
-		unsigned int geometry;
+		unsigned int geometry = 0;
+
+		/**
+		 * @brief The source files of this shader program's stages, the geometry file being empty if it has none.
+		 * 
+		 */
+		string vertexFile;
+		string fragmentFile;
+		string geometryFile;
+
+		/**
+		 * @brief The handle to this shader program in the resource manager.
+		 * 
+		 */
+		ResourceHandle handle;
 
 	public:
+		/**
+		 * @brief The virtual shader source folder.
+		 *
+		 */
+		static const char * SHADER_SOURCE;
+
+		/**
+		 * @brief The uniform buffer binding points of the FrameData, PassData and JointData uniform blocks, shared by all shader programs.
+		 *
+		 */
+		static const unsigned int FRAME_BLOCK_BINDING = 0;
+		static const unsigned int PASS_BLOCK_BINDING = 1;
+		static const unsigned int JOINT_BLOCK_BINDING = 2;
+
 		/**
 		 * @brief Constructs a new shader program with the specified vertex and fragment shaders.
 		 * 
@@ -69,7 +98,7 @@ class Shader {
 		 * @brief Destroys the shader program.
 		 * 
 		 */
-		~Shader();
+		virtual ~Shader();
 
 		/**
 		 * @brief Sets this shader program as the current shader used for rendering.
@@ -78,10 +107,44 @@ class Shader {
 		virtual inline void use() final;
 
 		/**
-		 * @brief Stops the shader program from being used for rendering.
+		 * @brief Ends rendering with the shader program. The program stays bound until another one is used,
+		 * unbinding it in between would only cost a redundant call.
 		 * 
 		 */
 		virtual inline void stop() final;
+
+		/**
+		 * @brief Returns this shader program's OpenGL ID, which changes when the program is reloaded.
+		 *
+		 * @return [unsigned int] The OpenGL program ID.
+		 */
+		inline unsigned int getID() const { return id; };
+
+		/**
+		 * @brief Returns this shader program's handle in the resource manager.
+		 * 
+		 * @return [ResourceHandle] The shader program's handle.
+		 */
+		inline ResourceHandle getHandle() const { return handle; };
+
+		/**
+		 * @brief Recompiles and relinks this shader program from new sources, rebinding its attributes and retrieving its uniform locations.
+		 * The current program is kept if the new sources fail to compile or link. Uniform values must be loaded again after a successful reload.
+		 * 
+		 * @param vertexCode The new vertex shader source.
+		 * @param fragmentCode The new fragment shader source.
+		 * @param geometryCode [Optional] The new geometry shader source, for programs with a geometry shader.
+		 * @return [bool] True if the program was replaced, false if the new sources contain errors.
+		 */
+		bool reload(const string & vertexCode, const string & fragmentCode, const string & geometryCode = "");
+
+		/**
+		 * @brief Returns the source files of this shader program's stages, relative to the shader source folder.
+		 * 
+		 */
+		inline const string & getVertexFile() const { return vertexFile; };
+		inline const string & getFragmentFile() const { return fragmentFile; };
+		inline const string & getGeometryFile() const { return geometryFile; };
 		
 	private:
 		/**
@@ -95,10 +158,18 @@ class Shader {
 		static bool checkCompileErrors(unsigned int shader, string type);
 
 		/**
-		 * @brief The shader source folder.
+		 * @brief Compiles a single shader stage.
+		 * 
+		 * @return [unsigned int] The shader ID, or 0 if the source contains errors.
+		 */
+		static unsigned int compileStage(GLenum type, const string & code, const string & name);
+
+		/**
+		 * @brief Assigns the program's FrameData, PassData and JointData uniform blocks, if it declares them, to their shared binding points.
 		 *
+		 * @param program The linked shader program ID.
 		 */
-		static const char * SHADER_SOURCE;
+		static void bindUniformBlocks(unsigned int program);
 
 	protected:
 		/**
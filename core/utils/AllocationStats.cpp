@@ -0,0 +1,57 @@
+#include <new>
+#include <cstdlib>
+
+#include "AllocationStats.h"
+
+std::atomic<bool> AllocationStats::counting(false);
+std::atomic<AllocationHook> AllocationStats::hook(nullptr);
+std::atomic<unsigned long long> AllocationStats::counts[ALLOCATION_SOURCE_COUNT];
+std::atomic<unsigned long long> AllocationStats::bytes[ALLOCATION_SOURCE_COUNT];
+
+// Whether or not the calling thread is inside the hook, whose own allocations are not recorded.
+static thread_local bool recording = false;
+
+void AllocationStats::setCounting(bool counting) {
+	AllocationStats::counting.store(counting, std::memory_order_relaxed);
+}
+
+void AllocationStats::setHook(AllocationHook hook) {
+	AllocationStats::hook.store(hook, std::memory_order_relaxed);
+}
+
+void AllocationStats::record(AllocationSource source, size_t size) {
+	if (!counting.load(std::memory_order_relaxed) || recording)
+		return;
+	counts[source].fetch_add(1, std::memory_order_relaxed);
+	bytes[source].fetch_add(size, std::memory_order_relaxed);
+	AllocationHook current = hook.load(std::memory_order_relaxed);
+	if (current != nullptr) {
+		recording = true;
+		current(source, size);
+		recording = false;
+	}
+}
+
+FrameAllocations AllocationStats::endFrame() {
+	FrameAllocations allocations;
+	for (unsigned int s = 0; s < ALLOCATION_SOURCE_COUNT; s++) {
+		allocations.counts[s] = counts[s].exchange(0, std::memory_order_relaxed);
+		allocations.bytes[s] = bytes[s].exchange(0, std::memory_order_relaxed);
+	}
+	return allocations;
+}
+
+// Debug builds report every heap allocation, the array and sized forms forwarding to these.
+#ifdef _DEBUG
+void * operator new(size_t size) {
+	AllocationStats::record(ALLOCATION_HEAP, size);
+	void * memory = std::malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void operator delete(void * memory) noexcept {
+	std::free(memory);
+}
+#endif
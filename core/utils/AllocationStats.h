@@ -0,0 +1,80 @@
+#include <atomic>
+#include <cstddef>
+
+#pragma once
+
+/**
+ * @brief Where an allocation was served from: the general heap, a linear arena or a fixed-size pool.
+ *
+ */
+enum AllocationSource {
+	ALLOCATION_HEAP,
+	ALLOCATION_ARENA,
+	ALLOCATION_POOL,
+	ALLOCATION_SOURCE_COUNT
+};
+
+/**
+ * @brief Called for every allocation recorded while counting, from the allocating thread. It must not allocate from the heap itself.
+ *
+ */
+typedef void (*AllocationHook)(AllocationSource source, size_t size);
+
+/**
+ * @brief The number of allocations and bytes allocated from each source over a frame.
+ *
+ */
+struct FrameAllocations {
+	unsigned long long counts[ALLOCATION_SOURCE_COUNT];
+	unsigned long long bytes[ALLOCATION_SOURCE_COUNT];
+};
+
+class AllocationStats {
+
+	private:
+		/**
+		 * @brief Whether or not allocations are counted, and the hook called for each of them.
+		 *
+		 */
+		static std::atomic<bool> counting;
+		static std::atomic<AllocationHook> hook;
+
+		/**
+		 * @brief The number of allocations and bytes allocated from each source since the last frame ended.
+		 *
+		 */
+		static std::atomic<unsigned long long> counts[ALLOCATION_SOURCE_COUNT];
+		static std::atomic<unsigned long long> bytes[ALLOCATION_SOURCE_COUNT];
+
+	public:
+		/**
+		 * @brief Sets whether or not allocations are counted. Heap allocations are only seen in debug builds,
+		 * where the global operator new reports them.
+		 *
+		 * @param counting Whether or not to count allocations.
+		 */
+		static void setCounting(bool counting);
+
+		/**
+		 * @brief Sets the hook called for each allocation recorded while counting.
+		 *
+		 * @param hook The hook, null to remove it.
+		 */
+		static void setHook(AllocationHook hook);
+
+		/**
+		 * @brief Records an allocation if counting is enabled.
+		 *
+		 * @param source The source the allocation was served from.
+		 * @param size The size of the allocation in bytes.
+		 */
+		static void record(AllocationSource source, size_t size);
+
+		/**
+		 * @brief Returns the allocations recorded since the last frame ended, and starts counting those of the next frame.
+		 *
+		 * @return [FrameAllocations] The number of allocations and bytes allocated from each source.
+		 */
+		static FrameAllocations endFrame();
+
+};
@@ -0,0 +1,313 @@
+#include <set>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+
+#include "stb_image.h"
+#include "KTX2.h"
+#include "Logger.h"
+#include "VirtualFileSystem.h"
+#include "AssetReloader.h"
+#include "../render/GLStateCache.h"
+
+using std::set;
+using std::shared_ptr;
+
+// A reload that could not load its asset, leaving the live asset as it was.
+static bool failedReload(bool) {
+	return false;
+}
+
+AssetReloader::AssetReloader(const Loader * loader, unsigned int numThreads, unsigned int pollInterval) :
+	settings(new Loader()), pollInterval(pollInterval), pool(new ThreadPool(numThreads)) {
+	settings->copySettings(*loader);
+	thread = std::thread(&AssetReloader::run, this);
+}
+
+AssetReloader::~AssetReloader() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		running = false;
+	}
+	wake.notify_all();
+	thread.join();
+	delete pool;
+	for (Swap & swap : ready)
+		swap.apply(false);
+	delete settings;
+}
+
+bool AssetReloader::add(AssetType type, void * object, const vector<string> & paths, function<void()> callback) {
+
+	// Only loose files can change, packed ones are left alone.
+	vector<string> watched;
+	for (const string & path : paths) {
+		string file = VirtualFileSystem::getShared()->resolve(path);
+		if (file.empty()) {
+			if (Logger::isEnabled(LOG_WARNING))
+				Logger::stream(LOG_WARNING) << "Cannot watch " << path << ", it is not a loose file." << std::endl;
+			return false;
+		}
+		watched.push_back(FileWatcher::normalize(file));
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for (const string & file : watched)
+		if (!watcher.watch(file))
+			return false;
+	unsigned int id = nextAsset++;
+	assets[id] = { type, object, paths, callback, 0 };
+	for (const string & file : watched)
+		files[file].push_back(id);
+	return true;
+}
+
+bool AssetReloader::watch(Texture * texture, const string & file) {
+	if (texture->getType() != GL_TEXTURE_2D || texture->isAtlasEntry())
+		return false;
+	return add(ASSET_TEXTURE, texture, { string(Loader::TEXTURE_DIRECTORY) + file }, nullptr);
+}
+
+bool AssetReloader::watch(Mesh * mesh, const string & file) {
+	return add(ASSET_MESH, mesh, { string(Loader::MODEL_DIRECTORY) + file }, nullptr);
+}
+
+bool AssetReloader::watch(Shader * shader, function<void()> onReload) {
+	vector<string> paths = {
+		string(Shader::SHADER_SOURCE) + shader->getVertexFile(),
+		string(Shader::SHADER_SOURCE) + shader->getFragmentFile()
+	};
+	if (!shader->getGeometryFile().empty())
+		paths.push_back(string(Shader::SHADER_SOURCE) + shader->getGeometryFile());
+	return add(ASSET_SHADER, shader, paths, onReload);
+}
+
+bool AssetReloader::watchFile(const string & path, function<void()> onChange) {
+	return add(ASSET_FILE, nullptr, { path }, onChange);
+}
+
+void AssetReloader::unwatch(const void * asset) {
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto it = assets.begin(); it != assets.end();)
+		it = it->second.object == asset && it->second.type != ASSET_FILE ? assets.erase(it) : std::next(it);
+	removeUnusedFiles();
+}
+
+void AssetReloader::unwatchFile(const string & path) {
+	string normalized = VirtualFileSystem::normalize(path);
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto it = assets.begin(); it != assets.end();)
+		it = it->second.type == ASSET_FILE && VirtualFileSystem::normalize(it->second.paths[0]) == normalized ? assets.erase(it) : std::next(it);
+	removeUnusedFiles();
+}
+
+void AssetReloader::removeUnusedFiles() {
+	for (auto it = files.begin(); it != files.end();) {
+		vector<unsigned int> & ids = it->second;
+		ids.erase(std::remove_if(ids.begin(), ids.end(), [this](unsigned int id) { return assets.count(id) == 0; }), ids.end());
+		if (ids.empty()) {
+			watcher.unwatch(it->first);
+			it = files.erase(it);
+		} else {
+			it++;
+		}
+	}
+}
+
+void AssetReloader::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (running) {
+
+		// Reload each asset of the changed files once, superseding the reloads already in progress.
+		set<unsigned int> changed;
+		for (const string & file : watcher.poll()) {
+			auto match = files.find(file);
+			if (match != files.end())
+				changed.insert(match->second.begin(), match->second.end());
+		}
+		for (unsigned int id : changed) {
+			Asset & asset = assets[id];
+			unsigned int generation = ++asset.generation;
+			if (asset.type == ASSET_FILE) {
+				ready.push_back({ id, generation, [](bool apply) { return apply; } });
+				continue;
+			}
+			AssetType type = asset.type;
+			void * object = asset.object;
+			vector<string> paths = asset.paths;
+			pool->submit([this, id, generation, type, object, paths]() {
+				load(id, generation, type, object, paths);
+			});
+		}
+
+		wake.wait_for(lock, std::chrono::milliseconds(pollInterval), [this]() { return !running; });
+	}
+}
+
+void AssetReloader::load(unsigned int id, unsigned int generation, AssetType type, void * object, const vector<string> & paths) {
+	function<bool(bool)> apply;
+	switch (type) {
+		case ASSET_TEXTURE:
+			apply = loadTexture(static_cast<Texture *>(object), paths[0]);
+			break;
+		case ASSET_MESH:
+			apply = loadMesh(static_cast<Mesh *>(object), paths[0]);
+			break;
+		case ASSET_SHADER:
+			apply = loadShader(static_cast<Shader *>(object), paths);
+			break;
+		default:
+			break;
+	}
+	if (!apply)
+		apply = failedReload;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	ready.push_back({ id, generation, apply });
+}
+
+function<bool(bool)> AssetReloader::loadTexture(Texture * texture, const string & path) {
+
+	// Cooked textures keep their compressed mip chain.
+	static const string KTX2_EXTENSION = ".ktx2";
+	if (path.size() >= KTX2_EXTENSION.size() && path.compare(path.size() - KTX2_EXTENSION.size(), KTX2_EXTENSION.size(), KTX2_EXTENSION) == 0) {
+		shared_ptr<KTX2::Image> image = std::make_shared<KTX2::Image>();
+		if (!KTX2::read(path.c_str(), *image) || image->layers > 0)
+			return nullptr;
+		return [texture, image](bool apply) {
+			if (!apply)
+				return false;
+			unsigned int texID;
+			glGenTextures(1, &texID);
+			GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, texID);
+			GLenum internalFormat = KTX2::getInternalFormat(image->format);
+			size_t memorySize = 0;
+			for (unsigned int level = 0; level < image->levels.size(); level++) {
+				unsigned int width = image->width >> level > 0 ? image->width >> level : 1;
+				unsigned int height = image->height >> level > 0 ? image->height >> level : 1;
+				glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0, static_cast<GLsizei>(image->levels[level].size()), image->levels[level].data());
+				memorySize += image->levels[level].size();
+			}
+			replaceTexture(texture, texID, image->width, image->height, static_cast<unsigned int>(image->levels.size()), memorySize);
+			return true;
+		};
+	}
+
+	// Other images are decoded here, and have their mip chain generated when swapped in.
+	FileView view = VirtualFileSystem::getShared()->open(path);
+	int width, height, nbChannels;
+	unsigned char * pixels = view.isValid() ? stbi_load_from_memory(view.getData(), static_cast<int>(view.getSize()), &width, &height, &nbChannels, STBI_rgb_alpha) : nullptr;
+	if (pixels == nullptr)
+		return nullptr;
+	return [texture, pixels, width, height](bool apply) {
+		if (apply) {
+			unsigned int texID;
+			glGenTextures(1, &texID);
+			GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, texID);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+			glGenerateMipmap(GL_TEXTURE_2D);
+			unsigned int levelCount = 1;
+			while ((std::max(width, height) >> levelCount) > 0)
+				levelCount++;
+			replaceTexture(texture, texID, width, height, levelCount, static_cast<size_t>(width) * height * 4 * 4 / 3);
+		}
+		stbi_image_free(pixels);
+		return apply;
+	};
+}
+
+void AssetReloader::replaceTexture(Texture * texture, unsigned int id, unsigned int width, unsigned int height, unsigned int levelCount, size_t memorySize) {
+
+	// Sample the new texture the way the old one was.
+	static const GLenum PARAMETERS[] = { GL_TEXTURE_MIN_FILTER, GL_TEXTURE_MAG_FILTER, GL_TEXTURE_WRAP_S, GL_TEXTURE_WRAP_T };
+	int values[4];
+	GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, texture->id);
+	for (unsigned int p = 0; p < 4; p++)
+		glGetTexParameteriv(GL_TEXTURE_2D, PARAMETERS[p], &values[p]);
+	GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, id);
+	for (unsigned int p = 0; p < 4; p++)
+		glTexParameteri(GL_TEXTURE_2D, PARAMETERS[p], values[p]);
+
+	// Draws issued with the old texture may still be in flight, let the resource manager delete it once they are done.
+	ResourceManager::getShared()->release(RESOURCE_TEXTURE, texture->id, texture->memorySize);
+	texture->id = id;
+	texture->width = width;
+	texture->height = height;
+	texture->levelCount = levelCount;
+	texture->memorySize = memorySize;
+	texture->setLevelRange(0, levelCount - 1);
+}
+
+function<bool(bool)> AssetReloader::loadMesh(Mesh * mesh, const string & path) {
+
+	// Each reload imports with its own loader, as importers cannot be shared between threads.
+	Loader loader;
+	loader.copySettings(*settings);
+	shared_ptr<Loader::MeshData> data = std::make_shared<Loader::MeshData>();
+	if (!loader.parseMesh(path.substr(string(Loader::MODEL_DIRECTORY).size()).c_str(), *data))
+		return nullptr;
+	return [mesh, data](bool apply) {
+		if (apply && Loader::replaceMesh(mesh, *data))
+			return true;
+		delete data->animator;
+		data->animator = nullptr;
+		return false;
+	};
+}
+
+function<bool(bool)> AssetReloader::loadShader(Shader * shader, const vector<string> & paths) {
+	vector<string> sources;
+	for (const string & path : paths) {
+		FileView view = VirtualFileSystem::getShared()->open(path);
+		if (!view.isValid())
+			return nullptr;
+		sources.push_back(view.toString());
+	}
+	sources.resize(3);
+	return [shader, sources](bool apply) {
+		return apply && shader->reload(sources[0], sources[1], sources[2]);
+	};
+}
+
+bool AssetReloader::hasPending() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return !ready.empty();
+}
+
+AssetReloader * AssetReloader::update() {
+	vector<Swap> swaps;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		swaps.swap(ready);
+	}
+
+	// Swap in the latest reload of each asset still watched, discarding the superseded ones.
+	for (Swap & swap : swaps) {
+		Asset asset;
+		bool current;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			auto match = assets.find(swap.asset);
+			current = match != assets.end() && match->second.generation == swap.generation;
+			if (current)
+				asset = match->second;
+		}
+		if (!current) {
+			swap.apply(false);
+			continue;
+		}
+		if (swap.apply(true)) {
+			reloaded++;
+			if (Logger::isEnabled(LOG_INFO))
+				Logger::stream(LOG_INFO) << "Reloaded " << asset.paths[0] << "." << std::endl;
+			if (asset.callback)
+				asset.callback();
+		} else {
+			failed++;
+			if (Logger::isEnabled(LOG_WARNING))
+				Logger::stream(LOG_WARNING) << "Failed to reload " << asset.paths[0] << ", keeping the previous version." << std::endl;
+		}
+	}
+
+	return this;
+}
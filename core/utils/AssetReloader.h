@@ -0,0 +1,252 @@
+#include <mutex>
+#include <thread>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "../objects/Mesh.h"
+#include "../objects/Texture.h"
+#include "../shaders/Shader.h"
+#include "FileWatcher.h"
+#include "ThreadPool.h"
+#include "Loader.h"
+
+using std::string;
+using std::vector;
+using std::function;
+using std::unordered_map;
+
+#pragma once
+class AssetReloader {
+
+	private:
+		/**
+		 * @brief The kinds of assets that can be reloaded.
+		 * 
+		 */
+		enum AssetType {
+			ASSET_TEXTURE,
+			ASSET_MESH,
+			ASSET_SHADER,
+			ASSET_FILE
+		};
+
+		/**
+		 * @brief A live asset, the virtual paths of the files it is loaded from, and the number of reloads started for it.
+		 * 
+		 */
+		struct Asset {
+			AssetType type;
+			void * object;
+			vector<string> paths;
+			function<void()> callback;
+			unsigned int generation;
+		};
+
+		/**
+		 * @brief A reloaded asset waiting for the next frame boundary. Applying it swaps it into the live asset,
+		 * discarding it only releases what was loaded.
+		 * 
+		 */
+		struct Swap {
+			unsigned int asset;
+			unsigned int generation;
+			function<bool(bool)> apply;
+		};
+
+		/**
+		 * @brief The loader whose mesh processing settings are used when reloading meshes.
+		 * 
+		 */
+		Loader * settings;
+
+		/**
+		 * @brief The watched assets by ID, and the IDs of the assets loaded from each watched file, guarded by the mutex.
+		 * 
+		 */
+		std::mutex mutex;
+		unordered_map<unsigned int, Asset> assets;
+		unordered_map<string, vector<unsigned int>> files;
+		unsigned int nextAsset = 0;
+
+		/**
+		 * @brief The reloaded assets waiting for the next update, guarded by the mutex.
+		 * 
+		 */
+		vector<Swap> ready;
+
+		/**
+		 * @brief The file watcher, polled by the watching thread until the reloader is destroyed.
+		 * 
+		 */
+		FileWatcher watcher;
+		std::thread thread;
+		std::condition_variable wake;
+		bool running = true;
+		unsigned int pollInterval;
+
+		/**
+		 * @brief The worker threads loading changed assets.
+		 * 
+		 */
+		ThreadPool * pool;
+
+		/**
+		 * @brief Reloading statistics.
+		 * 
+		 */
+		unsigned int reloaded = 0;
+		unsigned int failed = 0;
+
+		/**
+		 * @brief Registers an asset and watches the loose files its virtual paths resolve to.
+		 * 
+		 */
+		bool add(AssetType type, void * object, const vector<string> & paths, function<void()> callback);
+
+		/**
+		 * @brief Stops watching the files no asset is loaded from anymore. The mutex must be held.
+		 * 
+		 */
+		void removeUnusedFiles();
+
+		/**
+		 * @brief Polls the file watcher and starts reloading the assets of changed files until the reloader is destroyed.
+		 * 
+		 */
+		void run();
+
+		/**
+		 * @brief Loads an asset in the background and queues its swap. Called on a worker thread.
+		 * 
+		 */
+		void load(unsigned int id, unsigned int generation, AssetType type, void * object, const vector<string> & paths);
+
+		/**
+		 * @brief Loads a texture and returns the function swapping it into the live texture.
+		 * 
+		 */
+		static function<bool(bool)> loadTexture(Texture * texture, const string & path);
+
+		/**
+		 * @brief Replaces a live texture's OpenGL texture with a new one, keeping its sampling parameters and recording the memory it takes.
+		 * 
+		 */
+		static void replaceTexture(Texture * texture, unsigned int id, unsigned int width, unsigned int height, unsigned int levelCount, size_t memorySize);
+
+		/**
+		 * @brief Parses a mesh and returns the function swapping it into the live mesh.
+		 * 
+		 */
+		function<bool(bool)> loadMesh(Mesh * mesh, const string & path);
+
+		/**
+		 * @brief Reads a shader program's sources and returns the function recompiling the live program.
+		 * 
+		 */
+		static function<bool(bool)> loadShader(Shader * shader, const vector<string> & paths);
+
+	public:
+		/**
+		 * @brief The default interval between two checks for changed files, in milliseconds.
+		 * 
+		 */
+		static const unsigned int DEFAULT_POLL_INTERVAL = 250;
+
+		/**
+		 * @brief Constructs a new asset reloader and starts watching for changes.
+		 * 
+		 * @param loader The loader the watched meshes were loaded with, whose mesh processing settings are reused.
+		 * @param numThreads [Optional] The number of threads loading changed assets.
+		 * @param pollInterval [Optional] The interval between two checks for changed files, in milliseconds.
+		 */
+		AssetReloader(const Loader * loader, unsigned int numThreads = 1, unsigned int pollInterval = DEFAULT_POLL_INTERVAL);
+
+		/**
+		 * @brief Stops watching, waits for the pending reloads and destroys the reloader. Reloads not yet swapped in are discarded.
+		 * 
+		 */
+		~AssetReloader();
+
+		/**
+		 * @brief Reloads a texture whenever its file changes. Atlas entries and streamed textures cannot be watched.
+		 * 
+		 * @param texture The texture to keep up to date.
+		 * @param file The file it was loaded from, relative to the virtual textures directory.
+		 * @return [bool] True if the texture is being watched, false if its file is packed in an archive or cannot be watched.
+		 */
+		bool watch(Texture * texture, const string & file);
+
+		/**
+		 * @brief Reloads a mesh's geometry and skeleton whenever its file changes.
+		 * 
+		 * @param mesh The mesh to keep up to date.
+		 * @param file The file it was loaded from, relative to the virtual models directory.
+		 * @return [bool] True if the mesh is being watched, false if its file is packed in an archive or cannot be watched.
+		 */
+		bool watch(Mesh * mesh, const string & file);
+
+		/**
+		 * @brief Recompiles a shader program whenever one of its source files changes. Programs that fail to compile are kept as they were.
+		 * 
+		 * @param shader The shader program to keep up to date.
+		 * @param onReload [Optional] Called after the program is replaced, to load the uniforms that are not loaded every frame.
+		 * @return [bool] True if the program is being watched, false if its files are packed in an archive or cannot be watched.
+		 */
+		bool watch(Shader * shader, function<void()> onReload = nullptr);
+
+		/**
+		 * @brief Calls a function at a frame boundary whenever a file changes, for assets managing their own reloading.
+		 * 
+		 * @param path The virtual path of the file.
+		 * @param onChange The function to call on the OpenGL thread.
+		 * @return [bool] True if the file is being watched, false if it is packed in an archive or cannot be watched.
+		 */
+		bool watchFile(const string & path, function<void()> onChange);
+
+		/**
+		 * @brief Stops reloading an asset, which must be done before it is deleted.
+		 * 
+		 * @param asset The texture, mesh or shader program to stop reloading.
+		 */
+		void unwatch(const void * asset);
+
+		/**
+		 * @brief Stops calling the functions registered for a file.
+		 * 
+		 * @param path The virtual path of the file.
+		 */
+		void unwatchFile(const string & path);
+
+		/**
+		 * @brief Swaps every asset reloaded since the last update into its live object, all at once.
+		 * Must be called on the OpenGL thread between two frames.
+		 * 
+		 * @return [AssetReloader *] This same reloader instance in order to allow for method chaining.
+		 */
+		AssetReloader * update();
+
+		/**
+		 * @brief Returns whether or not reloaded assets are waiting for the next update, so updates can be skipped when there are none.
+		 * 
+		 * @return [bool] True if the next update swaps in at least one reload.
+		 */
+		bool hasPending();
+
+		/**
+		 * @brief Returns the number of assets swapped in, and the number of reloads that failed and left their asset as it was.
+		 * 
+		 */
+		inline unsigned int getReloaded() const { return reloaded; };
+		inline unsigned int getFailed() const { return failed; };
+
+		/**
+		 * @brief Returns whether or not changes are detected by polling modification times instead of operating system notifications.
+		 * 
+		 * @return [bool] True when polling, false when notified.
+		 */
+		inline bool isPolling() const { return watcher.isPolling(); };
+
+};
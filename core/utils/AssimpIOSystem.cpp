@@ -0,0 +1,84 @@
+#include <cstring>
+#include <algorithm>
+
+#include "VirtualFileSystem.h"
+#include "AssimpIOSystem.h"
+
+// Reads a file straight from its memory-mapped view.
+class ViewIOStream : public Assimp::IOStream {
+
+	private:
+		FileView view;
+		size_t position = 0;
+
+	public:
+		ViewIOStream(const FileView & view) :
+			view(view) {}
+
+		size_t Read(void * buffer, size_t size, size_t count) override {
+			if (size == 0)
+				return 0;
+			size_t read = std::min(count, (view.getSize() - position) / size);
+			if (read > 0)
+				memcpy(buffer, view.getData() + position, read * size);
+			position += read * size;
+			return read;
+		}
+
+		size_t Write(const void *, size_t, size_t) override {
+			return 0;
+		}
+
+		aiReturn Seek(size_t offset, aiOrigin origin) override {
+			size_t target;
+			switch (origin) {
+				case aiOrigin_SET:
+					target = offset;
+					break;
+				case aiOrigin_CUR:
+					target = position + offset;
+					break;
+				case aiOrigin_END:
+					if (offset > view.getSize())
+						return aiReturn_FAILURE;
+					target = view.getSize() - offset;
+					break;
+				default:
+					return aiReturn_FAILURE;
+			}
+			if (target > view.getSize())
+				return aiReturn_FAILURE;
+			position = target;
+			return aiReturn_SUCCESS;
+		}
+
+		size_t Tell() const override {
+			return position;
+		}
+
+		size_t FileSize() const override {
+			return view.getSize();
+		}
+
+		void Flush() override {}
+
+};
+
+bool AssimpIOSystem::Exists(const char * file) const {
+	return VirtualFileSystem::getShared()->exists(file);
+}
+
+char AssimpIOSystem::getOsSeparator() const {
+	return '/';
+}
+
+Assimp::IOStream * AssimpIOSystem::Open(const char * file, const char * mode) {
+	if (strchr(mode, 'w') != nullptr || strchr(mode, 'a') != nullptr)
+		return nullptr;
+	FileView view = VirtualFileSystem::getShared()->open(file);
+	return view.isValid() ? new ViewIOStream(view) : nullptr;
+}
+
+void AssimpIOSystem::Close(Assimp::IOStream * stream) {
+	delete stream;
+}
@@ -0,0 +1,49 @@
+#pragma warning(push, 0)
+#include <assimp/IOSystem.hpp>
+#include <assimp/IOStream.hpp>
+#pragma warning(pop)
+
+#pragma once
+
+/**
+ * @brief Serves the files ASSIMP opens, including the ones a model references, from the shared virtual file system.
+ *
+ */
+class AssimpIOSystem : public Assimp::IOSystem {
+
+	public:
+		using Assimp::IOSystem::Exists;
+		using Assimp::IOSystem::Open;
+
+		/**
+		 * @brief Returns whether or not a file exists in the virtual file system.
+		 * 
+		 * @param file The virtual path of the file.
+		 * @return [bool] True if the file exists, false otherwise.
+		 */
+		bool Exists(const char * file) const override;
+
+		/**
+		 * @brief Returns the path separator used by virtual paths.
+		 * 
+		 * @return [char] The forward slash.
+		 */
+		char getOsSeparator() const override;
+
+		/**
+		 * @brief Opens a file of the virtual file system for reading. Files cannot be opened for writing.
+		 * 
+		 * @param file The virtual path of the file.
+		 * @param mode The access mode requested by ASSIMP.
+		 * @return [Assimp::IOStream *] A stream reading from a view of the file, null if the file is not found.
+		 */
+		Assimp::IOStream * Open(const char * file, const char * mode) override;
+
+		/**
+		 * @brief Closes a stream returned by Open.
+		 * 
+		 * @param stream The stream to close.
+		 */
+		void Close(Assimp::IOStream * stream) override;
+
+};
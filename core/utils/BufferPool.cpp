@@ -0,0 +1,110 @@
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#include "BufferPool.h"
+
+BufferPool::BufferPool(size_t maxCachedBytes) : maxCachedBytes(maxCachedBytes) {}
+
+BufferPool::~BufferPool() {
+	trim();
+}
+
+void * BufferPool::allocate(size_t size) {
+
+	// Round large buffers up to their size class and try to reuse a free one.
+	unsigned int sizeClass = SIZE_CLASSES;
+	size_t capacity = size;
+	if (size >= MIN_POOLED_SIZE) {
+		sizeClass = 0;
+		while ((MIN_POOLED_SIZE << sizeClass) < size)
+			sizeClass++;
+		capacity = MIN_POOLED_SIZE << sizeClass;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		allocations++;
+		if (!freeBuffers[sizeClass].empty()) {
+			void * buffer = freeBuffers[sizeClass].back();
+			freeBuffers[sizeClass].pop_back();
+			cachedBytes -= capacity;
+			reuses++;
+			return buffer;
+		}
+	}
+
+	// Allocate a new buffer, leaving room for the header and the alignment.
+	void * allocation = malloc(capacity + sizeof(Header) + ALIGNMENT);
+	if (allocation == nullptr)
+		return nullptr;
+	uintptr_t address = (reinterpret_cast<uintptr_t>(allocation) + sizeof(Header) + ALIGNMENT - 1) & ~static_cast<uintptr_t>(ALIGNMENT - 1);
+	void * buffer = reinterpret_cast<void *>(address);
+	header(buffer)->allocation = allocation;
+	header(buffer)->capacity = capacity;
+	return buffer;
+}
+
+void * BufferPool::reallocate(void * buffer, size_t size) {
+	if (buffer == nullptr)
+		return allocate(size);
+	if (header(buffer)->capacity >= size)
+		return buffer;
+
+	void * result = allocate(size);
+	if (result != nullptr) {
+		memcpy(result, buffer, header(buffer)->capacity);
+		release(buffer);
+	}
+	return result;
+}
+
+void BufferPool::release(void * buffer) {
+	if (buffer == nullptr)
+		return;
+
+	// Keep large buffers for reuse while the cache has room.
+	size_t capacity = header(buffer)->capacity;
+	if (capacity >= MIN_POOLED_SIZE) {
+		unsigned int sizeClass = 0;
+		while ((MIN_POOLED_SIZE << sizeClass) < capacity)
+			sizeClass++;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (cachedBytes + capacity <= maxCachedBytes) {
+			freeBuffers[sizeClass].push_back(buffer);
+			cachedBytes += capacity;
+			return;
+		}
+	}
+
+	::free(header(buffer)->allocation);
+}
+
+void BufferPool::trim() {
+	std::lock_guard<std::mutex> lock(mutex);
+	for (vector<void *> & buffers : freeBuffers) {
+		for (void * buffer : buffers)
+			::free(header(buffer)->allocation);
+		buffers.clear();
+	}
+	cachedBytes = 0;
+}
+
+unsigned long long BufferPool::getAllocations() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return allocations;
+}
+
+unsigned long long BufferPool::getReuses() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return reuses;
+}
+
+size_t BufferPool::getCachedBytes() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return cachedBytes;
+}
+
+BufferPool * BufferPool::getShared() {
+	static BufferPool shared;
+	return &shared;
+}
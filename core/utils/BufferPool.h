@@ -0,0 +1,136 @@
+#include <mutex>
+#include <vector>
+#include <cstddef>
+
+using std::vector;
+
+#pragma once
+class BufferPool {
+
+	private:
+		/**
+		 * @brief The alignment of every buffer, which also holds the buffer's header.
+		 * 
+		 */
+		static const size_t ALIGNMENT = 64;
+
+		/**
+		 * @brief Buffers smaller than this are allocated and freed directly instead of being pooled.
+		 * 
+		 */
+		static const size_t MIN_POOLED_SIZE = 64 * 1024;
+
+		/**
+		 * @brief The number of power of two size classes pooled buffers are sorted into.
+		 * 
+		 */
+		static const unsigned int SIZE_CLASSES = 48;
+
+		/**
+		 * @brief Information stored right before each buffer.
+		 * 
+		 */
+		struct Header {
+			void * allocation;
+			size_t capacity;
+		};
+
+		/**
+		 * @brief The free buffers of each size class.
+		 * 
+		 */
+		vector<void *> freeBuffers[SIZE_CLASSES];
+
+		/**
+		 * @brief The maximum number of bytes kept in free buffers, and the number of bytes currently kept.
+		 * 
+		 */
+		size_t maxCachedBytes;
+		size_t cachedBytes = 0;
+
+		/**
+		 * @brief Allocation statistics.
+		 * 
+		 */
+		unsigned long long allocations = 0;
+		unsigned long long reuses = 0;
+
+		/**
+		 * @brief Guards the free lists and statistics.
+		 * 
+		 */
+		mutable std::mutex mutex;
+
+		/**
+		 * @brief Returns the header stored before a buffer.
+		 * 
+		 */
+		static inline Header * header(void * buffer) { return reinterpret_cast<Header *>(static_cast<char *>(buffer) - sizeof(Header)); };
+
+	public:
+		/**
+		 * @brief Constructs a new buffer pool.
+		 * 
+		 * @param maxCachedBytes [Optional] The maximum number of bytes kept in free buffers for reuse.
+		 */
+		BufferPool(size_t maxCachedBytes = 256 * 1024 * 1024);
+
+		/**
+		 * @brief Frees every cached buffer and destroys the pool. Buffers still in use must not be released afterwards.
+		 * 
+		 */
+		~BufferPool();
+
+		/**
+		 * @brief Returns a buffer of at least the given size, aligned to 64 bytes, reusing a free buffer when possible.
+		 * Large buffers are rounded up to the next power of two.
+		 * 
+		 * @param size The minimum size of the buffer, in bytes.
+		 * @return [void *] The buffer, or a null pointer if the allocation fails.
+		 */
+		void * allocate(size_t size);
+
+		/**
+		 * @brief Grows a buffer, keeping its contents. The buffer is returned as is if it is already large enough.
+		 * 
+		 * @param buffer The buffer to grow, or a null pointer to allocate a new one.
+		 * @param size The new minimum size of the buffer, in bytes.
+		 * @return [void *] The grown buffer, or a null pointer if the allocation fails.
+		 */
+		void * reallocate(void * buffer, size_t size);
+
+		/**
+		 * @brief Returns a buffer to the pool.
+		 * 
+		 * @param buffer The buffer to release, or a null pointer.
+		 */
+		void release(void * buffer);
+
+		/**
+		 * @brief Frees every cached buffer.
+		 * 
+		 */
+		void trim();
+
+		/**
+		 * @brief Returns the number of buffers handed out, and how many of them were reused from the pool.
+		 * 
+		 */
+		unsigned long long getAllocations() const;
+		unsigned long long getReuses() const;
+
+		/**
+		 * @brief Returns the number of bytes currently kept in free buffers.
+		 * 
+		 * @return [size_t] The number of cached bytes.
+		 */
+		size_t getCachedBytes() const;
+
+		/**
+		 * @brief Returns the pool shared by the engine's image decoders.
+		 * 
+		 * @return [BufferPool *] The shared buffer pool.
+		 */
+		static BufferPool * getShared();
+
+};
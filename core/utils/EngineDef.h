@@ -9,3 +9,8 @@
 #define ERR_ENGINE_NOT_INITIALIZED 4
 #define ERR_DISPLAY_NOT_CREATED 5
 #define ERR_SHADER_COMPILATION 6
+#define ERR_TEXTURE_COOK 7
+#define ERR_UNKNOWN_BENCHMARK 8
+#define ERR_PACK_ARCHIVE 9
+#define ERR_CHECK_FAILED 10
+#define ERR_NO_BENCHMARK_INPUT 11
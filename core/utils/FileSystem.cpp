@@ -0,0 +1,124 @@
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include "FileSystem.h"
+
+static bool hasExtension(const string & name, const string & extension) {
+	return name.size() >= extension.size() && name.compare(name.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+#ifndef _WIN32
+// Returns the type of a directory entry, from stat when the file system does not report it.
+static unsigned char getEntryType(const string & directory, const dirent * entry) {
+	if (entry->d_type != DT_UNKNOWN)
+		return entry->d_type;
+	struct stat info;
+	if (stat((directory + "/" + entry->d_name).c_str(), &info) != 0)
+		return DT_UNKNOWN;
+	return S_ISDIR(info.st_mode) ? DT_DIR : S_ISREG(info.st_mode) ? DT_REG : DT_UNKNOWN;
+}
+#endif
+
+vector<string> FileSystem::listFiles(const string & directory, const string & extension) {
+	vector<string> files;
+
+#ifdef _WIN32
+	WIN32_FIND_DATAA data;
+	HANDLE search = FindFirstFileA((directory + "\\*").c_str(), &data);
+	if (search != INVALID_HANDLE_VALUE) {
+		do {
+			if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && hasExtension(data.cFileName, extension))
+				files.push_back(data.cFileName);
+		} while (FindNextFileA(search, &data));
+		FindClose(search);
+	}
+#else
+	DIR * dir = opendir(directory.c_str());
+	if (dir != nullptr) {
+		while (dirent * entry = readdir(dir))
+			if (hasExtension(entry->d_name, extension) && getEntryType(directory, entry) == DT_REG)
+				files.push_back(entry->d_name);
+		closedir(dir);
+	}
+#endif
+
+	std::sort(files.begin(), files.end());
+	return files;
+}
+
+// Appends the files below a directory to the list, prefixed with their path relative to the listed root.
+static void collectFiles(const string & directory, const string & prefix, vector<string> & files) {
+#ifdef _WIN32
+	WIN32_FIND_DATAA data;
+	HANDLE search = FindFirstFileA((directory + "\\*").c_str(), &data);
+	if (search == INVALID_HANDLE_VALUE)
+		return;
+	do {
+		string name = data.cFileName;
+		if (name == "." || name == "..")
+			continue;
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			collectFiles(directory + "\\" + name, prefix + name + "/", files);
+		else
+			files.push_back(prefix + name);
+	} while (FindNextFileA(search, &data));
+	FindClose(search);
+#else
+	DIR * dir = opendir(directory.c_str());
+	if (dir == nullptr)
+		return;
+	while (dirent * entry = readdir(dir)) {
+		string name = entry->d_name;
+		if (name == "." || name == "..")
+			continue;
+		unsigned char type = getEntryType(directory, entry);
+		if (type == DT_DIR)
+			collectFiles(directory + "/" + name, prefix + name + "/", files);
+		else if (type == DT_REG)
+			files.push_back(prefix + name);
+	}
+	closedir(dir);
+#endif
+}
+
+vector<string> FileSystem::listFilesRecursive(const string & directory) {
+	vector<string> files;
+	collectFiles(directory, "", files);
+	std::sort(files.begin(), files.end());
+	return files;
+}
+
+bool FileSystem::isDirectory(const string & path) {
+#ifdef _WIN32
+	DWORD attributes = GetFileAttributesA(path.c_str());
+	return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+#else
+	struct stat info;
+	return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+#endif
+}
+
+unsigned long long FileSystem::getModificationStamp(const string & path) {
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data))
+		return 0;
+	unsigned long long time = (static_cast<unsigned long long>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+	unsigned long long size = (static_cast<unsigned long long>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+		return 0;
+	unsigned long long time = static_cast<unsigned long long>(info.st_mtim.tv_sec) * 1000000000ULL + info.st_mtim.tv_nsec;
+	unsigned long long size = static_cast<unsigned long long>(info.st_size);
+#endif
+	return (time ^ (size * 0x9E3779B97F4A7C15ULL)) | 1;
+}
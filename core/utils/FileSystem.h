@@ -0,0 +1,44 @@
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+#pragma once
+class FileSystem {
+
+	public:
+		/**
+		 * @brief Lists the regular files directly inside a directory.
+		 * 
+		 * @param directory The directory to list.
+		 * @param extension [Optional] Only list the files ending with this extension, e.g. ".png".
+		 * @return [vector<string>] The names of the files, without the directory, sorted alphabetically.
+		 */
+		static vector<string> listFiles(const string & directory, const string & extension = "");
+
+		/**
+		 * @brief Lists the regular files inside a directory and all of its subdirectories.
+		 * 
+		 * @param directory The directory to list.
+		 * @return [vector<string>] The paths of the files relative to the directory, separated by forward slashes and sorted alphabetically.
+		 */
+		static vector<string> listFilesRecursive(const string & directory);
+
+		/**
+		 * @brief Returns whether or not a path names an existing directory.
+		 * 
+		 * @param path The path to check.
+		 * @return [bool] True if the path is a directory, false otherwise.
+		 */
+		static bool isDirectory(const string & path);
+
+		/**
+		 * @brief Returns a stamp identifying the current contents of a file, changing whenever it is written to.
+		 * 
+		 * @param path The file to check.
+		 * @return [unsigned long long] The file's last modification time combined with its size, 0 if it does not exist.
+		 */
+		static unsigned long long getModificationStamp(const string & path);
+
+};
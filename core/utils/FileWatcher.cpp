@@ -0,0 +1,124 @@
+#include <algorithm>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+#include "FileSystem.h"
+#include "FileWatcher.h"
+
+// Returns the directory part of a normalized path, "." for files in the working directory.
+static string getDirectory(const string & path) {
+	size_t slash = path.find_last_of('/');
+	return slash == string::npos ? "." : path.substr(0, slash);
+}
+
+FileWatcher::FileWatcher() {
+#ifdef __linux__
+	notifier = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+	if (notifier >= 0)
+		close(notifier);
+#endif
+}
+
+string FileWatcher::normalize(const string & path) {
+	string normalized = path;
+	std::replace(normalized.begin(), normalized.end(), '\\', '/');
+	while (normalized.compare(0, 2, "./") == 0)
+		normalized.erase(0, 2);
+	return normalized;
+}
+
+bool FileWatcher::watch(const string & path) {
+	string file = normalize(path);
+
+#ifdef __linux__
+	// Watch the whole directory, as saving often replaces the file instead of writing to it.
+	if (notifier >= 0) {
+		string directory = getDirectory(file);
+		int descriptor = inotify_add_watch(notifier, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+		if (descriptor < 0)
+			return false;
+		directories[descriptor] = directory;
+	}
+#endif
+
+	files.insert(file);
+	stamps[file] = FileSystem::getModificationStamp(file);
+	return true;
+}
+
+void FileWatcher::unwatch(const string & path) {
+	string file = normalize(path);
+	if (files.erase(file) == 0)
+		return;
+	stamps.erase(file);
+	settling.erase(file);
+
+#ifdef __linux__
+	// Remove the directory's watch once none of its files are watched.
+	string directory = getDirectory(file);
+	for (const string & watched : files)
+		if (getDirectory(watched) == directory)
+			return;
+	for (auto it = directories.begin(); it != directories.end(); it++)
+		if (it->second == directory) {
+			inotify_rm_watch(notifier, it->first);
+			directories.erase(it);
+			return;
+		}
+#endif
+}
+
+vector<string> FileWatcher::poll() {
+	if (isPolling())
+		return scan();
+
+	set<string> changed;
+#ifdef __linux__
+	alignas(inotify_event) char buffer[4096];
+	ssize_t length;
+	while ((length = read(notifier, buffer, sizeof(buffer))) > 0) {
+		for (char * event = buffer; event < buffer + length;) {
+			const inotify_event * notification = reinterpret_cast<const inotify_event *>(event);
+			auto directory = directories.find(notification->wd);
+			if (directory != directories.end() && notification->len > 0) {
+				string file = directory->second == "." ? string(notification->name) : directory->second + "/" + notification->name;
+				if (files.count(file) > 0)
+					changed.insert(file);
+			}
+			event += sizeof(inotify_event) + notification->len;
+		}
+	}
+#endif
+	return vector<string>(changed.begin(), changed.end());
+}
+
+vector<string> FileWatcher::scan() {
+	vector<string> changed;
+	for (const string & file : files) {
+		unsigned long long stamp = FileSystem::getModificationStamp(file);
+		if (stamp == stamps[file]) {
+			settling.erase(file);
+			continue;
+		}
+
+		// Wait for the file to stop changing, it might still be being written.
+		auto previous = settling.find(file);
+		if (previous != settling.end() && previous->second == stamp) {
+			stamps[file] = stamp;
+			settling.erase(previous);
+			if (stamp != 0)
+				changed.push_back(file);
+		} else {
+			settling[file] = stamp;
+		}
+	}
+	return changed;
+}
@@ -0,0 +1,94 @@
+#include <set>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+using std::set;
+using std::string;
+using std::vector;
+using std::unordered_map;
+
+#pragma once
+class FileWatcher {
+
+	private:
+		/**
+		 * @brief The watched files, by their normalized path on disk.
+		 * 
+		 */
+		set<string> files;
+
+		/**
+		 * @brief The inotify instance and the watched directories by watch descriptor, when available.
+		 * 
+		 */
+		int notifier = -1;
+		unordered_map<int, string> directories;
+
+		/**
+		 * @brief When polling, the last stamp reported for each file and the stamp seen during the previous scan for files being written.
+		 * 
+		 */
+		unordered_map<string, unsigned long long> stamps;
+		unordered_map<string, unsigned long long> settling;
+
+		/**
+		 * @brief Returns the files whose modification stamp changed and stayed the same for a whole scan.
+		 * 
+		 */
+		vector<string> scan();
+
+	public:
+		/**
+		 * @brief Constructs a new file watcher, using inotify where available and polling modification stamps otherwise.
+		 * 
+		 */
+		FileWatcher();
+
+		/**
+		 * @brief Stops watching every file and destroys the file watcher.
+		 * 
+		 */
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher &) = delete;
+		FileWatcher & operator=(const FileWatcher &) = delete;
+
+		/**
+		 * @brief Starts watching a file for changes, including replacement by a renamed file as editors do when saving.
+		 * 
+		 * @param path The path of the file on disk.
+		 * @return [bool] True if the file is being watched, false if its directory cannot be watched.
+		 */
+		bool watch(const string & path);
+
+		/**
+		 * @brief Stops watching a file, and its directory once none of its other files are watched.
+		 * 
+		 * @param path The path of the file on disk.
+		 */
+		void unwatch(const string & path);
+
+		/**
+		 * @brief Returns the watched files changed since the last poll, without blocking.
+		 * 
+		 * @return [vector<string>] The normalized paths of the changed files, each listed once.
+		 */
+		vector<string> poll();
+
+		/**
+		 * @brief Returns whether or not changes are detected by polling modification stamps.
+		 * 
+		 * @return [bool] True when polling, false when notified by the operating system.
+		 */
+		inline bool isPolling() const { return notifier < 0; };
+
+		/**
+		 * @brief Normalizes a path on disk the way reported changes are, using forward slashes and no leading "./".
+		 * 
+		 * @param path The path to normalize.
+		 * @return [string] The normalized path.
+		 */
+		static string normalize(const string & path);
+
+};
@@ -0,0 +1,120 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+#include <cmath>
+#include <thread>
+
+#include "GameLoop.h"
+
+#if defined(_WIN32) && !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+const double GameLoop::INITIAL_SLEEP_ESTIMATE = 0.002;
+
+GameLoop::GameLoop(function<void(double)> tick, unsigned int tickRate, unsigned int maxTicks) :
+	tick(tick) {
+	setTickRate(tickRate);
+	setMaxTicks(maxTicks);
+
+	// Windows otherwise sleeps in steps of its ~15.6ms scheduler period, high resolution timers being available since Windows 10 1803.
+#ifdef _WIN32
+	timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+}
+
+GameLoop::~GameLoop() {
+#ifdef _WIN32
+	if (timer != nullptr)
+		CloseHandle(timer);
+#endif
+}
+
+GameLoop * GameLoop::setTickRate(unsigned int tickRate) {
+	this->timestep = 1.0 / (tickRate > 0 ? tickRate : 1);
+	return this;
+}
+
+GameLoop * GameLoop::setMaxTicks(unsigned int maxTicks) {
+	this->maxTicks = maxTicks > 0 ? maxTicks : 1;
+	return this;
+}
+
+GameLoop * GameLoop::setFrameCap(float frameRate) {
+	this->minFrameTime = frameRate > 0.0f ? 1.0 / frameRate : 0.0;
+	return this;
+}
+
+GameLoop * GameLoop::reset() {
+	started = false;
+	accumulator = 0.0;
+	alpha = 0.0f;
+	return this;
+}
+
+void GameLoop::sleepStep() {
+#ifdef _WIN32
+	if (timer != nullptr) {
+		// Negative due times are relative, in 100ns units.
+		LARGE_INTEGER due;
+		due.QuadPart = -10000;
+		if (SetWaitableTimer(timer, &due, 0, NULL, NULL, FALSE)) {
+			WaitForSingleObject(timer, INFINITE);
+			return;
+		}
+	}
+#endif
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void GameLoop::sleepUntil(Clock::time_point deadline) {
+	while (std::chrono::duration<double>(deadline - Clock::now()).count() > sleepEstimate) {
+		auto start = Clock::now();
+		sleepStep();
+		double slept = std::chrono::duration<double>(Clock::now() - start).count();
+
+		// Expect sleep steps to stay within a standard deviation above their mean duration.
+		sleepCount++;
+		double deviation = slept - sleepMean;
+		sleepMean += deviation / sleepCount;
+		sleepDeviations += deviation * (slept - sleepMean);
+		sleepEstimate = sleepMean + (sleepCount > 1.0 ? std::sqrt(sleepDeviations / (sleepCount - 1.0)) : 0.0);
+	}
+
+	// The last fraction of the frame is spun, sleeping being too coarse to land on the deadline.
+	while (Clock::now() < deadline)
+		std::this_thread::yield();
+}
+
+float GameLoop::advance() {
+	if (started && minFrameTime > 0.0)
+		sleepUntil(last + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(minFrameTime)));
+
+	auto now = Clock::now();
+	frameTime = started ? std::chrono::duration<double>(now - last).count() : 0.0;
+	last = now;
+	started = true;
+
+	accumulator += frameTime;
+	unsigned int ticks = 0;
+	while (accumulator >= timestep && ticks < maxTicks) {
+		tick(timestep);
+		accumulator -= timestep;
+		time += timestep;
+		tickCount++;
+		ticks++;
+	}
+
+	// Past the step limit the whole steps still due are dropped, so that a slow simulation cannot fall further and further behind.
+	if (accumulator >= timestep) {
+		double remainder = std::fmod(accumulator, timestep);
+		droppedTime += accumulator - remainder;
+		accumulator = remainder;
+	}
+
+	alpha = static_cast<float>(accumulator / timestep);
+	return alpha;
+}
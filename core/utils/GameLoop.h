@@ -0,0 +1,222 @@
+#include <chrono>
+#include <functional>
+
+using std::function;
+
+#pragma once
+class GameLoop {
+
+	private:
+		/**
+		 * @brief The clock timing frames and sleeps.
+		 *
+		 */
+		typedef std::chrono::high_resolution_clock Clock;
+
+		/**
+		 * @brief Advances the simulation by one fixed step, given in seconds.
+		 *
+		 */
+		function<void(double)> tick;
+
+		/**
+		 * @brief The duration of a simulation step and the shortest duration of a frame, in seconds, the latter being 0 when uncapped.
+		 *
+		 */
+		double timestep, minFrameTime = 0.0;
+
+		/**
+		 * @brief The largest number of steps run in a single frame.
+		 *
+		 */
+		unsigned int maxTicks;
+
+		/**
+		 * @brief Whether or not a frame was advanced since the loop was created or reset, and the time that frame started.
+		 *
+		 */
+		bool started = false;
+		Clock::time_point last;
+
+		/**
+		 * @brief The real time elapsed and not yet simulated, always less than a step between frames, in seconds.
+		 *
+		 */
+		double accumulator = 0.0;
+
+		/**
+		 * @brief The time simulated so far and the real time discarded by the spiral of death guard, in seconds.
+		 *
+		 */
+		double time = 0.0, droppedTime = 0.0;
+
+		/**
+		 * @brief The real duration of the last frame, in seconds.
+		 *
+		 */
+		double frameTime = 0.0;
+
+		/**
+		 * @brief The position of the last frame between the two last steps, in [0, 1).
+		 *
+		 */
+		float alpha = 0.0f;
+
+		/**
+		 * @brief The number of steps run so far.
+		 *
+		 */
+		unsigned long long tickCount = 0;
+
+		/**
+		 * @brief The mean, squared deviations and number of the sleep step durations observed,
+		 * and the duration a sleep step is expected not to exceed, in seconds.
+		 *
+		 */
+		double sleepMean = 0.0, sleepDeviations = 0.0, sleepCount = 0.0;
+		double sleepEstimate = INITIAL_SLEEP_ESTIMATE;
+
+		/**
+		 * @brief The high resolution waitable timer sleep steps wait on under Windows, null elsewhere or if it could not be created.
+		 *
+		 */
+		void * timer = nullptr;
+
+		/**
+		 * @brief Sleeps for about a millisecond, the operating system deciding how much longer it really sleeps.
+		 *
+		 */
+		void sleepStep();
+
+		/**
+		 * @brief Sleeps in short steps while more time remains than a step is expected to take, then spins until the deadline.
+		 *
+		 * @param deadline The time to return at.
+		 */
+		void sleepUntil(Clock::time_point deadline);
+
+	public:
+		/**
+		 * @brief The default number of simulation steps per second.
+		 *
+		 */
+		static const unsigned int DEFAULT_TICK_RATE = 60;
+
+		/**
+		 * @brief The default largest number of steps run in a single frame, past which the simulation falls behind real time
+		 * instead of taking ever longer to catch up.
+		 *
+		 */
+		static const unsigned int DEFAULT_MAX_TICKS = 5;
+
+		/**
+		 * @brief The duration a sleep step is assumed to take before any is measured, in seconds.
+		 *
+		 */
+		static const double INITIAL_SLEEP_ESTIMATE;
+
+		/**
+		 * @brief Creates a game loop running a simulation at a fixed rate.
+		 *
+		 * @param tick Advances the simulation by one step, given in seconds.
+		 * @param tickRate [Optional] The number of steps per second.
+		 * @param maxTicks [Optional] The largest number of steps run in a single frame.
+		 */
+		GameLoop(function<void(double)> tick, unsigned int tickRate = DEFAULT_TICK_RATE, unsigned int maxTicks = DEFAULT_MAX_TICKS);
+
+		/**
+		 * @brief Destroys the game loop object.
+		 *
+		 */
+		~GameLoop();
+
+		/**
+		 * @brief Sets the number of simulation steps per second.
+		 *
+		 * @param tickRate The number of steps per second.
+		 * @return [GameLoop *] This same game loop instance in order to allow for method chaining.
+		 */
+		GameLoop * setTickRate(unsigned int tickRate);
+
+		/**
+		 * @brief Sets the largest number of steps run in a single frame.
+		 *
+		 * @param maxTicks The largest number of steps, at least 1.
+		 * @return [GameLoop *] This same game loop instance in order to allow for method chaining.
+		 */
+		GameLoop * setMaxTicks(unsigned int maxTicks);
+
+		/**
+		 * @brief Limits the number of frames per second, frames finishing early sleeping until their time is up.
+		 *
+		 * @param frameRate The largest number of frames per second, 0 to leave frames uncapped.
+		 * @return [GameLoop *] This same game loop instance in order to allow for method chaining.
+		 */
+		GameLoop * setFrameCap(float frameRate);
+
+		/**
+		 * @brief Starts a new frame, sleeping first if the frame cap requires it, then runs as many simulation steps
+		 * as the real time elapsed since the last frame allows. When more steps are due than the loop may run,
+		 * the time left over is dropped. The first frame after creating or resetting the loop runs no step.
+		 *
+		 * @return [float] The position of the frame between the two last steps in [0, 1), to interpolate their states with.
+		 */
+		float advance();
+
+		/**
+		 * @brief Restarts the loop's clock without simulating the time elapsed since the last frame, after loading for instance.
+		 *
+		 * @return [GameLoop *] This same game loop instance in order to allow for method chaining.
+		 */
+		GameLoop * reset();
+
+		/**
+		 * @brief Returns the duration of a simulation step.
+		 *
+		 * @return [double] The duration of a step in seconds.
+		 */
+		inline double getTimestep() const { return timestep; };
+
+		/**
+		 * @brief Returns the time simulated so far.
+		 *
+		 * @return [double] The time simulated in seconds, a multiple of the step duration.
+		 */
+		inline double getTime() const { return time; };
+
+		/**
+		 * @brief Returns the simulation time the last frame shows, between the two last steps.
+		 *
+		 * @return [double] The interpolated simulation time in seconds.
+		 */
+		inline double getRenderTime() const { return time - (1.0 - alpha) * timestep; };
+
+		/**
+		 * @brief Returns the position of the last frame between the two last steps.
+		 *
+		 * @return [float] The interpolation factor in [0, 1).
+		 */
+		inline float getAlpha() const { return alpha; };
+
+		/**
+		 * @brief Returns the real duration of the last frame.
+		 *
+		 * @return [double] The time elapsed between the two last frames in seconds.
+		 */
+		inline double getFrameTime() const { return frameTime; };
+
+		/**
+		 * @brief Returns the number of simulation steps run so far.
+		 *
+		 * @return [unsigned long long] The number of steps.
+		 */
+		inline unsigned long long getTickCount() const { return tickCount; };
+
+		/**
+		 * @brief Returns the real time the loop could not simulate in time and dropped.
+		 *
+		 * @return [double] The time dropped in seconds.
+		 */
+		inline double getDroppedTime() const { return droppedTime; };
+
+};
@@ -0,0 +1,237 @@
+#include <algorithm>
+
+#include "LinearArena.h"
+#include "JobSystem.h"
+
+// The job system the calling thread is a worker of, and its index there.
+static thread_local const JobSystem * workerSystem = nullptr;
+static thread_local unsigned int workerIndex = 0;
+
+JobCounter::JobCounter() : value(0) {}
+
+JobSystem::WorkQueue::WorkQueue() : top(0), bottom(0), slots(new std::atomic<Job *>[QUEUE_CAPACITY]) {}
+
+JobSystem::WorkQueue::~WorkQueue() {
+	delete[] slots;
+}
+
+bool JobSystem::WorkQueue::push(Job * job) {
+	long long b = bottom.load(std::memory_order_relaxed);
+	long long t = top.load(std::memory_order_acquire);
+	if (b - t >= static_cast<long long>(QUEUE_CAPACITY))
+		return false;
+	slots[b & (QUEUE_CAPACITY - 1)].store(job, std::memory_order_relaxed);
+	bottom.store(b + 1, std::memory_order_release);
+	return true;
+}
+
+Job * JobSystem::WorkQueue::pop() {
+	long long b = bottom.load(std::memory_order_relaxed) - 1;
+
+	// Reserving the bottom slot must be visible to thieves before reading the top, hence sequentially consistent accesses.
+	bottom.store(b, std::memory_order_seq_cst);
+	long long t = top.load(std::memory_order_seq_cst);
+	if (t > b) {
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+	Job * job = slots[b & (QUEUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+
+	// The last job is raced for with the thieves by advancing the top.
+	if (t == b) {
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			job = nullptr;
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+Job * JobSystem::WorkQueue::steal() {
+	long long t = top.load(std::memory_order_seq_cst);
+	long long b = bottom.load(std::memory_order_seq_cst);
+	if (t >= b)
+		return nullptr;
+	Job * job = slots[t & (QUEUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return nullptr;
+	return job;
+}
+
+JobSystem::JobSystem(unsigned int numWorkers) : queued(0), injectedCount(0), sleeping(0) {
+	if (numWorkers == 0)
+		numWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+	for (unsigned int i = 0; i < numWorkers; i++)
+		queues.push_back(new WorkQueue());
+
+	// The calling thread is the first worker.
+	workerSystem = this;
+	workerIndex = 0;
+	for (unsigned int i = 1; i < numWorkers; i++)
+		workers.emplace_back(&JobSystem::work, this, i);
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread & worker : workers)
+		worker.join();
+
+	// Jobs left on the creating thread's queue are run by it.
+	Job * job;
+	while ((job = take(0)) != nullptr)
+		execute(job);
+
+	for (WorkQueue * queue : queues)
+		delete queue;
+	if (workerSystem == this)
+		workerSystem = nullptr;
+}
+
+unsigned int JobSystem::currentWorker() const {
+	return workerSystem == this ? workerIndex : static_cast<unsigned int>(queues.size());
+}
+
+void JobSystem::run(function<void()> task, JobCounter * counter, JobCounter * dependency) {
+	Job * job = new Job{ std::move(task), counter };
+	if (counter != nullptr)
+		counter->value.fetch_add(1, std::memory_order_relaxed);
+
+	// The job is kept by its dependency until it reaches zero, which the dependency's mutex decides.
+	if (dependency != nullptr) {
+		std::lock_guard<std::mutex> lock(dependency->mutex);
+		if (dependency->value.load(std::memory_order_acquire) > 0) {
+			dependency->dependents.push_back(job);
+			return;
+		}
+	}
+	enqueue(job);
+}
+
+void JobSystem::enqueue(Job * job) {
+	queued.fetch_add(1, std::memory_order_seq_cst);
+	unsigned int worker = currentWorker();
+	if (worker == queues.size() || !queues[worker]->push(job)) {
+		std::lock_guard<std::mutex> lock(injectedMutex);
+		injected.push_back(job);
+		injectedCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Either a worker going to sleep sees the job queued, or this sees it asleep and wakes it once it waits.
+	if (sleeping.load(std::memory_order_seq_cst) > 0) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+		}
+		wake.notify_one();
+	}
+}
+
+Job * JobSystem::take(unsigned int worker) {
+	Job * job = nullptr;
+	unsigned int count = static_cast<unsigned int>(queues.size());
+	if (worker < count)
+		job = queues[worker]->pop();
+
+	if (job == nullptr && injectedCount.load(std::memory_order_relaxed) > 0) {
+		std::lock_guard<std::mutex> lock(injectedMutex);
+		if (!injected.empty()) {
+			job = injected.front();
+			injected.pop_front();
+			injectedCount.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	// Steal from the other workers, starting with the next one so that thieves spread over the victims.
+	for (unsigned int i = 1; job == nullptr && i <= count; i++) {
+		unsigned int victim = (worker + i) % count;
+		if (victim != worker)
+			job = queues[victim]->steal();
+	}
+
+	if (job != nullptr)
+		queued.fetch_sub(1, std::memory_order_relaxed);
+	return job;
+}
+
+void JobSystem::execute(Job * job) {
+	LinearArena * arena = LinearArena::getThreadArena();
+	LinearArena::Marker marker = arena->getMarker();
+	job->task();
+	arena->rewind(marker);
+	JobCounter * counter = job->counter;
+	delete job;
+	if (counter == nullptr)
+		return;
+
+	// Decrements that cannot reach zero skip the mutex.
+	unsigned int value = counter->value.load(std::memory_order_relaxed);
+	while (value > 1)
+		if (counter->value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+			return;
+
+	// The last decrement releases the dependents. Waiters lock the mutex once they see zero,
+	// so the counter is not destroyed before it is unlocked here.
+	vector<Job *> ready;
+	{
+		std::lock_guard<std::mutex> lock(counter->mutex);
+		if (counter->value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			ready.swap(counter->dependents);
+	}
+	for (Job * dependent : ready)
+		enqueue(dependent);
+}
+
+void JobSystem::wait(JobCounter * counter) {
+	unsigned int worker = currentWorker();
+	while (!counter->isDone()) {
+		Job * job = take(worker);
+		if (job != nullptr)
+			execute(job);
+		else
+			std::this_thread::yield();
+	}
+	std::lock_guard<std::mutex> lock(counter->mutex);
+}
+
+void JobSystem::parallelFor(unsigned int begin, unsigned int end, const function<void(unsigned int, unsigned int)> & body, unsigned int grain) {
+	if (begin >= end)
+		return;
+	unsigned int count = end - begin;
+	if (grain == 0)
+		grain = std::max(count / (getWorkerCount() * 4), 1u);
+
+	// The calling thread takes the first chunk itself.
+	JobCounter counter;
+	for (unsigned int chunk = begin + grain; chunk < end; chunk += grain) {
+		unsigned int chunkEnd = chunk + std::min(grain, end - chunk);
+		run([&body, chunk, chunkEnd] { body(chunk, chunkEnd); }, &counter);
+	}
+	body(begin, begin + std::min(grain, count));
+	wait(&counter);
+}
+
+void JobSystem::work(unsigned int worker) {
+	workerSystem = this;
+	workerIndex = worker;
+	while (true) {
+		Job * job = take(worker);
+		for (unsigned int spin = 0; job == nullptr && spin < SPIN_COUNT; spin++) {
+			std::this_thread::yield();
+			job = take(worker);
+		}
+		if (job != nullptr) {
+			execute(job);
+			continue;
+		}
+
+		// Sleep until a job is queued, exiting once the system is stopping and no job is left.
+		std::unique_lock<std::mutex> lock(mutex);
+		sleeping.fetch_add(1, std::memory_order_seq_cst);
+		wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_seq_cst) > 0; });
+		sleeping.fetch_sub(1, std::memory_order_seq_cst);
+		if (stopping && queued.load(std::memory_order_seq_cst) == 0)
+			return;
+	}
+}
@@ -0,0 +1,237 @@
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+
+using std::vector;
+using std::deque;
+using std::function;
+
+#pragma once
+
+class JobCounter;
+
+/**
+ * @brief A job queued on the job system, owned by the system from the moment it is run until it has finished.
+ *
+ */
+struct Job {
+	function<void()> task;
+	JobCounter * counter;
+};
+
+/**
+ * @brief Counts the unfinished jobs of a group, each job run with the counter incrementing it and decrementing it once finished.
+ * Jobs may wait on a counter to reach zero before being queued, and threads may wait on it while running other jobs.
+ * A counter must outlive the jobs referencing it, and should be waited on before being destroyed.
+ *
+ */
+class JobCounter {
+
+	friend class JobSystem;
+
+	private:
+		/**
+		 * @brief The number of unfinished jobs.
+		 *
+		 */
+		std::atomic<unsigned int> value;
+
+		/**
+		 * @brief The jobs waiting for the counter to reach zero, and the mutex guarding them and the last decrement.
+		 *
+		 */
+		vector<Job *> dependents;
+		std::mutex mutex;
+
+	public:
+		/**
+		 * @brief Creates a counter with no unfinished job.
+		 *
+		 */
+		JobCounter();
+
+		/**
+		 * @brief Returns whether or not every job counted has finished.
+		 *
+		 * @return [bool] True if the counter is zero.
+		 */
+		inline bool isDone() const { return value.load(std::memory_order_acquire) == 0; };
+
+		/**
+		 * @brief Returns the number of unfinished jobs.
+		 *
+		 * @return [unsigned int] The counter's value.
+		 */
+		inline unsigned int getValue() const { return value.load(std::memory_order_acquire); };
+
+};
+
+class JobSystem {
+
+	private:
+		/**
+		 * @brief A worker's queue of jobs, the worker pushing and popping at the bottom while other threads steal from the top
+		 * (Chase and Lev's lock-free deque). Its indices are kept on separate cache lines.
+		 *
+		 */
+		struct WorkQueue {
+			std::atomic<long long> top;
+			char topPadding[64];
+			std::atomic<long long> bottom;
+			char bottomPadding[64];
+			std::atomic<Job *> * slots;
+
+			WorkQueue();
+			~WorkQueue();
+			bool push(Job * job);
+			Job * pop();
+			Job * steal();
+		};
+
+		/**
+		 * @brief The queue of each worker, the first being the thread that created the system.
+		 *
+		 */
+		vector<WorkQueue *> queues;
+
+		/**
+		 * @brief The worker threads, one less than the number of queues.
+		 *
+		 */
+		vector<std::thread> workers;
+
+		/**
+		 * @brief The jobs run from threads that are not workers, or while their worker's queue was full.
+		 *
+		 */
+		deque<Job *> injected;
+		std::mutex injectedMutex;
+
+		/**
+		 * @brief The number of jobs queued and not yet taken, and of injected ones among them.
+		 *
+		 */
+		std::atomic<unsigned int> queued;
+		std::atomic<unsigned int> injectedCount;
+
+		/**
+		 * @brief The number of workers asleep, waiting for a job to be queued or the system to stop.
+		 *
+		 */
+		std::atomic<unsigned int> sleeping;
+
+		/**
+		 * @brief Whether or not the workers should exit once no job is left.
+		 *
+		 */
+		bool stopping = false;
+
+		/**
+		 * @brief Guards the workers' sleep, signaling them when jobs are queued.
+		 *
+		 */
+		std::mutex mutex;
+		std::condition_variable wake;
+
+		/**
+		 * @brief Queues a job whose dependency is done, on the calling worker's queue if there is one.
+		 *
+		 * @param job The job to queue.
+		 */
+		void enqueue(Job * job);
+
+		/**
+		 * @brief Takes a queued job, first from the calling worker's own queue, then from the injected jobs,
+		 * and then from the other workers' queues.
+		 *
+		 * @param worker The index of the calling worker, or the number of queues for threads that are not workers.
+		 * @return [Job *] The job taken, null if none was found.
+		 */
+		Job * take(unsigned int worker);
+
+		/**
+		 * @brief Runs and deletes a job, then decrements its counter, queuing the jobs waiting on it once it reaches zero.
+		 * The calling thread's arena is rewound once the job has run, so jobs may use it as scratch memory.
+		 *
+		 * @param job The job to run.
+		 */
+		void execute(Job * job);
+
+		/**
+		 * @brief Runs jobs until the system stops, sleeping while none is queued.
+		 *
+		 * @param worker The index of the worker.
+		 */
+		void work(unsigned int worker);
+
+		/**
+		 * @brief Returns the index of the calling thread's queue.
+		 *
+		 * @return [unsigned int] The index of the calling worker, or the number of queues for threads that are not workers.
+		 */
+		unsigned int currentWorker() const;
+
+	public:
+		/**
+		 * @brief The number of jobs each worker's queue holds, further jobs being injected instead.
+		 *
+		 */
+		static const unsigned int QUEUE_CAPACITY = 4096;
+
+		/**
+		 * @brief The number of times a worker looks for jobs again before going to sleep.
+		 *
+		 */
+		static const unsigned int SPIN_COUNT = 64;
+
+		/**
+		 * @brief Creates a job system whose first worker is the calling thread, taking part in running jobs while it waits on counters.
+		 *
+		 * @param numWorkers [Optional] The number of workers including the calling thread, 0 to use one per hardware thread.
+		 */
+		JobSystem(unsigned int numWorkers = 0);
+
+		/**
+		 * @brief Finishes the jobs already queued and joins the worker threads. Jobs waiting on an unfinished counter are leaked.
+		 *
+		 */
+		~JobSystem();
+
+		/**
+		 * @brief Runs a job on any worker.
+		 *
+		 * @param task The job's work.
+		 * @param counter [Optional] The counter incremented now and decremented once the job has finished.
+		 * @param dependency [Optional] A counter the job waits on to reach zero before being queued.
+		 */
+		void run(function<void()> task, JobCounter * counter = nullptr, JobCounter * dependency = nullptr);
+
+		/**
+		 * @brief Splits a range of indices into chunks run as jobs, and waits for all of them to finish.
+		 *
+		 * @param begin The first index of the range.
+		 * @param end The index past the last one of the range.
+		 * @param body Processes the indices of a chunk, from its first index to the index past its last one.
+		 * @param grain [Optional] The number of indices of each chunk, 0 to split the range into a few chunks per worker.
+		 */
+		void parallelFor(unsigned int begin, unsigned int end, const function<void(unsigned int, unsigned int)> & body, unsigned int grain = 0);
+
+		/**
+		 * @brief Runs queued jobs on the calling thread until a counter reaches zero.
+		 *
+		 * @param counter The counter to wait on.
+		 */
+		void wait(JobCounter * counter);
+
+		/**
+		 * @brief Returns the number of workers, including the thread that created the system.
+		 *
+		 * @return [unsigned int] The number of workers.
+		 */
+		inline unsigned int getWorkerCount() const { return static_cast<unsigned int>(queues.size()); };
+
+};
@@ -0,0 +1,253 @@
+#include <fstream>
+#include <cstring>
+
+#include "KTX2.h"
+#include "VirtualFileSystem.h"
+
+using std::ofstream;
+
+// The 12 byte identifier every KTX2 file starts with.
+static const unsigned char IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+// Sizes of the fixed header, which includes the section index, and of each level index entry.
+static const unsigned int HEADER_SIZE = 80;
+static const unsigned int LEVEL_INDEX_SIZE = 24;
+
+// Khronos data format descriptor values.
+static const unsigned int DFD_BLOCK_HEADER_SIZE = 24;
+static const unsigned int DFD_SAMPLE_SIZE = 16;
+static const unsigned int DFD_VERSION = 2;
+static const unsigned int DFD_PRIMARIES_BT709 = 1;
+static const unsigned int DFD_TRANSFER_LINEAR = 1;
+
+static inline void writeU32(vector<unsigned char> & dst, unsigned int offset, unsigned int value) {
+	memcpy(dst.data() + offset, &value, sizeof(value));
+}
+static inline void writeU64(vector<unsigned char> & dst, unsigned int offset, unsigned long long value) {
+	memcpy(dst.data() + offset, &value, sizeof(value));
+}
+static inline unsigned int readU32(const unsigned char * src, size_t offset) {
+	unsigned int value;
+	memcpy(&value, src + offset, sizeof(value));
+	return value;
+}
+static inline unsigned long long readU64(const unsigned char * src, size_t offset) {
+	unsigned long long value;
+	memcpy(&value, src + offset, sizeof(value));
+	return value;
+}
+
+unsigned int KTX2::getBlockSize(TextureFormat format) {
+	switch (format) {
+		case TEXTURE_FORMAT_BC1:
+			return 8;
+		case TEXTURE_FORMAT_BC3:
+		case TEXTURE_FORMAT_BC5:
+		case TEXTURE_FORMAT_BC7:
+			return 16;
+		default:
+			return 0;
+	}
+}
+
+unsigned int KTX2::getLevelSize(TextureFormat format, unsigned int width, unsigned int height, unsigned int level) {
+	unsigned int levelWidth = width >> level > 0 ? width >> level : 1;
+	unsigned int levelHeight = height >> level > 0 ? height >> level : 1;
+	return ((levelWidth + 3) / 4) * ((levelHeight + 3) / 4) * getBlockSize(format);
+}
+
+GLenum KTX2::getInternalFormat(TextureFormat format) {
+	switch (format) {
+		case TEXTURE_FORMAT_BC1:
+			return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		case TEXTURE_FORMAT_BC3:
+			return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case TEXTURE_FORMAT_BC5:
+			return GL_COMPRESSED_RG_RGTC2;
+		case TEXTURE_FORMAT_BC7:
+			return GL_COMPRESSED_RGBA_BPTC_UNORM_ARB;
+		default:
+			return GL_NONE;
+	}
+}
+
+bool KTX2::read(const char * file, Image & image, unsigned int firstLevel, unsigned int lastLevel) {
+
+	// The file is mapped, only the pages holding the requested levels are read from disk.
+	FileView view = VirtualFileSystem::getShared()->open(file);
+	return view.isValid() && read(view.getData(), view.getSize(), image, firstLevel, lastLevel);
+}
+
+bool KTX2::read(const unsigned char * data, size_t size, Image & image, unsigned int firstLevel, unsigned int lastLevel) {
+
+	// Check the header.
+	if (size < HEADER_SIZE || memcmp(data, IDENTIFIER, sizeof(IDENTIFIER)) != 0)
+		return false;
+
+	// Only 2D textures and 2D texture arrays without supercompression or faces are supported.
+	TextureFormat format = static_cast<TextureFormat>(readU32(data, 12));
+	unsigned int width = readU32(data, 20);
+	unsigned int height = readU32(data, 24);
+	unsigned int depth = readU32(data, 28);
+	unsigned int layers = readU32(data, 32);
+	unsigned int faces = readU32(data, 36);
+	unsigned int levelCount = readU32(data, 40);
+	unsigned int supercompression = readU32(data, 44);
+	if (getBlockSize(format) == 0 || width == 0 || height == 0 || depth > 0 || faces != 1 || supercompression != 0)
+		return false;
+
+	// Read the key/value pairs, each one a null terminated key followed by its value and padded to 4 bytes.
+	unsigned long long kvdOffset = readU32(data, 56);
+	unsigned long long kvdSize = readU32(data, 60);
+	map<string, string> metadata;
+	if (kvdOffset + kvdSize > size)
+		return false;
+	const unsigned char * kvd = data + kvdOffset;
+	for (size_t offset = 0; offset + 4 <= kvdSize;) {
+		unsigned int length = readU32(kvd, offset);
+		if (offset + 4 + length > kvdSize)
+			return false;
+		string pair(reinterpret_cast<const char *>(kvd + offset + 4), length);
+		size_t separator = pair.find('\0');
+		if (separator != string::npos) {
+			string value = pair.substr(separator + 1);
+			if (!value.empty() && value.back() == '\0')
+				value.pop_back();
+			metadata[pair.substr(0, separator)] = value;
+		}
+		offset += (4 + static_cast<size_t>(length) + 3) / 4 * 4;
+	}
+
+	// A level count of 0 asks for the mip chain to be generated at load time, which compressed textures cannot do.
+	if (levelCount == 0 || HEADER_SIZE + static_cast<unsigned long long>(levelCount) * LEVEL_INDEX_SIZE > size)
+		return false;
+	const unsigned char * levelIndex = data + HEADER_SIZE;
+
+	// Copy the requested levels, validating their size against the texture's dimensions.
+	image.format = format;
+	image.width = width;
+	image.height = height;
+	image.layers = layers;
+	image.metadata = metadata;
+	image.levels.assign(levelCount, vector<unsigned char>());
+	for (unsigned int l = firstLevel; l < levelCount && l < lastLevel; l++) {
+		unsigned long long offset = readU64(levelIndex, l * LEVEL_INDEX_SIZE);
+		unsigned long long length = readU64(levelIndex, l * LEVEL_INDEX_SIZE + 8);
+		if (length != static_cast<unsigned long long>(getLevelSize(format, width, height, l)) * (layers > 0 ? layers : 1) || offset + length > size)
+			return false;
+		image.levels[l].assign(data + offset, data + offset + length);
+	}
+
+	return true;
+}
+
+bool KTX2::write(const char * file, const Image & image) {
+
+	unsigned int blockSize = getBlockSize(image.format);
+	unsigned int levelCount = static_cast<unsigned int>(image.levels.size());
+	if (blockSize == 0 || levelCount == 0)
+		return false;
+
+	// Describe the block layout of the format.
+	unsigned int colorModel = 0;
+	vector<unsigned int> channels;
+	switch (image.format) {
+		case TEXTURE_FORMAT_BC1:
+			colorModel = 128;
+			channels = { 15 };
+			break;
+		case TEXTURE_FORMAT_BC3:
+			colorModel = 130;
+			channels = { 15, 0 };
+			break;
+		case TEXTURE_FORMAT_BC5:
+			colorModel = 132;
+			channels = { 0, 1 };
+			break;
+		case TEXTURE_FORMAT_BC7:
+			colorModel = 134;
+			channels = { 0 };
+			break;
+	}
+	unsigned int dfdOffset = HEADER_SIZE + levelCount * LEVEL_INDEX_SIZE;
+	unsigned int dfdSize = 4 + DFD_BLOCK_HEADER_SIZE + static_cast<unsigned int>(channels.size()) * DFD_SAMPLE_SIZE;
+
+	// Key/value pairs, sorted by key, each padded to 4 bytes.
+	vector<unsigned char> kvd;
+	for (auto & pair : image.metadata) {
+		unsigned int length = static_cast<unsigned int>(pair.first.size() + pair.second.size() + 2);
+		size_t offset = kvd.size();
+		kvd.resize(offset + (4 + length + 3) / 4 * 4, 0);
+		writeU32(kvd, static_cast<unsigned int>(offset), length);
+		memcpy(kvd.data() + offset + 4, pair.first.c_str(), pair.first.size() + 1);
+		memcpy(kvd.data() + offset + 4 + pair.first.size() + 1, pair.second.c_str(), pair.second.size() + 1);
+	}
+	unsigned int kvdOffset = dfdOffset + dfdSize;
+
+	// Levels are stored from the smallest to the largest, each aligned to the block size.
+	vector<unsigned long long> offsets(levelCount);
+	unsigned long long size = kvdOffset + kvd.size();
+	for (unsigned int l = levelCount; l-- > 0;) {
+		size = (size + blockSize - 1) / blockSize * blockSize;
+		offsets[l] = size;
+		size += image.levels[l].size();
+	}
+
+	vector<unsigned char> data(static_cast<size_t>(size), 0);
+
+	// Header.
+	memcpy(data.data(), IDENTIFIER, sizeof(IDENTIFIER));
+	writeU32(data, 12, image.format);
+	writeU32(data, 16, 1);
+	writeU32(data, 20, image.width);
+	writeU32(data, 24, image.height);
+	writeU32(data, 28, 0);
+	writeU32(data, 32, image.layers);
+	writeU32(data, 36, 1);
+	writeU32(data, 40, levelCount);
+	writeU32(data, 44, 0);
+
+	// Section index, without supercompression data.
+	writeU32(data, 48, dfdOffset);
+	writeU32(data, 52, dfdSize);
+	writeU32(data, 56, kvd.empty() ? 0 : kvdOffset);
+	writeU32(data, 60, static_cast<unsigned int>(kvd.size()));
+
+	// Level index.
+	for (unsigned int l = 0; l < levelCount; l++) {
+		writeU64(data, HEADER_SIZE + l * LEVEL_INDEX_SIZE, offsets[l]);
+		writeU64(data, HEADER_SIZE + l * LEVEL_INDEX_SIZE + 8, image.levels[l].size());
+		writeU64(data, HEADER_SIZE + l * LEVEL_INDEX_SIZE + 16, image.levels[l].size());
+	}
+
+	// Data format descriptor, a single basic descriptor block with one sample per channel.
+	writeU32(data, dfdOffset, dfdSize);
+	writeU32(data, dfdOffset + 4, 0);
+	writeU32(data, dfdOffset + 8, DFD_VERSION | (dfdSize - 4) << 16);
+	writeU32(data, dfdOffset + 12, colorModel | DFD_PRIMARIES_BT709 << 8 | DFD_TRANSFER_LINEAR << 16);
+	writeU32(data, dfdOffset + 16, 3 | 3 << 8);
+	writeU32(data, dfdOffset + 20, blockSize);
+	writeU32(data, dfdOffset + 24, 0);
+	unsigned int bitsPerChannel = blockSize * 8 / static_cast<unsigned int>(channels.size());
+	for (unsigned int s = 0; s < channels.size(); s++) {
+		unsigned int sample = dfdOffset + 4 + DFD_BLOCK_HEADER_SIZE + s * DFD_SAMPLE_SIZE;
+		writeU32(data, sample, s * bitsPerChannel | (bitsPerChannel - 1) << 16 | channels[s] << 24);
+		writeU32(data, sample + 4, 0);
+		writeU32(data, sample + 8, 0);
+		writeU32(data, sample + 12, 0xFFFFFFFF);
+	}
+
+	// Key/value data.
+	if (!kvd.empty())
+		memcpy(data.data() + kvdOffset, kvd.data(), kvd.size());
+
+	// Level data.
+	for (unsigned int l = 0; l < levelCount; l++)
+		memcpy(data.data() + offsets[l], image.levels[l].data(), image.levels[l].size());
+
+	ofstream stream(file, std::ios::binary);
+	if (!stream)
+		return false;
+	stream.write(reinterpret_cast<const char *>(data.data()), data.size());
+	return static_cast<bool>(stream);
+}
@@ -0,0 +1,104 @@
+#include <map>
+#include <string>
+#include <vector>
+#include <climits>
+
+#include <glad/glad.h>
+
+using std::map;
+using std::string;
+using std::vector;
+
+#pragma once
+
+/**
+ * @brief The block-compressed texture formats supported by the engine, valued after their Vulkan format identifiers
+ * as stored in KTX2 files.
+ *
+ */
+enum TextureFormat : unsigned int {
+	TEXTURE_FORMAT_BC1 = 133,
+	TEXTURE_FORMAT_BC3 = 137,
+	TEXTURE_FORMAT_BC5 = 141,
+	TEXTURE_FORMAT_BC7 = 145
+};
+
+class KTX2 {
+
+	public:
+		/**
+		 * @brief A 2D texture or texture array and its complete mip chain, level 0 being the full resolution image.
+		 * Each level holds all the array layers one after the other. Plain 2D textures have 0 layers.
+		 * Metadata is stored as key/value pairs.
+		 *
+		 */
+		struct Image {
+			TextureFormat format;
+			unsigned int width;
+			unsigned int height;
+			unsigned int layers = 0;
+			vector<vector<unsigned char>> levels;
+			map<string, string> metadata;
+		};
+
+		/**
+		 * @brief Returns the number of bytes used to store each 4x4 block of texels in the given format.
+		 *
+		 * @param format The texture format.
+		 * @return [unsigned int] The size of a block in bytes, or 0 if the format is unknown.
+		 */
+		static unsigned int getBlockSize(TextureFormat format);
+
+		/**
+		 * @brief Returns the OpenGL internal format corresponding to the given texture format.
+		 *
+		 * @param format The texture format.
+		 * @return [GLenum] The OpenGL compressed internal format, or GL_NONE if the format is unknown.
+		 */
+		static GLenum getInternalFormat(TextureFormat format);
+
+		/**
+		 * @brief Returns the number of bytes used by a mip level of a texture, for a single array layer.
+		 *
+		 * @param format The texture format.
+		 * @param width The width of the texture at full resolution.
+		 * @param height The height of the texture at full resolution.
+		 * @param level The mip level.
+		 * @return [unsigned int] The size of the mip level in bytes.
+		 */
+		static unsigned int getLevelSize(TextureFormat format, unsigned int width, unsigned int height, unsigned int level);
+
+		/**
+		 * @brief Reads a KTX2 file containing a single block-compressed 2D texture or 2D texture array.
+		 * Only the levels in the range [firstLevel, lastLevel) are read, the others are left empty.
+		 *
+		 * @param file The virtual path of the file to read.
+		 * @param image The image receiving the texture's format, size and mip levels.
+		 * @param firstLevel [Optional] The finest mip level to read.
+		 * @param lastLevel [Optional] One past the coarsest mip level to read.
+		 * @return [bool] True if the file was read successfully, false otherwise.
+		 */
+		static bool read(const char * file, Image & image, unsigned int firstLevel = 0, unsigned int lastLevel = UINT_MAX);
+
+		/**
+		 * @brief Reads a KTX2 file already in memory. Only the levels in the range [firstLevel, lastLevel) are copied, the others are left empty.
+		 *
+		 * @param data The contents of the file.
+		 * @param size The size of the file in bytes.
+		 * @param image The image receiving the texture's format, size and mip levels.
+		 * @param firstLevel [Optional] The finest mip level to read.
+		 * @param lastLevel [Optional] One past the coarsest mip level to read.
+		 * @return [bool] True if the file was read successfully, false otherwise.
+		 */
+		static bool read(const unsigned char * data, size_t size, Image & image, unsigned int firstLevel = 0, unsigned int lastLevel = UINT_MAX);
+
+		/**
+		 * @brief Writes a block-compressed 2D texture or 2D texture array to a KTX2 file.
+		 *
+		 * @param file The path of the file to write.
+		 * @param image The texture to write.
+		 * @return [bool] True if the file was written successfully, false otherwise.
+		 */
+		static bool write(const char * file, const Image & image);
+
+};
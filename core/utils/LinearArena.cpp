@@ -0,0 +1,49 @@
+#include <cstdlib>
+#include <algorithm>
+
+#include "AllocationStats.h"
+#include "LinearArena.h"
+
+LinearArena::LinearArena(size_t capacity) :
+	memory(static_cast<unsigned char *>(std::malloc(capacity))), capacity(memory != nullptr ? capacity : 0) {}
+
+LinearArena::~LinearArena() {
+	reset();
+	std::free(memory);
+}
+
+void * LinearArena::allocate(size_t size, size_t alignment) {
+	AllocationStats::record(ALLOCATION_ARENA, size);
+	size_t start = (reinterpret_cast<size_t>(memory) + offset + alignment - 1) & ~(alignment - 1);
+	start -= reinterpret_cast<size_t>(memory);
+	if (start + size <= capacity) {
+		offset = start + size;
+		peak = std::max(peak, offset + overflowBytes);
+		return memory + start;
+	}
+
+	// Too large for what is left, served from the heap until the arena rewinds past it.
+	void * block = std::malloc(std::max(size, alignment) + alignment);
+	overflow.push_back(block);
+	overflowBytes += size;
+	peak = std::max(peak, offset + overflowBytes);
+	return reinterpret_cast<void *>((reinterpret_cast<size_t>(block) + alignment - 1) & ~(alignment - 1));
+}
+
+void LinearArena::rewind(const Marker & marker) {
+	offset = marker.offset;
+	while (overflow.size() > marker.overflowCount) {
+		std::free(overflow.back());
+		overflow.pop_back();
+	}
+	overflowBytes = marker.overflowBytes;
+}
+
+void LinearArena::reset() {
+	rewind({ 0, 0, 0 });
+}
+
+LinearArena * LinearArena::getThreadArena() {
+	static thread_local LinearArena arena;
+	return &arena;
+}
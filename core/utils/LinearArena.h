@@ -0,0 +1,130 @@
+#include <vector>
+#include <cstddef>
+
+using std::vector;
+
+#pragma once
+class LinearArena {
+
+	public:
+		/**
+		 * @brief A position in the arena to rewind to, freeing everything allocated after it.
+		 *
+		 */
+		struct Marker {
+			size_t offset;
+			size_t overflowCount;
+			size_t overflowBytes;
+		};
+
+	private:
+		/**
+		 * @brief The arena's memory, its size in bytes, and the offset of its first free byte.
+		 *
+		 */
+		unsigned char * memory;
+		size_t capacity;
+		size_t offset = 0;
+
+		/**
+		 * @brief The heap blocks serving allocations that did not fit in the arena, freed with the allocations made before them,
+		 * and the number of bytes they serve.
+		 *
+		 */
+		vector<void *> overflow;
+		size_t overflowBytes = 0;
+
+		/**
+		 * @brief The most bytes in use at once since the arena was created, counting overflowing allocations.
+		 *
+		 */
+		size_t peak = 0;
+
+	public:
+		/**
+		 * @brief The default size of an arena in bytes.
+		 *
+		 */
+		static const size_t DEFAULT_CAPACITY = 1 << 20;
+
+		/**
+		 * @brief Creates an arena.
+		 *
+		 * @param capacity [Optional] The size of the arena in bytes. Allocations past it fall back to the heap.
+		 */
+		LinearArena(size_t capacity = DEFAULT_CAPACITY);
+
+		/**
+		 * @brief Frees the arena's memory and destroys the arena object.
+		 *
+		 */
+		~LinearArena();
+
+		/**
+		 * @brief Allocates memory by bumping the arena's offset. It is freed by rewinding or resetting the arena, never individually.
+		 *
+		 * @param size The size of the allocation in bytes.
+		 * @param alignment [Optional] The alignment of the allocation, a power of two.
+		 * @return [void *] The allocated memory.
+		 */
+		void * allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		/**
+		 * @brief Allocates an array of objects, which are not constructed.
+		 *
+		 * @param count The number of objects.
+		 * @return [T *] The first object of the array.
+		 */
+		template <typename T>
+		inline T * allocate(size_t count) { return static_cast<T *>(allocate(count * sizeof(T), alignof(T))); };
+
+		/**
+		 * @brief Returns the arena's current position, to later free everything allocated after it.
+		 *
+		 * @return [Marker] The current position.
+		 */
+		inline Marker getMarker() const { return { offset, overflow.size(), overflowBytes }; };
+
+		/**
+		 * @brief Frees everything allocated since a marker was taken.
+		 *
+		 * @param marker The position to return to.
+		 */
+		void rewind(const Marker & marker);
+
+		/**
+		 * @brief Frees everything allocated in the arena, at the end of a frame for instance.
+		 *
+		 */
+		void reset();
+
+		/**
+		 * @brief Returns the number of bytes in use in the arena, not counting overflowing allocations.
+		 *
+		 * @return [size_t] The arena's offset in bytes.
+		 */
+		inline size_t getUsed() const { return offset; };
+
+		/**
+		 * @brief Returns the size of the arena.
+		 *
+		 * @return [size_t] The arena's capacity in bytes.
+		 */
+		inline size_t getCapacity() const { return capacity; };
+
+		/**
+		 * @brief Returns the most bytes in use at once, which should stay below the capacity.
+		 *
+		 * @return [size_t] The peak usage in bytes, counting overflowing allocations.
+		 */
+		inline size_t getPeak() const { return peak; };
+
+		/**
+		 * @brief Returns the arena of the calling thread, created on first use and freed when the thread exits.
+		 * Threads running frames reset their arena each frame, and job system workers rewind theirs after each job.
+		 *
+		 * @return [LinearArena *] The calling thread's arena.
+		 */
+		static LinearArena * getThreadArena();
+
+};
@@ -1,74 +1,178 @@
+// Decoded images are allocated from the shared buffer pool so their buffers get reused.
+#include "BufferPool.h"
+#define STBI_MALLOC(size) BufferPool::getShared()->allocate(size)
+#define STBI_REALLOC(buffer, size) BufferPool::getShared()->reallocate(buffer, size)
+#define STBI_FREE(buffer) BufferPool::getShared()->release(buffer)
+
+// Images are decoded on several threads at once, each keeping its own failure reason.
+#define STBI_THREAD_LOCAL thread_local
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
-#include "Loader.h"
+#include <thread>
+#include <sstream>
+#include <algorithm>
 
-Loader::Loader() {};
+#include "Loader.h"
+#include "TexturePacker.h"
+#include "AssimpIOSystem.h"
+#include "VirtualFileSystem.h"
+#include "../render/GLStateCache.h"
+#include "../render/ResourceManager.h"
+#include "../render/OcclusionCuller.h"
+
+const char * Loader::MODEL_DIRECTORY = "Models/";
+const char * Loader::TEXTURE_DIRECTORY = "Textures/";
+
+Loader::Loader() {
+	importer.SetIOHandler(new AssimpIOSystem());
+};
 Loader::~Loader() {};
 
-void Loader::normalizeWeights(vector<vertexJointWeight>* weights, unsigned int numVertices, unsigned int numWeightsPerVertex, unsigned int * dstJointIDs, float * dstWeights) {
+// Minimum number of bone weights handled by each thread when gathering joint influences.
+static const unsigned int MIN_WEIGHTS_PER_THREAD = 16384;
+
+void Loader::insertInfluence(vertexInfluences & influences, unsigned int numInfluences, unsigned int jointID, float weight) {
+
+	// Weaker than all the influences already kept.
+	if (weight <= influences.weights[numInfluences - 1])
+		return;
+
+	// Shift the weaker influences down, dropping the weakest.
+	unsigned int i = numInfluences - 1;
+	while (i > 0 && influences.weights[i - 1] < weight) {
+		influences.jointIDs[i] = influences.jointIDs[i - 1];
+		influences.weights[i] = influences.weights[i - 1];
+		i--;
+	}
+
+	influences.jointIDs[i] = jointID;
+	influences.weights[i] = weight;
+}
+
+void Loader::gatherInfluences(aiMesh * mesh, unsigned int numInfluences, vertexInfluences * dst) {
+
+	// Inserts the weights of a range of bones into an array of per-vertex influences.
+	auto gather = [mesh, numInfluences](vertexInfluences * influences, unsigned int first, unsigned int last) {
+		for (unsigned int b = first; b < last; b++) {
+			aiBone * bone = mesh->mBones[b];
+			for (unsigned int w = 0; w < bone->mNumWeights; w++)
+				insertInfluence(influences[bone->mWeights[w].mVertexId], numInfluences, b, bone->mWeights[w].mWeight);
+		}
+	};
+
+	memset(dst, 0, mesh->mNumVertices * sizeof(vertexInfluences));
+
+	// Only spread the work over several threads when there is enough of it.
+	unsigned int totalWeights = 0;
+	for (unsigned int b = 0; b < mesh->mNumBones; b++)
+		totalWeights += mesh->mBones[b]->mNumWeights;
+	unsigned int numThreads = std::min({ std::max(1u, std::thread::hardware_concurrency()), mesh->mNumBones, totalWeights / MIN_WEIGHTS_PER_THREAD });
+	if (numThreads <= 1) {
+		gather(dst, 0, mesh->mNumBones);
+		return;
+	}
+
+	// Split the bones into contiguous ranges holding roughly the same number of weights.
+	vector<unsigned int> ranges = { 0 };
+	unsigned int weightsInRange = 0;
+	for (unsigned int b = 0; b < mesh->mNumBones && ranges.size() < numThreads; b++) {
+		weightsInRange += mesh->mBones[b]->mNumWeights;
+		if (weightsInRange >= totalWeights / numThreads) {
+			ranges.push_back(b + 1);
+			weightsInRange = 0;
+		}
+	}
+	if (ranges.back() != mesh->mNumBones)
+		ranges.push_back(mesh->mNumBones);
+	numThreads = static_cast<unsigned int>(ranges.size() - 1);
+
+	// Each thread gathers its bones into its own array, the first one directly into the destination.
+	vector<vector<vertexInfluences>> partials(numThreads - 1, vector<vertexInfluences>(mesh->mNumVertices));
+	vector<std::thread> threads;
+	for (unsigned int t = 0; t < numThreads; t++) {
+		vertexInfluences * target = t == 0 ? dst : partials[t - 1].data();
+		if (t > 0)
+			memset(target, 0, mesh->mNumVertices * sizeof(vertexInfluences));
+		threads.emplace_back(gather, target, ranges[t], ranges[t + 1]);
+	}
+	for (std::thread & thread : threads)
+		thread.join();
+	threads.clear();
+
+	// Merge the partial results in bone order, splitting the vertices between the threads.
+	unsigned int verticesPerThread = (mesh->mNumVertices + numThreads - 1) / numThreads;
+	for (unsigned int t = 0; t < numThreads; t++)
+		threads.emplace_back([&, t]() {
+			unsigned int last = std::min(mesh->mNumVertices, (t + 1) * verticesPerThread);
+			for (unsigned int v = t * verticesPerThread; v < last; v++)
+				for (const vector<vertexInfluences> & partial : partials)
+					for (unsigned int i = 0; i < numInfluences && partial[v].weights[i] > 0.0f; i++)
+						insertInfluence(dst[v], numInfluences, partial[v].jointIDs[i], partial[v].weights[i]);
+		});
+	for (std::thread & thread : threads)
+		thread.join();
+}
+
+void Loader::normalizeWeights(const vertexInfluences * influences, unsigned int numVertices, unsigned int numInfluences, unsigned short * dstJointIDs, float * dstWeights) {
 
 	// Loop over all vertices.
-	for (unsigned int i = 0; i < numVertices; i++) {
-		
-		// Add padding joint weights to vertices with less than numWeightsPerVertex weights.
-		while (weights[i].size() < numWeightsPerVertex)
-			weights[i].push_back({ UINT32_MAX, 0.0f });
+	for (unsigned int v = 0; v < numVertices; v++) {
 
 		// Sum the weights.
 		float sum = 0;
-		for (vertexJointWeight jw : weights[i])
-			sum += jw.weight;
-
-		// Write the joint id and normalized weights to the output arrays.
-		for (unsigned int j = 0; j < weights[i].size(); j++) {
-			vertexJointWeight jw = weights[i][j];
-			
-			dstJointIDs[(i * numWeightsPerVertex) + j] = jw.jointID;
-			dstWeights[(i * numWeightsPerVertex) + j] = jw.weight / sum;
+		for (unsigned int i = 0; i < numInfluences; i++)
+			sum += influences[v].weights[i];
+
+		// Write the joint IDs and normalized weights to the output arrays. 
+		// Unused influences keep a weight of 0, and vertices without any influence follow the first joint.
+		for (unsigned int i = 0; i < numInfluences; i++) {
+			unsigned int index = (i / INFLUENCES_PER_ATTRIBUTE) * numVertices * INFLUENCES_PER_ATTRIBUTE + v * INFLUENCES_PER_ATTRIBUTE + i % INFLUENCES_PER_ATTRIBUTE;
+			dstJointIDs[index] = static_cast<unsigned short>(influences[v].jointIDs[i]);
+			dstWeights[index] = sum > 0.0f ? influences[v].weights[i] / sum : (i == 0 ? 1.0f : 0.0f);
 		}
- 	}
+	}
+
+}
 
+unordered_map<string, unsigned int> Loader::mapBones(aiMesh * mesh) {
+	unordered_map<string, unsigned int> bones;
+	bones.reserve(mesh->mNumBones);
+	for (unsigned int i = 0; i < mesh->mNumBones; i++)
+		bones.emplace(mesh->mBones[i]->mName.C_Str(), i);
+	return bones;
 }
 
-Joint * Loader::loadJointHierarchy(aiNode * scene, aiMesh * mesh) {
+Joint * Loader::loadJointHierarchy(aiNode * scene, aiMesh * mesh, const unordered_map<string, unsigned int> & bones) {
 
 	// Find the root node of the skeleton.
-	aiNode * root = findSkeletonRoot(scene, mesh);
+	aiNode * root = findSkeletonRoot(scene, bones);
 	if (root == nullptr)
 		return nullptr;
 
 	// Find the corresponding bone.
-	aiBone* bone = nullptr;
-	unsigned int index = 0;
-	for (unsigned int i = 0; i < mesh->mNumBones; i++)
-		if (string(mesh->mBones[i]->mName.C_Str()) == string(root->mName.C_Str())) {
-			bone = mesh->mBones[i];
-			index = i;
-			break;
-		}
+	unsigned int index = bones.at(root->mName.C_Str());
+	aiBone * bone = mesh->mBones[index];
 
 	// Create the root joint.
 	Joint * rootJoint = new Joint;
 	rootJoint->name = root->mName.C_Str();
 	rootJoint->index = index;
+	copy(&bone->mOffsetMatrix, &rootJoint->transform);
+
 	mat4 globalInverse;
-	if (bone != nullptr) {
-		copy(&bone->mOffsetMatrix, &rootJoint->transform);
-		
-		copy(&scene->mTransformation, &globalInverse);
-		globalInverse.inverse();
-		std::cout << rootJoint->name << std::endl;
-		std::cout << globalInverse * rootJoint->transform << std::endl;
-	}
+	copy(&scene->mTransformation, &globalInverse);
+	globalInverse.inverse();
+	if (Logger::isEnabled(LOG_DEBUG))
+		Logger::stream(LOG_DEBUG) << rootJoint->name << endl << globalInverse * rootJoint->transform << endl;
 
 	// Load its children.
-	loadJointChildren(root, rootJoint, mesh, globalInverse);
+	loadJointChildren(root, rootJoint, mesh, bones, globalInverse);
 
 	// Return it.
 	return rootJoint;
 }
-void Loader::loadJointChildren(aiNode * current, Joint * parent, aiMesh * mesh, mat4 & gInverse){
+void Loader::loadJointChildren(aiNode * current, Joint * parent, aiMesh * mesh, const unordered_map<string, unsigned int> & bones, mat4 & gInverse){
 
 	// Loop for all children nodes of the root node. 
 	// The base condition of the function is stumbling upon a joint with no children.
@@ -76,37 +180,24 @@ void Loader::loadJointChildren(aiNode * current, Joint * parent, aiMesh * mesh,
 	for (unsigned int i = 0; i < current->mNumChildren; i++) {
 		
 		aiNode * node = current->mChildren[i];
-		Joint * child = nullptr;
-
-		// Attempt to find the matching bone.
-		for (unsigned int j = 0; j < mesh->mNumBones; j++) {
-
-			aiBone * bone = mesh->mBones[j];
-
-			// Create and add the joint as a child joint of its parent.
-			if (string(bone->mName.C_Str()) == string(node->mName.C_Str())) {
-				
-				// Create the new joint.
-				Joint * tbi = new Joint;
-				tbi->index = j;
-				tbi->name = node->mName.C_Str();
-				copy(&bone->mOffsetMatrix, &tbi->transform);
-				std::cout << tbi->name << std::endl;
-				std::cout << gInverse * tbi->transform << std::endl;
-				child = tbi;
-
-				// Add it to the parent joint.
-				if (parent != nullptr)
-					parent->children.push_back(tbi);
-				
-				break;
-			}
 
-		}
+		// Nodes without a matching bone end this branch of the skeleton.
+		auto match = bones.find(node->mName.C_Str());
+		if (match == bones.end())
+			continue;
 
-		// If a child joint was created and added, create and load its children joints.
-		if(child != nullptr)
-			loadJointChildren(node, child, mesh, gInverse);
+		// Create the new joint.
+		aiBone * bone = mesh->mBones[match->second];
+		Joint * child = new Joint;
+		child->index = match->second;
+		child->name = node->mName.C_Str();
+		copy(&bone->mOffsetMatrix, &child->transform);
+		if (Logger::isEnabled(LOG_DEBUG))
+			Logger::stream(LOG_DEBUG) << child->name << endl << gInverse * child->transform << endl;
+
+		// Add it to the parent joint and load its children joints.
+		parent->children.push_back(child);
+		loadJointChildren(node, child, mesh, bones, gInverse);
 
 	}
 }
@@ -200,34 +291,16 @@ Animation * Loader::loadAnimation(aiAnimation * anim) {
 	return result;
 }
 
-aiNode * Loader::findSkeletonRoot(aiNode * root, aiMesh * mesh) {
-	for (unsigned int i = 0; i < mesh->mNumBones; i++) {
-		if (string(root->mName.C_Str()) == (mesh->mBones[i]->mName.C_Str()))
-			return root;
-	}
-	return _findSkeletonRoot(root, mesh);
-}
-aiNode * Loader::_findSkeletonRoot(aiNode * node, aiMesh * mesh) {
+aiNode * Loader::findSkeletonRoot(aiNode * node, const unordered_map<string, unsigned int> & bones) {
 
-	// Loop for all children of the node.
-	for (unsigned int i = 0; i < node->mNumChildren; i++) {
-		
-		aiNode * child = node->mChildren[i];
-		
-
-		// Check if the node is a bone of the mesh.
-		for (unsigned int j = 0; j < mesh->mNumBones; j++) {
+	// The first node matching a bone in depth-first order is the root of the skeleton.
+	if (bones.count(node->mName.C_Str()) > 0)
+		return node;
 
-			aiBone * bone = mesh->mBones[j];
-			
-			// If it is, return the current node.
-			if (string(bone->mName.C_Str()) == string(child->mName.C_Str()))
-				return child;
-		}
-
-		// If not, search the children of this child node.
-		aiNode * search = _findSkeletonRoot(child, mesh);
-		if(search != nullptr)
+	// If not, search the children of this node.
+	for (unsigned int i = 0; i < node->mNumChildren; i++) {
+		aiNode * search = findSkeletonRoot(node->mChildren[i], bones);
+		if (search != nullptr)
 			return search;
 	}
 
@@ -254,11 +327,48 @@ void Loader::copy(aiMatrix4x4 * src, mat4 * dest) {
 }
 
 Mesh * Loader::loadMesh(const char * file) {
+	MeshData data;
+	if (!parseMesh(file, data))
+		return nullptr;
+
+	// Skeletal mesh
+	Mesh * result;
+	VAO * vao = uploadMesh(data);
+	if (data.animator != nullptr)
+		result = new SkeletalMesh(vao, data.indexCount, data.animator, data.numInfluences);
+
+	// No animation
+	else
+		result = new Mesh(vao, data.indexCount);
+
+	result->lods = data.lods;
+	result->boundingCenter = data.boundingCenter;
+	result->boundingRadius = data.boundingRadius;
+	result->boundsMin = data.boundsMin;
+	result->boundsMax = data.boundsMax;
+	result->meshlets = data.meshlets;
+
+	return result;
+}
+
+OccluderMesh * Loader::loadOccluder(const char * file) {
+	MeshData data;
+	if (!parseMesh(file, data))
+		return nullptr;
+
+	// Occluders stay in their bind pose.
+	delete data.animator;
+	OccluderMesh * result = new OccluderMesh();
+	result->vertices = std::move(data.vertices);
+	result->indices.assign(data.indexBuffer.begin(), data.indexBuffer.begin() + data.lods[0].indexCount);
+	return result;
+}
+
+bool Loader::parseMesh(const char * file, MeshData & data) {
 
 	static const unsigned int INDICES_PER_FACE = 3;
-	static const unsigned int NUM_WEIGHTS_PER_VERTEX = 3;
 
-	const aiScene * scene = importer.ReadFile(string("./Assets/Models/") + file,
+	const aiScene * scene = importer.ReadFile(string(MODEL_DIRECTORY) + file,
 		aiProcess_FlipUVs |
 		aiProcess_CalcTangentSpace |
 		aiProcess_Triangulate |
@@ -266,55 +376,45 @@ Mesh * Loader::loadMesh(const char * file) {
 
 	// Error loading file or file does not contain any meshes.
 	if(!scene || !scene->HasMeshes())
-		return nullptr;
+		return false;
 
 	// Retrieve first mesh.
 	aiMesh * mesh = scene->mMeshes[0];
+	data.vertexCount = mesh->mNumVertices;
 
 	// Indices
 	unsigned int * indices = new unsigned int[mesh->mNumFaces * INDICES_PER_FACE];
 
-	// Vertices
-	float * vertices = reinterpret_cast<float*>(mesh->mVertices);
-
-	// Normals
-	float * normals = reinterpret_cast<float*>(mesh->mNormals);
+	// Vertices and normals, copied out of the scene which only lives until the next import
+	data.vertices.assign(reinterpret_cast<vec3*>(mesh->mVertices), reinterpret_cast<vec3*>(mesh->mVertices) + mesh->mNumVertices);
+	data.normals.assign(reinterpret_cast<vec3*>(mesh->mNormals), reinterpret_cast<vec3*>(mesh->mNormals) + mesh->mNumVertices);
+	float * vertices = reinterpret_cast<float*>(data.vertices.data());
 
 	// UVs
-	float * uvs = new float[mesh->mNumVertices * 2];
+	data.uvs.resize(mesh->mNumVertices);
+	float * uvs = reinterpret_cast<float*>(data.uvs.data());
 
-	// Vertex joint weights and IDs
-	float * weights = new float[mesh->mNumVertices * NUM_WEIGHTS_PER_VERTEX];
-	unsigned int * jointIDs = new unsigned int[mesh->mNumVertices * NUM_WEIGHTS_PER_VERTEX];
+	// Vertex joint weights and IDs, zero for meshes without a skeleton
+	unsigned int numInfluences = mesh->HasBones() ? maxInfluences : INFLUENCES_PER_ATTRIBUTE;
+	data.numInfluences = numInfluences;
+	data.weights.assign(mesh->mNumVertices * numInfluences, 0.0f);
+	data.jointIDs.assign(mesh->mNumVertices * numInfluences, 0);
+	float * weights = data.weights.data();
+	unsigned short * jointIDs = data.jointIDs.data();
 
 	// If the mesh has a skeleton
 	Animator * animator = nullptr;
 	if (mesh->HasBones()) {
-		vector<vertexJointWeight> * vertexWeights = new vector<vertexJointWeight>[mesh->mNumVertices];
-
-		for (unsigned int i = 0; i < mesh->mNumBones; i++) {
+		vertexInfluences * vertexWeights = new vertexInfluences[mesh->mNumVertices];
 
-			aiBone * bone = mesh->mBones[i];
-			
-			for (unsigned int w = 0; w < bone->mNumWeights; w++) {
-				aiVertexWeight vw = bone->mWeights[w];
-
-				if (vertexWeights[vw.mVertexId].size() >= NUM_WEIGHTS_PER_VERTEX)
-					break;
-
-				vertexJointWeight jw = {
-					i, vw.mWeight
-				};
-
-				vertexWeights[vw.mVertexId].push_back(jw);
-			}
-		}
+		// Keep the strongest influences of each vertex
+		gatherInfluences(mesh, numInfluences, vertexWeights);
 
 		// Format the weights and joint IDs
-		normalizeWeights(vertexWeights, mesh->mNumVertices, NUM_WEIGHTS_PER_VERTEX, jointIDs, weights);
+		normalizeWeights(vertexWeights, mesh->mNumVertices, numInfluences, jointIDs, weights);
 
 		// Load the skeleton
-		Joint * root = loadJointHierarchy(scene->mRootNode, mesh);
+		Joint * root = loadJointHierarchy(scene->mRootNode, mesh, mapBones(mesh));
 		if (root != nullptr) {
 			mat4 globalInverseTransform;
 			copy(&scene->mRootNode->mTransformation, &globalInverseTransform);
@@ -324,6 +424,7 @@ Mesh * Loader::loadMesh(const char * file) {
 
 		delete[] vertexWeights;
 	}
+	data.animator = animator;
 
 	// If the scene has animations and this mesh is an animation target
 	if (scene->HasAnimations()) {
@@ -350,36 +451,205 @@ Mesh * Loader::loadMesh(const char * file) {
 			sizeof(vec2)								// Copy size of UV in bytes
 		);
 
+	// Generate the levels of detail, each appended to the index buffer after the previous one.
+	unsigned int indexCount = mesh->mNumFaces * INDICES_PER_FACE;
+	vector<unsigned int> indexBuffer(indices, indices + indexCount);
+	vector<MeshLOD> lods = { { 0, indexCount, 0.0f } };
+	if (!lodRatios.empty()) {
+		MeshSimplifier simplifier(vertices, mesh->mNumVertices, indices, indexCount);
+		simplifier.lockSeams(uvs);
+		if (animator != nullptr)
+			simplifier.lockSkinBorders(jointIDs, weights, INFLUENCES_PER_ATTRIBUTE);
+
+		for (float ratio : lodRatios) {
+			float error;
+			vector<unsigned int> lod = simplifier.simplify(ratio, &error);
+
+			// Stop once the simplifier cannot make any further progress.
+			if (lod.size() >= lods.back().indexCount)
+				break;
+
+			lods.push_back({ static_cast<unsigned int>(indexBuffer.size()), static_cast<unsigned int>(lod.size()), error });
+			indexBuffer.insert(indexBuffer.end(), lod.begin(), lod.end());
+		}
+	}
+
+	// Partition the full detail level into clusters, reordering its triangles in place.
+	// Skinned meshes deform at runtime, which would invalidate the clusters' bounds.
+	vector<Meshlet> meshlets;
+	if (buildMeshlets && animator == nullptr)
+		meshlets = MeshletBuilder(vertices, mesh->mNumVertices).build(indexBuffer.data(), indexCount);
+
+	// Compute the bounding box, and the bounding sphere around its center.
+	vec3 lower = vec3(INFINITY), upper = vec3(-INFINITY);
+	for (unsigned int v = 0; v < mesh->mNumVertices; v++) {
+		aiVector3D & p = mesh->mVertices[v];
+		lower = vec3(std::fmin(lower.x, p.x), std::fmin(lower.y, p.y), std::fmin(lower.z, p.z));
+		upper = vec3(std::fmax(upper.x, p.x), std::fmax(upper.y, p.y), std::fmax(upper.z, p.z));
+	}
+	vec3 center = 0.5f * (lower + upper);
+	float radius = 0.0f;
+	if (animator != nullptr) {
+
+		// Skinned vertices move, the sphere encloses the box over all poses instead.
+		computeAnimatedBounds(data, lower, upper);
+		center = 0.5f * (lower + upper);
+		radius = (0.5f * (upper - lower)).length();
+	}
+	else {
+		for (unsigned int v = 0; v < mesh->mNumVertices; v++) {
+			aiVector3D & p = mesh->mVertices[v];
+			radius = std::fmax(radius, (vec3(p.x, p.y, p.z) - center).length());
+		}
+	}
+
+	data.indexCount = indexCount;
+	data.indexBuffer = std::move(indexBuffer);
+	data.lods = lods;
+	data.meshlets = meshlets;
+	data.boundingCenter = center;
+	data.boundingRadius = radius;
+	data.boundsMin = lower;
+	data.boundsMax = upper;
+
+	// Clean up.
+	delete[] indices;
+
+	return true;
+}
+
+VAO * Loader::uploadMesh(const MeshData & data) {
+	const unsigned int * indices = data.indexBuffer.data();
+	unsigned int numVertices = data.vertexCount;
+	const unsigned short * jointIDs = data.jointIDs.data();
+	const float * weights = data.weights.data();
+
 	// Create the VAO representing the mesh.
 	VAO * vao = VAO::create()
 		->bind()
-		->storeIndices(indices, mesh->mNumFaces * INDICES_PER_FACE * sizeof(unsigned int), GL_STATIC_DRAW)
-		->storeData(0, vertices, mesh->mNumVertices * sizeof(vec3), 3, GL_FLOAT, GL_STATIC_DRAW)
-		->storeData(1, normals, mesh->mNumVertices * sizeof(vec3), 3, GL_FLOAT, GL_STATIC_DRAW)
-		->storeData(2, uvs, mesh->mNumVertices * sizeof(vec2), 2, GL_FLOAT, GL_STATIC_DRAW)
-		->storeData(3, jointIDs, mesh->mNumVertices * NUM_WEIGHTS_PER_VERTEX * sizeof(unsigned int), NUM_WEIGHTS_PER_VERTEX, GL_UNSIGNED_INT, GL_STATIC_DRAW)
-		->storeData(4, weights, mesh->mNumVertices * NUM_WEIGHTS_PER_VERTEX * sizeof(float), NUM_WEIGHTS_PER_VERTEX, GL_FLOAT, GL_STATIC_DRAW)
-		->unbind();
+		->storeIndices(indices, static_cast<unsigned int>(data.indexBuffer.size() * sizeof(unsigned int)), GL_STATIC_DRAW)
+		->storeData(0, data.vertices.data(), numVertices * sizeof(vec3), 3, GL_FLOAT, GL_STATIC_DRAW)
+		->storeData(1, data.normals.data(), numVertices * sizeof(vec3), 3, GL_FLOAT, GL_STATIC_DRAW)
+		->storeData(2, data.uvs.data(), numVertices * sizeof(vec2), 2, GL_FLOAT, GL_STATIC_DRAW)
+		->storeData(3, jointIDs, numVertices * INFLUENCES_PER_ATTRIBUTE * sizeof(unsigned short), INFLUENCES_PER_ATTRIBUTE, GL_UNSIGNED_SHORT, GL_STATIC_DRAW)
+		->storeData(4, weights, numVertices * INFLUENCES_PER_ATTRIBUTE * sizeof(float), INFLUENCES_PER_ATTRIBUTE, GL_FLOAT, GL_STATIC_DRAW);
 
-	// Clean up.
-	delete[] indices;
-	delete[] uvs;
-	delete[] weights;
-	delete[] jointIDs;
+	// Additional influences go in a second pair of attributes.
+	if (data.numInfluences > INFLUENCES_PER_ATTRIBUTE)
+		vao->storeData(5, jointIDs + numVertices * INFLUENCES_PER_ATTRIBUTE, numVertices * INFLUENCES_PER_ATTRIBUTE * sizeof(unsigned short), INFLUENCES_PER_ATTRIBUTE, GL_UNSIGNED_SHORT, GL_STATIC_DRAW)
+			->storeData(6, weights + numVertices * INFLUENCES_PER_ATTRIBUTE, numVertices * INFLUENCES_PER_ATTRIBUTE * sizeof(float), INFLUENCES_PER_ATTRIBUTE, GL_FLOAT, GL_STATIC_DRAW);
 
-	// Skeletal mesh
-	if (animator != nullptr)
-		return new SkeletalMesh(vao, mesh->mNumFaces * INDICES_PER_FACE, animator);
+	vao->unbind();
 
-	// No animation
-	return new Mesh(vao, mesh->mNumFaces * INDICES_PER_FACE);
+	return vao;
+}
+
+void Loader::computeAnimatedBounds(const MeshData & data, vec3 & lower, vec3 & upper) {
+	Animator * animator = data.animator;
+	Animation * anim = animator->getAnimation();
+	if (anim == nullptr)
+		return;
+
+	// Bound the vertices influenced by each joint, in bind pose.
+	unsigned int numJoints = animator->getJointCount();
+	vector<vec3> jointLower(numJoints, vec3(INFINITY)), jointUpper(numJoints, vec3(-INFINITY));
+	for (unsigned int v = 0; v < data.vertexCount; v++) {
+		const vec3 & p = data.vertices[v];
+		for (unsigned int i = 0; i < data.numInfluences; i++) {
+			unsigned int index = (i / INFLUENCES_PER_ATTRIBUTE) * data.vertexCount * INFLUENCES_PER_ATTRIBUTE + v * INFLUENCES_PER_ATTRIBUTE + i % INFLUENCES_PER_ATTRIBUTE;
+			unsigned int joint = data.jointIDs[index];
+			if (data.weights[index] <= 0.0f || joint >= numJoints)
+				continue;
+			jointLower[joint] = vec3(std::fmin(jointLower[joint].x, p.x), std::fmin(jointLower[joint].y, p.y), std::fmin(jointLower[joint].z, p.z));
+			jointUpper[joint] = vec3(std::fmax(jointUpper[joint].x, p.x), std::fmax(jointUpper[joint].y, p.y), std::fmax(jointUpper[joint].z, p.z));
+		}
+	}
+
+	// Sample the animation at every keyframe and halfway between consecutive keyframes.
+	vector<float> keys = { 0.0f };
+	for (auto it = anim->keyframes.begin(); it != anim->keyframes.end(); it++) {
+		for (TranslationKeyframe * key : it->second->translations)
+			keys.push_back(key->time);
+		for (RotationKeyframe * key : it->second->rotations)
+			keys.push_back(key->time);
+		for (ScaleKeyframe * key : it->second->scales)
+			keys.push_back(key->time);
+	}
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	vector<float> times = keys;
+	for (size_t k = 1; k < keys.size(); k++)
+		times.push_back(0.5f * (keys[k - 1] + keys[k]));
+
+	// Merge the joint boxes moved by each sampled pose.
+	for (float time : times) {
+		if (time < 0.0f || time >= anim->duration)
+			continue;
+		const mat4 * transforms = animator->seek(time)->computeTransforms();
+		for (unsigned int j = 0; j < numJoints; j++) {
+			if (jointLower[j].x > jointUpper[j].x)
+				continue;
+			for (unsigned int c = 0; c < 8; c++) {
+				vec4 corner;
+				transform(transforms[j], vec4(c & 1 ? jointUpper[j].x : jointLower[j].x, c & 2 ? jointUpper[j].y : jointLower[j].y, c & 4 ? jointUpper[j].z : jointLower[j].z, 1.0f), &corner);
+				lower = vec3(std::fmin(lower.x, corner.x), std::fmin(lower.y, corner.y), std::fmin(lower.z, corner.z));
+				upper = vec3(std::fmax(upper.x, corner.x), std::fmax(upper.y, corner.y), std::fmax(upper.z, corner.z));
+			}
+		}
+	}
+	animator->seek(0)->computeTransforms();
+}
+
+bool Loader::replaceMesh(Mesh * mesh, MeshData & data) {
+
+	// A mesh cannot gain or lose its skeleton in place.
+	SkeletalMesh * skeletal = dynamic_cast<SkeletalMesh *>(mesh);
+	if ((skeletal != nullptr) != (data.animator != nullptr)) {
+		delete data.animator;
+		data.animator = nullptr;
+		return false;
+	}
+
+	// Frames still in flight may draw the previous vertex array, so it is only deleted once the GPU is done with it.
+	ResourceManager::getShared()->destroy(mesh->vao->getHandle());
+	mesh->vao = uploadMesh(data);
+	mesh->vertexCount = data.indexCount;
+	mesh->lods = data.lods;
+	mesh->boundingCenter = data.boundingCenter;
+	mesh->boundingRadius = data.boundingRadius;
+	mesh->boundsMin = data.boundsMin;
+	mesh->boundsMax = data.boundsMax;
+	mesh->meshlets = data.meshlets;
+
+	if (skeletal != nullptr) {
+		delete skeletal->anim;
+		skeletal->anim = data.animator;
+		skeletal->influences = data.numInfluences;
+		data.animator = nullptr;
+	}
+	return true;
+}
+
+void Loader::copySettings(const Loader & other) {
+	lodRatios = other.lodRatios;
+	buildMeshlets = other.buildMeshlets;
+	maxInfluences = other.maxInfluences;
 }
 
 Texture * Loader::loadTexture2D(const char * file, GLenum textureFilter) {
 
-	// Load the texture in RAM
+	// Cooked textures are already compressed
+	string path = string(TEXTURE_DIRECTORY) + file;
+	static const string KTX2_EXTENSION = ".ktx2";
+	if (path.size() >= KTX2_EXTENSION.size() && path.compare(path.size() - KTX2_EXTENSION.size(), KTX2_EXTENSION.size(), KTX2_EXTENSION) == 0)
+		return loadCompressedTexture2D(path, textureFilter);
+
+	// Decode the texture in RAM straight from its mapped file
+	FileView view = VirtualFileSystem::getShared()->open(path);
+	if (!view.isValid())
+		return nullptr;
 	int width, height, nbChannels;
-	unsigned char * data = stbi_load((string("./Assets/Textures/") + file).c_str(), &width, &height, &nbChannels, STBI_rgb_alpha);
+	unsigned char * data = stbi_load_from_memory(view.getData(), static_cast<int>(view.getSize()), &width, &height, &nbChannels, STBI_rgb_alpha);
 
 	// Return a null pointer if the texture has not been loaded correctly 
 	if (data == NULL)
@@ -388,7 +658,7 @@ Texture * Loader::loadTexture2D(const char * file, GLenum textureFilter) {
 	// Create texture and buffer its data in OpenGL
 	unsigned int texID;
 	glGenTextures(1, &texID);
-	glBindTexture(GL_TEXTURE_2D, texID);
+	GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, texID);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, textureFilter);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, textureFilter);
@@ -398,5 +668,106 @@ Texture * Loader::loadTexture2D(const char * file, GLenum textureFilter) {
 	stbi_image_free(data);
 
 	// Return the newly created texture object
-	return new Texture(GL_TEXTURE_2D, texID);
-}
\ No newline at end of file
+	Texture * texture = new Texture(GL_TEXTURE_2D, texID);
+	texture->width = width;
+	texture->height = height;
+	while ((std::max(width, height) >> texture->levelCount) > 0)
+		texture->levelCount++;
+	texture->maxLevel = texture->levelCount - 1;
+
+	// The mip chain adds a third to the 4 bytes per texel of level 0.
+	texture->memorySize = static_cast<size_t>(width) * height * 4 * 4 / 3;
+	return texture;
+}
+
+Texture * Loader::loadCompressedTexture2D(const string & path, GLenum textureFilter) {
+
+	// Load the compressed mip chain in RAM, texture arrays are loaded as atlases
+	KTX2::Image image;
+	if (!KTX2::read(path.c_str(), image) || image.layers > 0)
+		return nullptr;
+
+	// Upload every level as is
+	unsigned int texID;
+	glGenTextures(1, &texID);
+	GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, texID);
+	GLenum internalFormat = KTX2::getInternalFormat(image.format);
+	for (unsigned int level = 0; level < image.levels.size(); level++) {
+		unsigned int width = image.width >> level > 0 ? image.width >> level : 1;
+		unsigned int height = image.height >> level > 0 ? image.height >> level : 1;
+		glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0, static_cast<GLsizei>(image.levels[level].size()), image.levels[level].data());
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, textureFilter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, textureFilter);
+
+	// Return the newly created texture object
+	Texture * texture = new Texture(GL_TEXTURE_2D, texID);
+	texture->width = image.width;
+	texture->height = image.height;
+	texture->levelCount = static_cast<unsigned int>(image.levels.size());
+	texture->setLevelRange(0, texture->levelCount - 1);
+	for (const auto & level : image.levels)
+		texture->memorySize += level.size();
+	return texture;
+}
+
+TextureAtlas * Loader::loadTextureAtlas(const char * file, GLenum textureFilter) {
+
+	// Load the compressed mip chain of every page in RAM
+	string path = string(TEXTURE_DIRECTORY) + file;
+	KTX2::Image image;
+	if (!KTX2::read(path.c_str(), image) || image.layers == 0)
+		return nullptr;
+	auto locations = image.metadata.find(TexturePacker::METADATA_KEY);
+	if (locations == image.metadata.end())
+		return nullptr;
+
+	// Upload every level of every page at once
+	unsigned int texID;
+	glGenTextures(1, &texID);
+	GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D_ARRAY, texID);
+	GLenum internalFormat = KTX2::getInternalFormat(image.format);
+	for (unsigned int level = 0; level < image.levels.size(); level++) {
+		unsigned int width = image.width >> level > 0 ? image.width >> level : 1;
+		unsigned int height = image.height >> level > 0 ? image.height >> level : 1;
+		glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat, width, height, image.layers, 0, static_cast<GLsizei>(image.levels[level].size()), image.levels[level].data());
+	}
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, textureFilter == GL_NEAREST ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, textureFilter);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	Texture * array = new Texture(GL_TEXTURE_2D_ARRAY, texID);
+	array->width = image.width;
+	array->height = image.height;
+	array->levelCount = static_cast<unsigned int>(image.levels.size());
+	array->setLevelRange(0, array->levelCount - 1);
+	for (const auto & level : image.levels)
+		array->memorySize += level.size();
+	TextureAtlas * atlas = new TextureAtlas(array);
+
+	// Each line locates a packed texture as "layer x y width height name"
+	std::istringstream lines(locations->second);
+	string line;
+	while (std::getline(lines, line)) {
+		std::istringstream fields(line);
+		unsigned int layer, x, y, width, height;
+		string name;
+		if (!(fields >> layer >> x >> y >> width >> height) || !std::getline(fields >> std::ws, name) || layer >= image.layers)
+			continue;
+		Texture * texture = new Texture(GL_TEXTURE_2D_ARRAY, texID);
+		texture->owner = false;
+		texture->width = width;
+		texture->height = height;
+		texture->levelCount = array->levelCount;
+		texture->maxLevel = array->maxLevel;
+		texture->layer = layer;
+		texture->uvTransform = vec4(
+			static_cast<float>(x) / image.width, static_cast<float>(y) / image.height,
+			static_cast<float>(width) / image.width, static_cast<float>(height) / image.height);
+		delete atlas->entries[name];
+		atlas->entries[name] = texture;
+	}
+
+	return atlas;
+}
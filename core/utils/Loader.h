@@ -1,5 +1,6 @@
 #include <string>
 #include <iostream>
+#include <unordered_map>
 
 #pragma warning(push, 0)
 #include <assimp/Importer.hpp>
@@ -9,8 +10,13 @@
 
 #include "../math/GLVector.h"
 #include "../objects/Texture.h"
+#include "../objects/TextureAtlas.h"
 #include "../objects/SkeletalMesh.h"
 #include "../animation/Animation.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "Logger.h"
+#include "KTX2.h"
 
 using namespace Assimp;
 using glmath::vec2;
@@ -18,15 +24,44 @@ using glmath::vec3;
 using std::cout;
 using std::endl;
 using std::string;
+using std::unordered_map;
+
+class AssetReloader;
+struct OccluderMesh;
 
 #pragma once
 class Loader {
 
-	private:
+	friend class AssetReloader;
+
+	public:
+		/**
+		 * @brief The largest supported number of joint influences per vertex.
+		 * 
+		 */
+		static const unsigned int MAX_INFLUENCES = 8;
+
+		/**
+		 * @brief The number of joint influences packed into each skinning vertex attribute.
+		 * 
+		 */
+		static const unsigned int INFLUENCES_PER_ATTRIBUTE = 4;
+
+		/**
+		 * @brief The virtual directories models and textures are loaded from.
+		 * 
+		 */
+		static const char * MODEL_DIRECTORY;
+		static const char * TEXTURE_DIRECTORY;
 
-		struct vertexJointWeight {
-			unsigned int jointID;
-			float weight;
+	private:
+		/**
+		 * @brief The strongest joint influences of a single vertex, sorted by decreasing weight.
+		 * 
+		 */
+		struct vertexInfluences {
+			unsigned int jointIDs[MAX_INFLUENCES];
+			float weights[MAX_INFLUENCES];
 		};
 
 		/**
@@ -34,29 +69,126 @@ class Loader {
 		 * 
 		 */
 		Importer importer;
+
+		/**
+		 * @brief The target triangle ratios of the levels of detail generated for each loaded mesh.
+		 * 
+		 */
+		vector<float> lodRatios;
+
+		/**
+		 * @brief Whether or not the full detail level of each loaded mesh is partitioned into culling clusters.
+		 * 
+		 */
+		bool buildMeshlets = false;
+
+		/**
+		 * @brief The number of joint influences kept per vertex. (4 or 8)
+		 * 
+		 */
+		unsigned int maxInfluences = 4;
+
+		/**
+		 * @brief A mesh parsed into RAM and ready to be uploaded, owning its animator until then.
+		 * 
+		 */
+		struct MeshData {
+			unsigned int vertexCount;
+			unsigned int indexCount;
+			unsigned int numInfluences;
+			vector<vec3> vertices;
+			vector<vec3> normals;
+			vector<vec2> uvs;
+			vector<unsigned short> jointIDs;
+			vector<float> weights;
+			vector<unsigned int> indexBuffer;
+			vector<MeshLOD> lods;
+			vector<Meshlet> meshlets;
+			vec3 boundingCenter;
+			float boundingRadius;
+			vec3 boundsMin;
+			vec3 boundsMax;
+			Animator * animator;
+		};
+
+		/**
+		 * @brief Parses the first mesh found in the input file and builds its levels of detail and clusters, without any OpenGL calls.
+		 * 
+		 * @return [bool] True if the mesh was parsed successfully, false otherwise.
+		 */
+		bool parseMesh(const char * file, MeshData & data);
+
+		/**
+		 * @brief Uploads a parsed mesh's vertex attributes and indices to a new VAO.
+		 * 
+		 */
+		static VAO * uploadMesh(const MeshData & data);
+
+		/**
+		 * @brief Grows a skeletal mesh's bounding box to enclose it in every pose of its animation.
+		 * Skinned vertices lie within the boxes of their joints' vertices moved by each joint, which are merged over poses 
+		 * sampled at every keyframe and halfway between them.
+		 * 
+		 * @param data The parsed mesh, with its animator.
+		 * @param lower The bounding box's minimum corner, in bind pose on input.
+		 * @param upper The bounding box's maximum corner, in bind pose on input.
+		 */
+		static void computeAnimatedBounds(const MeshData & data, vec3 & lower, vec3 & upper);
+
+		/**
+		 * @brief Replaces the geometry and skeleton of a live mesh with a parsed mesh, taking ownership of its animator.
+		 * 
+		 * @return [bool] True if the mesh was replaced, false if one of them is skinned and the other is not.
+		 */
+		static bool replaceMesh(Mesh * mesh, MeshData & data);
+
+		/**
+		 * @brief Copies the mesh processing settings of another loader.
+		 * 
+		 */
+		void copySettings(const Loader & other);
 		
 		/**
-		 * @brief Normalizes the joint weights for each vertex ensuring each vertex has numWeightsPerVertex weights or fewer and that their sum is equal to 1.
+		 * @brief Inserts a joint influence into a vertex's sorted influences if it is among its numInfluences strongest.
+		 *
+		 */
+		static void insertInfluence(vertexInfluences & influences, unsigned int numInfluences, unsigned int jointID, float weight);
+
+		/**
+		 * @brief Gathers the numInfluences strongest joint influences of every vertex of a mesh, processing bones in parallel.
+		 *
+		 */
+		static void gatherInfluences(aiMesh * mesh, unsigned int numInfluences, vertexInfluences * dst);
+
+		/**
+		 * @brief Normalizes the joint weights of each vertex so that their sum is equal to 1 and packs them for upload.
+		 * Joint IDs and weights are written in groups of INFLUENCES_PER_ATTRIBUTE, one array of numVertices groups per vertex attribute.
 		 *
 		 */
 		void normalizeWeights(
-			vector<vertexJointWeight> * weights, /* Array of joint weight vectors, each corresponding to a single vertex */
+			const vertexInfluences * influences, /* Array of sorted joint influences, each corresponding to a single vertex */
 			unsigned int numVertices, /* Total number of vertices */
-			unsigned int numWeightsPerVertex, /* Maximum number of weights per vertex */
-			unsigned int * dstJointIDs, /* Resulting array of joint IDs */
+			unsigned int numInfluences, /* Number of influences per vertex */
+			unsigned short * dstJointIDs, /* Resulting array of joint IDs */
 			float * dstWeights); /* Resulting array of joint weights */
 
+		/**
+		 * @brief Maps the name of every bone of a mesh to its index.
+		 *
+		 */
+		static unordered_map<string, unsigned int> mapBones(aiMesh * mesh);
+
 		/**
 		 * @brief Creates the joint hierarchy of a mesh and returns its root joint.
 		 *
 		 */
-		Joint * loadJointHierarchy(aiNode * scene, aiMesh* mesh);
+		Joint * loadJointHierarchy(aiNode * scene, aiMesh * mesh, const unordered_map<string, unsigned int> & bones);
 
 		/**
 		 * @brief Creates and adds a joint's children joints.
 		 *
 		 */
-		void loadJointChildren(aiNode * current, Joint * parent, aiMesh * mesh, mat4 & gInverse);
+		void loadJointChildren(aiNode * current, Joint * parent, aiMesh * mesh, const unordered_map<string, unsigned int> & bones, mat4 & gInverse);
 
 		/**
 		 * @brief Creates an animation instance from the raw animation data.
@@ -68,8 +200,7 @@ class Loader {
 		 * @brief Finds the root joint node of the given mesh's skeleton.
 		 *
 		 */
-		aiNode * findSkeletonRoot(aiNode * root, aiMesh * mesh);
-		aiNode * _findSkeletonRoot(aiNode * node, aiMesh * mesh);
+		aiNode * findSkeletonRoot(aiNode * node, const unordered_map<string, unsigned int> & bones);
 
 		/**
 		 * @brief Copies an assimp matrix into a glmath mat4 struct.
@@ -77,6 +208,12 @@ class Loader {
 		 */
 		static void copy(aiMatrix4x4 * src, mat4 * dest);
 
+		/**
+		 * @brief Uploads a block-compressed texture and its mip chain from a KTX2 file.
+		 *
+		 */
+		Texture * loadCompressedTexture2D(const string & path, GLenum textureFilter);
+
 	public:
 		/**
 		 * @brief Constructs a new loader object.
@@ -90,6 +227,43 @@ class Loader {
 		 */
 		~Loader();
 
+		/**
+		 * @brief Sets the levels of detail to generate for every mesh loaded from now on.
+		 * 
+		 * @param ratios The target triangle count of each level as a fraction of the full detail triangle count,
+		 * in decreasing order. (e.g. { 0.5f, 0.25f, 0.125f }) An empty list disables level of detail generation.
+		 * @return [Loader *] This same loader instance in order to allow for method chaining.
+		 */
+		inline Loader * setLODLevels(const vector<float> & ratios) {
+			this->lodRatios = ratios;
+			return this;
+		}
+
+		/**
+		 * @brief Sets whether or not the full detail level of every mesh loaded from now on is partitioned into
+		 * clusters of up to 64 vertices and 124 triangles, allowing parts of the mesh to be culled individually.
+		 * Skinned meshes are never partitioned.
+		 * 
+		 * @param build Whether or not to build the clusters.
+		 * @return [Loader *] This same loader instance in order to allow for method chaining.
+		 */
+		inline Loader * setBuildMeshlets(bool build) {
+			this->buildMeshlets = build;
+			return this;
+		}
+
+		/**
+		 * @brief Sets the number of joint influences kept per vertex for every skinned mesh loaded from now on.
+		 * The strongest influences are kept and renormalized.
+		 * 
+		 * @param influences The number of influences per vertex, rounded up to 4 or 8.
+		 * @return [Loader *] This same loader instance in order to allow for method chaining.
+		 */
+		inline Loader * setMaxInfluences(unsigned int influences) {
+			this->maxInfluences = influences <= INFLUENCES_PER_ATTRIBUTE ? INFLUENCES_PER_ATTRIBUTE : MAX_INFLUENCES;
+			return this;
+		}
+
 		/**
 		 * @brief Parses the first mesh found in the input file to OpenGL memory and returns an instance of it.
 		 * This method returns a null pointer if the parsing process fails.
@@ -99,8 +273,19 @@ class Loader {
 		 */
 		Mesh * loadMesh(const char * file);
 
+		/**
+		 * @brief Parses the full detail level of the first mesh found in the input file into an occluder kept in RAM for the CPU occlusion culler.
+		 * The occluder's triangles should lie within the meshes it hides, as with the simplified walls of a level.
+		 * This method returns a null pointer if the parsing process fails.
+		 * 
+		 * @param file The file to parse from.
+		 * @return [OccluderMesh *] The resulting occluder.
+		 */
+		OccluderMesh * loadOccluder(const char * file);
+
 		/**
 		 * @brief Loads a two dimensional texture from the input file into OpenGL memory and returns an instance of it.
+		 * KTX2 files are uploaded as is with their precomputed mip chain, other images are decoded and have their mip chain generated.
 		 * This method returns a null pointer if the loading process fails.
 		 * 
 		 * @param file The texture file to load.
@@ -109,5 +294,16 @@ class Loader {
 		 */
 		Texture * loadTexture2D(const char* file, GLenum textureFilter);
 
+		/**
+		 * @brief Loads a texture atlas cooked by the texture packer into an OpenGL texture array and returns an instance of it.
+		 * Each packed texture becomes an atlas entry sampling its own region and layer of the array.
+		 * This method returns a null pointer if the loading process fails.
+		 * 
+		 * @param file The KTX2 atlas file to load.
+		 * @param textureFilter The type for filtering to use for interpolation, between mip levels too. (GL_NEAREST, GL_LINEAR, etc...)
+		 * @return [TextureAtlas *] The resulting texture atlas instance.
+		 */
+		TextureAtlas * loadTextureAtlas(const char * file, GLenum textureFilter);
+
 };
 
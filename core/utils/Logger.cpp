@@ -0,0 +1,7 @@
+#include "Logger.h"
+
+LogLevel Logger::level = LOG_WARNING;
+
+ostream & Logger::stream(LogLevel level) {
+	return level <= LOG_WARNING ? std::cerr : std::cout;
+}
@@ -0,0 +1,60 @@
+#include <iostream>
+
+using std::ostream;
+
+#pragma once
+
+/**
+ * @brief The different levels of verbosity messages can be logged at, from least to most verbose.
+ * 
+ */
+enum LogLevel {
+	LOG_NONE,
+	LOG_ERROR,
+	LOG_WARNING,
+	LOG_INFO,
+	LOG_DEBUG
+};
+
+class Logger {
+
+	private:
+		/**
+		 * @brief The most verbose level of messages currently written out.
+		 * 
+		 */
+		static LogLevel level;
+
+	public:
+		/**
+		 * @brief Sets the most verbose level of messages to write out.
+		 * 
+		 * @param level The new log level.
+		 */
+		static inline void setLevel(LogLevel level) { Logger::level = level; }
+
+		/**
+		 * @brief Returns the most verbose level of messages currently written out.
+		 * 
+		 * @return [LogLevel] The current log level.
+		 */
+		static inline LogLevel getLevel() { return level; }
+
+		/**
+		 * @brief Returns whether or not messages of the given level are written out.
+		 * Expensive messages should be guarded by this check so they are not even formatted when disabled.
+		 * 
+		 * @param level The level of the message.
+		 * @return [bool] True if messages of this level are written out, false otherwise.
+		 */
+		static inline bool isEnabled(LogLevel level) { return level != LOG_NONE && level <= Logger::level; }
+
+		/**
+		 * @brief Returns the stream messages of the given level are written to.
+		 * 
+		 * @param level The level of the message.
+		 * @return [ostream &] The output stream for this level.
+		 */
+		static ostream & stream(LogLevel level);
+
+};
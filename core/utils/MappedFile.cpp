@@ -0,0 +1,79 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "MappedFile.h"
+
+MappedFile::MappedFile(const unsigned char * data, size_t size) :
+	data(data), size(size) {}
+
+shared_ptr<MappedFile> MappedFile::open(const string & path) {
+	const unsigned char * data = nullptr;
+	size_t size = 0;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		return nullptr;
+	}
+	size = static_cast<size_t>(fileSize.QuadPart);
+
+	// Empty files cannot be mapped, the view keeps the mapping alive once created.
+	if (size > 0) {
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping != NULL) {
+			data = static_cast<const unsigned char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			CloseHandle(mapping);
+		}
+		if (data == nullptr) {
+			CloseHandle(file);
+			return nullptr;
+		}
+	}
+	CloseHandle(file);
+#else
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return nullptr;
+	struct stat info;
+	if (fstat(file, &info) != 0 || !S_ISREG(info.st_mode)) {
+		close(file);
+		return nullptr;
+	}
+	size = static_cast<size_t>(info.st_size);
+
+	// Empty files cannot be mapped, the mapping stays valid once the file is closed.
+	if (size > 0) {
+		void * mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapping == MAP_FAILED) {
+			close(file);
+			return nullptr;
+		}
+		data = static_cast<const unsigned char *>(mapping);
+	}
+	close(file);
+#endif
+
+	return shared_ptr<MappedFile>(new MappedFile(data, size));
+}
+
+MappedFile::~MappedFile() {
+	if (data == nullptr)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+#else
+	munmap(const_cast<unsigned char *>(data), size);
+#endif
+}
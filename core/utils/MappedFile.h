@@ -0,0 +1,59 @@
+#include <string>
+#include <memory>
+
+using std::string;
+using std::shared_ptr;
+
+#pragma once
+class MappedFile {
+
+	private:
+		/**
+		 * @brief The first byte of the file's read-only mapping, and the file's size in bytes.
+		 * 
+		 */
+		const unsigned char * data;
+		size_t size;
+
+		/**
+		 * @brief Constructs a new mapped file object around an existing mapping.
+		 * 
+		 * @param data The first byte of the mapping, null for empty files.
+		 * @param size The size of the mapping in bytes.
+		 */
+		MappedFile(const unsigned char * data, size_t size);
+
+	public:
+		/**
+		 * @brief Maps a file into memory for reading. Its pages are only read from disk when first accessed.
+		 * This method returns a null pointer if the file cannot be opened.
+		 * 
+		 * @param path The path of the file on disk.
+		 * @return [shared_ptr<MappedFile>] The mapped file, unmapped once the last reference to it is released.
+		 */
+		static shared_ptr<MappedFile> open(const string & path);
+
+		/**
+		 * @brief Unmaps the file and destroys the mapped file object.
+		 * 
+		 */
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile & operator=(const MappedFile &) = delete;
+
+		/**
+		 * @brief Returns the file's contents.
+		 * 
+		 * @return [const unsigned char *] The first byte of the mapping, null for empty files.
+		 */
+		inline const unsigned char * getData() const { return data; };
+
+		/**
+		 * @brief Returns the file's size.
+		 * 
+		 * @return [size_t] The size of the file in bytes.
+		 */
+		inline size_t getSize() const { return size; };
+
+};
@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+#include "MeshSimplifier.h"
+
+// Weight of the constraint planes placed perpendicular to border edges.
+static const float BORDER_WEIGHT = 10.0f;
+
+// Minimum cosine between a triangle's normal before and after a collapse.
+static const float MIN_NORMAL_COSINE = 0.25f;
+
+void MeshSimplifier::Quadric::addPlane(const vec3 & n, float d, float w) {
+	a00 += w * n.x * n.x;
+	a01 += w * n.x * n.y;
+	a02 += w * n.x * n.z;
+	a11 += w * n.y * n.y;
+	a12 += w * n.y * n.z;
+	a22 += w * n.z * n.z;
+	b0 += w * n.x * d;
+	b1 += w * n.y * d;
+	b2 += w * n.z * d;
+	c += w * d * d;
+}
+
+void MeshSimplifier::Quadric::add(const Quadric & q) {
+	a00 += q.a00;
+	a01 += q.a01;
+	a02 += q.a02;
+	a11 += q.a11;
+	a12 += q.a12;
+	a22 += q.a22;
+	b0 += q.b0;
+	b1 += q.b1;
+	b2 += q.b2;
+	c += q.c;
+}
+
+double MeshSimplifier::Quadric::evaluate(const vec3 & p) const {
+	double x = p.x, y = p.y, z = p.z;
+	double result =
+		a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z +
+		a11 * y * y + 2 * a12 * y * z +
+		a22 * z * z +
+		2 * (b0 * x + b1 * y + b2 * z) + c;
+	return result < 0 ? 0 : result;
+}
+
+static inline unsigned long long edgeKey(unsigned int a, unsigned int b) {
+	return a < b ?
+		(static_cast<unsigned long long>(a) << 32) | b :
+		(static_cast<unsigned long long>(b) << 32) | a;
+}
+
+MeshSimplifier::MeshSimplifier(const float * positions, unsigned int vertexCount, const unsigned int * indices, unsigned int indexCount) :
+	positions(reinterpret_cast<const vec3*>(positions)),
+	vertexCount(vertexCount),
+	indices(indices, indices + indexCount),
+	sourceTriangleCount(indexCount / 3),
+	wedges(vertexCount),
+	seams(vertexCount, false) {
+	std::iota(wedges.begin(), wedges.end(), 0);
+}
+
+MeshSimplifier::~MeshSimplifier() {}
+
+MeshSimplifier * MeshSimplifier::lockSeams(const float * uvs) {
+
+	// Sort the vertices by position, then by texture coordinates.
+	vector<unsigned int> order(vertexCount);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [this, uvs](unsigned int a, unsigned int b) {
+		const vec3 & pa = positions[a], & pb = positions[b];
+		if (pa.x != pb.x) return pa.x < pb.x;
+		if (pa.y != pb.y) return pa.y < pb.y;
+		if (pa.z != pb.z) return pa.z < pb.z;
+		if (uvs[a * 2] != uvs[b * 2]) return uvs[a * 2] < uvs[b * 2];
+		return uvs[a * 2 + 1] < uvs[b * 2 + 1];
+	});
+
+	// Walk each group of vertices sharing a position.
+	for (unsigned int start = 0; start < vertexCount;) {
+		const vec3 & p = positions[order[start]];
+		unsigned int end = start + 1;
+		while (end < vertexCount && positions[order[end]].x == p.x && positions[order[end]].y == p.y && positions[order[end]].z == p.z)
+			end++;
+
+		// Weld vertices that also share texture coordinates onto the first of them.
+		bool seam = false;
+		unsigned int wedge = order[start];
+		for (unsigned int i = start; i < end; i++) {
+			unsigned int v = order[i];
+			if (uvs[v * 2] != uvs[wedge * 2] || uvs[v * 2 + 1] != uvs[wedge * 2 + 1]) {
+				wedge = v;
+				seam = true;
+			}
+			wedges[v] = wedge;
+		}
+
+		// Several distinct texture coordinates at a single position form a seam.
+		if (seam)
+			for (unsigned int i = start; i < end; i++)
+				seams[order[i]] = true;
+
+		start = end;
+	}
+
+	dirty = true;
+	return this;
+}
+
+MeshSimplifier * MeshSimplifier::lockSkinBorders(const unsigned short * jointIDs, const float * weights, unsigned int weightsPerVertex) {
+	skinGroups.resize(vertexCount);
+	for (unsigned int v = 0; v < vertexCount; v++) {
+		unsigned int best = 0;
+		for (unsigned int w = 1; w < weightsPerVertex; w++)
+			if (weights[v * weightsPerVertex + w] > weights[v * weightsPerVertex + best])
+				best = w;
+		skinGroups[v] = jointIDs[v * weightsPerVertex + best];
+	}
+
+	dirty = true;
+	return this;
+}
+
+void MeshSimplifier::prepare() {
+
+	// Move all indices onto their representative vertices.
+	for (unsigned int & i : indices)
+		i = wedges[i];
+
+	// Count the triangles sharing each edge.
+	vector<unsigned long long> edges;
+	edges.reserve(indices.size());
+	for (size_t t = 0; t < indices.size(); t += 3)
+		for (int e = 0; e < 3; e++)
+			edges.push_back(edgeKey(indices[t + e], indices[t + (e + 1) % 3]));
+	std::sort(edges.begin(), edges.end());
+
+	// Classify the vertices.
+	kinds.assign(vertexCount, MANIFOLD);
+	skinBorders.assign(vertexCount, false);
+	for (size_t i = 0; i < edges.size();) {
+		size_t j = i + 1;
+		while (j < edges.size() && edges[j] == edges[i])
+			j++;
+
+		unsigned int a = static_cast<unsigned int>(edges[i] >> 32);
+		unsigned int b = static_cast<unsigned int>(edges[i] & 0xFFFFFFFF);
+
+		// Edges used by a single triangle are borders, edges used by more than two are non-manifold.
+		if (j - i == 1) {
+			kinds[a] = kinds[a] == LOCKED ? LOCKED : BORDER;
+			kinds[b] = kinds[b] == LOCKED ? LOCKED : BORDER;
+		} else if (j - i > 2) {
+			kinds[a] = LOCKED;
+			kinds[b] = LOCKED;
+		}
+
+		if (!skinGroups.empty() && skinGroups[a] != skinGroups[b]) {
+			skinBorders[a] = true;
+			skinBorders[b] = true;
+		}
+
+		i = j;
+	}
+	for (unsigned int v = 0; v < vertexCount; v++)
+		if (seams[v])
+			kinds[v] = LOCKED;
+
+	// Accumulate the error quadrics.
+	quadrics.assign(vertexCount, Quadric());
+	for (size_t t = 0; t < indices.size(); t += 3) {
+		unsigned int i0 = indices[t], i1 = indices[t + 1], i2 = indices[t + 2];
+		const vec3 & p0 = positions[i0];
+		vec3 normal = glmath::cross(positions[i1] - p0, positions[i2] - p0);
+		float length = normal.length();
+		if (length == 0.0f)
+			continue;
+		normal = normal / length;
+
+		Quadric q;
+		q.addPlane(normal, -glmath::dot(normal, p0), 1.0f);
+		quadrics[i0].add(q);
+		quadrics[i1].add(q);
+		quadrics[i2].add(q);
+
+		// Add constraint planes along border edges to keep the silhouette of open meshes in place.
+		for (int e = 0; e < 3; e++) {
+			unsigned int a = indices[t + e], b = indices[t + (e + 1) % 3];
+			auto range = std::equal_range(edges.begin(), edges.end(), edgeKey(a, b));
+			if (range.second - range.first != 1)
+				continue;
+
+			vec3 edge = positions[b] - positions[a];
+			vec3 perpendicular = glmath::cross(edge, normal);
+			float perpendicularLength = perpendicular.length();
+			if (perpendicularLength == 0.0f)
+				continue;
+			perpendicular = perpendicular / perpendicularLength;
+
+			Quadric border;
+			border.addPlane(perpendicular, -glmath::dot(perpendicular, positions[a]), BORDER_WEIGHT);
+			quadrics[a].add(border);
+			quadrics[b].add(border);
+		}
+	}
+
+	dirty = false;
+}
+
+bool MeshSimplifier::isCollapseAllowed(unsigned int from, unsigned int to, bool borderEdge) const {
+	if (kinds[from] == LOCKED)
+		return false;
+
+	// Border vertices may only slide along the border.
+	if (kinds[from] == BORDER && !borderEdge)
+		return false;
+
+	// Keep skinning regions intact.
+	if (!skinGroups.empty()) {
+		if (skinGroups[from] != skinGroups[to])
+			return false;
+		if (skinBorders[from] && !skinBorders[to])
+			return false;
+	}
+
+	return true;
+}
+
+bool MeshSimplifier::preservesOrientation(unsigned int from, unsigned int to, const vector<unsigned int> & adjacencyOffsets, const vector<unsigned int> & adjacency) const {
+	for (unsigned int a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; a++) {
+		unsigned int t = adjacency[a] * 3;
+		unsigned int i0 = indices[t], i1 = indices[t + 1], i2 = indices[t + 2];
+
+		// Triangles containing both vertices disappear.
+		if (i0 == to || i1 == to || i2 == to)
+			continue;
+
+		vec3 before = glmath::cross(positions[i1] - positions[i0], positions[i2] - positions[i0]);
+
+		vec3 p0 = positions[i0 == from ? to : i0];
+		vec3 p1 = positions[i1 == from ? to : i1];
+		vec3 p2 = positions[i2 == from ? to : i2];
+		vec3 after = glmath::cross(p1 - p0, p2 - p0);
+
+		if (glmath::dot(before, after) <= MIN_NORMAL_COSINE * before.length() * after.length())
+			return false;
+	}
+	return true;
+}
+
+unsigned int MeshSimplifier::pass(unsigned int targetTriangleCount) {
+	unsigned int triangleCount = static_cast<unsigned int>(indices.size() / 3);
+
+	// Build the vertex to triangle adjacency.
+	vector<unsigned int> adjacencyOffsets(vertexCount + 1, 0);
+	for (unsigned int i : indices)
+		adjacencyOffsets[i + 1]++;
+	for (unsigned int v = 0; v < vertexCount; v++)
+		adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+	vector<unsigned int> adjacency(indices.size());
+	vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (unsigned int t = 0; t < triangleCount; t++)
+		for (int c = 0; c < 3; c++)
+			adjacency[fill[indices[t * 3 + c]]++] = t;
+
+	// Gather the unique edges and whether they lie on a border.
+	vector<unsigned long long> edges;
+	edges.reserve(indices.size());
+	for (size_t t = 0; t < indices.size(); t += 3)
+		for (int e = 0; e < 3; e++)
+			edges.push_back(edgeKey(indices[t + e], indices[t + (e + 1) % 3]));
+	std::sort(edges.begin(), edges.end());
+
+	// Pick the cheapest valid direction for every edge.
+	vector<Collapse> collapses;
+	for (size_t i = 0; i < edges.size();) {
+		size_t j = i + 1;
+		while (j < edges.size() && edges[j] == edges[i])
+			j++;
+
+		unsigned int a = static_cast<unsigned int>(edges[i] >> 32);
+		unsigned int b = static_cast<unsigned int>(edges[i] & 0xFFFFFFFF);
+		bool border = j - i == 1;
+		i = j;
+
+		Quadric q = quadrics[a];
+		q.add(quadrics[b]);
+
+		Collapse best = { 0, 0, INFINITY };
+		if (isCollapseAllowed(a, b, border))
+			best = { a, b, static_cast<float>(q.evaluate(positions[b])) };
+		if (isCollapseAllowed(b, a, border)) {
+			float cost = static_cast<float>(q.evaluate(positions[a]));
+			if (cost < best.cost)
+				best = { b, a, cost };
+		}
+
+		if (best.cost != INFINITY)
+			collapses.push_back(best);
+	}
+
+	std::sort(collapses.begin(), collapses.end(), [](const Collapse & a, const Collapse & b) {
+		return a.cost < b.cost;
+	});
+
+	// Perform collapses in order, skipping any whose neighbourhood has already changed during this pass.
+	vector<unsigned int> remap(vertexCount);
+	std::iota(remap.begin(), remap.end(), 0);
+	vector<bool> touched(vertexCount, false);
+	unsigned int removed = 0, performed = 0;
+	for (const Collapse & c : collapses) {
+		if (triangleCount - removed <= targetTriangleCount)
+			break;
+
+		if (touched[c.from] || touched[c.to])
+			continue;
+
+		if (!preservesOrientation(c.from, c.to, adjacencyOffsets, adjacency))
+			continue;
+
+		remap[c.from] = c.to;
+		quadrics[c.to].add(quadrics[c.from]);
+
+		for (unsigned int a = adjacencyOffsets[c.from]; a < adjacencyOffsets[c.from + 1]; a++) {
+			unsigned int t = adjacency[a] * 3;
+			bool collapsed = false;
+			for (int k = 0; k < 3; k++) {
+				touched[indices[t + k]] = true;
+				collapsed |= indices[t + k] == c.to;
+			}
+			if (collapsed)
+				removed++;
+		}
+
+		maxError = std::max(maxError, std::sqrt(c.cost));
+		performed++;
+	}
+
+	// Rewrite the index list and drop the triangles that became degenerate.
+	size_t write = 0;
+	for (size_t t = 0; t < indices.size(); t += 3) {
+		unsigned int i0 = remap[indices[t]], i1 = remap[indices[t + 1]], i2 = remap[indices[t + 2]];
+		if (i0 == i1 || i1 == i2 || i0 == i2)
+			continue;
+		indices[write++] = i0;
+		indices[write++] = i1;
+		indices[write++] = i2;
+	}
+	indices.resize(write);
+
+	return performed;
+}
+
+vector<unsigned int> MeshSimplifier::simplify(float ratio, float * error) {
+	if (dirty)
+		prepare();
+
+	unsigned int target = static_cast<unsigned int>(sourceTriangleCount * std::max(0.0f, std::min(1.0f, ratio)));
+	while (indices.size() / 3 > target)
+		if (pass(target) == 0)
+			break;
+
+	if (error != nullptr)
+		*error = maxError;
+
+	return indices;
+}
@@ -0,0 +1,180 @@
+#include <vector>
+
+#include "../math/GLVector.h"
+
+using glmath::vec3;
+using std::vector;
+
+#pragma once
+class MeshSimplifier {
+
+	private:
+		/**
+		 * @brief Symmetric 4x4 error quadric accumulated from the planes surrounding a vertex.
+		 *
+		 */
+		struct Quadric {
+			double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+			double b0 = 0, b1 = 0, b2 = 0;
+			double c = 0;
+
+			void addPlane(const vec3 & normal, float distance, float weight);
+			void add(const Quadric & other);
+			double evaluate(const vec3 & point) const;
+		};
+
+		/**
+		 * @brief A single half-edge collapse candidate, moving vertex `from` onto vertex `to`.
+		 *
+		 */
+		struct Collapse {
+			unsigned int from;
+			unsigned int to;
+			float cost;
+		};
+
+		/**
+		 * @brief The different topological classes a vertex can fall into.
+		 * Locked vertices never move, border vertices may only slide along their border.
+		 *
+		 */
+		enum VertexKind : unsigned char {
+			MANIFOLD,
+			BORDER,
+			LOCKED
+		};
+
+		/**
+		 * @brief The source vertex positions and vertex count.
+		 *
+		 */
+		const vec3 * positions;
+		unsigned int vertexCount;
+
+		/**
+		 * @brief The current index list, rewritten after each simplification pass.
+		 *
+		 */
+		vector<unsigned int> indices;
+
+		/**
+		 * @brief The original triangle count.
+		 *
+		 */
+		unsigned int sourceTriangleCount;
+
+		/**
+		 * @brief Maps every vertex to the first vertex sharing its position and texture coordinates.
+		 * All topology is computed on these representative vertices.
+		 *
+		 */
+		vector<unsigned int> wedges;
+
+		/**
+		 * @brief Per-vertex topological class, error quadric, and skinning group.
+		 *
+		 */
+		vector<VertexKind> kinds;
+		vector<Quadric> quadrics;
+		vector<unsigned int> skinGroups;
+
+		/**
+		 * @brief Per-vertex flag indicating that the vertex neighbours a vertex of another skinning group.
+		 *
+		 */
+		vector<bool> skinBorders;
+
+		/**
+		 * @brief Per-vertex flag indicating that the vertex lies on a UV seam.
+		 *
+		 */
+		vector<bool> seams;
+
+		/**
+		 * @brief The largest collapse error accepted so far.
+		 *
+		 */
+		float maxError = 0.0f;
+
+		/**
+		 * @brief Whether or not the quadrics and vertex classes need to be recomputed before the next pass.
+		 *
+		 */
+		bool dirty = true;
+
+		/**
+		 * @brief Recomputes vertex classes and error quadrics from the current index list.
+		 *
+		 */
+		void prepare();
+
+		/**
+		 * @brief Returns whether or not moving `from` onto `to` keeps every remaining triangle around `from` facing the same way.
+		 *
+		 */
+		bool preservesOrientation(unsigned int from, unsigned int to, const vector<unsigned int> & adjacencyOffsets, const vector<unsigned int> & adjacency) const;
+
+		/**
+		 * @brief Returns whether or not the collapse respects vertex classes and skinning group boundaries.
+		 *
+		 */
+		bool isCollapseAllowed(unsigned int from, unsigned int to, bool borderEdge) const;
+
+		/**
+		 * @brief Performs a single pass of non-overlapping collapses, ordered by increasing error.
+		 *
+		 * @return [unsigned int] The number of collapses performed.
+		 */
+		unsigned int pass(unsigned int targetTriangleCount);
+
+	public:
+		/**
+		 * @brief Constructs a new simplifier operating on the given indexed triangle list.
+		 *
+		 * @param positions The vertex positions, 3 floats per vertex.
+		 * @param vertexCount The number of vertices.
+		 * @param indices The triangle indices, 3 per triangle.
+		 * @param indexCount The number of indices.
+		 */
+		MeshSimplifier(const float * positions, unsigned int vertexCount, const unsigned int * indices, unsigned int indexCount);
+
+		/**
+		 * @brief Destroys the simplifier.
+		 *
+		 */
+		~MeshSimplifier();
+
+		/**
+		 * @brief Welds vertices sharing both position and texture coordinates and locks the vertices lying on UV seams,
+		 * i.e. positions referenced by several vertices with different texture coordinates.
+		 * Must be called before the first call to `simplify`.
+		 *
+		 * @param uvs The vertex texture coordinates, 2 floats per vertex.
+		 * @return [MeshSimplifier *] This same simplifier instance in order to allow for method chaining.
+		 */
+		MeshSimplifier * lockSeams(const float * uvs);
+
+		/**
+		 * @brief Groups vertices by their most influential joint. Collapses are only allowed within a group
+		 * and vertices bordering another group may only move along that border.
+		 * Must be called before the first call to `simplify`.
+		 *
+		 * @param jointIDs The joint IDs, `weightsPerVertex` per vertex.
+		 * @param weights The joint weights, `weightsPerVertex` per vertex.
+		 * @param weightsPerVertex The number of joint influences stored per vertex.
+		 * @return [MeshSimplifier *] This same simplifier instance in order to allow for method chaining.
+		 */
+		MeshSimplifier * lockSkinBorders(const unsigned short * jointIDs, const float * weights, unsigned int weightsPerVertex);
+
+		/**
+		 * @brief Simplifies the mesh further until its triangle count reaches the given ratio of the original triangle count,
+		 * or until no more collapses are possible. Successive calls continue from the previous result,
+		 * which makes generating a chain of levels of detail cheap.
+		 *
+		 * @param ratio The target triangle count as a fraction of the original triangle count.
+		 * @param error [Optional] Receives the largest geometric error introduced so far, in model units.
+		 * @return [vector<unsigned int>] The simplified index list, referencing the original vertices.
+		 */
+		vector<unsigned int> simplify(float ratio, float * error = nullptr);
+
+};
@@ -0,0 +1,191 @@
+#include <cmath>
+#include <cstdint>
+
+#include "MeshletBuilder.h"
+
+MeshletBuilder::MeshletBuilder(const float * positions, unsigned int vertexCount, unsigned int maxVertices, unsigned int maxTriangles) :
+	positions(reinterpret_cast<const vec3*>(positions)),
+	vertexCount(vertexCount),
+	maxVertices(maxVertices < 3 ? 3 : maxVertices),
+	maxTriangles(maxTriangles < 1 ? 1 : maxTriangles) {}
+
+MeshletBuilder::~MeshletBuilder() {}
+
+vector<Meshlet> MeshletBuilder::build(unsigned int * indices, unsigned int indexCount, unsigned int indexOffset) {
+	unsigned int triangleCount = indexCount / 3;
+
+	// Build the vertex to triangle adjacency.
+	vector<unsigned int> adjacencyOffsets(vertexCount + 1, 0);
+	for (unsigned int i = 0; i < triangleCount * 3; i++)
+		adjacencyOffsets[indices[i] + 1]++;
+	for (unsigned int v = 0; v < vertexCount; v++)
+		adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+	vector<unsigned int> adjacency(triangleCount * 3);
+	vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (unsigned int t = 0; t < triangleCount; t++)
+		for (int c = 0; c < 3; c++)
+			adjacency[fill[indices[t * 3 + c]]++] = t;
+
+	// Number of triangles not yet assigned to a cluster around each vertex.
+	vector<unsigned int> live(vertexCount);
+	for (unsigned int v = 0; v < vertexCount; v++)
+		live[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+
+	vector<bool> used(triangleCount, false);
+	vector<unsigned int> marks(vertexCount, UINT32_MAX);
+	vector<unsigned int> order;
+	order.reserve(triangleCount);
+
+	// Triangle counts and vertex lists of the clusters, in creation order.
+	vector<unsigned int> clusterTriangles;
+	vector<vector<unsigned int>> clusterVertices;
+	vector<unsigned int> current;
+	unsigned int currentTriangles = 0;
+	unsigned int cluster = 0;
+	unsigned int seed = 0;
+
+	// Returns the number of vertices a triangle would add to the current cluster.
+	auto countNewVertices = [&](unsigned int t) {
+		unsigned int i0 = indices[t * 3], i1 = indices[t * 3 + 1], i2 = indices[t * 3 + 2];
+		unsigned int count = marks[i0] != cluster ? 1 : 0;
+		count += marks[i1] != cluster && i1 != i0 ? 1 : 0;
+		count += marks[i2] != cluster && i2 != i0 && i2 != i1 ? 1 : 0;
+		return count;
+	};
+
+	for (unsigned int emitted = 0; emitted < triangleCount; emitted++) {
+
+		// Grow the cluster with the unused neighbouring triangle adding the fewest new vertices,
+		// preferring triangles whose vertices have few triangles left to avoid stranding them.
+		unsigned int best = UINT32_MAX, bestNew = UINT32_MAX, bestLive = UINT32_MAX;
+		for (unsigned int v : current)
+			for (unsigned int a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; a++) {
+				unsigned int t = adjacency[a];
+				if (used[t])
+					continue;
+
+				unsigned int newVertices = countNewVertices(t);
+				unsigned int liveSum = live[indices[t * 3]] + live[indices[t * 3 + 1]] + live[indices[t * 3 + 2]];
+				if (newVertices < bestNew || (newVertices == bestNew && liveSum < bestLive)) {
+					best = t;
+					bestNew = newVertices;
+					bestLive = liveSum;
+				}
+			}
+
+		// Without any neighbour, continue with the next unused triangle in index order.
+		if (best == UINT32_MAX) {
+			while (used[seed])
+				seed++;
+			best = seed;
+			bestNew = countNewVertices(best);
+		}
+
+		// Close the cluster if the triangle does not fit.
+		if (current.size() + bestNew > maxVertices || currentTriangles + 1 > maxTriangles) {
+			clusterTriangles.push_back(currentTriangles);
+			clusterVertices.push_back(current);
+			current.clear();
+			currentTriangles = 0;
+			cluster++;
+		}
+
+		// Add the triangle to the cluster.
+		for (int c = 0; c < 3; c++) {
+			unsigned int v = indices[best * 3 + c];
+			if (marks[v] != cluster) {
+				marks[v] = cluster;
+				current.push_back(v);
+			}
+			live[v]--;
+		}
+		used[best] = true;
+		order.push_back(best);
+		currentTriangles++;
+	}
+	if (currentTriangles > 0) {
+		clusterTriangles.push_back(currentTriangles);
+		clusterVertices.push_back(current);
+	}
+
+	// Reorder the triangles so that each cluster is contiguous.
+	vector<unsigned int> source(indices, indices + triangleCount * 3);
+	for (unsigned int t = 0; t < triangleCount; t++)
+		for (int c = 0; c < 3; c++)
+			indices[t * 3 + c] = source[order[t] * 3 + c];
+
+	// Create the clusters and compute their bounds.
+	vector<Meshlet> meshlets(clusterTriangles.size());
+	unsigned int offset = 0;
+	for (size_t m = 0; m < meshlets.size(); m++) {
+		meshlets[m].indexOffset = indexOffset + offset;
+		meshlets[m].indexCount = clusterTriangles[m] * 3;
+		meshlets[m].vertexCount = static_cast<unsigned int>(clusterVertices[m].size());
+		computeBounds(meshlets[m], indices + offset, clusterVertices[m]);
+		offset += meshlets[m].indexCount;
+	}
+
+	return meshlets;
+}
+
+void MeshletBuilder::computeBounds(Meshlet & meshlet, const unsigned int * indices, const vector<unsigned int> & vertices) const {
+
+	// Bounding sphere around the center of the cluster's bounding box.
+	vec3 lower = vec3(INFINITY), upper = vec3(-INFINITY);
+	for (unsigned int v : vertices) {
+		const vec3 & p = positions[v];
+		lower = vec3(std::fmin(lower.x, p.x), std::fmin(lower.y, p.y), std::fmin(lower.z, p.z));
+		upper = vec3(std::fmax(upper.x, p.x), std::fmax(upper.y, p.y), std::fmax(upper.z, p.z));
+	}
+	meshlet.center = 0.5f * (lower + upper);
+	meshlet.radius = 0.0f;
+	for (unsigned int v : vertices)
+		meshlet.radius = std::fmax(meshlet.radius, (positions[v] - meshlet.center).length());
+
+	// Average the triangle normals to find the cone axis.
+	unsigned int triangleCount = meshlet.indexCount / 3;
+	vector<vec3> normals, origins;
+	normals.reserve(triangleCount);
+	origins.reserve(triangleCount);
+	vec3 axis = vec3(0.0f);
+	for (unsigned int t = 0; t < triangleCount; t++) {
+		const vec3 & p0 = positions[indices[t * 3]];
+		vec3 normal = glmath::cross(positions[indices[t * 3 + 1]] - p0, positions[indices[t * 3 + 2]] - p0);
+		float length = normal.length();
+		if (length == 0.0f)
+			continue;
+		normal = normal / length;
+		normals.push_back(normal);
+		origins.push_back(p0);
+		axis += normal;
+	}
+
+	// Clusters without a consistent facing can never be backface culled.
+	meshlet.coneApex = meshlet.center;
+	meshlet.coneAxis = vec3(0.0f, 0.0f, 1.0f);
+	meshlet.coneCutoff = 1.0f;
+
+	float axisLength = axis.length();
+	if (normals.empty() || axisLength == 0.0f)
+		return;
+	axis = axis / axisLength;
+
+	float minDot = 1.0f;
+	for (const vec3 & normal : normals)
+		minDot = std::fmin(minDot, glmath::dot(normal, axis));
+	if (minDot <= 0.0f)
+		return;
+
+	// Move the apex back along the axis until every triangle plane lies in front of it.
+	float maxT = 0.0f;
+	for (size_t n = 0; n < normals.size(); n++) {
+		float distance = glmath::dot(meshlet.center - origins[n], normals[n]);
+		maxT = std::fmax(maxT, distance / glmath::dot(axis, normals[n]));
+	}
+
+	// The normal cone's half angle a has cos(a) = minDot. Widening it by 90 degrees on both sides and inverting it 
+	// gives the cone of view directions from which every triangle is backfacing: -cos(a + 90) = sin(a).
+	meshlet.coneApex = meshlet.center - maxT * axis;
+	meshlet.coneAxis = axis;
+	meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
@@ -0,0 +1,74 @@
+#include <vector>
+
+#include "../math/GLVector.h"
+#include "../objects/Mesh.h"
+
+using glmath::vec3;
+using std::vector;
+
+#pragma once
+class MeshletBuilder {
+
+	private:
+		/**
+		 * @brief The vertex positions and vertex count of the mesh being partitioned.
+		 * 
+		 */
+		const vec3 * positions;
+		unsigned int vertexCount;
+
+		/**
+		 * @brief The maximum number of unique vertices per cluster.
+		 * 
+		 */
+		unsigned int maxVertices;
+
+		/**
+		 * @brief The maximum number of triangles per cluster.
+		 * 
+		 */
+		unsigned int maxTriangles;
+
+		/**
+		 * @brief Computes the bounding sphere and normal cone of a cluster.
+		 * 
+		 */
+		void computeBounds(Meshlet & meshlet, const unsigned int * indices, const vector<unsigned int> & vertices) const;
+
+	public:
+		/**
+		 * @brief Default cluster limits, matching the common mesh shader limits.
+		 * 
+		 */
+		static const unsigned int DEFAULT_MAX_VERTICES = 64;
+		static const unsigned int DEFAULT_MAX_TRIANGLES = 124;
+
+		/**
+		 * @brief Constructs a new meshlet builder for a mesh.
+		 * 
+		 * @param positions The vertex positions, 3 floats per vertex.
+		 * @param vertexCount The number of vertices.
+		 * @param maxVertices The maximum number of unique vertices per cluster.
+		 * @param maxTriangles The maximum number of triangles per cluster.
+		 */
+		MeshletBuilder(const float * positions, unsigned int vertexCount, 
+			unsigned int maxVertices = DEFAULT_MAX_VERTICES, unsigned int maxTriangles = DEFAULT_MAX_TRIANGLES);
+
+		/**
+		 * @brief Destroys the meshlet builder.
+		 * 
+		 */
+		~MeshletBuilder();
+
+		/**
+		 * @brief Partitions a triangle list into clusters of neighbouring triangles. 
+		 * The triangles are reordered in place so that each cluster occupies a contiguous range of the index list.
+		 * 
+		 * @param indices The triangle indices, 3 per triangle, reordered by this method.
+		 * @param indexCount The number of indices.
+		 * @param indexOffset The offset of the index list in the mesh's index buffer, added to each cluster's index offset.
+		 * @return [vector<Meshlet>] The resulting clusters, in index buffer order.
+		 */
+		vector<Meshlet> build(unsigned int * indices, unsigned int indexCount, unsigned int indexOffset = 0);
+
+};
@@ -0,0 +1,142 @@
+#include <fstream>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include "FileSystem.h"
+#include "PackArchive.h"
+#include "VirtualFileSystem.h"
+
+using std::ofstream;
+using std::vector;
+
+// The 4 byte identifier every archive starts with, and the current format version.
+static const char IDENTIFIER[4] = { 'E', 'P', 'A', 'K' };
+static const unsigned int VERSION = 1;
+
+// Header layout: identifier, version, entry count, reserved, table of contents offset, name table offset, name table size.
+static const unsigned int HEADER_SIZE = 40;
+
+static_assert(sizeof(PackArchive::Entry) == 32, "Pack archive entries must match their on-disk layout.");
+
+static inline unsigned int readU32(const unsigned char * src, size_t offset) {
+	unsigned int value;
+	memcpy(&value, src + offset, sizeof(value));
+	return value;
+}
+static inline unsigned long long readU64(const unsigned char * src, size_t offset) {
+	unsigned long long value;
+	memcpy(&value, src + offset, sizeof(value));
+	return value;
+}
+
+// Returns whether a range lies within a buffer, without overflowing on ranges read from a corrupted archive.
+static inline bool isWithin(unsigned long long offset, unsigned long long size, unsigned long long total) {
+	return offset <= total && size <= total - offset;
+}
+
+PackArchive::PackArchive(const shared_ptr<MappedFile> & file, const Entry * entries, unsigned int entryCount, const char * names, size_t namesSize) :
+	file(file), entries(entries), entryCount(entryCount), names(names), namesSize(namesSize) {}
+
+unsigned long long PackArchive::hashPath(const string & path) {
+	unsigned long long hash = 14695981039346656037ULL;
+	for (char c : path) {
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+shared_ptr<PackArchive> PackArchive::open(const string & path) {
+	shared_ptr<MappedFile> file = MappedFile::open(path);
+	if (file == nullptr || file->getSize() < HEADER_SIZE || memcmp(file->getData(), IDENTIFIER, sizeof(IDENTIFIER)) != 0)
+		return nullptr;
+
+	// Check that the table of contents and the name table lie within the file, the table being 8 byte aligned.
+	const unsigned char * data = file->getData();
+	unsigned int entryCount = readU32(data, 8);
+	unsigned long long tocOffset = readU64(data, 16);
+	unsigned long long namesOffset = readU64(data, 24);
+	unsigned long long namesSize = readU64(data, 32);
+	if (readU32(data, 4) != VERSION || tocOffset % 8 != 0 ||
+		!isWithin(tocOffset, static_cast<unsigned long long>(entryCount) * sizeof(Entry), file->getSize()) ||
+		!isWithin(namesOffset, namesSize, file->getSize()))
+		return nullptr;
+
+	return shared_ptr<PackArchive>(new PackArchive(file, reinterpret_cast<const Entry *>(data + tocOffset), entryCount,
+		reinterpret_cast<const char *>(data + namesOffset), static_cast<size_t>(namesSize)));
+}
+
+const PackArchive::Entry * PackArchive::find(const string & path) const {
+	unsigned long long hash = hashPath(path);
+	const Entry * end = entries + entryCount;
+	const Entry * entry = std::lower_bound(entries, end, hash, [](const Entry & e, unsigned long long h) { return e.hash < h; });
+
+	// Tell apart colliding paths by name, and reject entries pointing outside of the archive.
+	for (; entry != end && entry->hash == hash; entry++) {
+		if (!isWithin(entry->nameOffset, entry->nameLength, namesSize) ||
+			entry->nameLength != path.size() || memcmp(names + entry->nameOffset, path.data(), path.size()) != 0)
+			continue;
+		if (!isWithin(entry->offset, entry->size, file->getSize()))
+			return nullptr;
+		return entry;
+	}
+	return nullptr;
+}
+
+bool PackArchive::build(const string & directory, const char * dst, const string & prefix, unsigned int * count) {
+	vector<string> files = FileSystem::listFilesRecursive(directory);
+	string root = VirtualFileSystem::normalize(prefix);
+	if (!root.empty() && root.back() != '/')
+		root += '/';
+	ofstream stream(dst, std::ios::binary);
+	if (!stream)
+		return false;
+
+	// Copy the files after the header, each one aligned.
+	vector<unsigned char> header(HEADER_SIZE, 0);
+	stream.write(reinterpret_cast<const char *>(header.data()), HEADER_SIZE);
+	unsigned long long offset = HEADER_SIZE;
+	vector<Entry> entries;
+	string names;
+	static const char PADDING[FILE_ALIGNMENT] = {};
+	for (const string & name : files) {
+		shared_ptr<MappedFile> file = MappedFile::open(directory + "/" + name);
+		if (file == nullptr)
+			return false;
+		unsigned long long aligned = (offset + FILE_ALIGNMENT - 1) / FILE_ALIGNMENT * FILE_ALIGNMENT;
+		stream.write(PADDING, static_cast<std::streamsize>(aligned - offset));
+		stream.write(reinterpret_cast<const char *>(file->getData()), static_cast<std::streamsize>(file->getSize()));
+		string path = root + name;
+		entries.push_back({ hashPath(path), aligned, file->getSize(), static_cast<unsigned int>(names.size()), static_cast<unsigned int>(path.size()) });
+		names += path;
+		offset = aligned + file->getSize();
+	}
+
+	// Write the table of contents sorted by hash, then the names it points to.
+	std::sort(entries.begin(), entries.end(), [&names](const Entry & a, const Entry & b) {
+		if (a.hash != b.hash)
+			return a.hash < b.hash;
+		return names.compare(a.nameOffset, a.nameLength, names, b.nameOffset, b.nameLength) < 0;
+	});
+	unsigned long long tocOffset = (offset + 7) / 8 * 8;
+	stream.write(PADDING, static_cast<std::streamsize>(tocOffset - offset));
+	stream.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+	stream.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+	unsigned int entryCount = static_cast<unsigned int>(entries.size());
+	unsigned long long namesOffset = tocOffset + entries.size() * sizeof(Entry);
+	unsigned long long namesSize = names.size();
+	memcpy(header.data(), IDENTIFIER, sizeof(IDENTIFIER));
+	memcpy(header.data() + 4, &VERSION, sizeof(VERSION));
+	memcpy(header.data() + 8, &entryCount, sizeof(entryCount));
+	memcpy(header.data() + 16, &tocOffset, sizeof(tocOffset));
+	memcpy(header.data() + 24, &namesOffset, sizeof(namesOffset));
+	memcpy(header.data() + 32, &namesSize, sizeof(namesSize));
+	stream.seekp(0);
+	stream.write(reinterpret_cast<const char *>(header.data()), HEADER_SIZE);
+
+	if (count != nullptr)
+		*count = entryCount;
+	return static_cast<bool>(stream);
+}
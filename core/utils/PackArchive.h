@@ -0,0 +1,101 @@
+#include <string>
+#include <memory>
+
+#include "MappedFile.h"
+
+using std::string;
+using std::shared_ptr;
+
+#pragma once
+class PackArchive {
+
+	public:
+		/**
+		 * @brief A table of contents entry locating a packed file, stored as is in the archive.
+		 * Entries are sorted by path hash so lookups are a binary search over the mapped table.
+		 * 
+		 */
+		struct Entry {
+			unsigned long long hash;
+			unsigned long long offset;
+			unsigned long long size;
+			unsigned int nameOffset;
+			unsigned int nameLength;
+		};
+
+	private:
+		/**
+		 * @brief The whole archive mapped into memory, and its table of contents and name table within the mapping.
+		 * 
+		 */
+		shared_ptr<MappedFile> file;
+		const Entry * entries;
+		unsigned int entryCount;
+		const char * names;
+		size_t namesSize;
+
+		/**
+		 * @brief Constructs a new pack archive object around its mapping.
+		 * 
+		 */
+		PackArchive(const shared_ptr<MappedFile> & file, const Entry * entries, unsigned int entryCount, const char * names, size_t namesSize);
+
+	public:
+		/**
+		 * @brief The alignment of every packed file within the archive, in bytes.
+		 * 
+		 */
+		static const unsigned int FILE_ALIGNMENT = 16;
+
+		/**
+		 * @brief Maps a pack archive into memory. Only its header is validated, the table of contents is used in place.
+		 * This method returns a null pointer if the file is not a valid archive.
+		 * 
+		 * @param path The path of the archive on disk.
+		 * @return [shared_ptr<PackArchive>] The opened archive.
+		 */
+		static shared_ptr<PackArchive> open(const string & path);
+
+		/**
+		 * @brief Packs every file below a directory into a single archive, named by their path relative to the directory.
+		 * 
+		 * @param directory The directory to pack.
+		 * @param dst The path of the archive to write, outside of the packed directory.
+		 * @param prefix [Optional] A virtual directory prepended to every packed path, e.g. "shaders/".
+		 * @param count [Optional] Receives the number of packed files.
+		 * @return [bool] True if the archive was written successfully, false otherwise.
+		 */
+		static bool build(const string & directory, const char * dst, const string & prefix = "", unsigned int * count = nullptr);
+
+		/**
+		 * @brief Hashes a normalized path the way the table of contents does. (64 bit FNV-1a)
+		 * 
+		 * @param path The normalized path to hash.
+		 * @return [unsigned long long] The path's hash.
+		 */
+		static unsigned long long hashPath(const string & path);
+
+		/**
+		 * @brief Looks up a packed file by its normalized path.
+		 * This method returns a null pointer if the archive does not contain the file.
+		 * 
+		 * @param path The normalized path of the file relative to the archive root.
+		 * @return [const Entry *] The file's table of contents entry, within the archive's mapping.
+		 */
+		const Entry * find(const string & path) const;
+
+		/**
+		 * @brief Returns the archive's mapping, which packed file contents point into.
+		 * 
+		 * @return [const shared_ptr<MappedFile> &] The mapped archive.
+		 */
+		inline const shared_ptr<MappedFile> & getFile() const { return file; };
+
+		/**
+		 * @brief Returns the number of files in the archive.
+		 * 
+		 * @return [unsigned int] The number of table of contents entries.
+		 */
+		inline unsigned int getEntryCount() const { return entryCount; };
+
+};
@@ -0,0 +1,126 @@
+#include <new>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+
+#include "AllocationStats.h"
+
+using std::vector;
+
+#pragma once
+
+/**
+ * @brief Serves memory for objects of a single type from chunks of fixed-size blocks, freed blocks being kept on a list for reuse.
+ * Types route their operator new and delete to their shared pool. Pools are thread safe.
+ *
+ */
+template <typename T, unsigned int CHUNK_BLOCKS = 256>
+class PoolAllocator {
+
+	private:
+		/**
+		 * @brief A block, holding either an object or the next free block.
+		 *
+		 */
+		union Block {
+			Block * next;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+		/**
+		 * @brief The chunks of blocks allocated so far, and the first free block.
+		 *
+		 */
+		vector<Block *> chunks;
+		Block * freeList = nullptr;
+
+		/**
+		 * @brief The number of blocks currently holding an object.
+		 *
+		 */
+		size_t used = 0;
+
+		/**
+		 * @brief Guards the chunks and the free list.
+		 *
+		 */
+		mutable std::mutex mutex;
+
+	public:
+		/**
+		 * @brief Frees the pool's chunks, which must hold no object anymore, and destroys the pool object.
+		 *
+		 */
+		~PoolAllocator() {
+			for (Block * chunk : chunks)
+				delete[] chunk;
+		}
+
+		/**
+		 * @brief Takes a free block, allocating a new chunk when none is left.
+		 *
+		 * @return [void *] The memory of an object.
+		 */
+		void * allocate() {
+			AllocationStats::record(ALLOCATION_POOL, sizeof(T));
+			std::lock_guard<std::mutex> lock(mutex);
+			if (freeList == nullptr) {
+				Block * chunk = new Block[CHUNK_BLOCKS];
+				chunks.push_back(chunk);
+				for (unsigned int b = 0; b < CHUNK_BLOCKS; b++)
+					chunk[b].next = b + 1 < CHUNK_BLOCKS ? &chunk[b + 1] : nullptr;
+				freeList = chunk;
+			}
+			Block * block = freeList;
+			freeList = block->next;
+			used++;
+			return block->storage;
+		}
+
+		/**
+		 * @brief Returns a block to the free list.
+		 *
+		 * @param memory The memory of an object allocated from this pool, whose destructor already ran, or null.
+		 */
+		void free(void * memory) {
+			if (memory == nullptr)
+				return;
+			std::lock_guard<std::mutex> lock(mutex);
+			Block * block = static_cast<Block *>(memory);
+			block->next = freeList;
+			freeList = block;
+			used--;
+		}
+
+		/**
+		 * @brief Returns the number of objects allocated from the pool and not yet freed.
+		 *
+		 * @return [size_t] The number of blocks in use.
+		 */
+		size_t getUsed() const {
+			std::lock_guard<std::mutex> lock(mutex);
+			return used;
+		}
+
+		/**
+		 * @brief Returns the number of blocks allocated so far.
+		 *
+		 * @return [size_t] The number of blocks, in use or free.
+		 */
+		size_t getCapacity() const {
+			std::lock_guard<std::mutex> lock(mutex);
+			return chunks.size() * CHUNK_BLOCKS;
+		}
+
+		/**
+		 * @brief Returns the pool shared by all objects of the type. It is never destroyed,
+		 * so that objects may still be freed while static objects are destroyed.
+		 *
+		 * @return [PoolAllocator *] The shared pool.
+		 */
+		static PoolAllocator * getShared() {
+			static PoolAllocator * shared = new PoolAllocator();
+			return shared;
+		}
+
+};
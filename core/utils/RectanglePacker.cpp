@@ -0,0 +1,85 @@
+#include <climits>
+#include <algorithm>
+
+#include "RectanglePacker.h"
+
+RectanglePacker::RectanglePacker(unsigned int width, unsigned int height) : width(width), height(height) {
+	freeRects.push_back({ 0, 0, width, height });
+}
+
+bool RectanglePacker::insert(unsigned int width, unsigned int height, Rect & result) {
+
+	// Find the free rectangle leaving the smallest leftover on its short side, then on its long side.
+	const Rect * best = nullptr;
+	unsigned int bestShort = UINT_MAX, bestLong = UINT_MAX;
+	for (const Rect & free : freeRects) {
+		if (free.width < width || free.height < height)
+			continue;
+		unsigned int leftoverX = free.width - width, leftoverY = free.height - height;
+		unsigned int shortSide = std::min(leftoverX, leftoverY), longSide = std::max(leftoverX, leftoverY);
+		if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+			best = &free;
+			bestShort = shortSide;
+			bestLong = longSide;
+		}
+	}
+	if (best == nullptr)
+		return false;
+
+	result = { best->x, best->y, width, height };
+	split(result);
+	prune();
+	usedArea += static_cast<unsigned long long>(width) * height;
+	return true;
+}
+
+void RectanglePacker::split(const Rect & placed) {
+	vector<Rect> result;
+	result.reserve(freeRects.size() + 4);
+	for (const Rect & free : freeRects) {
+
+		// Keep the free rectangles the placed rectangle does not overlap.
+		if (placed.x >= free.x + free.width || placed.x + placed.width <= free.x ||
+			placed.y >= free.y + free.height || placed.y + placed.height <= free.y) {
+			result.push_back(free);
+			continue;
+		}
+
+		// Replace the others with the maximal rectangles on each side of the placed rectangle.
+		if (placed.x > free.x)
+			result.push_back({ free.x, free.y, placed.x - free.x, free.height });
+		if (placed.x + placed.width < free.x + free.width)
+			result.push_back({ placed.x + placed.width, free.y, free.x + free.width - placed.x - placed.width, free.height });
+		if (placed.y > free.y)
+			result.push_back({ free.x, free.y, free.width, placed.y - free.y });
+		if (placed.y + placed.height < free.y + free.height)
+			result.push_back({ free.x, placed.y + placed.height, free.width, free.y + free.height - placed.y - placed.height });
+	}
+	freeRects.swap(result);
+}
+
+void RectanglePacker::prune() {
+	auto contains = [](const Rect & a, const Rect & b) {
+		return b.x >= a.x && b.y >= a.y && b.x + b.width <= a.x + a.width && b.y + b.height <= a.y + a.height;
+	};
+
+	vector<bool> removed(freeRects.size(), false);
+	for (size_t i = 0; i < freeRects.size(); i++) {
+		if (removed[i])
+			continue;
+		for (size_t j = 0; j < freeRects.size(); j++) {
+			if (i == j || removed[j])
+				continue;
+			if (contains(freeRects[j], freeRects[i])) {
+				removed[i] = true;
+				break;
+			}
+		}
+	}
+
+	size_t kept = 0;
+	for (size_t i = 0; i < freeRects.size(); i++)
+		if (!removed[i])
+			freeRects[kept++] = freeRects[i];
+	freeRects.resize(kept);
+}
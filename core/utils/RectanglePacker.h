@@ -0,0 +1,85 @@
+#include <vector>
+
+using std::vector;
+
+#pragma once
+class RectanglePacker {
+
+	public:
+		/**
+		 * @brief An axis aligned rectangle, in texels.
+		 * 
+		 */
+		struct Rect {
+			unsigned int x;
+			unsigned int y;
+			unsigned int width;
+			unsigned int height;
+		};
+
+	private:
+		/**
+		 * @brief The dimensions of the bin.
+		 * 
+		 */
+		unsigned int width;
+		unsigned int height;
+
+		/**
+		 * @brief The area covered by the rectangles inserted so far.
+		 * 
+		 */
+		unsigned long long usedArea = 0;
+
+		/**
+		 * @brief The maximal free rectangles of the bin, which may overlap each other.
+		 * 
+		 */
+		vector<Rect> freeRects;
+
+		/**
+		 * @brief Splits the free rectangles overlapping a newly placed rectangle into the maximal rectangles around it.
+		 * 
+		 */
+		void split(const Rect & placed);
+
+		/**
+		 * @brief Removes the free rectangles contained in another free rectangle.
+		 * 
+		 */
+		void prune();
+
+	public:
+		/**
+		 * @brief Constructs a new empty bin using the maximal rectangles algorithm.
+		 * 
+		 * @param width The width of the bin.
+		 * @param height The height of the bin.
+		 */
+		RectanglePacker(unsigned int width, unsigned int height);
+
+		/**
+		 * @brief Places a rectangle in the free space leaving the shortest leftover side. (best short side fit)
+		 * 
+		 * @param width The width of the rectangle.
+		 * @param height The height of the rectangle.
+		 * @param result Receives the position and size of the placed rectangle.
+		 * @return [bool] True if the rectangle was placed, false if it does not fit in the remaining space.
+		 */
+		bool insert(unsigned int width, unsigned int height, Rect & result);
+
+		/**
+		 * @brief Returns the fraction of the bin covered by the rectangles inserted so far.
+		 * 
+		 * @return [float] The occupancy of the bin, between 0 and 1.
+		 */
+		inline float getOccupancy() const { return static_cast<float>(static_cast<double>(usedArea) / (static_cast<double>(width) * height)); };
+
+		/**
+		 * @brief Returns the area covered by the rectangles inserted so far.
+		 * 
+		 * @return [unsigned long long] The used area, in texels.
+		 */
+		inline unsigned long long getUsedArea() const { return usedArea; };
+
+};
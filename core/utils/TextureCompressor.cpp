@@ -0,0 +1,416 @@
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+#include <algorithm>
+
+#include "stb_image.h"
+#include "TextureCompressor.h"
+
+// Number of texels in a 4x4 block.
+static const unsigned int BLOCK_TEXELS = 16;
+
+// Number of times the endpoints of a block are refitted to the texels assigned to each palette entry.
+static const unsigned int REFINE_ITERATIONS = 2;
+
+// Position of each BC1 palette entry along the segment between the two endpoints, in 4 and 3 color modes.
+static const float BC1_WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+static const float BC1_ALPHA_WEIGHTS[3] = { 0.0f, 1.0f, 0.5f };
+
+// BC7 4 bit index interpolation weights, out of 64.
+static const unsigned int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static inline float clampChannel(float value) {
+	return value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value);
+}
+
+static void fitEndpoints(const float * points, unsigned int count, unsigned int channels, float * e0, float * e1) {
+
+	// Mean and covariance of the points.
+	float mean[4] = { 0 };
+	float covariance[4][4] = { { 0 } };
+	for (unsigned int i = 0; i < count; i++)
+		for (unsigned int c = 0; c < channels; c++)
+			mean[c] += points[i * channels + c] / count;
+	for (unsigned int i = 0; i < count; i++)
+		for (unsigned int a = 0; a < channels; a++)
+			for (unsigned int b = 0; b < channels; b++)
+				covariance[a][b] += (points[i * channels + a] - mean[a]) * (points[i * channels + b] - mean[b]);
+
+	// Find the principal axis by power iteration, starting from the channel with the widest spread.
+	float axis[4] = { 0 };
+	unsigned int widest = 0;
+	for (unsigned int c = 1; c < channels; c++)
+		if (covariance[c][c] > covariance[widest][widest])
+			widest = c;
+	axis[widest] = 1.0f;
+	for (int iteration = 0; iteration < 8; iteration++) {
+		float next[4] = { 0 };
+		float length = 0.0f;
+		for (unsigned int a = 0; a < channels; a++) {
+			for (unsigned int b = 0; b < channels; b++)
+				next[a] += covariance[a][b] * axis[b];
+			length += next[a] * next[a];
+		}
+		if (length < 1e-12f)
+			break;
+		length = sqrtf(length);
+		for (unsigned int c = 0; c < channels; c++)
+			axis[c] = next[c] / length;
+	}
+
+	// The endpoints are the extreme projections of the points onto the axis.
+	float lower = FLT_MAX, upper = -FLT_MAX;
+	for (unsigned int i = 0; i < count; i++) {
+		float t = 0.0f;
+		for (unsigned int c = 0; c < channels; c++)
+			t += (points[i * channels + c] - mean[c]) * axis[c];
+		lower = std::min(lower, t);
+		upper = std::max(upper, t);
+	}
+	for (unsigned int c = 0; c < channels; c++) {
+		e0[c] = clampChannel(mean[c] + lower * axis[c]);
+		e1[c] = clampChannel(mean[c] + upper * axis[c]);
+	}
+}
+
+static float selectIndices(const float * points, unsigned int count, unsigned int channels, const float * palette, unsigned int paletteSize, unsigned int * indices) {
+	float total = 0.0f;
+	for (unsigned int i = 0; i < count; i++) {
+		float best = FLT_MAX;
+		for (unsigned int k = 0; k < paletteSize; k++) {
+			float error = 0.0f;
+			for (unsigned int c = 0; c < channels; c++) {
+				float d = points[i * channels + c] - palette[k * channels + c];
+				error += d * d;
+			}
+			if (error < best) {
+				best = error;
+				indices[i] = k;
+			}
+		}
+		total += best;
+	}
+	return total;
+}
+
+static bool refineEndpoints(const float * points, unsigned int count, unsigned int channels, const unsigned int * indices, const float * weights, float * e0, float * e1) {
+
+	// Least squares fit of both endpoints given the position of each point along the segment.
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	float ax[4] = { 0 }, bx[4] = { 0 };
+	for (unsigned int i = 0; i < count; i++) {
+		float b = weights[indices[i]];
+		float a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (unsigned int c = 0; c < channels; c++) {
+			ax[c] += a * points[i * channels + c];
+			bx[c] += b * points[i * channels + c];
+		}
+	}
+
+	// All the points use the same palette entry.
+	float determinant = aa * bb - ab * ab;
+	if (fabsf(determinant) < 1e-6f)
+		return false;
+
+	for (unsigned int c = 0; c < channels; c++) {
+		e0[c] = clampChannel((bb * ax[c] - ab * bx[c]) / determinant);
+		e1[c] = clampChannel((aa * bx[c] - ab * ax[c]) / determinant);
+	}
+	return true;
+}
+
+static inline unsigned short packRGB565(const float * color) {
+	unsigned int r = static_cast<unsigned int>(color[0] * 31.0f / 255.0f + 0.5f);
+	unsigned int g = static_cast<unsigned int>(color[1] * 63.0f / 255.0f + 0.5f);
+	unsigned int b = static_cast<unsigned int>(color[2] * 31.0f / 255.0f + 0.5f);
+	return static_cast<unsigned short>(r << 11 | g << 5 | b);
+}
+
+static inline void unpackRGB565(unsigned short value, float * color) {
+	unsigned int r = value >> 11 & 31, g = value >> 5 & 63, b = value & 31;
+	color[0] = static_cast<float>(r << 3 | r >> 2);
+	color[1] = static_cast<float>(g << 2 | g >> 4);
+	color[2] = static_cast<float>(b << 3 | b >> 2);
+}
+
+static void quantizeBC7(const float * endpoint, unsigned int * quantized, unsigned int & pBit, float * reconstructed) {
+
+	// Each channel is stored on 7 bits, with a low bit shared between all channels.
+	float best = FLT_MAX;
+	for (unsigned int p = 0; p < 2; p++) {
+		unsigned int q[4];
+		float r[4];
+		float error = 0.0f;
+		for (unsigned int c = 0; c < 4; c++) {
+			float value = (endpoint[c] - p) / 2.0f + 0.5f;
+			q[c] = static_cast<unsigned int>(std::max(0.0f, std::min(127.0f, value)));
+			r[c] = static_cast<float>(q[c] << 1 | p);
+			error += (r[c] - endpoint[c]) * (r[c] - endpoint[c]);
+		}
+		if (error < best) {
+			best = error;
+			pBit = p;
+			memcpy(quantized, q, sizeof(q));
+			memcpy(reconstructed, r, sizeof(r));
+		}
+	}
+}
+
+void TextureCompressor::encodeBC1(const unsigned char * rgba, unsigned char * dst, bool alpha) {
+
+	// Transparent texels are left out of the fit, and switch the block to 3 color mode.
+	float points[BLOCK_TEXELS * 3];
+	unsigned int texels[BLOCK_TEXELS];
+	unsigned int count = 0;
+	unsigned int bits = 0;
+	for (unsigned int i = 0; i < BLOCK_TEXELS; i++) {
+		if (alpha && rgba[i * 4 + 3] < 128) {
+			bits |= 3u << (i * 2);
+			continue;
+		}
+		for (unsigned int c = 0; c < 3; c++)
+			points[count * 3 + c] = rgba[i * 4 + c];
+		texels[count++] = i;
+	}
+
+	unsigned short c0 = 0, c1 = 0;
+	if (count > 0) {
+
+		// The order of the endpoints selects the mode, c0 > c1 for 4 colors and c0 <= c1 for 3 colors and transparency.
+		bool threeColor = count < BLOCK_TEXELS;
+		const float * weights = threeColor ? BC1_ALPHA_WEIGHTS : BC1_WEIGHTS;
+		unsigned int paletteSize = threeColor ? 3 : 4;
+
+		float e0[3], e1[3];
+		fitEndpoints(points, count, 3, e0, e1);
+
+		float bestError = FLT_MAX;
+		unsigned int indices[BLOCK_TEXELS], bestIndices[BLOCK_TEXELS];
+		for (unsigned int iteration = 0; iteration <= REFINE_ITERATIONS; iteration++) {
+			unsigned short p0 = packRGB565(e0), p1 = packRGB565(e1);
+			if (threeColor ? p0 > p1 : p0 < p1)
+				std::swap(p0, p1);
+
+			// Equal endpoints can only use the first palette entry.
+			float palette[4 * 3];
+			unpackRGB565(p0, palette);
+			unpackRGB565(p1, palette + 3);
+			for (unsigned int k = 2; k < paletteSize; k++)
+				for (unsigned int c = 0; c < 3; c++)
+					palette[k * 3 + c] = (1.0f - weights[k]) * palette[c] + weights[k] * palette[3 + c];
+			float error = selectIndices(points, count, 3, palette, p0 == p1 ? 1 : paletteSize, indices);
+
+			if (error < bestError) {
+				bestError = error;
+				c0 = p0;
+				c1 = p1;
+				memcpy(bestIndices, indices, sizeof(indices));
+			}
+			if (!refineEndpoints(points, count, 3, indices, weights, e0, e1))
+				break;
+		}
+
+		for (unsigned int i = 0; i < count; i++)
+			bits |= bestIndices[i] << (texels[i] * 2);
+	}
+
+	dst[0] = c0 & 0xFF;
+	dst[1] = c0 >> 8;
+	dst[2] = c1 & 0xFF;
+	dst[3] = c1 >> 8;
+	for (unsigned int b = 0; b < 4; b++)
+		dst[4 + b] = bits >> (b * 8) & 0xFF;
+}
+
+void TextureCompressor::encodeBC4(const unsigned char * values, unsigned char * dst) {
+
+	// Use the 8 value mode spanning the whole range of the block.
+	unsigned char lower = *std::min_element(values, values + BLOCK_TEXELS);
+	unsigned char upper = *std::max_element(values, values + BLOCK_TEXELS);
+	dst[0] = upper;
+	dst[1] = lower;
+
+	// Equal endpoints leave every index at 0.
+	unsigned long long bits = 0;
+	if (upper != lower) {
+		float palette[8] = { static_cast<float>(upper), static_cast<float>(lower) };
+		for (unsigned int k = 2; k < 8; k++)
+			palette[k] = ((8 - k) * upper + (k - 1) * lower) / 7.0f;
+
+		for (unsigned int i = 0; i < BLOCK_TEXELS; i++) {
+			float point = values[i];
+			unsigned int index;
+			selectIndices(&point, 1, 1, palette, 8, &index);
+			bits |= static_cast<unsigned long long>(index) << (i * 3);
+		}
+	}
+
+	for (unsigned int b = 0; b < 6; b++)
+		dst[2 + b] = bits >> (b * 8) & 0xFF;
+}
+
+void TextureCompressor::encodeBC7(const unsigned char * rgba, unsigned char * dst) {
+
+	float points[BLOCK_TEXELS * 4];
+	for (unsigned int i = 0; i < BLOCK_TEXELS * 4; i++)
+		points[i] = rgba[i];
+
+	float e0[4], e1[4];
+	fitEndpoints(points, BLOCK_TEXELS, 4, e0, e1);
+
+	float weights[16];
+	for (unsigned int k = 0; k < 16; k++)
+		weights[k] = BC7_WEIGHTS[k] / 64.0f;
+
+	float bestError = FLT_MAX;
+	unsigned int q0[4], q1[4], p0 = 0, p1 = 0;
+	unsigned int indices[BLOCK_TEXELS], bestIndices[BLOCK_TEXELS];
+	for (unsigned int iteration = 0; iteration <= REFINE_ITERATIONS; iteration++) {
+
+		// Quantize the endpoints and interpolate the palette exactly as the decoder does.
+		unsigned int quantized0[4], quantized1[4], pBit0, pBit1;
+		float r0[4], r1[4];
+		quantizeBC7(e0, quantized0, pBit0, r0);
+		quantizeBC7(e1, quantized1, pBit1, r1);
+		float palette[16 * 4];
+		for (unsigned int k = 0; k < 16; k++)
+			for (unsigned int c = 0; c < 4; c++)
+				palette[k * 4 + c] = static_cast<float>(((64 - BC7_WEIGHTS[k]) * static_cast<unsigned int>(r0[c]) + BC7_WEIGHTS[k] * static_cast<unsigned int>(r1[c]) + 32) >> 6);
+		float error = selectIndices(points, BLOCK_TEXELS, 4, palette, 16, indices);
+
+		if (error < bestError) {
+			bestError = error;
+			memcpy(q0, quantized0, sizeof(q0));
+			memcpy(q1, quantized1, sizeof(q1));
+			p0 = pBit0;
+			p1 = pBit1;
+			memcpy(bestIndices, indices, sizeof(indices));
+		}
+		if (!refineEndpoints(points, BLOCK_TEXELS, 4, indices, weights, e0, e1))
+			break;
+	}
+
+	// The high bit of the first index is implicitly 0, swap the endpoints if needed.
+	if (bestIndices[0] >= 8) {
+		std::swap(q0, q1);
+		std::swap(p0, p1);
+		for (unsigned int & index : bestIndices)
+			index = 15 - index;
+	}
+
+	// Pack the block, starting from the least significant bit.
+	memset(dst, 0, 16);
+	unsigned int position = 0;
+	auto write = [dst, &position](unsigned int value, unsigned int bits) {
+		for (unsigned int b = 0; b < bits; b++, position++)
+			if (value >> b & 1)
+				dst[position >> 3] |= 1 << (position & 7);
+	};
+	write(1 << 6, 7);
+	for (unsigned int c = 0; c < 4; c++) {
+		write(q0[c], 7);
+		write(q1[c], 7);
+	}
+	write(p0, 1);
+	write(p1, 1);
+	for (unsigned int i = 0; i < BLOCK_TEXELS; i++)
+		write(bestIndices[i], i == 0 ? 3 : 4);
+}
+
+vector<unsigned char> TextureCompressor::compress(const unsigned char * rgba, unsigned int width, unsigned int height, TextureFormat format) {
+
+	unsigned int blockSize = KTX2::getBlockSize(format);
+	unsigned int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+	vector<unsigned char> result(static_cast<size_t>(blocksX) * blocksY * blockSize);
+
+	for (unsigned int by = 0; by < blocksY; by++) {
+		for (unsigned int bx = 0; bx < blocksX; bx++) {
+
+			// Gather the block's texels, repeating the last row and column past the edges of the image.
+			unsigned char block[BLOCK_TEXELS * 4];
+			for (unsigned int y = 0; y < 4; y++)
+				for (unsigned int x = 0; x < 4; x++) {
+					unsigned int sx = std::min(bx * 4 + x, width - 1), sy = std::min(by * 4 + y, height - 1);
+					memcpy(block + (y * 4 + x) * 4, rgba + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+				}
+
+			unsigned char * dst = result.data() + (static_cast<size_t>(by) * blocksX + bx) * blockSize;
+			switch (format) {
+				case TEXTURE_FORMAT_BC1:
+					encodeBC1(block, dst, true);
+					break;
+				case TEXTURE_FORMAT_BC3:
+				case TEXTURE_FORMAT_BC5: {
+					unsigned char first[BLOCK_TEXELS], second[BLOCK_TEXELS];
+					for (unsigned int i = 0; i < BLOCK_TEXELS; i++) {
+						first[i] = block[i * 4 + (format == TEXTURE_FORMAT_BC3 ? 3 : 0)];
+						second[i] = block[i * 4 + 1];
+					}
+					encodeBC4(first, dst);
+					if (format == TEXTURE_FORMAT_BC3)
+						encodeBC1(block, dst + 8, false);
+					else
+						encodeBC4(second, dst + 8);
+					break;
+				}
+				case TEXTURE_FORMAT_BC7:
+					encodeBC7(block, dst);
+					break;
+			}
+		}
+	}
+
+	return result;
+}
+
+vector<unsigned char> TextureCompressor::downsample(const unsigned char * rgba, unsigned int width, unsigned int height) {
+
+	unsigned int dstWidth = std::max(1u, width / 2), dstHeight = std::max(1u, height / 2);
+	vector<unsigned char> result(static_cast<size_t>(dstWidth) * dstHeight * 4);
+
+	for (unsigned int y = 0; y < dstHeight; y++) {
+		unsigned int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+		for (unsigned int x = 0; x < dstWidth; x++) {
+			unsigned int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+			for (unsigned int c = 0; c < 4; c++) {
+				unsigned int sum = rgba[(static_cast<size_t>(y0) * width + x0) * 4 + c] + rgba[(static_cast<size_t>(y0) * width + x1) * 4 + c]
+					+ rgba[(static_cast<size_t>(y1) * width + x0) * 4 + c] + rgba[(static_cast<size_t>(y1) * width + x1) * 4 + c];
+				result[(static_cast<size_t>(y) * dstWidth + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+			}
+		}
+	}
+
+	return result;
+}
+
+bool TextureCompressor::cook(const char * src, const char * dst, TextureFormat format) {
+
+	// Load the source image.
+	int width, height, nbChannels;
+	unsigned char * data = stbi_load(src, &width, &height, &nbChannels, STBI_rgb_alpha);
+	if (data == NULL)
+		return false;
+
+	KTX2::Image image;
+	image.format = format;
+	image.width = width;
+	image.height = height;
+
+	// Compress every level of the mip chain, down to a single texel.
+	vector<unsigned char> level(data, data + static_cast<size_t>(width) * height * 4);
+	stbi_image_free(data);
+	unsigned int levelWidth = width, levelHeight = height;
+	while (true) {
+		image.levels.push_back(compress(level.data(), levelWidth, levelHeight, format));
+		if (levelWidth == 1 && levelHeight == 1)
+			break;
+		level = downsample(level.data(), levelWidth, levelHeight);
+		levelWidth = std::max(1u, levelWidth / 2);
+		levelHeight = std::max(1u, levelHeight / 2);
+	}
+
+	return KTX2::write(dst, image);
+}
@@ -0,0 +1,63 @@
+#include <vector>
+
+#include "KTX2.h"
+
+using std::vector;
+
+#pragma once
+class TextureCompressor {
+
+	private:
+		/**
+		 * @brief Encodes a 4x4 block of RGBA texels to BC1, using the punch-through alpha mode if any texel is transparent.
+		 *
+		 */
+		static void encodeBC1(const unsigned char * rgba, unsigned char * dst, bool alpha);
+
+		/**
+		 * @brief Encodes a 4x4 block of single channel values to BC4, as used by BC3 alpha and BC5 channels.
+		 *
+		 */
+		static void encodeBC4(const unsigned char * values, unsigned char * dst);
+
+		/**
+		 * @brief Encodes a 4x4 block of RGBA texels to BC7 using mode 6. (single subset, RGBA endpoints, 4 bit indices)
+		 *
+		 */
+		static void encodeBC7(const unsigned char * rgba, unsigned char * dst);
+
+	public:
+		/**
+		 * @brief Compresses an RGBA image to the given block-compressed format.
+		 * Images whose dimensions are not multiples of 4 have their edge texels repeated to fill the last blocks.
+		 *
+		 * @param rgba The image data, 4 bytes per texel, rows from top to bottom.
+		 * @param width The width of the image in texels.
+		 * @param height The height of the image in texels.
+		 * @param format The block-compressed format to encode to.
+		 * @return [vector<unsigned char>] The compressed blocks, in row-major order.
+		 */
+		static vector<unsigned char> compress(const unsigned char * rgba, unsigned int width, unsigned int height, TextureFormat format);
+
+		/**
+		 * @brief Halves an RGBA image in each dimension with a box filter, down to a minimum of 1 texel.
+		 *
+		 * @param rgba The image data, 4 bytes per texel.
+		 * @param width The width of the image in texels.
+		 * @param height The height of the image in texels.
+		 * @return [vector<unsigned char>] The next mip level's image data.
+		 */
+		static vector<unsigned char> downsample(const unsigned char * rgba, unsigned int width, unsigned int height);
+
+		/**
+		 * @brief Loads an image file, generates its full mip chain, compresses every level, and writes the result to a KTX2 file.
+		 * Meant to be run when cooking assets, not at runtime.
+		 *
+		 * @param src The path of the source image. (PNG, JPEG, TGA, etc...)
+		 * @param dst The path of the KTX2 file to write.
+		 * @param format The block-compressed format to encode to.
+		 * @return [bool] True if the texture was cooked successfully, false otherwise.
+		 */
+		static bool cook(const char * src, const char * dst, TextureFormat format);
+
+};
@@ -0,0 +1,142 @@
+#include <cstring>
+#include <algorithm>
+
+#include "stb_image.h"
+#include "Logger.h"
+#include "TextureDecoder.h"
+#include "VirtualFileSystem.h"
+#include "../render/GLStateCache.h"
+
+// How long to wait on the GPU for a ring slot when the caller asked to block, in nanoseconds.
+static const GLuint64 SLOT_TIMEOUT = 1000000000;
+
+TextureDecoder::TextureDecoder(const string & directory, unsigned int numThreads, unsigned int ringSize) :
+	directory(directory), pool(new ThreadPool(numThreads)), ring(ringSize) {
+	for (Slot & slot : ring) {
+		slot.pbo = VBO::create(GL_PIXEL_UNPACK_BUFFER);
+		slot.fence = nullptr;
+	}
+}
+
+TextureDecoder::~TextureDecoder() {
+	finish();
+	delete pool;
+	for (Slot & slot : ring) {
+		if (slot.fence != nullptr)
+			glDeleteSync(slot.fence);
+		ResourceManager::getShared()->destroy(slot.pbo->getHandle());
+	}
+}
+
+void TextureDecoder::load(const char * file, GLenum textureFilter, function<void(Texture *)> callback) {
+	Request request = { file, textureFilter, callback, nullptr, 0, 0 };
+	pending++;
+
+	// Decode from the mapped file straight into a pooled buffer, stb_image allocating from the shared buffer pool.
+	string path = directory + file;
+	pool->submit([this, request, path]() mutable {
+		int nbChannels;
+		FileView view = VirtualFileSystem::getShared()->open(path);
+		if (view.isValid())
+			request.pixels = stbi_load_from_memory(view.getData(), static_cast<int>(view.getSize()), &request.width, &request.height, &nbChannels, STBI_rgb_alpha);
+		std::lock_guard<std::mutex> lock(mutex);
+		decoded.push_back(std::move(request));
+	});
+}
+
+TextureDecoder * TextureDecoder::update() {
+	uploadDecoded(false);
+	return this;
+}
+
+TextureDecoder * TextureDecoder::finish() {
+	pool->wait();
+	uploadDecoded(true);
+	return this;
+}
+
+void TextureDecoder::uploadDecoded(bool wait) {
+	while (true) {
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (decoded.empty())
+				return;
+		}
+
+		// Wait for the GPU to be done with the slot's previous upload.
+		Slot & slot = ring[nextSlot];
+		if (slot.fence != nullptr) {
+			if (glClientWaitSync(slot.fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+				stalls++;
+				if (!wait)
+					return;
+				glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, SLOT_TIMEOUT);
+			}
+			glDeleteSync(slot.fence);
+			slot.fence = nullptr;
+		}
+
+		Request request;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			request = std::move(decoded.front());
+			decoded.pop_front();
+		}
+		upload(request, slot);
+		nextSlot = (nextSlot + 1) % ring.size();
+	}
+}
+
+void TextureDecoder::upload(Request & request, Slot & slot) {
+	pending--;
+	if (request.pixels == nullptr) {
+		request.callback(nullptr);
+		return;
+	}
+
+	// Copy the pixels into the slot's buffer, growing it if needed.
+	size_t size = static_cast<size_t>(request.width) * request.height * 4;
+	slot.pbo->bind();
+	if (size > slot.pbo->getSize())
+		slot.pbo->store(nullptr, static_cast<unsigned int>(size), GL_STREAM_DRAW);
+	void * dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	const void * source = nullptr;
+	if (dst != nullptr) {
+		memcpy(dst, request.pixels, size);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	} else {
+
+		// Upload straight from the decoded pixels when the buffer cannot be mapped.
+		if (Logger::isEnabled(LOG_ERROR))
+			Logger::stream(LOG_ERROR) << "Failed to map the upload buffer for " << request.file << ", uploading it synchronously." << std::endl;
+		slot.pbo->unbind();
+		source = request.pixels;
+	}
+
+	// The texture reads from the buffer asynchronously, fence the slot until it is done.
+	unsigned int texID;
+	glGenTextures(1, &texID);
+	GLStateCache::getShared()->bindTexture(GL_TEXTURE_2D, texID);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, request.width, request.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, source);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, request.textureFilter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, request.textureFilter);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	if (dst != nullptr) {
+		slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		slot.pbo->unbind();
+	}
+	stbi_image_free(request.pixels);
+
+	Texture * texture = new Texture(GL_TEXTURE_2D, texID);
+	texture->width = request.width;
+	texture->height = request.height;
+	while ((std::max(request.width, request.height) >> texture->levelCount) > 0)
+		texture->levelCount++;
+	texture->maxLevel = texture->levelCount - 1;
+	texture->memorySize = size * 4 / 3;
+
+	uploaded++;
+	bytesUploaded += size;
+	request.callback(texture);
+}
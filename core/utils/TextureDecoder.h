@@ -0,0 +1,165 @@
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <glad/glad.h>
+
+#include "../objects/Texture.h"
+#include "../objects/VAO.h"
+#include "ThreadPool.h"
+
+using std::deque;
+using std::string;
+using std::vector;
+using std::function;
+
+#pragma once
+class TextureDecoder {
+
+	private:
+		/**
+		 * @brief An image being loaded, holding its decoded pixels once a worker is done with it.
+		 *
+		 */
+		struct Request {
+			string file;
+			GLenum textureFilter;
+			function<void(Texture *)> callback;
+			unsigned char * pixels;
+			int width;
+			int height;
+		};
+
+		/**
+		 * @brief A pixel unpack buffer of the upload ring, and the fence signaled once the GPU is done reading from it.
+		 *
+		 */
+		struct Slot {
+			VBO * pbo;
+			GLsync fence;
+		};
+
+		/**
+		 * @brief The virtual directory the loaded files are relative to.
+		 *
+		 */
+		string directory;
+
+		/**
+		 * @brief The worker threads decoding the images.
+		 *
+		 */
+		ThreadPool * pool;
+
+		/**
+		 * @brief The decoded images waiting to be uploaded, guarded by the mutex.
+		 *
+		 */
+		std::mutex mutex;
+		deque<Request> decoded;
+
+		/**
+		 * @brief The ring of pixel unpack buffers the images are uploaded through, and the next one to use.
+		 *
+		 */
+		vector<Slot> ring;
+		unsigned int nextSlot = 0;
+
+		/**
+		 * @brief Loading statistics.
+		 *
+		 */
+		unsigned int pending = 0;
+		unsigned int uploaded = 0;
+		unsigned int stalls = 0;
+		unsigned long long bytesUploaded = 0;
+
+		/**
+		 * @brief Uploads a decoded image through the given ring slot and hands the resulting texture to its callback.
+		 *
+		 */
+		void upload(Request & request, Slot & slot);
+
+		/**
+		 * @brief Uploads decoded images until none are left, or until the next ring slot is still in use and wait is false.
+		 *
+		 */
+		void uploadDecoded(bool wait);
+
+	public:
+		/**
+		 * @brief The default number of pixel unpack buffers in the upload ring.
+		 *
+		 */
+		static const unsigned int DEFAULT_RING_SIZE = 3;
+
+		/**
+		 * @brief Constructs a new texture decoder, creating its upload ring. Must be called on the OpenGL thread.
+		 *
+		 * @param directory [Optional] The virtual directory the loaded files are relative to.
+		 * @param numThreads [Optional] The number of decoding threads, 0 to use one less than the number of hardware threads.
+		 * @param ringSize [Optional] The number of pixel unpack buffers in the upload ring.
+		 */
+		TextureDecoder(const string & directory = "Textures/", unsigned int numThreads = 0, unsigned int ringSize = DEFAULT_RING_SIZE);
+
+		/**
+		 * @brief Waits for the pending loads to finish and destroys the decoder and its upload ring.
+		 *
+		 */
+		~TextureDecoder();
+
+		/**
+		 * @brief Starts decoding an image in the background. The callback receives the texture on the OpenGL thread
+		 * during a later update, or a null pointer if the image could not be decoded.
+		 *
+		 * @param file The image file to load.
+		 * @param textureFilter The type for filtering to use for interpolation. (GL_NEAREST, GL_LINEAR, etc...)
+		 * @param callback The function receiving the loaded texture.
+		 */
+		void load(const char * file, GLenum textureFilter, function<void(Texture *)> callback);
+
+		/**
+		 * @brief Uploads the images decoded so far, without waiting on the GPU. Must be called on the OpenGL thread.
+		 *
+		 * @return [TextureDecoder *] This same decoder instance in order to allow for method chaining.
+		 */
+		TextureDecoder * update();
+
+		/**
+		 * @brief Blocks until every pending image is decoded and uploaded. Must be called on the OpenGL thread.
+		 *
+		 * @return [TextureDecoder *] This same decoder instance in order to allow for method chaining.
+		 */
+		TextureDecoder * finish();
+
+		/**
+		 * @brief Returns the number of images loading, decoded or not.
+		 *
+		 * @return [unsigned int] The number of pending loads.
+		 */
+		inline unsigned int getPending() const { return pending; };
+
+		/**
+		 * @brief Returns the number of images uploaded so far, and the number of bytes they took.
+		 *
+		 */
+		inline unsigned int getUploaded() const { return uploaded; };
+		inline unsigned long long getBytesUploaded() const { return bytesUploaded; };
+
+		/**
+		 * @brief Returns the number of times an upload had to wait on the GPU to release a ring slot.
+		 *
+		 * @return [unsigned int] The number of upload stalls.
+		 */
+		inline unsigned int getStalls() const { return stalls; };
+
+		/**
+		 * @brief Returns the number of threads decoding images.
+		 *
+		 * @return [unsigned int] The number of decoding threads.
+		 */
+		inline unsigned int getThreadCount() const { return pool->getThreadCount(); };
+
+};
@@ -0,0 +1,138 @@
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+#include "stb_image.h"
+#include "Logger.h"
+#include "TextureCompressor.h"
+#include "TexturePacker.h"
+
+using std::ostringstream;
+
+const char * TexturePacker::METADATA_KEY = "engine.atlas";
+
+// A source image and where it was packed.
+struct PackedImage {
+	string name;
+	unsigned char * pixels;
+	unsigned int width;
+	unsigned int height;
+	unsigned int layer;
+	RectanglePacker::Rect rect;
+};
+
+bool TexturePacker::cook(const vector<string> & sources, const char * dst, TextureFormat format, unsigned int pageSize, unsigned int padding, PackingStats * stats) {
+
+	// Load the source images.
+	vector<PackedImage> images;
+	bool loaded = true;
+	for (const string & source : sources) {
+		int width, height, nbChannels;
+		unsigned char * pixels = stbi_load(source.c_str(), &width, &height, &nbChannels, STBI_rgb_alpha);
+		if (pixels == NULL) {
+			loaded = false;
+			break;
+		}
+		size_t slash = source.find_last_of("/\\");
+		images.push_back({ slash == string::npos ? source : source.substr(slash + 1), pixels, static_cast<unsigned int>(width), static_cast<unsigned int>(height), 0, {} });
+	}
+	auto release = [&images]() {
+		for (PackedImage & image : images)
+			stbi_image_free(image.pixels);
+	};
+	if (!loaded || images.empty()) {
+		release();
+		return false;
+	}
+
+	// Pack the largest images first, padding them and rounding them up to whole blocks.
+	vector<PackedImage *> order;
+	for (PackedImage & image : images)
+		order.push_back(&image);
+	std::sort(order.begin(), order.end(), [](const PackedImage * a, const PackedImage * b) {
+		unsigned int sideA = std::max(a->width, a->height), sideB = std::max(b->width, b->height);
+		return sideA != sideB ? sideA > sideB : a->width * a->height > b->width * b->height;
+	});
+	vector<RectanglePacker> pages;
+	vector<PackedImage *> packed;
+	unsigned int rejected = 0;
+	for (PackedImage * image : order) {
+		unsigned int width = (image->width + padding * 2 + 3) / 4 * 4;
+		unsigned int height = (image->height + padding * 2 + 3) / 4 * 4;
+		if (width > pageSize || height > pageSize) {
+			if (Logger::isEnabled(LOG_WARNING))
+				Logger::stream(LOG_WARNING) << "Texture " << image->name << " does not fit in a " << pageSize << "x" << pageSize << " atlas page, skipping it." << std::endl;
+			rejected++;
+			continue;
+		}
+
+		// Try every page before starting a new one.
+		bool placed = false;
+		for (unsigned int p = 0; p < pages.size() && !placed; p++)
+			if (pages[p].insert(width, height, image->rect)) {
+				image->layer = p;
+				placed = true;
+			}
+		if (!placed) {
+			pages.emplace_back(pageSize, pageSize);
+			pages.back().insert(width, height, image->rect);
+			image->layer = static_cast<unsigned int>(pages.size() - 1);
+		}
+		packed.push_back(image);
+	}
+	if (packed.empty()) {
+		release();
+		return false;
+	}
+
+	// Copy the images into their pages, repeating their edges into the padding.
+	vector<vector<unsigned char>> layers(pages.size(), vector<unsigned char>(static_cast<size_t>(pageSize) * pageSize * 4, 0));
+	ostringstream locations;
+	for (PackedImage * image : packed) {
+		unsigned char * page = layers[image->layer].data();
+		for (unsigned int y = 0; y < image->rect.height; y++) {
+			int sy = std::min(std::max(static_cast<int>(y) - static_cast<int>(padding), 0), static_cast<int>(image->height) - 1);
+			for (unsigned int x = 0; x < image->rect.width; x++) {
+				int sx = std::min(std::max(static_cast<int>(x) - static_cast<int>(padding), 0), static_cast<int>(image->width) - 1);
+				memcpy(page + ((static_cast<size_t>(image->rect.y) + y) * pageSize + image->rect.x + x) * 4, image->pixels + (static_cast<size_t>(sy) * image->width + sx) * 4, 4);
+			}
+		}
+		locations << image->layer << " " << image->rect.x + padding << " " << image->rect.y + padding << " " << image->width << " " << image->height << " " << image->name << "\n";
+	}
+	release();
+
+	// Compress the mip chain of every page, each level holding all the pages.
+	KTX2::Image atlas;
+	atlas.format = format;
+	atlas.width = pageSize;
+	atlas.height = pageSize;
+	atlas.layers = static_cast<unsigned int>(pages.size());
+	atlas.metadata[METADATA_KEY] = locations.str();
+	unsigned int levelSize = pageSize;
+	while (true) {
+		vector<unsigned char> level;
+		for (vector<unsigned char> & layer : layers) {
+			vector<unsigned char> blocks = TextureCompressor::compress(layer.data(), levelSize, levelSize, format);
+			level.insert(level.end(), blocks.begin(), blocks.end());
+		}
+		atlas.levels.push_back(std::move(level));
+		if (levelSize == 1)
+			break;
+		for (vector<unsigned char> & layer : layers)
+			layer = TextureCompressor::downsample(layer.data(), levelSize, levelSize);
+		levelSize /= 2;
+	}
+
+	if (stats != nullptr) {
+		stats->pages = static_cast<unsigned int>(pages.size());
+		stats->entries = static_cast<unsigned int>(packed.size());
+		stats->rejected = rejected;
+		stats->usedArea = 0;
+		for (PackedImage * image : packed)
+			stats->usedArea += static_cast<unsigned long long>(image->width) * image->height;
+		stats->pageArea = static_cast<unsigned long long>(pageSize) * pageSize * pages.size();
+		stats->efficiency = static_cast<float>(static_cast<double>(stats->usedArea) / stats->pageArea);
+	}
+
+	return KTX2::write(dst, atlas);
+}
@@ -0,0 +1,63 @@
+#include <string>
+#include <vector>
+
+#include "KTX2.h"
+#include "RectanglePacker.h"
+
+using std::string;
+using std::vector;
+
+#pragma once
+
+/**
+ * @brief Statistics of a packing pass. The efficiency is the fraction of the pages covered by packed textures, padding excluded.
+ *
+ */
+struct PackingStats {
+	unsigned int pages;
+	unsigned int entries;
+	unsigned int rejected;
+	unsigned long long usedArea;
+	unsigned long long pageArea;
+	float efficiency;
+};
+
+class TexturePacker {
+
+	public:
+		/**
+		 * @brief The default size of each page, i.e. array layer, of a packed atlas.
+		 *
+		 */
+		static const unsigned int DEFAULT_PAGE_SIZE = 2048;
+
+		/**
+		 * @brief The default number of texels repeated around each packed texture to keep filtering and mip levels from bleeding.
+		 *
+		 */
+		static const unsigned int DEFAULT_PADDING = 4;
+
+		/**
+		 * @brief The KTX2 metadata key holding the location of each packed texture, one line per texture formatted as
+		 * "layer x y width height name", in texels of level 0.
+		 *
+		 */
+		static const char * METADATA_KEY;
+
+		/**
+		 * @brief Packs images into the layers of a block-compressed 2D texture array and writes it to a KTX2 file with its mip chain.
+		 * Textures are placed on 4 texel boundaries so that no compressed block straddles two of them.
+		 * Meant to be run when cooking assets, not at runtime.
+		 *
+		 * @param sources The paths of the source images. Each texture is named after its file name.
+		 * @param dst The path of the KTX2 file to write.
+		 * @param format The block-compressed format to encode to.
+		 * @param pageSize [Optional] The width and height of each array layer.
+		 * @param padding [Optional] The number of edge texels repeated around each texture.
+		 * @param stats [Optional] Receives the packing statistics.
+		 * @return [bool] True if the atlas was cooked successfully, false otherwise.
+		 */
+		static bool cook(const vector<string> & sources, const char * dst, TextureFormat format, 
+			unsigned int pageSize = DEFAULT_PAGE_SIZE, unsigned int padding = DEFAULT_PADDING, PackingStats * stats = nullptr);
+
+};
@@ -0,0 +1,55 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int numThreads) {
+	if (numThreads == 0)
+		numThreads = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1;
+	for (unsigned int i = 0; i < numThreads; i++)
+		workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	available.notify_all();
+	for (std::thread & worker : workers)
+		worker.join();
+}
+
+void ThreadPool::submit(function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push(std::move(task));
+		unfinished++;
+	}
+	available.notify_one();
+}
+
+void ThreadPool::wait() {
+	std::unique_lock<std::mutex> lock(mutex);
+	idle.wait(lock, [this]() { return unfinished == 0; });
+}
+
+void ThreadPool::work() {
+	while (true) {
+
+		// Wait for a task, exiting once the pool is stopping and no task is left.
+		function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+			if (tasks.empty())
+				return;
+			task = std::move(tasks.front());
+			tasks.pop();
+		}
+
+		task();
+
+		// Wake up the waiters once the last task is done.
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--unfinished == 0)
+			idle.notify_all();
+	}
+}
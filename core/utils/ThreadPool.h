@@ -0,0 +1,88 @@
+#include <queue>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+
+using std::queue;
+using std::vector;
+using std::function;
+
+#pragma once
+class ThreadPool {
+
+	private:
+		/**
+		 * @brief The worker threads running the submitted tasks.
+		 * 
+		 */
+		vector<std::thread> workers;
+
+		/**
+		 * @brief The tasks waiting for a worker, in submission order.
+		 * 
+		 */
+		queue<function<void()>> tasks;
+
+		/**
+		 * @brief The number of tasks queued or currently running.
+		 * 
+		 */
+		unsigned int unfinished = 0;
+
+		/**
+		 * @brief Whether or not the workers should exit once the queue is empty.
+		 * 
+		 */
+		bool stopping = false;
+
+		/**
+		 * @brief Guards the task queue, signaling workers when tasks are submitted and waiters when all tasks are done.
+		 * 
+		 */
+		std::mutex mutex;
+		std::condition_variable available;
+		std::condition_variable idle;
+
+		/**
+		 * @brief Runs tasks until the pool is destroyed.
+		 * 
+		 */
+		void work();
+
+	public:
+		/**
+		 * @brief Starts a new pool of worker threads.
+		 * 
+		 * @param numThreads [Optional] The number of worker threads, 0 to use one less than the number of hardware threads.
+		 */
+		ThreadPool(unsigned int numThreads = 0);
+
+		/**
+		 * @brief Finishes the tasks already submitted and joins the worker threads.
+		 * 
+		 */
+		~ThreadPool();
+
+		/**
+		 * @brief Queues a task to be run on one of the worker threads.
+		 * 
+		 * @param task The task to run.
+		 */
+		void submit(function<void()> task);
+
+		/**
+		 * @brief Blocks until every submitted task has finished running.
+		 * 
+		 */
+		void wait();
+
+		/**
+		 * @brief Returns the number of worker threads in this pool.
+		 * 
+		 * @return [unsigned int] The number of worker threads.
+		 */
+		inline unsigned int getThreadCount() const { return static_cast<unsigned int>(workers.size()); };
+
+};
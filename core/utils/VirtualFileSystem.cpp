@@ -0,0 +1,122 @@
+#include <algorithm>
+
+#include "FileSystem.h"
+#include "VirtualFileSystem.h"
+
+// Drops the trailing separators of a directory path on disk.
+static string trimSeparators(const string & path) {
+	size_t end = path.find_last_not_of("/\\");
+	return end == string::npos ? path : path.substr(0, end + 1);
+}
+
+VirtualFileSystem * VirtualFileSystem::getShared() {
+	static VirtualFileSystem shared;
+	return &shared;
+}
+
+string VirtualFileSystem::normalize(const string & path) {
+	string normalized = path;
+	std::replace(normalized.begin(), normalized.end(), '\\', '/');
+	size_t start = 0;
+	while (true) {
+		if (normalized.compare(start, 2, "./") == 0)
+			start += 2;
+		else if (normalized.compare(start, 1, "/") == 0)
+			start += 1;
+		else
+			break;
+	}
+	return normalized.substr(start);
+}
+
+bool VirtualFileSystem::mount(const string & point, const string & path) {
+	Mount mount;
+	mount.point = normalize(point);
+	if (!mount.point.empty() && mount.point.back() != '/')
+		mount.point += '/';
+	mount.path = trimSeparators(path);
+	if (!FileSystem::isDirectory(mount.path)) {
+		mount.archive = PackArchive::open(mount.path);
+		if (mount.archive == nullptr)
+			return false;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	mounts.push_back(mount);
+	return true;
+}
+
+void VirtualFileSystem::unmount(const string & path) {
+	string trimmed = trimSeparators(path);
+	std::lock_guard<std::mutex> lock(mutex);
+	mounts.erase(std::remove_if(mounts.begin(), mounts.end(), [&trimmed](const Mount & mount) { return mount.path == trimmed; }), mounts.end());
+}
+
+vector<VirtualFileSystem::Mount> VirtualFileSystem::getSearchOrder() const {
+	vector<Mount> order;
+	bool overrides;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		order.assign(mounts.rbegin(), mounts.rend());
+		overrides = looseOverrides;
+	}
+
+	// Loose files first when they override archives, keeping the mount order within each kind.
+	if (overrides)
+		std::stable_partition(order.begin(), order.end(), [](const Mount & mount) { return mount.archive == nullptr; });
+	return order;
+}
+
+bool VirtualFileSystem::getRelativePath(const Mount & mount, const string & path, string & relative) {
+	if (path.compare(0, mount.point.size(), mount.point) != 0)
+		return false;
+	relative = path.substr(mount.point.size());
+	return true;
+}
+
+FileView VirtualFileSystem::open(const string & path) const {
+	string normalized = normalize(path);
+	string relative;
+	for (const Mount & mount : getSearchOrder()) {
+		if (!getRelativePath(mount, normalized, relative))
+			continue;
+
+		// Packed files are views into the archive's mapping, loose files are mapped on their own.
+		if (mount.archive != nullptr) {
+			const PackArchive::Entry * entry = mount.archive->find(relative);
+			if (entry != nullptr)
+				return FileView(mount.archive->getFile(), mount.archive->getFile()->getData() + entry->offset, static_cast<size_t>(entry->size));
+		} else {
+			shared_ptr<MappedFile> file = MappedFile::open(mount.path + "/" + relative);
+			if (file != nullptr)
+				return FileView(file, file->getData(), file->getSize());
+		}
+	}
+	return FileView();
+}
+
+string VirtualFileSystem::resolve(const string & path) const {
+	string normalized = normalize(path);
+	string relative;
+	for (const Mount & mount : getSearchOrder()) {
+		if (!getRelativePath(mount, normalized, relative))
+			continue;
+		if (mount.archive != nullptr) {
+			if (mount.archive->find(relative) != nullptr)
+				return "";
+		} else if (MappedFile::open(mount.path + "/" + relative) != nullptr) {
+			return mount.path + "/" + relative;
+		}
+	}
+	return "";
+}
+
+VirtualFileSystem * VirtualFileSystem::setLooseOverrides(bool looseOverrides) {
+	std::lock_guard<std::mutex> lock(mutex);
+	this->looseOverrides = looseOverrides;
+	return this;
+}
+
+bool VirtualFileSystem::getLooseOverrides() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return looseOverrides;
+}
@@ -0,0 +1,183 @@
+#include <mutex>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "MappedFile.h"
+#include "PackArchive.h"
+
+using std::string;
+using std::vector;
+using std::shared_ptr;
+
+#pragma once
+
+/**
+ * @brief A read-only view of a file's contents, pointing straight into a memory mapping kept alive by the view.
+ *
+ */
+class FileView {
+
+	private:
+		shared_ptr<MappedFile> file;
+		const unsigned char * data = nullptr;
+		size_t size = 0;
+
+	public:
+		/**
+		 * @brief Constructs an invalid view, for files that could not be found.
+		 * 
+		 */
+		FileView() = default;
+
+		/**
+		 * @brief Constructs a view of a range of a mapped file.
+		 * 
+		 * @param file The mapped file the range belongs to.
+		 * @param data The first byte of the range.
+		 * @param size The size of the range in bytes.
+		 */
+		FileView(const shared_ptr<MappedFile> & file, const unsigned char * data, size_t size) :
+			file(file), data(data), size(size) {}
+
+		/**
+		 * @brief Returns whether or not the view refers to a file that was found.
+		 * 
+		 * @return [bool] True if the file was found, false otherwise.
+		 */
+		inline bool isValid() const { return file != nullptr; };
+
+		/**
+		 * @brief Returns the file's contents.
+		 * 
+		 * @return [const unsigned char *] The first byte of the file, null for empty or invalid files.
+		 */
+		inline const unsigned char * getData() const { return data; };
+
+		/**
+		 * @brief Returns the file's size.
+		 * 
+		 * @return [size_t] The size of the file in bytes.
+		 */
+		inline size_t getSize() const { return size; };
+
+		/**
+		 * @brief Copies the file's contents into a string, for text files.
+		 * 
+		 * @return [string] The file's contents.
+		 */
+		inline string toString() const { return size > 0 ? string(reinterpret_cast<const char *>(data), size) : string(); };
+
+};
+
+class VirtualFileSystem {
+
+	private:
+		/**
+		 * @brief A directory or pack archive mounted at a virtual path prefix.
+		 * 
+		 */
+		struct Mount {
+			string point;
+			string path;
+			shared_ptr<PackArchive> archive;
+		};
+
+		/**
+		 * @brief The mounted directories and archives, searched from the most recently mounted, guarded by the mutex.
+		 * 
+		 */
+		mutable std::mutex mutex;
+		vector<Mount> mounts;
+
+		/**
+		 * @brief Whether or not loose files in mounted directories take precedence over every mounted archive.
+		 * 
+		 */
+		bool looseOverrides = false;
+
+		/**
+		 * @brief Returns a copy of the mounts in the order they are searched.
+		 * 
+		 */
+		vector<Mount> getSearchOrder() const;
+
+		/**
+		 * @brief Returns the path of a normalized virtual path relative to a mount, or false if the mount does not contain it.
+		 * 
+		 */
+		static bool getRelativePath(const Mount & mount, const string & path, string & relative);
+
+	public:
+		/**
+		 * @brief Returns the file system shared by the whole engine.
+		 * 
+		 * @return [VirtualFileSystem *] The shared file system instance.
+		 */
+		static VirtualFileSystem * getShared();
+
+		/**
+		 * @brief Normalizes a virtual path, using forward slashes and dropping leading "./" and "/" components.
+		 * 
+		 * @param path The path to normalize.
+		 * @return [string] The normalized path.
+		 */
+		static string normalize(const string & path);
+
+		/**
+		 * @brief Mounts a directory or a pack archive at a virtual path prefix. Later mounts hide the files of earlier ones.
+		 * 
+		 * @param point The virtual directory the mount's files appear under, empty for the root.
+		 * @param path The directory or pack archive to mount.
+		 * @return [bool] True if the directory or archive was mounted, false if it does not exist or is not a valid archive.
+		 */
+		bool mount(const string & point, const string & path);
+
+		/**
+		 * @brief Unmounts every mount of a directory or pack archive. Views of its files remain valid.
+		 * 
+		 * @param path The directory or pack archive to unmount.
+		 */
+		void unmount(const string & path);
+
+		/**
+		 * @brief Opens a file for reading, mapping it into memory without copying it.
+		 * This method returns an invalid view if no mount contains the file.
+		 * 
+		 * @param path The virtual path of the file.
+		 * @return [FileView] A view of the file's contents.
+		 */
+		FileView open(const string & path) const;
+
+		/**
+		 * @brief Returns whether or not a mounted directory or archive contains a file.
+		 * 
+		 * @param path The virtual path of the file.
+		 * @return [bool] True if the file exists, false otherwise.
+		 */
+		inline bool exists(const string & path) const { return open(path).isValid(); };
+
+		/**
+		 * @brief Returns the path on disk of the loose file a virtual path resolves to.
+		 * 
+		 * @param path The virtual path of the file.
+		 * @return [string] The path of the loose file, empty if the file is packed in an archive or not found.
+		 */
+		string resolve(const string & path) const;
+
+		/**
+		 * @brief Sets whether or not loose files in mounted directories override every mounted archive, for development.
+		 * 
+		 * @param looseOverrides Whether or not loose files take precedence.
+		 * @return [VirtualFileSystem *] This same file system instance in order to allow for method chaining.
+		 */
+		VirtualFileSystem * setLooseOverrides(bool looseOverrides);
+
+		/**
+		 * @brief Returns whether or not loose files in mounted directories override every mounted archive.
+		 * 
+		 * @return [bool] True if loose files take precedence, false if mounts are searched in order only.
+		 */
+		bool getLooseOverrides() const;
+
+};
@@ -1,5 +1,8 @@
 /* stb_image - v2.16 - public domain image loader - http://nothings.org/stb_image.h
 no warranty implied; use at your own risk
+
+LOCAL PATCH (game-engine): stbi__g_failure_reason honors STBI_THREAD_LOCAL, see its declaration.
+
 Do this:
 #define STB_IMAGE_IMPLEMENTATION
 before you include this file in *one* C or C++ file to create the implementation.
@@ -807,8 +810,12 @@ static void    *stbi__pnm_load(stbi__context *s, int *x, int *y, int *comp, int
 static int      stbi__pnm_info(stbi__context *s, int *x, int *y, int *comp);
 #endif
 
-// this is not threadsafe
-static const char *stbi__g_failure_reason;
+// LOCAL PATCH (game-engine): the including file may define STBI_THREAD_LOCAL, as upstream allows from v2.26,
+// so that images can be decoded on several threads at once. Reapply when updating this header.
+#ifndef STBI_THREAD_LOCAL
+#define STBI_THREAD_LOCAL
+#endif
+static STBI_THREAD_LOCAL const char *stbi__g_failure_reason;
 
 STBIDEF const char *stbi_failure_reason(void)
 {
@@ -1,11 +1,27 @@
 #version 400 core
 
 in vec2 pass_uv;
+in vec4 pass_tint;
 
 out vec4 color;
 
 uniform sampler2D tex;
+uniform sampler2DArray texArray;
+uniform bool arrayTexture;
+uniform vec4 uvTransform;
+uniform int layer;
 
 void main(void){
-	color = texture(tex, pass_uv);
-}
\ No newline at end of file
+	vec2 uv = uvTransform.xy + pass_uv * uvTransform.zw;
+	if (arrayTexture) {
+
+		// Keep the filter footprint inside the atlas entry, half a texel in from its edges at the coarsest level sampled.
+		int level = int(ceil(textureQueryLod(texArray, uv).x));
+		vec2 inset = min(0.5 / vec2(textureSize(texArray, level).xy), uvTransform.zw * 0.5);
+		uv = clamp(uv, uvTransform.xy + inset, uvTransform.xy + uvTransform.zw - inset);
+		color = texture(texArray, vec3(uv, layer));
+	}
+	else
+		color = texture(tex, uv);
+	color *= pass_tint;
+}
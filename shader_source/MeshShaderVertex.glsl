@@ -1,34 +1,70 @@
 #version 400 core
 
-const int MAX_JOINTS = 50;
-const int MAX_WEIGHTS = 3;
+const int MAX_JOINTS = 256;
+const int INFLUENCES_PER_ATTRIBUTE = 4;
 
 in vec3 pos;
 in vec3 normal;
 in vec2 uv;
-in uvec3 jointIDs;
-in vec3 weights;
+in uvec4 jointIDs;
+in vec4 weights;
+in uvec4 jointIDs2;
+in vec4 weights2;
+
+in mat4 instanceModel;
+in vec4 instanceTint;
+in uint instancePalette;
 
 out vec2 pass_uv;
+out vec4 pass_tint;
+
+// Camera and render target data shared by all shaders, see FrameUniforms
+layout(std140) uniform FrameData {
+	mat4 view;
+	mat4 projection;
+	mat4 projView;
+	vec4 cameraPosition;
+	vec4 time;
+};
+
+layout(std140) uniform PassData {
+	vec4 viewport;
+	vec4 clipPlanes;
+};
 
-uniform mat4 projViewMatrix;
 uniform mat4 modelMatrix;
 
-uniform mat4 jointTransforms[MAX_JOINTS];
+// Joint palette of the draw, each instance's skeleton starting at its palette offset, see MeshShader
+layout(std140) uniform JointData {
+	mat4 jointTransforms[MAX_JOINTS];
+};
 
 uniform bool animated;
+uniform int influences;
+uniform bool instanced;
 
 void main(void){
 	
 	vec4 totalPos = vec4(0);
 	vec4 totalNormal = vec4(0);
 
+	// Instanced draws read their model matrix, tint and joint palette offset from the instance attributes
+	mat4 model = instanced ? instanceModel : modelMatrix;
+	uint palette = instanced ? instancePalette : 0u;
+
 	// Calculate position and normal based on current pose
 	if(animated) {
-		for (int i = 0; i < MAX_WEIGHTS; i++) {
-			mat4 transform = jointTransforms[jointIDs[i]];
+		for (int i = 0; i < INFLUENCES_PER_ATTRIBUTE; i++) {
+			mat4 transform = jointTransforms[palette + jointIDs[i]];
 			totalPos += weights[i] * transform * vec4(pos, 1.0);
-			totalNormal = weights[i] * transform * vec4(normal, 0.0);
+			totalNormal += weights[i] * transform * vec4(normal, 0.0);
+		}
+		if (influences > INFLUENCES_PER_ATTRIBUTE) {
+			for (int i = 0; i < INFLUENCES_PER_ATTRIBUTE; i++) {
+				mat4 transform = jointTransforms[palette + jointIDs2[i]];
+				totalPos += weights2[i] * transform * vec4(pos, 1.0);
+				totalNormal += weights2[i] * transform * vec4(normal, 0.0);
+			}
 		}
 	} else {
 		totalPos = vec4(pos, 1.0);
@@ -36,9 +72,10 @@ void main(void){
 	}
 
 	// Set world position
-	gl_Position = projViewMatrix * modelMatrix * totalPos;
+	gl_Position = projView * model * totalPos;
 
-	// Pass the texture coordinates to fragment shader
+	// Pass the texture coordinates and tint to fragment shader
 	pass_uv = uv;
+	pass_tint = instanced ? instanceTint : vec4(1.0);
 
 }
\ No newline at end of file
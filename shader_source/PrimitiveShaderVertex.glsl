@@ -5,12 +5,24 @@ in vec3 color;
 
 out vec3 pass_color;
 
-uniform mat4 projViewMatrix;
+// Camera and render target data shared by all shaders, see FrameUniforms
+layout(std140) uniform FrameData {
+	mat4 view;
+	mat4 projection;
+	mat4 projView;
+	vec4 cameraPosition;
+	vec4 time;
+};
+
+layout(std140) uniform PassData {
+	vec4 viewport;
+	vec4 clipPlanes;
+};
 
 void main(void){
 
 	pass_color = color;
 
-	gl_Position = projViewMatrix * vec4(pos, 1);
+	gl_Position = projView * vec4(pos, 1);
 
 }
\ No newline at end of file